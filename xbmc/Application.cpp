@@ -30,6 +30,7 @@
 #include "PlayListPlayer.h"
 #include "Autorun.h"
 #include "video/Bookmark.h"
+#include "video/VideoExtractionQueue.h"
 #include "video/VideoLibraryQueue.h"
 #include "music/MusicLibraryQueue.h"
 #include "guilib/GUIControlProfiler.h"
@@ -735,6 +736,15 @@ bool CApplication::Initialize()
   // initialize (and update as needed) our databases
   CDatabaseManager &databaseManager = m_ServiceManager->GetDatabaseManager();
 
+  const std::shared_ptr<CAdvancedSettings> advancedSettings = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings();
+  CJobManager::GetInstance().SetWorkStealing(advancedSettings->m_jobManagerWorkStealing);
+
+  g_directoryCache.SetMaxMemorySize(advancedSettings->m_dirCacheMemSize);
+  if (advancedSettings->m_dirCachePersistent)
+    g_directoryCache.SetPersistentCache("special://temp/directorycache/", advancedSettings->m_dirCacheDiskSize);
+
+  CServiceBroker::GetGUI()->GetTextureManager().SetMemoryBudget(advancedSettings->m_guiTextureMemoryBudget);
+
   CEvent event(true);
   CJobManager::GetInstance().Submit([&databaseManager, &event]() {
     databaseManager.Initialize();
@@ -2594,6 +2604,9 @@ void CApplication::Stop(int exitCode)
     if (CVideoLibraryQueue::GetInstance().IsRunning())
       CVideoLibraryQueue::GetInstance().CancelAllJobs();
 
+    // also drops the idle thumb decoders
+    CVideoExtractionQueue::GetInstance().CancelAllJobs();
+
     CApplicationMessenger::GetInstance().Cleanup();
 
     StopServices();
@@ -13,6 +13,7 @@
 #include "cores/VideoPlayer/VideoPlayer.h"
 #include "guilib/GUIComponent.h"
 #include "guilib/GUIWindowManager.h"
+#include "rendering/RenderSystem.h"
 #include "Application.h"
 #include "PlayListPlayer.h"
 #include "ServiceBroker.h"
@@ -829,7 +830,10 @@ void CApplicationPlayer::Render(bool clear, uint32_t alpha, bool gui)
 {
   std::shared_ptr<IPlayer> player = GetInternal();
   if (player)
+  {
+    CServiceBroker::GetRenderSystem()->FlushBatch();
     player->Render(clear, alpha, gui);
+  }
 }
 
 void CApplicationPlayer::FlushRenderer()
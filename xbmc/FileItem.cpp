@@ -116,6 +116,16 @@ CFileItem::CFileItem(const CVideoInfoTag& movie)
 
 namespace
 {
+  /*! identifies the directory caches written by CFileItemList::Save() */
+  const uint32_t CACHE_MAGIC = 0x4b464943;
+
+  /*! has to be increased whenever the Archive() of CFileItem, CFileItemList or
+      one of the info tags changes, older caches are ignored then */
+  const uint32_t CACHE_VERSION = 1;
+
+  /*! magic, version and the size of the items in bytes */
+  const size_t CACHE_HEADER_SIZE = 2 * sizeof(uint32_t) + sizeof(uint64_t);
+
   std::string GetEpgTagTitle(const std::shared_ptr<CPVREpgInfoTag>& epgTag)
   {
     if (CServiceBroker::GetPVRManager().IsParentalLocked(epgTag))
@@ -2881,14 +2891,28 @@ bool CFileItemList::Load(int windowID)
   auto path = GetDiscFileCache(windowID);
   try
   {
-    if (file.Open(path))
+    // read the whole cache at once and decode it from memory
+    auto_buffer buffer;
+    if (file.LoadFile(path, buffer) >= static_cast<ssize_t>(CACHE_HEADER_SIZE))
     {
-      CArchive ar(&file, CArchive::load);
+      CArchive ar(reinterpret_cast<const uint8_t*>(buffer.get()), buffer.size());
+
+      uint32_t magic = 0;
+      uint32_t version = 0;
+      uint64_t size = 0;
+      ar >> magic;
+      ar >> version;
+      ar >> size;
+      if (magic != CACHE_MAGIC || version != CACHE_VERSION || size != buffer.size() - CACHE_HEADER_SIZE)
+      {
+        CLog::Log(LOGDEBUG, "Ignoring outdated or truncated cache: %s", CURL::GetRedacted(path).c_str());
+        return false;
+      }
+
       ar >> *this;
       CLog::Log(LOGDEBUG,"Loading items: %i, directory: %s sort method: %i, ascending: %s", Size(), CURL::GetRedacted(GetPath()).c_str(), m_sortDescription.sortBy,
         m_sortDescription.sortOrder == SortOrderAscending ? "true" : "false");
       ar.Close();
-      file.Close();
       return true;
     }
   }
@@ -2908,13 +2932,28 @@ bool CFileItemList::Save(int windowID)
 
   CLog::Log(LOGDEBUG,"Saving fileitems [%s]", CURL::GetRedacted(GetPath()).c_str());
 
+  // the size in the header is filled in once the items are stored
+  std::vector<uint8_t> data;
+  CArchive ar(data);
+  ar << CACHE_MAGIC;
+  ar << CACHE_VERSION;
+  ar << static_cast<uint64_t>(0);
+  ar << *this;
+  ar.Close();
+
+  const uint64_t size = data.size() - CACHE_HEADER_SIZE;
+  memcpy(data.data() + CACHE_HEADER_SIZE - sizeof(size), &size, sizeof(size));
+
   CFile file;
   if (file.OpenForWrite(GetDiscFileCache(windowID), true)) // overwrite always
   {
-    CArchive ar(&file, CArchive::store);
-    ar << *this;
+    if (file.Write(data.data(), data.size()) != static_cast<ssize_t>(data.size()))
+    {
+      file.Close();
+      CFile::Delete(GetDiscFileCache(windowID));
+      return false;
+    }
     CLog::Log(LOGDEBUG,"  -- items: %i, sort method: %i, ascending: %s", iSize, m_sortDescription.sortBy, m_sortDescription.sortOrder == SortOrderAscending ? "true" : "false");
-    ar.Close();
     file.Close();
     return true;
   }
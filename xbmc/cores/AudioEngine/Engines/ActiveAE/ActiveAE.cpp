@@ -15,6 +15,7 @@ using namespace ActiveAE;
 #include "ActiveAEStream.h"
 #include "ServiceBroker.h"
 #include "cores/AudioEngine/Interfaces/IAudioCallback.h"
+#include "cores/AudioEngine/Utils/AEKernels.h"
 #include "cores/AudioEngine/Utils/AEUtil.h"
 #include "cores/AudioEngine/Utils/AEStreamData.h"
 #include "cores/AudioEngine/Utils/AEStreamInfo.h"
@@ -25,6 +26,7 @@ using namespace ActiveAE;
 #include "settings/SettingsComponent.h"
 #include "windowing/WinSystem.h"
 #include "utils/log.h"
+#include "utils/TimeUtils.h"
 
 #define MAX_CACHE_LEVEL 0.4   // total cache time of stream in seconds
 #define MAX_WATER_LEVEL 0.2   // buffered time after stream stages in seconds
@@ -246,6 +248,21 @@ AEAudioFormat CEngineStats::GetCurrentSinkFormat()
   return m_sinkFormat;
 }
 
+void CEngineStats::AddConfigureTime(double time)
+{
+  CSingleLock lock(m_lock);
+  m_configureStats.count++;
+  m_configureStats.last = time;
+  m_configureStats.max = std::max(m_configureStats.max, time);
+  m_configureStats.total += time;
+}
+
+CEngineStats::ConfigureStats CEngineStats::GetConfigureStats()
+{
+  CSingleLock lock(m_lock);
+  return m_configureStats;
+}
+
 CActiveAE::CActiveAE() :
   CThread("ActiveAE"),
   m_controlPort("OutputControlPort", &m_inMsgEvent, &m_outMsgEvent),
@@ -296,6 +313,10 @@ void CActiveAE::Dispose()
   m_controlPort.Purge();
   m_dataPort.Purge();
   m_sink.Dispose();
+
+  // free what the buffer pools of the engine left behind
+  CActiveAEResampleCache::Clear();
+  CSampleMemoryCache::Clear();
 }
 
 //-----------------------------------------------------------------------------
@@ -1124,8 +1145,13 @@ AEAudioFormat CActiveAE::GetInputFormat(AEAudioFormat *desiredFmt)
 
 void CActiveAE::Configure(AEAudioFormat *desiredFmt)
 {
+  int64_t startTime = CurrentHostCounter();
   bool initSink = false;
 
+  // hand the memory and resamplers of unused pools to the caches before
+  // creating new ones
+  ClearDiscardedBuffers();
+
   AEAudioFormat sinkInputFormat, inputFormat;
   AEAudioFormat oldInternalFormat = m_internalFormat;
   AEAudioFormat oldSinkRequestFormat = m_sinkRequestFormat;
@@ -1403,6 +1429,14 @@ void CActiveAE::Configure(AEAudioFormat *desiredFmt)
 
   ClearDiscardedBuffers();
   m_extDrain = false;
+
+  double configureTime = (double)(CurrentHostCounter() - startTime) / CurrentHostFrequency();
+  m_stats.AddConfigureTime(configureTime);
+  CSampleMemoryCache::Stats memoryStats = CSampleMemoryCache::GetStats();
+  CActiveAEResampleCache::Stats resampleStats = CActiveAEResampleCache::GetStats();
+  CLog::Log(LOGDEBUG, "CActiveAE::Configure - took %.2f ms, sample memory %u hits %u misses, "
+            "resamplers %u hits %u misses", configureTime * 1000,
+            memoryStats.hits, memoryStats.misses, resampleStats.hits, resampleStats.misses);
 }
 
 CActiveAEStream* CActiveAE::CreateStream(MsgStreamNew *streamMsg)
@@ -1985,6 +2019,7 @@ bool CActiveAE::RunStages()
       }
 
       bool needClamp = false;
+      const CAEKernels::Functions& kernels = CAEKernels::Get();
       for (it = m_streams.begin(); it != m_streams.end() && allStreamsReady; ++it)
       {
         if ((*it)->m_paused || !(*it)->m_processingBuffers)
@@ -2066,15 +2101,7 @@ bool CActiveAE::RunStages()
 
               for(int j=0; j<out->pkt->planes; j++)
               {
-#if defined(HAVE_SSE) && defined(__SSE__)
-                CAEUtil::SSEMulArray((float*)out->pkt->data[j]+i*nb_floats, volume, nb_floats);
-#else
-                float* fbuffer = (float*) out->pkt->data[j]+i*nb_floats;
-                for (int k = 0; k < nb_floats; ++k)
-                {
-                  fbuffer[k] *= volume;
-                }
-#endif
+                kernels.MulArray((float*)out->pkt->data[j]+i*nb_floats, volume, nb_floats);
               }
             }
           }
@@ -2135,24 +2162,8 @@ bool CActiveAE::RunStages()
               {
                 float *dst = (float*)out->pkt->data[j]+i*nb_floats;
                 float *src = (float*)mix->pkt->data[j]+i*nb_floats;
-#if defined(HAVE_SSE) && defined(__SSE__)
-                CAEUtil::SSEMulAddArray(dst, src, volume, nb_floats);
-                for (int k = 0; k < nb_floats; ++k)
-                {
-                  if (fabs(dst[k]) > 1.0f)
-                  {
-                    needClamp = true;
-                    break;
-                  }
-                }
-#else
-                for (int k = 0; k < nb_floats; ++k)
-                {
-                  dst[k] += src[k] * volume;
-                  if (fabs(dst[k]) > 1.0f)
-                    needClamp = true;
-                }
-#endif
+                if (kernels.MulAddArray(dst, src, volume, nb_floats))
+                  needClamp = true;
               }
             }
             mix->Return();
@@ -2512,6 +2523,7 @@ void CActiveAE::MixSounds(CSoundPacket &dstSample)
   if (m_sounds_playing.empty())
     return;
 
+  const CAEKernels::Functions& kernels = CAEKernels::Get();
   float volume;
   float *out;
   float *sample_buffer;
@@ -2535,12 +2547,7 @@ void CActiveAE::MixSounds(CSoundPacket &dstSample)
       out = (float*)dstSample.data[j];
       sample_buffer = (float*)(it->sound->GetSound(false)->data[j]+start);
       int nb_floats = mix_samples * dstSample.config.channels / dstSample.planes;
-#if defined(HAVE_SSE) && defined(__SSE__)
-      CAEUtil::SSEMulAddArray(out, sample_buffer, volume, nb_floats);
-#else
-      for (int k = 0; k < nb_floats; ++k)
-        *out++ += *sample_buffer++ * volume;
-#endif
+      kernels.MulAddArray(out, sample_buffer, volume, nb_floats);
     }
 
     it->samples_played += mix_samples;
@@ -2561,17 +2568,12 @@ void CActiveAE::Deamplify(CSoundPacket &dstSample)
   {
     int nb_floats = dstSample.nb_samples * dstSample.config.channels / dstSample.planes;
     float volume = m_muted ? 0.0f : m_volumeScaled;
+    const CAEKernels::Functions& kernels = CAEKernels::Get();
 
     for(int j=0; j<dstSample.planes; j++)
     {
       float* buffer = reinterpret_cast<float*>(dstSample.data[j]);
-#if defined(HAVE_SSE) && defined(__SSE__)
-      CAEUtil::SSEMulArray(buffer, volume, nb_floats);
-#else
-      float *fbuffer = buffer;
-      for (int i = 0; i < nb_floats; i++)
-        *fbuffer++ *= volume;
-#endif
+      kernels.MulArray(buffer, volume, nb_floats);
     }
   }
 }
@@ -2907,22 +2909,26 @@ void CActiveAE::OnAppFocusChange(bool focus)
 // Utils
 //-----------------------------------------------------------------------------
 
-uint8_t **CActiveAE::AllocSoundSample(SampleConfig &config, int &samples, int &bytes_per_sample, int &planes, int &linesize)
+uint8_t **CActiveAE::AllocSoundSample(SampleConfig &config, int &samples, int &bytes_per_sample, int &planes, int &linesize, int &allocated)
 {
   uint8_t **buffer;
   planes = av_sample_fmt_is_planar(config.fmt) ? config.channels : 1;
   buffer = new uint8_t*[planes];
 
   // align buffer to 16 in order to be compatible with sse in CAEConvert
-  av_samples_alloc(buffer, &linesize, config.channels,
-                                 samples, config.fmt, 16);
+  int size = av_samples_get_buffer_size(nullptr, config.channels, samples, config.fmt, 16);
+  uint8_t *block = CSampleMemoryCache::Alloc(size, allocated);
+  av_samples_fill_arrays(buffer, &linesize, block, config.channels,
+                         samples, config.fmt, 16);
+  // memory may come from a previous packet
+  av_samples_set_silence(buffer, 0, samples, config.channels, config.fmt);
   bytes_per_sample = av_get_bytes_per_sample(config.fmt);
   return buffer;
 }
 
-void CActiveAE::FreeSoundSample(uint8_t **data)
+void CActiveAE::FreeSoundSample(uint8_t **data, int allocated)
 {
-  av_freep(data);
+  CSampleMemoryCache::Free(data[0], allocated);
   delete [] data;
 }
 
@@ -192,6 +192,16 @@ public:
   void SetSinkLatency(float time) { m_sinkLatency = time; }
   bool IsSuspended();
   AEAudioFormat GetCurrentSinkFormat();
+
+  struct ConfigureStats
+  {
+    unsigned int count = 0; ///< Number of reconfigurations
+    double last = 0.0;      ///< Duration of the last one in seconds
+    double max = 0.0;
+    double total = 0.0;
+  };
+  void AddConfigureTime(double time);
+  ConfigureStats GetConfigureStats();
 protected:
   float m_sinkCacheTotal;
   float m_sinkLatency;
@@ -212,6 +222,7 @@ protected:
     CAESyncInfo::AESyncState m_syncState;
   };
   std::vector<StreamStats> m_streamStats;
+  ConfigureStats m_configureStats;
 };
 
 class CActiveAE : public IAE, public IDispResource, private CThread
@@ -255,6 +266,8 @@ public:
   void KeepConfiguration(unsigned int millis) override;
   void DeviceChange() override;
   bool GetCurrentSinkFormat(AEAudioFormat &SinkFormat) override;
+  /* number and duration of the reconfigurations of the sink and the buffers */
+  CEngineStats::ConfigureStats GetConfigureStats() { return m_stats.GetConfigureStats(); }
 
   void RegisterAudioCallback(IAudioCallback* pCallback) override;
   void UnregisterAudioCallback(IAudioCallback* pCallback) override;
@@ -265,8 +278,8 @@ public:
 
 protected:
   void PlaySound(CActiveAESound *sound);
-  static uint8_t **AllocSoundSample(SampleConfig &config, int &samples, int &bytes_per_sample, int &planes, int &linesize);
-  static void FreeSoundSample(uint8_t **data);
+  static uint8_t **AllocSoundSample(SampleConfig &config, int &samples, int &bytes_per_sample, int &planes, int &linesize, int &allocated);
+  static void FreeSoundSample(uint8_t **data, int allocated);
   void GetDelay(AEDelayStatus& status, CActiveAEStream *stream) { m_stats.GetDelay(status, stream); }
   void GetSyncInfo(CAESyncInfo& info, CActiveAEStream *stream) { m_stats.GetSyncInfo(info, stream); }
   float GetCacheTime(CActiveAEStream *stream) { return m_stats.GetCacheTime(stream); }
@@ -11,12 +11,188 @@
 #include "ActiveAEFilter.h"
 #include "cores/AudioEngine/Utils/AEUtil.h"
 #include "cores/AudioEngine/AEResampleFactory.h"
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
+
+#include <deque>
+#include <map>
+#include <utility>
+#include <vector>
+
+extern "C" {
+#include <libavutil/mem.h>
+}
 
 using namespace ActiveAE;
 
+namespace
+{
+// smallest size class, blocks of silence buffers and the like are tiny
+const int MIN_BLOCK_SIZE = 1024;
+const size_t MAX_CACHED_BYTES = 32 * 1024 * 1024;
+// enough for the resamplers of a stream, the sink and the visualisation
+const size_t MAX_CACHED_RESAMPLERS = 4;
+
+CCriticalSection memoryLock;
+std::map<int, std::vector<uint8_t*>> memoryBlocks;
+CSampleMemoryCache::Stats memoryStats;
+
+CCriticalSection resampleLock;
+std::deque<std::pair<CActiveAEResampleCache::Config, ActiveAE::IAEResample*>> resamplers;
+CActiveAEResampleCache::Stats resampleStats;
+
+bool IsSameConfig(const SampleConfig &lhs, const SampleConfig &rhs)
+{
+  return lhs.fmt == rhs.fmt &&
+         lhs.channel_layout == rhs.channel_layout &&
+         lhs.channels == rhs.channels &&
+         lhs.sample_rate == rhs.sample_rate &&
+         lhs.bits_per_sample == rhs.bits_per_sample &&
+         lhs.dither_bits == rhs.dither_bits;
+}
+}
+
+uint8_t* CSampleMemoryCache::Alloc(int size, int &allocated)
+{
+  allocated = MIN_BLOCK_SIZE;
+  while (allocated < size)
+    allocated *= 2;
+
+  {
+    CSingleLock lock(memoryLock);
+    auto it = memoryBlocks.find(allocated);
+    if (it != memoryBlocks.end() && !it->second.empty())
+    {
+      uint8_t *block = it->second.back();
+      it->second.pop_back();
+      memoryStats.cachedBytes -= allocated;
+      memoryStats.hits++;
+      return block;
+    }
+    memoryStats.misses++;
+  }
+  return static_cast<uint8_t*>(av_malloc(allocated));
+}
+
+void CSampleMemoryCache::Free(uint8_t *block, int allocated)
+{
+  if (!block)
+    return;
+
+  {
+    CSingleLock lock(memoryLock);
+    if (memoryStats.cachedBytes + allocated <= MAX_CACHED_BYTES)
+    {
+      memoryBlocks[allocated].push_back(block);
+      memoryStats.cachedBytes += allocated;
+      return;
+    }
+  }
+  av_free(block);
+}
+
+void CSampleMemoryCache::Clear()
+{
+  CSingleLock lock(memoryLock);
+  for (auto &blocks : memoryBlocks)
+  {
+    for (auto block : blocks.second)
+      av_free(block);
+  }
+  memoryBlocks.clear();
+  memoryStats.cachedBytes = 0;
+}
+
+CSampleMemoryCache::Stats CSampleMemoryCache::GetStats()
+{
+  CSingleLock lock(memoryLock);
+  return memoryStats;
+}
+
+bool CActiveAEResampleCache::Config::operator==(const Config &rhs) const
+{
+  return IsSameConfig(dst, rhs.dst) &&
+         IsSameConfig(src, rhs.src) &&
+         upmix == rhs.upmix &&
+         normalize == rhs.normalize &&
+         centerMix == rhs.centerMix &&
+         remap == rhs.remap &&
+         (!remap || remapLayout == rhs.remapLayout) &&
+         quality == rhs.quality &&
+         forceResample == rhs.forceResample;
+}
+
+ActiveAE::IAEResample* CActiveAEResampleCache::Acquire(const Config &config)
+{
+  {
+    CSingleLock lock(resampleLock);
+    for (auto it = resamplers.begin(); it != resamplers.end(); ++it)
+    {
+      if (it->first == config)
+      {
+        IAEResample *resampler = it->second;
+        resamplers.erase(it);
+        resampleStats.hits++;
+        return resampler;
+      }
+    }
+    resampleStats.misses++;
+  }
+
+  IAEResample *resampler = CAEResampleFactory::Create();
+  CAEChannelInfo remapLayout = config.remapLayout;
+  resampler->Init(config.dst, config.src,
+                  config.upmix,
+                  config.normalize,
+                  config.centerMix,
+                  config.remap ? &remapLayout : nullptr,
+                  config.quality,
+                  config.forceResample);
+  return resampler;
+}
+
+void CActiveAEResampleCache::Release(const Config &config, IAEResample *resampler)
+{
+  if (!resampler)
+    return;
+
+  // reset now, the resampler is ready when it is acquired again
+  if (!resampler->Reset())
+  {
+    delete resampler;
+    return;
+  }
+
+  IAEResample *evicted = nullptr;
+  {
+    CSingleLock lock(resampleLock);
+    resamplers.emplace_back(config, resampler);
+    if (resamplers.size() > MAX_CACHED_RESAMPLERS)
+    {
+      evicted = resamplers.front().second;
+      resamplers.pop_front();
+    }
+  }
+  delete evicted;
+}
+
+void CActiveAEResampleCache::Clear()
+{
+  CSingleLock lock(resampleLock);
+  for (auto &entry : resamplers)
+    delete entry.second;
+  resamplers.clear();
+}
+
+CActiveAEResampleCache::Stats CActiveAEResampleCache::GetStats()
+{
+  CSingleLock lock(resampleLock);
+  return resampleStats;
+}
+
 CSoundPacket::CSoundPacket(SampleConfig conf, int samples) : config(conf)
 {
-  data = CActiveAE::AllocSoundSample(config, samples, bytes_per_sample, planes, linesize);
+  data = CActiveAE::AllocSoundSample(config, samples, bytes_per_sample, planes, linesize, allocated);
   max_nb_samples = samples;
   nb_samples = 0;
   pause_burst_ms = 0;
@@ -25,7 +201,7 @@ CSoundPacket::CSoundPacket(SampleConfig conf, int samples) : config(conf)
 CSoundPacket::~CSoundPacket()
 {
   if (data)
-    CActiveAE::FreeSoundSample(data);
+    CActiveAE::FreeSoundSample(data, allocated);
 }
 
 CSampleBuffer::CSampleBuffer()
@@ -149,7 +325,7 @@ CActiveAEBufferPoolResample::~CActiveAEBufferPoolResample()
 {
   Flush();
 
-  delete m_resampler;
+  CActiveAEResampleCache::Release(m_resamplerConfig, m_resampler);
 }
 
 bool CActiveAEBufferPoolResample::Create(unsigned int totaltime, bool remap, bool upmix, bool normalize)
@@ -177,34 +353,34 @@ void CActiveAEBufferPoolResample::ChangeResampler()
 {
   if (m_resampler)
   {
-    delete m_resampler;
+    CActiveAEResampleCache::Release(m_resamplerConfig, m_resampler);
     m_resampler = NULL;
   }
 
-  m_resampler = CAEResampleFactory::Create();
-
-  SampleConfig dstConfig, srcConfig;
-  dstConfig.channel_layout = CAEUtil::GetAVChannelLayout(m_format.m_channelLayout);
-  dstConfig.channels = m_format.m_channelLayout.Count();
-  dstConfig.sample_rate = m_format.m_sampleRate;
-  dstConfig.fmt = CAEUtil::GetAVSampleFormat(m_format.m_dataFormat);
-  dstConfig.bits_per_sample = CAEUtil::DataFormatToUsedBits(m_format.m_dataFormat);
-  dstConfig.dither_bits = CAEUtil::DataFormatToDitherBits(m_format.m_dataFormat);
-
-  srcConfig.channel_layout = CAEUtil::GetAVChannelLayout(m_inputFormat.m_channelLayout);
-  srcConfig.channels = m_inputFormat.m_channelLayout.Count();
-  srcConfig.sample_rate = m_inputFormat.m_sampleRate;
-  srcConfig.fmt = CAEUtil::GetAVSampleFormat(m_inputFormat.m_dataFormat);
-  srcConfig.bits_per_sample = CAEUtil::DataFormatToUsedBits(m_inputFormat.m_dataFormat);
-  srcConfig.dither_bits = CAEUtil::DataFormatToDitherBits(m_inputFormat.m_dataFormat);
-
-  m_resampler->Init(dstConfig, srcConfig,
-                    m_stereoUpmix,
-                    m_normalize,
-                    m_centerMixLevel,
-                    m_remap ? &m_format.m_channelLayout : nullptr,
-                    m_resampleQuality,
-                    m_forceResampler);
+  CActiveAEResampleCache::Config &config = m_resamplerConfig;
+  config.dst.channel_layout = CAEUtil::GetAVChannelLayout(m_format.m_channelLayout);
+  config.dst.channels = m_format.m_channelLayout.Count();
+  config.dst.sample_rate = m_format.m_sampleRate;
+  config.dst.fmt = CAEUtil::GetAVSampleFormat(m_format.m_dataFormat);
+  config.dst.bits_per_sample = CAEUtil::DataFormatToUsedBits(m_format.m_dataFormat);
+  config.dst.dither_bits = CAEUtil::DataFormatToDitherBits(m_format.m_dataFormat);
+
+  config.src.channel_layout = CAEUtil::GetAVChannelLayout(m_inputFormat.m_channelLayout);
+  config.src.channels = m_inputFormat.m_channelLayout.Count();
+  config.src.sample_rate = m_inputFormat.m_sampleRate;
+  config.src.fmt = CAEUtil::GetAVSampleFormat(m_inputFormat.m_dataFormat);
+  config.src.bits_per_sample = CAEUtil::DataFormatToUsedBits(m_inputFormat.m_dataFormat);
+  config.src.dither_bits = CAEUtil::DataFormatToDitherBits(m_inputFormat.m_dataFormat);
+
+  config.upmix = m_stereoUpmix;
+  config.normalize = m_normalize;
+  config.centerMix = m_centerMixLevel;
+  config.remap = m_remap;
+  config.remapLayout = m_format.m_channelLayout;
+  config.quality = m_resampleQuality;
+  config.forceResample = m_forceResampler;
+
+  m_resampler = CActiveAEResampleCache::Acquire(config);
 
   m_changeResampler = false;
 }
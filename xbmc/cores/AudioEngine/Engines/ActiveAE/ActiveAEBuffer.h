@@ -22,6 +22,32 @@ extern "C" {
 namespace ActiveAE
 {
 
+/**
+ * Keeps the memory of freed sound packets for reuse. Blocks are sorted into
+ * size classes of powers of two, so the buffer pools created on every
+ * reconfiguration get the memory of the pools they replace instead of going
+ * back to the allocator. The amount of kept memory is limited.
+ */
+class CSampleMemoryCache
+{
+public:
+  /**
+   * Get a block of at least size bytes, aligned like av_malloc
+   * @param allocated receives the size of the block, required by Free()
+   */
+  static uint8_t* Alloc(int size, int &allocated);
+  static void Free(uint8_t *block, int allocated);
+  static void Clear();
+
+  struct Stats
+  {
+    unsigned int hits = 0;
+    unsigned int misses = 0;
+    size_t cachedBytes = 0;
+  };
+  static Stats GetStats();
+};
+
 /**
  * the variables here follow ffmpeg naming
  */
@@ -38,6 +64,7 @@ public:
   int nb_samples;                        // number of frames used
   int max_nb_samples;                    // max number of frames this packet can hold
   int pause_burst_ms;
+  int allocated;                         // size of the memory block behind data
 };
 
 class CActiveAEBufferPool;
@@ -72,6 +99,50 @@ public:
 
 class IAEResample;
 
+/**
+ * Keeps the resamplers of deleted buffer pools. Initializing a resampler
+ * computes its filters, a cached one with the same configuration only needs
+ * its state reset. This makes recreating the buffer pools for streams of a
+ * known format, like on gapless playback or when zapping live TV channels,
+ * cheaper. The number of kept resamplers is limited.
+ */
+class CActiveAEResampleCache
+{
+public:
+  struct Config
+  {
+    SampleConfig dst;
+    SampleConfig src;
+    bool upmix = false;
+    bool normalize = true;
+    double centerMix = M_SQRT1_2;
+    bool remap = false;
+    CAEChannelInfo remapLayout;
+    AEQuality quality = AE_QUALITY_MID;
+    bool forceResample = false;
+
+    bool operator==(const Config &rhs) const;
+  };
+
+  /**
+   * Get a resampler initialized for config, a cached one if available
+   */
+  static IAEResample* Acquire(const Config &config);
+
+  /**
+   * Hand back a resampler acquired for config, it is reset and kept or deleted
+   */
+  static void Release(const Config &config, IAEResample *resampler);
+  static void Clear();
+
+  struct Stats
+  {
+    unsigned int hits = 0;
+    unsigned int misses = 0;
+  };
+  static Stats GetStats();
+};
+
 class CActiveAEBufferPoolResample : public CActiveAEBufferPool
 {
 public:
@@ -103,6 +174,7 @@ protected:
   bool m_remap = false;
   CSampleBuffer *m_procSample = nullptr;
   IAEResample *m_resampler = nullptr;
+  CActiveAEResampleCache::Config m_resamplerConfig;
   double m_resampleRatio = 1.0f;
   double m_centerMixLevel = M_SQRT1_2;
   bool m_fillPackets = false;
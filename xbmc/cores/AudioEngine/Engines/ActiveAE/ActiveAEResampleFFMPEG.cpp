@@ -275,3 +275,19 @@ int CActiveAEResampleFFMPEG::GetDstBufferSize(int samples)
 {
   return av_samples_get_buffer_size(NULL, m_dst_channels, samples, m_dst_fmt, 1);
 }
+
+bool CActiveAEResampleFFMPEG::Reset()
+{
+  if (!m_pContext)
+    return false;
+
+  // swr_init clears all buffers and the compensation, the filters are only
+  // computed again if their parameters changed
+  if (swr_init(m_pContext) < 0)
+  {
+    CLog::Log(LOGERROR, "CActiveAEResampleFFMPEG::Reset - init resampler failed");
+    return false;
+  }
+  m_doesResample = m_src_rate != m_dst_rate;
+  return true;
+}
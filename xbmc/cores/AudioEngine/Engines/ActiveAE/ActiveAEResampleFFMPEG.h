@@ -36,6 +36,7 @@ public:
   int CalcDstSampleCount(int src_samples, int dst_rate, int src_rate) override;
   int GetSrcBufferSize(int samples) override;
   int GetDstBufferSize(int samples) override;
+  bool Reset() override;
 
 protected:
   bool m_loaded;
@@ -0,0 +1,154 @@
+/*
+ *  Copyright (C) 2010-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/AudioEngine/Engines/ActiveAE/ActiveAEBuffer.h"
+#include "cores/AudioEngine/Interfaces/AEResample.h"
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace ActiveAE;
+
+namespace
+{
+CActiveAEResampleCache::Config MakeConfig(int srcRate)
+{
+  CActiveAEResampleCache::Config config;
+  config.src.fmt = AV_SAMPLE_FMT_FLT;
+  config.src.channel_layout = AV_CH_LAYOUT_STEREO;
+  config.src.channels = 2;
+  config.src.sample_rate = srcRate;
+  config.src.bits_per_sample = 32;
+  config.src.dither_bits = 0;
+  config.dst = config.src;
+  config.dst.sample_rate = 48000;
+  return config;
+}
+}
+
+TEST(TestSampleMemoryCache, HitAndMiss)
+{
+  CSampleMemoryCache::Clear();
+  const CSampleMemoryCache::Stats start = CSampleMemoryCache::GetStats();
+  EXPECT_EQ(0u, start.cachedBytes);
+
+  int allocated = 0;
+  uint8_t* block = CSampleMemoryCache::Alloc(3000, allocated);
+  ASSERT_TRUE(block);
+  EXPECT_EQ(4096, allocated);
+  EXPECT_EQ(start.misses + 1, CSampleMemoryCache::GetStats().misses);
+
+  CSampleMemoryCache::Free(block, allocated);
+  EXPECT_EQ(4096u, CSampleMemoryCache::GetStats().cachedBytes);
+
+  // same size class, the freed block comes back
+  int allocatedAgain = 0;
+  uint8_t* blockAgain = CSampleMemoryCache::Alloc(2500, allocatedAgain);
+  EXPECT_EQ(block, blockAgain);
+  EXPECT_EQ(4096, allocatedAgain);
+  CSampleMemoryCache::Stats stats = CSampleMemoryCache::GetStats();
+  EXPECT_EQ(start.hits + 1, stats.hits);
+  EXPECT_EQ(0u, stats.cachedBytes);
+
+  // other size class, nothing cached for it
+  CSampleMemoryCache::Free(blockAgain, allocatedAgain);
+  uint8_t* larger = CSampleMemoryCache::Alloc(5000, allocated);
+  EXPECT_EQ(8192, allocated);
+  stats = CSampleMemoryCache::GetStats();
+  EXPECT_EQ(start.hits + 1, stats.hits);
+  EXPECT_EQ(start.misses + 2, stats.misses);
+
+  CSampleMemoryCache::Free(larger, allocated);
+  CSampleMemoryCache::Clear();
+  EXPECT_EQ(0u, CSampleMemoryCache::GetStats().cachedBytes);
+}
+
+TEST(TestSampleMemoryCache, Limit)
+{
+  CSampleMemoryCache::Clear();
+
+  // nine blocks of 4MB, only eight of them fit into the cache
+  const int size = 4 * 1024 * 1024;
+  std::vector<uint8_t*> blocks;
+  int allocated = 0;
+  for (int i = 0; i < 9; i++)
+  {
+    blocks.push_back(CSampleMemoryCache::Alloc(size, allocated));
+    ASSERT_EQ(size, allocated);
+  }
+  for (auto block : blocks)
+    CSampleMemoryCache::Free(block, size);
+  EXPECT_EQ(8u * size, CSampleMemoryCache::GetStats().cachedBytes);
+
+  const CSampleMemoryCache::Stats start = CSampleMemoryCache::GetStats();
+  blocks.clear();
+  for (int i = 0; i < 9; i++)
+    blocks.push_back(CSampleMemoryCache::Alloc(size, allocated));
+  const CSampleMemoryCache::Stats stats = CSampleMemoryCache::GetStats();
+  EXPECT_EQ(start.hits + 8, stats.hits);
+  EXPECT_EQ(start.misses + 1, stats.misses);
+
+  for (auto block : blocks)
+    CSampleMemoryCache::Free(block, size);
+  CSampleMemoryCache::Clear();
+}
+
+TEST(TestActiveAEResampleCache, HitAndMiss)
+{
+  CActiveAEResampleCache::Clear();
+  const CActiveAEResampleCache::Stats start = CActiveAEResampleCache::GetStats();
+
+  const CActiveAEResampleCache::Config config = MakeConfig(44100);
+  IAEResample* resampler = CActiveAEResampleCache::Acquire(config);
+  ASSERT_TRUE(resampler);
+  EXPECT_EQ(start.misses + 1, CActiveAEResampleCache::GetStats().misses);
+
+  CActiveAEResampleCache::Release(config, resampler);
+  IAEResample* cached = CActiveAEResampleCache::Acquire(config);
+  EXPECT_EQ(resampler, cached);
+  EXPECT_EQ(start.hits + 1, CActiveAEResampleCache::GetStats().hits);
+
+  // a different configuration does not get the cached resampler
+  CActiveAEResampleCache::Release(config, cached);
+  CActiveAEResampleCache::Config other = config;
+  other.quality = AE_QUALITY_HIGH;
+  IAEResample* otherResampler = CActiveAEResampleCache::Acquire(other);
+  EXPECT_NE(cached, otherResampler);
+  const CActiveAEResampleCache::Stats stats = CActiveAEResampleCache::GetStats();
+  EXPECT_EQ(start.hits + 1, stats.hits);
+  EXPECT_EQ(start.misses + 2, stats.misses);
+
+  CActiveAEResampleCache::Release(other, otherResampler);
+  CActiveAEResampleCache::Clear();
+}
+
+TEST(TestActiveAEResampleCache, Eviction)
+{
+  CActiveAEResampleCache::Clear();
+
+  // one more than the cache keeps, the first one released is dropped
+  const std::vector<int> rates = {8000, 11025, 22050, 32000, 44100};
+  std::vector<IAEResample*> resamplers;
+  for (int rate : rates)
+    resamplers.push_back(CActiveAEResampleCache::Acquire(MakeConfig(rate)));
+  for (size_t i = 0; i < rates.size(); i++)
+    CActiveAEResampleCache::Release(MakeConfig(rates[i]), resamplers[i]);
+
+  const CActiveAEResampleCache::Stats start = CActiveAEResampleCache::GetStats();
+  IAEResample* last = CActiveAEResampleCache::Acquire(MakeConfig(rates.back()));
+  EXPECT_EQ(resamplers.back(), last);
+  EXPECT_EQ(start.hits + 1, CActiveAEResampleCache::GetStats().hits);
+
+  IAEResample* first = CActiveAEResampleCache::Acquire(MakeConfig(rates.front()));
+  EXPECT_EQ(start.misses + 1, CActiveAEResampleCache::GetStats().misses);
+
+  CActiveAEResampleCache::Release(MakeConfig(rates.back()), last);
+  CActiveAEResampleCache::Release(MakeConfig(rates.front()), first);
+  CActiveAEResampleCache::Clear();
+}
@@ -29,6 +29,13 @@ public:
   virtual int CalcDstSampleCount(int src_samples, int dst_rate, int src_rate) = 0;
   virtual int GetSrcBufferSize(int samples) = 0;
   virtual int GetDstBufferSize(int samples) = 0;
+
+  /**
+   * Drop all buffered samples and start over like after Init(), keeping the
+   * configuration and the filters computed for it.
+   * @return false if not supported, the resampler needs to be created again
+   */
+  virtual bool Reset() { return false; }
 };
 
 }
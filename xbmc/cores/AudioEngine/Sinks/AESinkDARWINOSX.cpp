@@ -505,18 +505,24 @@ OSStatus CAESinkDARWINOSX::renderCallback(AudioDeviceID inDevice, const AudioTim
 
       size_t wanted = outOutputData->mBuffers[0].mDataByteSize / sizeof(float) * sizeof(int16_t);
       size_t bytes = std::min((size_t)sink->m_buffer->GetReadSize(), wanted);
-      for (unsigned int j = 0; j < bytes / sizeof(int16_t); j++)
+      // convert straight from the ring buffer, in two parts when its end is reached
+      size_t done = 0;
+      while (done < bytes)
       {
+        unsigned char *planes[AE_CH_MAX];
+        size_t size = std::min((size_t)sink->m_buffer->ReserveRead(planes), bytes - done);
         for (unsigned int i = startIdx; i < endIdx; i++)
         {
-          int16_t src;
-          sink->m_buffer->Read((unsigned char *)&src, sizeof(int16_t), i);
           if (i < outOutputData->mNumberBuffers && outOutputData->mBuffers[i].mData)
           {
-            float *dest = (float *)outOutputData->mBuffers[i].mData;
-            dest[j] = src * mul;
+            const int16_t *src = (const int16_t *)planes[i - startIdx];
+            float *dest = (float *)outOutputData->mBuffers[i].mData + done / sizeof(int16_t);
+            for (unsigned int j = 0; j < size / sizeof(int16_t); j++)
+              dest[j] = src[j] * mul;
           }
         }
+        sink->m_buffer->CommitRead(size);
+        done += size;
       }
       LogLevel(bytes, wanted);
     }
@@ -525,12 +531,18 @@ OSStatus CAESinkDARWINOSX::renderCallback(AudioDeviceID inDevice, const AudioTim
       /* buffers appear to come from CA already zero'd, so just copy what is wanted */
       unsigned int wanted = outOutputData->mBuffers[0].mDataByteSize;
       unsigned int bytes = std::min(sink->m_buffer->GetReadSize(), wanted);
-      for (unsigned int i = startIdx; i < endIdx; i++)
+      unsigned int done = 0;
+      while (done < bytes)
       {
-        if (i < outOutputData->mNumberBuffers && outOutputData->mBuffers[i].mData)
-          sink->m_buffer->Read((unsigned char *)outOutputData->mBuffers[i].mData, bytes, i);
-        else
-          sink->m_buffer->Read(NULL, bytes, i);
+        unsigned char *planes[AE_CH_MAX];
+        unsigned int size = std::min(sink->m_buffer->ReserveRead(planes), bytes - done);
+        for (unsigned int i = startIdx; i < endIdx; i++)
+        {
+          if (i < outOutputData->mNumberBuffers && outOutputData->mBuffers[i].mData)
+            memcpy((unsigned char *)outOutputData->mBuffers[i].mData + done, planes[i - startIdx], size);
+        }
+        sink->m_buffer->CommitRead(size);
+        done += size;
       }
       LogLevel(bytes, wanted);
     }
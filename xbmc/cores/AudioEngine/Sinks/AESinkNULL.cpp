@@ -0,0 +1,260 @@
+/*
+ *  Copyright (C) 2010-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "AESinkNULL.h"
+#include "cores/AudioEngine/AESinkFactory.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <stdlib.h>
+#include <thread>
+
+namespace
+{
+  // 20ms periods, 4 of them buffered, like a typical ALSA setup
+  const unsigned int PERIODS_PER_SECOND = 50;
+  const unsigned int PERIODS = 4;
+
+  std::atomic<double> clockSpeed(1.0);
+  std::atomic<uint64_t> framesPlayed(0);
+  std::atomic<unsigned int> underruns(0);
+
+  class CSystemClock : public CAESinkNULL::IClock
+  {
+  public:
+    double Now() override
+    {
+      return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void Sleep(double seconds) override
+    {
+      std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    }
+  };
+
+  CSystemClock systemClock;
+  std::atomic<CAESinkNULL::IClock*> sinkClock(&systemClock);
+}
+
+CAESinkNULL::~CAESinkNULL()
+{
+  Deinitialize();
+}
+
+void CAESinkNULL::Register()
+{
+  const char* speed = getenv("KODI_AE_NULL_SPEED");
+  if (speed)
+    SetClockSpeed(atof(speed));
+
+  AE::AESinkRegEntry entry;
+  entry.sinkName = "NULL";
+  entry.createFunc = CAESinkNULL::Create;
+  entry.enumerateFunc = CAESinkNULL::EnumerateDevicesEx;
+  AE::CAESinkFactory::RegisterSink(entry);
+}
+
+IAESink* CAESinkNULL::Create(std::string &device, AEAudioFormat &desiredFormat)
+{
+  IAESink* sink = new CAESinkNULL();
+  if (sink->Initialize(desiredFormat, device))
+    return sink;
+
+  delete sink;
+  return nullptr;
+}
+
+void CAESinkNULL::EnumerateDevicesEx(AEDeviceInfoList &list, bool force)
+{
+  CAEDeviceInfo info;
+  info.m_deviceName = "default";
+  info.m_displayName = "Null";
+  info.m_displayNameExtra = "emulated device";
+  info.m_deviceType = AE_DEVTYPE_PCM;
+  info.m_wantsIECPassthrough = false;
+  info.m_channels = AE_CH_LAYOUT_7_1;
+  info.m_sampleRates = { 44100, 48000, 88200, 96000, 192000 };
+  info.m_dataFormats = { AE_FMT_FLOAT, AE_FMT_S32NE, AE_FMT_S16NE };
+  list.push_back(info);
+}
+
+void CAESinkNULL::SetClockSpeed(double speed)
+{
+  clockSpeed = std::max(speed, 0.0);
+}
+
+double CAESinkNULL::GetClockSpeed()
+{
+  return clockSpeed;
+}
+
+void CAESinkNULL::SetClock(IClock* clock)
+{
+  sinkClock = clock ? clock : &systemClock;
+}
+
+CAESinkNULL::Stats CAESinkNULL::GetStats()
+{
+  Stats stats;
+  stats.framesPlayed = framesPlayed;
+  stats.underruns = underruns;
+  return stats;
+}
+
+void CAESinkNULL::ResetStats()
+{
+  framesPlayed = 0;
+  underruns = 0;
+}
+
+bool CAESinkNULL::Initialize(AEAudioFormat &format, std::string &device)
+{
+  if (format.m_dataFormat == AE_FMT_RAW)
+    return false;
+
+  AEDeviceInfoList devices;
+  EnumerateDevicesEx(devices);
+  const CAEDeviceInfo& info = devices.front();
+
+  if (std::find(info.m_dataFormats.begin(), info.m_dataFormats.end(), format.m_dataFormat) == info.m_dataFormats.end())
+    format.m_dataFormat = AE_FMT_FLOAT;
+  if (std::find(info.m_sampleRates.begin(), info.m_sampleRates.end(), format.m_sampleRate) == info.m_sampleRates.end())
+    format.m_sampleRate = 48000;
+  if (format.m_channelLayout.Count() == 0 || format.m_channelLayout.Count() > info.m_channels.Count())
+    format.m_channelLayout = info.m_channels;
+
+  format.m_frameSize = format.m_channelLayout.Count() * (CAEUtil::DataFormatToBits(format.m_dataFormat) >> 3);
+  format.m_frames = format.m_sampleRate / PERIODS_PER_SECOND;
+
+  m_format = format;
+  m_speed = clockSpeed;
+  m_bufferFrames = format.m_frames * PERIODS;
+  m_written = 0;
+  m_played = 0;
+  m_running = false;
+  m_starved = false;
+
+  CLog::Log(LOGDEBUG, "CAESinkNULL::Initialize - %s, %u channels, %uHz, clock speed %.2f",
+            CAEUtil::DataFormatToStr(format.m_dataFormat), format.m_channelLayout.Count(),
+            format.m_sampleRate, m_speed);
+  return true;
+}
+
+void CAESinkNULL::Deinitialize()
+{
+  m_running = false;
+  m_written = 0;
+  m_played = 0;
+}
+
+double CAESinkNULL::FramesToSeconds(int64_t frames) const
+{
+  if (m_speed <= 0.0 || m_format.m_sampleRate == 0)
+    return 0.0;
+  return frames / (m_format.m_sampleRate * m_speed);
+}
+
+void CAESinkNULL::Update()
+{
+  if (!m_running)
+    return;
+
+  const double elapsed = sinkClock.load()->Now() - m_startTime;
+  const int64_t played = m_startPlayed + static_cast<int64_t>(elapsed * m_format.m_sampleRate * m_speed);
+  const int64_t previous = m_played;
+
+  if (played >= m_written)
+  {
+    // the device ran out of data and stopped
+    m_played = m_written;
+    m_running = false;
+    m_starved = true;
+  }
+  else
+    m_played = played;
+
+  framesPlayed += m_played - previous;
+}
+
+unsigned int CAESinkNULL::Queue(unsigned int frames)
+{
+  if (m_speed <= 0.0)
+  {
+    m_written += frames;
+    m_played = m_written;
+    framesPlayed += frames;
+    return frames;
+  }
+
+  Update();
+
+  // like a real device, block until at least a period or all the data fits
+  const int64_t wanted = std::min(frames, m_format.m_frames);
+  int64_t space = m_bufferFrames - (m_written - m_played);
+  while (space < wanted)
+  {
+    sinkClock.load()->Sleep(FramesToSeconds(wanted - space));
+    Update();
+    space = m_bufferFrames - (m_written - m_played);
+  }
+
+  const unsigned int queued = static_cast<unsigned int>(std::min<int64_t>(frames, space));
+
+  if (!m_running)
+  {
+    if (m_starved)
+      underruns++;
+    m_starved = false;
+    m_running = true;
+    m_startTime = sinkClock.load()->Now();
+    m_startPlayed = m_played;
+  }
+
+  m_written += queued;
+  return queued;
+}
+
+unsigned int CAESinkNULL::AddPackets(uint8_t **data, unsigned int frames, unsigned int offset)
+{
+  return Queue(frames);
+}
+
+void CAESinkNULL::AddPause(unsigned int millis)
+{
+  unsigned int frames = millis * m_format.m_sampleRate / 1000;
+  while (frames > 0)
+    frames -= Queue(frames);
+}
+
+void CAESinkNULL::GetDelay(AEDelayStatus& status)
+{
+  Update();
+  status.SetDelay(FramesToSeconds(m_written - m_played));
+}
+
+double CAESinkNULL::GetCacheTotal()
+{
+  return FramesToSeconds(m_bufferFrames);
+}
+
+void CAESinkNULL::Drain()
+{
+  Update();
+  const double wait = FramesToSeconds(m_written - m_played);
+  if (wait > 0.0)
+    sinkClock.load()->Sleep(wait);
+  Update();
+
+  framesPlayed += m_written - m_played;
+  m_played = m_written;
+  m_running = false;
+  m_starved = false;
+}
@@ -0,0 +1,109 @@
+/*
+ *  Copyright (C) 2010-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "cores/AudioEngine/Interfaces/AESink.h"
+#include "cores/AudioEngine/Utils/AEDeviceInfo.h"
+
+#include <stdint.h>
+
+/*!
+ * \brief Sink without audio hardware
+ *
+ * Emulates a device with a buffer of a few periods that is played out at a
+ * fixed clock, so AddPackets() blocks and GetDelay() reports the buffered
+ * audio like a real device would. The clock can run faster than real time
+ * for load tests of the engine. Register it by setting KODI_AE_SINK=NULL,
+ * KODI_AE_NULL_SPEED sets the clock speed.
+ */
+class CAESinkNULL : public IAESink
+{
+public:
+  const char *GetName() override { return "NULL"; }
+
+  CAESinkNULL() = default;
+  ~CAESinkNULL() override;
+
+  static void Register();
+  static IAESink* Create(std::string &device, AEAudioFormat &desiredFormat);
+  static void EnumerateDevicesEx(AEDeviceInfoList &list, bool force = false);
+
+  /*!
+   * \brief Set how fast sinks created afterwards play audio
+   * \param speed 1.0 for real time, 10.0 for ten seconds of audio per second,
+   *              0.0 to consume audio without any delay
+   */
+  static void SetClockSpeed(double speed);
+  static double GetClockSpeed();
+
+  /*!
+   * \brief Time source of the sinks, tests replace it to not depend on the
+   * scheduling of the machine they run on
+   */
+  class IClock
+  {
+  public:
+    virtual ~IClock() = default;
+    virtual double Now() = 0; ///< Seconds since an arbitrary start
+    virtual void Sleep(double seconds) = 0;
+  };
+
+  /*!
+   * \brief Set the time source of all sinks, nullptr for the system clock
+   */
+  static void SetClock(IClock* clock);
+
+  struct Stats
+  {
+    uint64_t framesPlayed = 0;  ///< Frames consumed by all sinks
+    unsigned int underruns = 0; ///< Times a sink ran empty while playing
+  };
+
+  /*!
+   * \brief Get the statistics of all sinks since the last reset
+   */
+  static Stats GetStats();
+  static void ResetStats();
+
+  bool Initialize(AEAudioFormat &format, std::string &device) override;
+  void Deinitialize() override;
+
+  double GetCacheTotal() override;
+  unsigned int AddPackets(uint8_t **data, unsigned int frames, unsigned int offset) override;
+  void AddPause(unsigned int millis) override;
+  void GetDelay(AEDelayStatus& status) override;
+  void Drain() override;
+
+private:
+  /*!
+   * \brief Advance the emulated play position to now
+   */
+  void Update();
+
+  /*!
+   * \brief Wait for room and queue up to frames frames
+   * \return number of frames queued
+   */
+  unsigned int Queue(unsigned int frames);
+
+  /*!
+   * \brief Convert frames to real time seconds at the clock speed
+   */
+  double FramesToSeconds(int64_t frames) const;
+
+  AEAudioFormat m_format;
+  double m_speed = 1.0;
+  unsigned int m_bufferFrames = 0;
+  int64_t m_written = 0;
+  int64_t m_played = 0;
+  bool m_running = false;
+  bool m_starved = false;
+  double m_startTime = 0.0;
+  int64_t m_startPlayed = 0;
+};
@@ -0,0 +1,290 @@
+/*
+ *  Copyright (C) 2010-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "ServiceBroker.h"
+#include "cores/AudioEngine/Engines/ActiveAE/ActiveAE.h"
+#include "cores/AudioEngine/Interfaces/AEStream.h"
+#include "cores/AudioEngine/Sinks/AESinkNULL.h"
+#include "settings/Settings.h"
+#include "settings/SettingsComponent.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <ctime>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+const unsigned int PERIOD = 960; // 20ms at 48kHz
+
+AEAudioFormat MakeFormat(AEDataFormat dataFormat, unsigned int sampleRate, AEStdChLayout layout)
+{
+  AEAudioFormat format;
+  format.m_dataFormat = dataFormat;
+  format.m_sampleRate = sampleRate;
+  format.m_channelLayout = layout;
+  format.m_frameSize = format.m_channelLayout.Count() * (CAEUtil::DataFormatToBits(dataFormat) >> 3);
+  return format;
+}
+
+double Percentile(std::vector<double> values, double percentile)
+{
+  if (values.empty())
+    return 0.0;
+  std::sort(values.begin(), values.end());
+  return values[static_cast<size_t>(percentile / 100.0 * (values.size() - 1))];
+}
+
+/*!
+ * \brief Clock that only moves when the sink sleeps or the test advances it
+ */
+class CManualClock : public CAESinkNULL::IClock
+{
+public:
+  double Now() override { return m_now; }
+  void Sleep(double seconds) override { m_now += seconds; }
+
+  double m_now = 1.0;
+};
+
+/*!
+ * \brief Puts the sinks back on the system clock at real time when a test ends
+ */
+struct ClockGuard
+{
+  ~ClockGuard()
+  {
+    CAESinkNULL::SetClock(nullptr);
+    CAESinkNULL::SetClockSpeed(1.0);
+  }
+};
+}
+
+TEST(TestAESinkNULL, Format)
+{
+  AEAudioFormat format = MakeFormat(AE_FMT_S24NE3, 22050, AE_CH_LAYOUT_2_0);
+  std::string device = "default";
+  std::unique_ptr<IAESink> sink(CAESinkNULL::Create(device, format));
+  ASSERT_TRUE(sink);
+  EXPECT_EQ(AE_FMT_FLOAT, format.m_dataFormat);
+  EXPECT_EQ(48000u, format.m_sampleRate);
+  EXPECT_EQ(2u, format.m_channelLayout.Count());
+  EXPECT_EQ(8u, format.m_frameSize);
+  EXPECT_EQ(PERIOD, format.m_frames);
+
+  format.m_dataFormat = AE_FMT_RAW;
+  EXPECT_FALSE(CAESinkNULL::Create(device, format));
+}
+
+TEST(TestAESinkNULL, Timing)
+{
+  CManualClock clock;
+  ClockGuard guard;
+  CAESinkNULL::SetClock(&clock);
+  CAESinkNULL::SetClockSpeed(10.0);
+  CAESinkNULL::ResetStats();
+
+  AEAudioFormat format = MakeFormat(AE_FMT_FLOAT, 48000, AE_CH_LAYOUT_2_0);
+  std::string device = "default";
+  std::unique_ptr<IAESink> sink(CAESinkNULL::Create(device, format));
+  ASSERT_TRUE(sink);
+
+  // 4 periods of 2ms at 10x speed
+  EXPECT_NEAR(0.008, sink->GetCacheTotal(), 1e-9);
+
+  // the buffer takes the first periods without blocking
+  AEDelayStatus status;
+  for (int i = 0; i < 4; i++)
+    EXPECT_EQ(PERIOD, sink->AddPackets(nullptr, PERIOD, 0));
+  EXPECT_EQ(1.0, clock.m_now);
+  sink->GetDelay(status);
+  EXPECT_NEAR(0.008, status.delay, 1e-9);
+
+  // half of it is played after 4ms
+  clock.m_now += 0.004;
+  sink->GetDelay(status);
+  EXPECT_NEAR(0.004, status.delay, 1e-6);
+
+  // one second of audio takes 100ms, the buffer stays full
+  const double start = clock.m_now;
+  unsigned int frames = 48000;
+  while (frames > 0)
+    frames -= sink->AddPackets(nullptr, std::min(frames, PERIOD), 0);
+  EXPECT_NEAR(0.1 - 0.004, clock.m_now - start, 1e-4);
+  sink->GetDelay(status);
+  EXPECT_NEAR(0.008, status.delay, 1e-4);
+  EXPECT_EQ(0u, CAESinkNULL::GetStats().underruns);
+
+  // running out of data is an underrun
+  clock.m_now += 0.02;
+  sink->GetDelay(status);
+  EXPECT_EQ(0.0, status.delay);
+  EXPECT_EQ(PERIOD, sink->AddPackets(nullptr, PERIOD, 0));
+  EXPECT_EQ(1u, CAESinkNULL::GetStats().underruns);
+
+  const double drainStart = clock.m_now;
+  sink->Drain();
+  EXPECT_NEAR(0.002, clock.m_now - drainStart, 1e-6);
+  sink->GetDelay(status);
+  EXPECT_EQ(0.0, status.delay);
+  EXPECT_EQ(4u * PERIOD + 48000 + PERIOD, CAESinkNULL::GetStats().framesPlayed);
+
+  // unthrottled
+  CAESinkNULL::SetClockSpeed(0.0);
+  sink.reset(CAESinkNULL::Create(device, format));
+  const double unthrottledStart = clock.m_now;
+  for (int i = 0; i < 100; i++)
+    EXPECT_EQ(PERIOD, sink->AddPackets(nullptr, PERIOD, 0));
+  EXPECT_EQ(unthrottledStart, clock.m_now);
+  sink->GetDelay(status);
+  EXPECT_EQ(0.0, status.delay);
+}
+
+/*
+ * Load test of the engine, run with --gtest_also_run_disabled_tests.
+ *
+ * Streams of different formats are resampled and mixed into a 7.1 float sink
+ * that runs at 10x real time. Reports the CPU time spent per second of audio,
+ * the time AddData() blocks and the delay the streams report. At an
+ * accelerated clock the delays mix device time and audio time, so compare
+ * them between runs rather than against real devices.
+ */
+TEST(TestAESinkNULL, DISABLED_ActiveAELoad)
+{
+  const int streamCount = 8;
+  const double seconds = 30.0;
+  const double speed = 10.0;
+
+  ClockGuard clockGuard;
+  CAESinkNULL::SetClockSpeed(speed);
+  CAESinkNULL::ResetStats();
+  CAESinkNULL::Register();
+
+  // the engine reads the device from the settings, put them back however the test ends
+  struct SettingsGuard
+  {
+    explicit SettingsGuard(const std::shared_ptr<CSettings>& settings)
+      : m_settings(settings),
+        m_device(settings->GetString(CSettings::SETTING_AUDIOOUTPUT_AUDIODEVICE)),
+        m_channels(settings->GetInt(CSettings::SETTING_AUDIOOUTPUT_CHANNELS))
+    {
+    }
+    ~SettingsGuard()
+    {
+      m_settings->SetString(CSettings::SETTING_AUDIOOUTPUT_AUDIODEVICE, m_device);
+      m_settings->SetInt(CSettings::SETTING_AUDIOOUTPUT_CHANNELS, m_channels);
+    }
+
+    std::shared_ptr<CSettings> m_settings;
+    std::string m_device;
+    int m_channels;
+  };
+
+  const std::shared_ptr<CSettings> settings = CServiceBroker::GetSettingsComponent()->GetSettings();
+  SettingsGuard settingsGuard(settings);
+  settings->SetString(CSettings::SETTING_AUDIOOUTPUT_AUDIODEVICE, "NULL:default");
+  settings->SetInt(CSettings::SETTING_AUDIOOUTPUT_CHANNELS, AE_CH_LAYOUT_7_1);
+
+  {
+    ActiveAE::CActiveAE ae;
+    ae.Start();
+
+    struct Stream
+    {
+      IAEStream* stream;
+      AEAudioFormat format;
+      std::vector<float> samples;
+      unsigned int added;
+    };
+    std::vector<Stream> streams;
+    for (int i = 0; i < streamCount; i++)
+    {
+      Stream s;
+      s.format = MakeFormat(AE_FMT_FLOAT, i % 2 ? 44100 : 48000, i % 4 == 0 ? AE_CH_LAYOUT_5_1 : AE_CH_LAYOUT_2_0);
+      s.stream = ae.MakeStream(s.format);
+      ASSERT_TRUE(s.stream);
+      const unsigned int channels = s.format.m_channelLayout.Count();
+      s.samples.resize(PERIOD * channels);
+      for (unsigned int f = 0; f < PERIOD; f++)
+      {
+        for (unsigned int c = 0; c < channels; c++)
+          s.samples[f * channels + c] = 0.1f * sinf(f * (i + 1) * 0.01f);
+      }
+      s.added = 0;
+      streams.push_back(s);
+    }
+
+    std::vector<double> addTimes;
+    std::vector<double> delays;
+    const std::clock_t cpuStart = std::clock();
+    const auto start = Clock::now();
+
+    bool done = false;
+    while (!done)
+    {
+      done = true;
+      bool added = false;
+      for (auto& s : streams)
+      {
+        if (s.added >= seconds * s.format.m_sampleRate)
+          continue;
+        done = false;
+        if (s.stream->GetSpace() < PERIOD * s.format.m_frameSize)
+          continue;
+
+        delays.push_back(s.stream->GetDelay());
+        const uint8_t* data[] = { reinterpret_cast<const uint8_t*>(s.samples.data()) };
+        const auto addStart = Clock::now();
+        s.added += s.stream->AddData(data, 0, PERIOD, nullptr);
+        addTimes.push_back(std::chrono::duration<double>(Clock::now() - addStart).count());
+        added = true;
+      }
+      if (!done && !added)
+        std::this_thread::sleep_for(std::chrono::microseconds(500));
+    }
+
+    for (auto& s : streams)
+      s.stream->Drain(true);
+    for (auto& s : streams)
+    {
+      while (!s.stream->IsDrained())
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    const double cpu = static_cast<double>(std::clock() - cpuStart) / CLOCKS_PER_SEC;
+    const std::chrono::duration<double> elapsed = Clock::now() - start;
+
+    for (auto& s : streams)
+      ae.FreeStream(s.stream, false);
+    const ActiveAE::CEngineStats::ConfigureStats configure = ae.GetConfigureStats();
+    ae.Shutdown();
+
+    const CAESinkNULL::Stats stats = CAESinkNULL::GetStats();
+    printf("[ BENCHMARK] %d streams, %.0fs of audio in %.2fs, %u underruns\n", streamCount, seconds,
+           elapsed.count(), stats.underruns);
+    printf("[ BENCHMARK] CPU: %.2f ms per second of audio\n", cpu * 1000.0 / seconds);
+    printf("[ BENCHMARK] AddData: p50 %.1f us, p95 %.1f us, p99 %.1f us, max %.1f us\n",
+           Percentile(addTimes, 50) * 1e6, Percentile(addTimes, 95) * 1e6,
+           Percentile(addTimes, 99) * 1e6, Percentile(addTimes, 100) * 1e6);
+    printf("[ BENCHMARK] stream delay: p50 %.1f ms, p95 %.1f ms, p99 %.1f ms, max %.1f ms\n",
+           Percentile(delays, 50) * 1e3, Percentile(delays, 95) * 1e3,
+           Percentile(delays, 99) * 1e3, Percentile(delays, 100) * 1e3);
+    printf("[ BENCHMARK] %u reconfigurations, last %.1f ms, max %.1f ms, total %.1f ms\n",
+           configure.count, configure.last * 1e3, configure.max * 1e3, configure.total * 1e3);
+    EXPECT_GE(configure.count, 1u);
+    EXPECT_GE(stats.framesPlayed, static_cast<uint64_t>(seconds * 48000 * 0.99));
+  }
+}
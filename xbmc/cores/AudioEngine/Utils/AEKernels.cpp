@@ -0,0 +1,756 @@
+/*
+ *  Copyright (C) 2010-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "AEKernels.h"
+#include "utils/CPUInfo.h"
+
+#include <algorithm>
+#include <math.h>
+
+#if defined(HAVE_SSE2) && defined(__SSE2__)
+#include <emmintrin.h>
+#include <xmmintrin.h>
+#define AE_HAS_SSE2
+#endif
+
+// AVX2 is detected at runtime, the rest of the build doesn't need to enable it
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define AE_HAS_AVX2
+#define AE_TARGET_AVX2 __attribute__((target("avx2")))
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <immintrin.h>
+#define AE_HAS_AVX2
+#define AE_TARGET_AVX2
+#endif
+
+#if defined(HAS_NEON)
+#include <arm_neon.h>
+#define AE_HAS_NEON
+#endif
+
+namespace
+{
+  const float S16_SCALE = 32768.0f;
+  const float S32_SCALE = 2147483648.0f;
+  // largest float below 2^31, anything above doesn't fit into int32_t
+  const float S32_MAX = 2147483520.0f;
+
+  // The soft clipper is a rational function approximating tanh. It is based on the
+  // pade-approximation of tanh with tweaked coefficients and reaches +-1.0 at +-3.0.
+  // See: http://www.musicdsp.org/showone.php?id=238
+  const float CLAMP_LIMIT = 3.0f;
+  const float CLAMP_C1 = 27.0f;
+  const float CLAMP_C2 = 9.0f;
+
+  inline float SoftClamp(float x)
+  {
+    x = std::min(std::max(x, -CLAMP_LIMIT), CLAMP_LIMIT);
+    const float y = x * x;
+    return x * (CLAMP_C1 + y) / (CLAMP_C1 + CLAMP_C2 * y);
+  }
+
+  inline int16_t FloatToS16Sample(float x)
+  {
+    const float scaled = std::min(std::max(x * S16_SCALE, -S16_SCALE), S16_SCALE - 1.0f);
+    return static_cast<int16_t>(lrintf(scaled));
+  }
+
+  inline int32_t FloatToS32Sample(float x)
+  {
+    const float scaled = std::min(std::max(x * S32_SCALE, -S32_SCALE), S32_MAX);
+    return static_cast<int32_t>(lrintf(scaled));
+  }
+
+  //----------------------------------------------------------------------------
+  // Scalar
+  //----------------------------------------------------------------------------
+
+  void MulArrayScalar(float* data, float mul, uint32_t count)
+  {
+    for (uint32_t i = 0; i < count; i++)
+      data[i] *= mul;
+  }
+
+  bool MulAddArrayScalar(float* data, const float* add, float mul, uint32_t count)
+  {
+    bool clip = false;
+    for (uint32_t i = 0; i < count; i++)
+    {
+      data[i] += add[i] * mul;
+      if (fabsf(data[i]) > 1.0f)
+        clip = true;
+    }
+    return clip;
+  }
+
+  void ClampArrayScalar(float* data, uint32_t count)
+  {
+    for (uint32_t i = 0; i < count; i++)
+      data[i] = SoftClamp(data[i]);
+  }
+
+  void FloatToS16Scalar(const float* in, int16_t* out, uint32_t count)
+  {
+    for (uint32_t i = 0; i < count; i++)
+      out[i] = FloatToS16Sample(in[i]);
+  }
+
+  void S16ToFloatScalar(const int16_t* in, float* out, uint32_t count)
+  {
+    for (uint32_t i = 0; i < count; i++)
+      out[i] = in[i] * (1.0f / S16_SCALE);
+  }
+
+  void FloatToS32Scalar(const float* in, int32_t* out, uint32_t count)
+  {
+    for (uint32_t i = 0; i < count; i++)
+      out[i] = FloatToS32Sample(in[i]);
+  }
+
+  void S32ToFloatScalar(const int32_t* in, float* out, uint32_t count)
+  {
+    for (uint32_t i = 0; i < count; i++)
+      out[i] = in[i] * (1.0f / S32_SCALE);
+  }
+
+  inline void InterleaveChannel(const float* plane, float* out, unsigned int channels, uint32_t start, uint32_t end)
+  {
+    for (uint32_t f = start; f < end; f++)
+      out[f * channels] = plane[f];
+  }
+
+  inline void DeinterleaveChannel(const float* in, float* plane, unsigned int channels, uint32_t start, uint32_t end)
+  {
+    for (uint32_t f = start; f < end; f++)
+      plane[f] = in[f * channels];
+  }
+
+  void InterleaveScalar(const float* const* planes, float* out, unsigned int channels, uint32_t frames)
+  {
+    for (unsigned int c = 0; c < channels; c++)
+      InterleaveChannel(planes[c], out + c, channels, 0, frames);
+  }
+
+  void DeinterleaveScalar(const float* in, float* const* planes, unsigned int channels, uint32_t frames)
+  {
+    for (unsigned int c = 0; c < channels; c++)
+      DeinterleaveChannel(in + c, planes[c], channels, 0, frames);
+  }
+
+  const CAEKernels::Functions scalarFunctions =
+  {
+    MulArrayScalar,
+    MulAddArrayScalar,
+    ClampArrayScalar,
+    FloatToS16Scalar,
+    S16ToFloatScalar,
+    FloatToS32Scalar,
+    S32ToFloatScalar,
+    InterleaveScalar,
+    DeinterleaveScalar,
+  };
+
+  //----------------------------------------------------------------------------
+  // SSE2
+  //----------------------------------------------------------------------------
+
+#ifdef AE_HAS_SSE2
+  void MulArraySSE2(float* data, float mul, uint32_t count)
+  {
+    const __m128 m = _mm_set1_ps(mul);
+    uint32_t i = 0;
+    for (; i + 4 <= count; i += 4)
+      _mm_storeu_ps(data + i, _mm_mul_ps(_mm_loadu_ps(data + i), m));
+    MulArrayScalar(data + i, mul, count - i);
+  }
+
+  bool MulAddArraySSE2(float* data, const float* add, float mul, uint32_t count)
+  {
+    const __m128 m = _mm_set1_ps(mul);
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 sign = _mm_set1_ps(-0.0f);
+    __m128 clip = _mm_setzero_ps();
+    uint32_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+      const __m128 out = _mm_add_ps(_mm_loadu_ps(data + i), _mm_mul_ps(_mm_loadu_ps(add + i), m));
+      clip = _mm_or_ps(clip, _mm_cmpgt_ps(_mm_andnot_ps(sign, out), one));
+      _mm_storeu_ps(data + i, out);
+    }
+    const bool tailClip = MulAddArrayScalar(data + i, add + i, mul, count - i);
+    return _mm_movemask_ps(clip) != 0 || tailClip;
+  }
+
+  void ClampArraySSE2(float* data, uint32_t count)
+  {
+    const __m128 limit = _mm_set1_ps(CLAMP_LIMIT);
+    const __m128 negLimit = _mm_set1_ps(-CLAMP_LIMIT);
+    const __m128 c1 = _mm_set1_ps(CLAMP_C1);
+    const __m128 c2 = _mm_set1_ps(CLAMP_C2);
+    uint32_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+      const __m128 x = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(data + i), negLimit), limit);
+      const __m128 y = _mm_mul_ps(x, x);
+      const __m128 num = _mm_mul_ps(x, _mm_add_ps(c1, y));
+      _mm_storeu_ps(data + i, _mm_div_ps(num, _mm_add_ps(c1, _mm_mul_ps(c2, y))));
+    }
+    ClampArrayScalar(data + i, count - i);
+  }
+
+  void FloatToS16SSE2(const float* in, int16_t* out, uint32_t count)
+  {
+    // limit to what fits into int32_t, packing saturates the rest
+    const __m128 scale = _mm_set1_ps(S16_SCALE);
+    const __m128 min = _mm_set1_ps(-S16_SCALE * 2.0f);
+    const __m128 max = _mm_set1_ps(S16_SCALE * 2.0f);
+    uint32_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+      const __m128i a = _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(in + i), scale), min), max));
+      const __m128i b = _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(in + i + 4), scale), min), max));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_packs_epi32(a, b));
+    }
+    FloatToS16Scalar(in + i, out + i, count - i);
+  }
+
+  void S16ToFloatSSE2(const int16_t* in, float* out, uint32_t count)
+  {
+    const __m128 scale = _mm_set1_ps(1.0f / S16_SCALE);
+    uint32_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+      const __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+      const __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(s, s), 16);
+      const __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(s, s), 16);
+      _mm_storeu_ps(out + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+      _mm_storeu_ps(out + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+    }
+    S16ToFloatScalar(in + i, out + i, count - i);
+  }
+
+  void FloatToS32SSE2(const float* in, int32_t* out, uint32_t count)
+  {
+    // too small values convert to INT32_MIN anyway
+    const __m128 scale = _mm_set1_ps(S32_SCALE);
+    const __m128 max = _mm_set1_ps(S32_MAX);
+    uint32_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+      const __m128 scaled = _mm_min_ps(_mm_mul_ps(_mm_loadu_ps(in + i), scale), max);
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_cvtps_epi32(scaled));
+    }
+    FloatToS32Scalar(in + i, out + i, count - i);
+  }
+
+  void S32ToFloatSSE2(const int32_t* in, float* out, uint32_t count)
+  {
+    const __m128 scale = _mm_set1_ps(1.0f / S32_SCALE);
+    uint32_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+      const __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+      _mm_storeu_ps(out + i, _mm_mul_ps(_mm_cvtepi32_ps(s), scale));
+    }
+    S32ToFloatScalar(in + i, out + i, count - i);
+  }
+
+  /*
+   * Channels are handled in groups of four by transposing 4x4 blocks of
+   * samples, remaining pairs by unpacking. This covers all common layouts up
+   * to 7.1 without a single scalar channel.
+   */
+  void InterleaveSSE2(const float* const* planes, float* out, unsigned int channels, uint32_t frames)
+  {
+    const uint32_t blockFrames = frames & ~3u;
+    unsigned int c = 0;
+    for (; c + 4 <= channels; c += 4)
+    {
+      for (uint32_t f = 0; f < blockFrames; f += 4)
+      {
+        __m128 r0 = _mm_loadu_ps(planes[c] + f);
+        __m128 r1 = _mm_loadu_ps(planes[c + 1] + f);
+        __m128 r2 = _mm_loadu_ps(planes[c + 2] + f);
+        __m128 r3 = _mm_loadu_ps(planes[c + 3] + f);
+        _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+        float* dst = out + f * channels + c;
+        _mm_storeu_ps(dst, r0);
+        _mm_storeu_ps(dst + channels, r1);
+        _mm_storeu_ps(dst + 2 * channels, r2);
+        _mm_storeu_ps(dst + 3 * channels, r3);
+      }
+    }
+    for (; c + 2 <= channels; c += 2)
+    {
+      for (uint32_t f = 0; f < blockFrames; f += 4)
+      {
+        const __m128 a = _mm_loadu_ps(planes[c] + f);
+        const __m128 b = _mm_loadu_ps(planes[c + 1] + f);
+        const __m128 lo = _mm_unpacklo_ps(a, b);
+        const __m128 hi = _mm_unpackhi_ps(a, b);
+        float* dst = out + f * channels + c;
+        _mm_storel_pi(reinterpret_cast<__m64*>(dst), lo);
+        _mm_storeh_pi(reinterpret_cast<__m64*>(dst + channels), lo);
+        _mm_storel_pi(reinterpret_cast<__m64*>(dst + 2 * channels), hi);
+        _mm_storeh_pi(reinterpret_cast<__m64*>(dst + 3 * channels), hi);
+      }
+    }
+    for (; c < channels; c++)
+      InterleaveChannel(planes[c], out + c, channels, 0, blockFrames);
+
+    for (c = 0; c < channels; c++)
+      InterleaveChannel(planes[c], out + c, channels, blockFrames, frames);
+  }
+
+  void DeinterleaveSSE2(const float* in, float* const* planes, unsigned int channels, uint32_t frames)
+  {
+    const uint32_t blockFrames = frames & ~3u;
+    unsigned int c = 0;
+    for (; c + 4 <= channels; c += 4)
+    {
+      for (uint32_t f = 0; f < blockFrames; f += 4)
+      {
+        const float* src = in + f * channels + c;
+        __m128 r0 = _mm_loadu_ps(src);
+        __m128 r1 = _mm_loadu_ps(src + channels);
+        __m128 r2 = _mm_loadu_ps(src + 2 * channels);
+        __m128 r3 = _mm_loadu_ps(src + 3 * channels);
+        _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+        _mm_storeu_ps(planes[c] + f, r0);
+        _mm_storeu_ps(planes[c + 1] + f, r1);
+        _mm_storeu_ps(planes[c + 2] + f, r2);
+        _mm_storeu_ps(planes[c + 3] + f, r3);
+      }
+    }
+    for (; c + 2 <= channels; c += 2)
+    {
+      for (uint32_t f = 0; f < blockFrames; f += 4)
+      {
+        const float* src = in + f * channels + c;
+        __m128 lo = _mm_setzero_ps();
+        __m128 hi = _mm_setzero_ps();
+        lo = _mm_loadl_pi(lo, reinterpret_cast<const __m64*>(src));
+        lo = _mm_loadh_pi(lo, reinterpret_cast<const __m64*>(src + channels));
+        hi = _mm_loadl_pi(hi, reinterpret_cast<const __m64*>(src + 2 * channels));
+        hi = _mm_loadh_pi(hi, reinterpret_cast<const __m64*>(src + 3 * channels));
+        _mm_storeu_ps(planes[c] + f, _mm_shuffle_ps(lo, hi, _MM_SHUFFLE(2, 0, 2, 0)));
+        _mm_storeu_ps(planes[c + 1] + f, _mm_shuffle_ps(lo, hi, _MM_SHUFFLE(3, 1, 3, 1)));
+      }
+    }
+    for (; c < channels; c++)
+      DeinterleaveChannel(in + c, planes[c], channels, 0, blockFrames);
+
+    for (c = 0; c < channels; c++)
+      DeinterleaveChannel(in + c, planes[c], channels, blockFrames, frames);
+  }
+
+  const CAEKernels::Functions sse2Functions =
+  {
+    MulArraySSE2,
+    MulAddArraySSE2,
+    ClampArraySSE2,
+    FloatToS16SSE2,
+    S16ToFloatSSE2,
+    FloatToS32SSE2,
+    S32ToFloatSSE2,
+    InterleaveSSE2,
+    DeinterleaveSSE2,
+  };
+#endif
+
+  //----------------------------------------------------------------------------
+  // AVX2
+  //----------------------------------------------------------------------------
+
+#ifdef AE_HAS_AVX2
+  AE_TARGET_AVX2 void MulArrayAVX2(float* data, float mul, uint32_t count)
+  {
+    const __m256 m = _mm256_set1_ps(mul);
+    uint32_t i = 0;
+    for (; i + 8 <= count; i += 8)
+      _mm256_storeu_ps(data + i, _mm256_mul_ps(_mm256_loadu_ps(data + i), m));
+    MulArrayScalar(data + i, mul, count - i);
+  }
+
+  AE_TARGET_AVX2 bool MulAddArrayAVX2(float* data, const float* add, float mul, uint32_t count)
+  {
+    const __m256 m = _mm256_set1_ps(mul);
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 sign = _mm256_set1_ps(-0.0f);
+    __m256 clip = _mm256_setzero_ps();
+    uint32_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+      const __m256 out = _mm256_add_ps(_mm256_loadu_ps(data + i), _mm256_mul_ps(_mm256_loadu_ps(add + i), m));
+      clip = _mm256_or_ps(clip, _mm256_cmp_ps(_mm256_andnot_ps(sign, out), one, _CMP_GT_OQ));
+      _mm256_storeu_ps(data + i, out);
+    }
+    const bool tailClip = MulAddArrayScalar(data + i, add + i, mul, count - i);
+    return _mm256_movemask_ps(clip) != 0 || tailClip;
+  }
+
+  AE_TARGET_AVX2 void ClampArrayAVX2(float* data, uint32_t count)
+  {
+    const __m256 limit = _mm256_set1_ps(CLAMP_LIMIT);
+    const __m256 negLimit = _mm256_set1_ps(-CLAMP_LIMIT);
+    const __m256 c1 = _mm256_set1_ps(CLAMP_C1);
+    const __m256 c2 = _mm256_set1_ps(CLAMP_C2);
+    uint32_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+      const __m256 x = _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(data + i), negLimit), limit);
+      const __m256 y = _mm256_mul_ps(x, x);
+      const __m256 num = _mm256_mul_ps(x, _mm256_add_ps(c1, y));
+      _mm256_storeu_ps(data + i, _mm256_div_ps(num, _mm256_add_ps(c1, _mm256_mul_ps(c2, y))));
+    }
+    ClampArrayScalar(data + i, count - i);
+  }
+
+  AE_TARGET_AVX2 void FloatToS16AVX2(const float* in, int16_t* out, uint32_t count)
+  {
+    const __m256 scale = _mm256_set1_ps(S16_SCALE);
+    const __m256 min = _mm256_set1_ps(-S16_SCALE * 2.0f);
+    const __m256 max = _mm256_set1_ps(S16_SCALE * 2.0f);
+    uint32_t i = 0;
+    for (; i + 16 <= count; i += 16)
+    {
+      const __m256i a = _mm256_cvtps_epi32(_mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(_mm256_loadu_ps(in + i), scale), min), max));
+      const __m256i b = _mm256_cvtps_epi32(_mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(_mm256_loadu_ps(in + i + 8), scale), min), max));
+      // packing works per 128 bit lane, restore the order afterwards
+      const __m256i packed = _mm256_permute4x64_epi64(_mm256_packs_epi32(a, b), _MM_SHUFFLE(3, 1, 2, 0));
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), packed);
+    }
+    FloatToS16Scalar(in + i, out + i, count - i);
+  }
+
+  AE_TARGET_AVX2 void S16ToFloatAVX2(const int16_t* in, float* out, uint32_t count)
+  {
+    const __m256 scale = _mm256_set1_ps(1.0f / S16_SCALE);
+    uint32_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+      const __m256i s = _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i)));
+      _mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_cvtepi32_ps(s), scale));
+    }
+    S16ToFloatScalar(in + i, out + i, count - i);
+  }
+
+  AE_TARGET_AVX2 void FloatToS32AVX2(const float* in, int32_t* out, uint32_t count)
+  {
+    const __m256 scale = _mm256_set1_ps(S32_SCALE);
+    const __m256 max = _mm256_set1_ps(S32_MAX);
+    uint32_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+      const __m256 scaled = _mm256_min_ps(_mm256_mul_ps(_mm256_loadu_ps(in + i), scale), max);
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_cvtps_epi32(scaled));
+    }
+    FloatToS32Scalar(in + i, out + i, count - i);
+  }
+
+  AE_TARGET_AVX2 void S32ToFloatAVX2(const int32_t* in, float* out, uint32_t count)
+  {
+    const __m256 scale = _mm256_set1_ps(1.0f / S32_SCALE);
+    uint32_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+      const __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+      _mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_cvtepi32_ps(s), scale));
+    }
+    S32ToFloatScalar(in + i, out + i, count - i);
+  }
+
+  // (De)interleaving is bound by memory access, wider registers don't help
+  const CAEKernels::Functions avx2Functions =
+  {
+    MulArrayAVX2,
+    MulAddArrayAVX2,
+    ClampArrayAVX2,
+    FloatToS16AVX2,
+    S16ToFloatAVX2,
+    FloatToS32AVX2,
+    S32ToFloatAVX2,
+#ifdef AE_HAS_SSE2
+    InterleaveSSE2,
+    DeinterleaveSSE2,
+#else
+    InterleaveScalar,
+    DeinterleaveScalar,
+#endif
+  };
+#endif
+
+  //----------------------------------------------------------------------------
+  // NEON
+  //----------------------------------------------------------------------------
+
+#ifdef AE_HAS_NEON
+  inline int32x4_t RoundToInt(float32x4_t x)
+  {
+#if defined(__aarch64__)
+    return vcvtnq_s32_f32(x);
+#else
+    // ARMv7 only truncates, round half away from zero
+    const uint32x4_t sign = vandq_u32(vreinterpretq_u32_f32(x), vdupq_n_u32(0x80000000));
+    const float32x4_t half = vreinterpretq_f32_u32(vorrq_u32(sign, vreinterpretq_u32_f32(vdupq_n_f32(0.5f))));
+    return vcvtq_s32_f32(vaddq_f32(x, half));
+#endif
+  }
+
+  inline float32x4_t Divide(float32x4_t num, float32x4_t den)
+  {
+#if defined(__aarch64__)
+    return vdivq_f32(num, den);
+#else
+    float32x4_t r = vrecpeq_f32(den);
+    r = vmulq_f32(vrecpsq_f32(den, r), r);
+    r = vmulq_f32(vrecpsq_f32(den, r), r);
+    return vmulq_f32(num, r);
+#endif
+  }
+
+  void MulArrayNEON(float* data, float mul, uint32_t count)
+  {
+    uint32_t i = 0;
+    for (; i + 4 <= count; i += 4)
+      vst1q_f32(data + i, vmulq_n_f32(vld1q_f32(data + i), mul));
+    MulArrayScalar(data + i, mul, count - i);
+  }
+
+  bool MulAddArrayNEON(float* data, const float* add, float mul, uint32_t count)
+  {
+    const float32x4_t one = vdupq_n_f32(1.0f);
+    uint32x4_t clip = vdupq_n_u32(0);
+    uint32_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+      // not fused, to get the same result as the other kernels
+      const float32x4_t out = vaddq_f32(vld1q_f32(data + i), vmulq_n_f32(vld1q_f32(add + i), mul));
+      clip = vorrq_u32(clip, vcagtq_f32(out, one));
+      vst1q_f32(data + i, out);
+    }
+    const uint32x2_t clip2 = vorr_u32(vget_low_u32(clip), vget_high_u32(clip));
+    const bool tailClip = MulAddArrayScalar(data + i, add + i, mul, count - i);
+    return (vget_lane_u32(clip2, 0) | vget_lane_u32(clip2, 1)) != 0 || tailClip;
+  }
+
+  void ClampArrayNEON(float* data, uint32_t count)
+  {
+    const float32x4_t limit = vdupq_n_f32(CLAMP_LIMIT);
+    const float32x4_t negLimit = vdupq_n_f32(-CLAMP_LIMIT);
+    const float32x4_t c1 = vdupq_n_f32(CLAMP_C1);
+    uint32_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+      const float32x4_t x = vminq_f32(vmaxq_f32(vld1q_f32(data + i), negLimit), limit);
+      const float32x4_t y = vmulq_f32(x, x);
+      const float32x4_t num = vmulq_f32(x, vaddq_f32(c1, y));
+      vst1q_f32(data + i, Divide(num, vaddq_f32(c1, vmulq_n_f32(y, CLAMP_C2))));
+    }
+    ClampArrayScalar(data + i, count - i);
+  }
+
+  void FloatToS16NEON(const float* in, int16_t* out, uint32_t count)
+  {
+    uint32_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+      const int32x4_t a = RoundToInt(vmulq_n_f32(vld1q_f32(in + i), S16_SCALE));
+      const int32x4_t b = RoundToInt(vmulq_n_f32(vld1q_f32(in + i + 4), S16_SCALE));
+      vst1q_s16(out + i, vcombine_s16(vqmovn_s32(a), vqmovn_s32(b)));
+    }
+    FloatToS16Scalar(in + i, out + i, count - i);
+  }
+
+  void S16ToFloatNEON(const int16_t* in, float* out, uint32_t count)
+  {
+    uint32_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+      const int16x8_t s = vld1q_s16(in + i);
+      vst1q_f32(out + i, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(s))), 1.0f / S16_SCALE));
+      vst1q_f32(out + i + 4, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(s))), 1.0f / S16_SCALE));
+    }
+    S16ToFloatScalar(in + i, out + i, count - i);
+  }
+
+  void FloatToS32NEON(const float* in, int32_t* out, uint32_t count)
+  {
+    const float32x4_t max = vdupq_n_f32(S32_MAX);
+    uint32_t i = 0;
+    for (; i + 4 <= count; i += 4)
+      vst1q_s32(out + i, RoundToInt(vminq_f32(vmulq_n_f32(vld1q_f32(in + i), S32_SCALE), max)));
+    FloatToS32Scalar(in + i, out + i, count - i);
+  }
+
+  void S32ToFloatNEON(const int32_t* in, float* out, uint32_t count)
+  {
+    uint32_t i = 0;
+    for (; i + 4 <= count; i += 4)
+      vst1q_f32(out + i, vmulq_n_f32(vcvtq_f32_s32(vld1q_s32(in + i)), 1.0f / S32_SCALE));
+    S32ToFloatScalar(in + i, out + i, count - i);
+  }
+
+  // The structured loads and stores of NEON only cover stereo and quad
+  void InterleaveNEON(const float* const* planes, float* out, unsigned int channels, uint32_t frames)
+  {
+    const uint32_t blockFrames = frames & ~3u;
+    if (channels == 2)
+    {
+      for (uint32_t f = 0; f < blockFrames; f += 4)
+      {
+        float32x4x2_t v;
+        v.val[0] = vld1q_f32(planes[0] + f);
+        v.val[1] = vld1q_f32(planes[1] + f);
+        vst2q_f32(out + f * 2, v);
+      }
+    }
+    else if (channels == 4)
+    {
+      for (uint32_t f = 0; f < blockFrames; f += 4)
+      {
+        float32x4x4_t v;
+        for (unsigned int c = 0; c < 4; c++)
+          v.val[c] = vld1q_f32(planes[c] + f);
+        vst4q_f32(out + f * 4, v);
+      }
+    }
+    else
+    {
+      InterleaveScalar(planes, out, channels, frames);
+      return;
+    }
+
+    for (unsigned int c = 0; c < channels; c++)
+      InterleaveChannel(planes[c], out + c, channels, blockFrames, frames);
+  }
+
+  void DeinterleaveNEON(const float* in, float* const* planes, unsigned int channels, uint32_t frames)
+  {
+    const uint32_t blockFrames = frames & ~3u;
+    if (channels == 2)
+    {
+      for (uint32_t f = 0; f < blockFrames; f += 4)
+      {
+        const float32x4x2_t v = vld2q_f32(in + f * 2);
+        vst1q_f32(planes[0] + f, v.val[0]);
+        vst1q_f32(planes[1] + f, v.val[1]);
+      }
+    }
+    else if (channels == 4)
+    {
+      for (uint32_t f = 0; f < blockFrames; f += 4)
+      {
+        const float32x4x4_t v = vld4q_f32(in + f * 4);
+        for (unsigned int c = 0; c < 4; c++)
+          vst1q_f32(planes[c] + f, v.val[c]);
+      }
+    }
+    else
+    {
+      DeinterleaveScalar(in, planes, channels, frames);
+      return;
+    }
+
+    for (unsigned int c = 0; c < channels; c++)
+      DeinterleaveChannel(in + c, planes[c], channels, blockFrames, frames);
+  }
+
+  const CAEKernels::Functions neonFunctions =
+  {
+    MulArrayNEON,
+    MulAddArrayNEON,
+    ClampArrayNEON,
+    FloatToS16NEON,
+    S16ToFloatNEON,
+    FloatToS32NEON,
+    S32ToFloatNEON,
+    InterleaveNEON,
+    DeinterleaveNEON,
+  };
+#endif
+}
+
+bool CAEKernels::IsSupported(Kernel kernel)
+{
+  switch (kernel)
+  {
+  case Kernel::SCALAR:
+    return true;
+#ifdef AE_HAS_SSE2
+  case Kernel::SSE2:
+    return (g_cpuInfo.GetCPUFeatures() & CPU_FEATURE_SSE2) != 0;
+#endif
+#ifdef AE_HAS_AVX2
+  case Kernel::AVX2:
+    return (g_cpuInfo.GetCPUFeatures() & CPU_FEATURE_AVX2) != 0;
+#endif
+#ifdef AE_HAS_NEON
+  case Kernel::NEON:
+    return (g_cpuInfo.GetCPUFeatures() & CPU_FEATURE_NEON) != 0;
+#endif
+  default:
+    break;
+  }
+  return false;
+}
+
+CAEKernels::Kernel CAEKernels::GetBestKernel()
+{
+  static const Kernel bestKernel = IsSupported(Kernel::AVX2) ? Kernel::AVX2 :
+                                   IsSupported(Kernel::SSE2) ? Kernel::SSE2 :
+                                   IsSupported(Kernel::NEON) ? Kernel::NEON :
+                                   Kernel::SCALAR;
+  return bestKernel;
+}
+
+const char* CAEKernels::GetKernelName(Kernel kernel)
+{
+  switch (kernel)
+  {
+  case Kernel::SSE2:
+    return "SSE2";
+  case Kernel::AVX2:
+    return "AVX2";
+  case Kernel::NEON:
+    return "NEON";
+  default:
+    return "scalar";
+  }
+}
+
+const CAEKernels::Functions& CAEKernels::Get()
+{
+  static const Functions& bestFunctions = Get(GetBestKernel());
+  return bestFunctions;
+}
+
+const CAEKernels::Functions& CAEKernels::Get(Kernel kernel)
+{
+  if (!IsSupported(kernel))
+    return scalarFunctions;
+
+  switch (kernel)
+  {
+#ifdef AE_HAS_SSE2
+  case Kernel::SSE2:
+    return sse2Functions;
+#endif
+#ifdef AE_HAS_AVX2
+  case Kernel::AVX2:
+    return avx2Functions;
+#endif
+#ifdef AE_HAS_NEON
+  case Kernel::NEON:
+    return neonFunctions;
+#endif
+  default:
+    return scalarFunctions;
+  }
+}
@@ -0,0 +1,82 @@
+/*
+ *  Copyright (C) 2010-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+/*!
+ * \brief Sample processing kernels of the audio engine
+ *
+ * Every kernel is implemented in plain C++ and, where the build supports it,
+ * with SSE2, AVX2 and NEON. The fastest implementation supported by the CPU
+ * is picked at runtime, so AVX2 can be used without building everything for
+ * it. All implementations produce the same results as the scalar ones, apart
+ * from small rounding differences of NEON on ARMv7, which lacks a division
+ * and rounding float to integer conversions.
+ *
+ * Buffers don't need to be aligned.
+ */
+class CAEKernels
+{
+public:
+  enum class Kernel
+  {
+    SCALAR,
+    SSE2,
+    AVX2,
+    NEON,
+  };
+
+  struct Functions
+  {
+    //! data[i] *= mul
+    void (*MulArray)(float* data, float mul, uint32_t count);
+
+    /*!
+     * \brief data[i] += add[i] * mul
+     * \return True if a resulting sample is outside of [-1.0, 1.0] and needs clamping
+     */
+    bool (*MulAddArray)(float* data, const float* add, float mul, uint32_t count);
+
+    //! Soft clip data to [-1.0, 1.0] with a tanh like curve
+    void (*ClampArray)(float* data, uint32_t count);
+
+    //! Convert between float in [-1.0, 1.0) and full scale integer samples, out of range values saturate
+    void (*FloatToS16)(const float* in, int16_t* out, uint32_t count);
+    void (*S16ToFloat)(const int16_t* in, float* out, uint32_t count);
+    void (*FloatToS32)(const float* in, int32_t* out, uint32_t count);
+    void (*S32ToFloat)(const int32_t* in, float* out, uint32_t count);
+
+    //! Convert frames samples of channels planes to interleaved samples and back
+    void (*Interleave)(const float* const* planes, float* out, unsigned int channels, uint32_t frames);
+    void (*Deinterleave)(const float* in, float* const* planes, unsigned int channels, uint32_t frames);
+  };
+
+  /*!
+   * \brief Check if the kernel is built in and can be used on this CPU
+   */
+  static bool IsSupported(Kernel kernel);
+
+  /*!
+   * \brief Get the fastest kernel supported by this CPU
+   */
+  static Kernel GetBestKernel();
+
+  static const char* GetKernelName(Kernel kernel);
+
+  /*!
+   * \brief Get the functions of the fastest kernel
+   */
+  static const Functions& Get();
+
+  /*!
+   * \brief Get the functions of a kernel, the scalar ones if it isn't supported
+   */
+  static const Functions& Get(Kernel kernel);
+};
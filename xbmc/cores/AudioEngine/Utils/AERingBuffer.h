@@ -15,7 +15,10 @@
 
 //#define AE_RING_BUFFER_DEBUG
 
+#include "utils/CacheLine.h"
 #include "utils/log.h"  //CLog
+#include <algorithm>
+#include <atomic>
 #include <string.h>     //memset, memcpy
 #ifdef TARGET_POSIX
 #include "platform/linux/XMemUtils.h"
@@ -23,36 +26,29 @@
 
 /**
  * This buffer can be used by one read and one write thread at any one time
- * without the risk of data corruption.
+ * without the risk of data corruption and without locks.
  * If you intend to call the Reset() method, please use Locks.
  * All other operations are thread-safe.
+ *
+ * Besides copying with Write() and Read(), the writer can fill the buffer in
+ * place with ReserveWrite() and CommitWrite(), and the reader can consume it
+ * in place with ReserveRead() and CommitRead(). The counters of both sides
+ * live in separate cache lines, so the threads don't invalidate each other's
+ * cache on every operation.
  */
 class AERingBuffer {
 
 public:
-  AERingBuffer() :
-    m_iReadPos(0),
-    m_iWritePos(0),
-    m_iRead(0),
-    m_iWritten(0),
-    m_iSize(0),
-    m_planes(0),
-    m_Buffer(NULL)
-  {
-  }
+  AERingBuffer() = default;
 
-  AERingBuffer(unsigned int size, unsigned int planes = 1) :
-    m_iReadPos(0),
-    m_iWritePos(0),
-    m_iRead(0),
-    m_iWritten(0),
-    m_iSize(0),
-    m_planes(0),
-    m_Buffer(NULL)
+  AERingBuffer(unsigned int size, unsigned int planes = 1)
   {
     Create(size, planes);
   }
 
+  AERingBuffer(const AERingBuffer&) = delete;
+  AERingBuffer& operator=(const AERingBuffer&) = delete;
+
   ~AERingBuffer()
   {
 #ifdef AE_RING_BUFFER_DEBUG
@@ -92,8 +88,8 @@ public:
 #ifdef AE_RING_BUFFER_DEBUG
     CLog::Log(LOGDEBUG, "AERingBuffer::Reset: Buffer reset.");
 #endif
-    m_iWritten = 0;
-    m_iRead = 0;
+    m_iWritten.store(0, std::memory_order_relaxed);
+    m_iRead.store(0, std::memory_order_relaxed);
     m_iReadPos = 0;
     m_iWritePos = 0;
   }
@@ -218,7 +214,7 @@ public:
       }
     }
     bufferContents[m_iSize*m_planes] = '\0';
-    CLog::Log(LOGDEBUG, "AERingBuffer::Dump()\n%s",bufferContents);
+    CLog::Log(LOGDEBUG, "AERingBuffer::Dump()\n%s", reinterpret_cast<char*>(bufferContents));
     _aligned_free(bufferContents);
   }
 
@@ -228,7 +224,7 @@ public:
    */
   unsigned int GetWriteSize()
   {
-    return m_iSize - ( m_iWritten - m_iRead );
+    return m_iSize - GetReadSize();
   }
 
   /**
@@ -237,7 +233,61 @@ public:
    */
   unsigned int GetReadSize()
   {
-    return m_iWritten - m_iRead;
+    // load the read count first, it never passes the write count loaded after it
+    const unsigned int read = m_iRead.load(std::memory_order_acquire);
+    return m_iWritten.load(std::memory_order_acquire) - read;
+  }
+
+  /**
+   * Gets the free space at the write position for writing in place.
+   * The space ends at the end of the buffer, once that is committed the
+   * next call returns the space at its start.
+   * Only to be called by the writing thread.
+   *
+   * @param planes receives the write position of every plane, NumPlanes() pointers
+   * @return number of bytes that can be written to every plane
+   */
+  unsigned int ReserveWrite(unsigned char **planes)
+  {
+    for (unsigned int i = 0; i < m_planes; i++)
+      planes[i] = m_Buffer[i] + m_iWritePos;
+    return std::min(GetWriteSize(), m_iSize - m_iWritePos);
+  }
+
+  /**
+   * Hands data written in place to the reader.
+   *
+   * @param size number of bytes written to every plane, at most what ReserveWrite() returned
+   */
+  void CommitWrite(unsigned int size)
+  {
+    WriteFinished(size);
+  }
+
+  /**
+   * Gets the data at the read position for reading in place.
+   * The data ends at the end of the buffer, once that is committed the
+   * next call returns the data at its start.
+   * Only to be called by the reading thread.
+   *
+   * @param planes receives the read position of every plane, NumPlanes() pointers
+   * @return number of bytes that can be read from every plane
+   */
+  unsigned int ReserveRead(unsigned char **planes)
+  {
+    for (unsigned int i = 0; i < m_planes; i++)
+      planes[i] = m_Buffer[i] + m_iReadPos;
+    return std::min(GetReadSize(), m_iSize - m_iReadPos);
+  }
+
+  /**
+   * Frees data read in place for the writer.
+   *
+   * @param size number of bytes read from every plane, at most what ReserveRead() returned
+   */
+  void CommitRead(unsigned int size)
+  {
+    ReadFinished(size);
   }
 
   /**
@@ -267,8 +317,8 @@ private:
     else // wrapping
       m_iWritePos = size - (m_iSize - m_iWritePos);
 
-    //we can increase the write count now
-    m_iWritten+=size;
+    //we can increase the write count now, publishing the data to the reader
+    m_iWritten.store(m_iWritten.load(std::memory_order_relaxed) + size, std::memory_order_release);
   }
 
   /**
@@ -282,15 +332,22 @@ private:
     else
       m_iReadPos = size - (m_iSize - m_iReadPos);
 
-    //we can increase the read count now
-    m_iRead+=size;
+    //we can increase the read count now, handing the space back to the writer
+    m_iRead.store(m_iRead.load(std::memory_order_relaxed) + size, std::memory_order_release);
   }
 
-  unsigned int m_iReadPos;
-  unsigned int m_iWritePos;
-  unsigned int m_iRead;
-  unsigned int m_iWritten;
-  unsigned int m_iSize;
-  unsigned int m_planes;
-  unsigned char **m_Buffer;
+  // the padding keeps the state of the reader and of the writer on different
+  // cache lines
+  // state of the reader
+  std::atomic<unsigned int> m_iRead{0};
+  unsigned int m_iReadPos = 0;
+  CACHE_LINE_PADDING char m_readPadding[CACHE_LINE_SIZE];
+  // state of the writer
+  std::atomic<unsigned int> m_iWritten{0};
+  unsigned int m_iWritePos = 0;
+  CACHE_LINE_PADDING char m_writePadding[CACHE_LINE_SIZE];
+  // shared, read only while in use
+  unsigned int m_iSize = 0;
+  unsigned int m_planes = 0;
+  unsigned char **m_Buffer = nullptr;
 };
@@ -0,0 +1,204 @@
+/*
+ *  Copyright (C) 2010-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/AudioEngine/Utils/AEKernels.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+const CAEKernels::Kernel KERNELS[] = { CAEKernels::Kernel::SCALAR, CAEKernels::Kernel::SSE2,
+                                       CAEKernels::Kernel::AVX2, CAEKernels::Kernel::NEON };
+
+// odd count to cover the scalar tails, offset to cover unaligned buffers
+const uint32_t COUNT = 1023;
+const uint32_t OFFSET = 1;
+
+std::vector<float> MakeSamples(uint32_t count, float range)
+{
+  std::mt19937 rng(1234);
+  std::uniform_real_distribution<float> dist(-range, range);
+  std::vector<float> samples(count + OFFSET);
+  for (auto& sample : samples)
+    sample = dist(rng);
+  return samples;
+}
+}
+
+TEST(TestAEKernels, MatchScalar)
+{
+  const CAEKernels::Functions& scalar = CAEKernels::Get(CAEKernels::Kernel::SCALAR);
+  const std::vector<float> input = MakeSamples(COUNT, 1.5f);
+  const std::vector<float> add = MakeSamples(COUNT, 0.5f);
+
+  for (CAEKernels::Kernel kernel : KERNELS)
+  {
+    if (!CAEKernels::IsSupported(kernel))
+      continue;
+    SCOPED_TRACE(CAEKernels::GetKernelName(kernel));
+    const CAEKernels::Functions& functions = CAEKernels::Get(kernel);
+
+    std::vector<float> expected(input);
+    std::vector<float> actual(input);
+    scalar.MulArray(expected.data() + OFFSET, 0.7f, COUNT);
+    functions.MulArray(actual.data() + OFFSET, 0.7f, COUNT);
+    EXPECT_EQ(expected, actual);
+
+    expected = input;
+    actual = input;
+    EXPECT_TRUE(scalar.MulAddArray(expected.data() + OFFSET, add.data() + OFFSET, 0.5f, COUNT));
+    EXPECT_TRUE(functions.MulAddArray(actual.data() + OFFSET, add.data() + OFFSET, 0.5f, COUNT));
+    EXPECT_EQ(expected, actual);
+
+    // clipping is detected in the vectorized part and in the tail
+    std::vector<float> quiet(COUNT, 0.1f);
+    EXPECT_FALSE(functions.MulAddArray(quiet.data(), quiet.data(), 1.0f, COUNT));
+    quiet[0] = 0.6f;
+    EXPECT_TRUE(functions.MulAddArray(quiet.data(), quiet.data(), 1.0f, COUNT));
+    quiet.assign(COUNT, 0.1f);
+    quiet[COUNT - 1] = -0.6f;
+    EXPECT_TRUE(functions.MulAddArray(quiet.data(), quiet.data(), 1.0f, COUNT));
+
+    std::vector<float> loud = MakeSamples(COUNT, 10.0f);
+    expected = loud;
+    actual = loud;
+    scalar.ClampArray(expected.data() + OFFSET, COUNT);
+    functions.ClampArray(actual.data() + OFFSET, COUNT);
+    for (uint32_t i = OFFSET; i < loud.size(); i++)
+    {
+      EXPECT_NEAR(expected[i], actual[i], 1e-6f);
+      EXPECT_LE(std::abs(actual[i]), 1.0f);
+    }
+  }
+}
+
+TEST(TestAEKernels, Conversions)
+{
+  std::vector<float> input = MakeSamples(COUNT, 1.2f);
+  input[1] = 1e10f;
+  input[2] = -1e10f;
+  input[3] = 1.0f;
+  input[4] = -1.0f;
+
+  for (CAEKernels::Kernel kernel : KERNELS)
+  {
+    if (!CAEKernels::IsSupported(kernel))
+      continue;
+    SCOPED_TRACE(CAEKernels::GetKernelName(kernel));
+    const CAEKernels::Functions& functions = CAEKernels::Get(kernel);
+
+    std::vector<int16_t> s16(COUNT);
+    functions.FloatToS16(input.data() + OFFSET, s16.data(), COUNT);
+    EXPECT_EQ(32767, s16[0]);
+    EXPECT_EQ(-32768, s16[1]);
+    EXPECT_EQ(32767, s16[2]);
+    EXPECT_EQ(-32768, s16[3]);
+
+    std::vector<float> output(COUNT);
+    functions.S16ToFloat(s16.data(), output.data(), COUNT);
+    for (uint32_t i = 0; i < COUNT; i++)
+      EXPECT_NEAR(std::min(std::max(input[i + OFFSET], -1.0f), 1.0f), output[i], 1.0f / 32768);
+
+    std::vector<int32_t> s32(COUNT);
+    functions.FloatToS32(input.data() + OFFSET, s32.data(), COUNT);
+    EXPECT_GE(s32[0], 2147483520);
+    EXPECT_EQ(INT32_MIN, s32[1]);
+    EXPECT_GE(s32[2], 2147483520);
+    EXPECT_EQ(INT32_MIN, s32[3]);
+
+    functions.S32ToFloat(s32.data(), output.data(), COUNT);
+    for (uint32_t i = 0; i < COUNT; i++)
+      EXPECT_NEAR(std::min(std::max(input[i + OFFSET], -1.0f), 1.0f), output[i], 1e-7f);
+  }
+}
+
+TEST(TestAEKernels, Interleave)
+{
+  for (unsigned int channels = 1; channels <= 8; channels++)
+  {
+    const std::vector<float> interleaved = MakeSamples(COUNT * channels, 1.0f);
+    for (CAEKernels::Kernel kernel : KERNELS)
+    {
+      if (!CAEKernels::IsSupported(kernel))
+        continue;
+      SCOPED_TRACE(CAEKernels::GetKernelName(kernel));
+      const CAEKernels::Functions& functions = CAEKernels::Get(kernel);
+
+      std::vector<std::vector<float>> planes(channels, std::vector<float>(COUNT));
+      std::vector<float*> planePtrs;
+      for (auto& plane : planes)
+        planePtrs.push_back(plane.data());
+
+      functions.Deinterleave(interleaved.data() + OFFSET, planePtrs.data(), channels, COUNT);
+      for (unsigned int c = 0; c < channels; c++)
+      {
+        for (uint32_t f = 0; f < COUNT; f++)
+          ASSERT_EQ(interleaved[OFFSET + f * channels + c], planes[c][f]) << channels << " channels";
+      }
+
+      std::vector<float> output(COUNT * channels + OFFSET);
+      functions.Interleave(planePtrs.data(), output.data() + OFFSET, channels, COUNT);
+      output[0] = interleaved[0];
+      EXPECT_EQ(interleaved, output) << channels << " channels";
+    }
+  }
+}
+
+TEST(TestAEKernels, DISABLED_Benchmark)
+{
+  // 7.1 at 48kHz, one second worth of samples per run
+  const unsigned int channels = 8;
+  const uint32_t frames = 48000;
+  const uint32_t count = frames * channels;
+  const int runs = 20;
+
+  std::vector<float> data = MakeSamples(count, 0.5f);
+  std::vector<float> add = MakeSamples(count, 0.5f);
+  std::vector<int16_t> s16(count);
+  std::vector<int32_t> s32(count);
+  std::vector<std::vector<float>> planes(channels, std::vector<float>(frames));
+  std::vector<float*> planePtrs;
+  for (auto& plane : planes)
+    planePtrs.push_back(plane.data());
+
+  for (CAEKernels::Kernel kernel : KERNELS)
+  {
+    if (!CAEKernels::IsSupported(kernel))
+      continue;
+    const CAEKernels::Functions& f = CAEKernels::Get(kernel);
+
+    auto measure = [&](const char* name, const std::function<void()>& func)
+    {
+      func();
+      const auto start = std::chrono::steady_clock::now();
+      for (int i = 0; i < runs; i++)
+        func();
+      const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+      printf("[ BENCHMARK] %-6s %-12s %.3f ns/sample\n", CAEKernels::GetKernelName(kernel), name,
+             elapsed.count() / (static_cast<double>(count) * runs));
+    };
+
+    measure("Mul", [&] { f.MulArray(data.data(), 1.0f, count); });
+    measure("MulAdd", [&] { f.MulAddArray(data.data(), add.data(), 0.0f, count); });
+    measure("Clamp", [&] { f.ClampArray(data.data(), count); });
+    measure("FloatToS16", [&] { f.FloatToS16(data.data(), s16.data(), count); });
+    measure("S16ToFloat", [&] { f.S16ToFloat(s16.data(), data.data(), count); });
+    measure("FloatToS32", [&] { f.FloatToS32(data.data(), s32.data(), count); });
+    measure("S32ToFloat", [&] { f.S32ToFloat(s32.data(), data.data(), count); });
+    measure("Deinterleave", [&] { f.Deinterleave(data.data(), planePtrs.data(), channels, frames); });
+    measure("Interleave", [&] { f.Interleave(planePtrs.data(), data.data(), channels, frames); });
+  }
+}
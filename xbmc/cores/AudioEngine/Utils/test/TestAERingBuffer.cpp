@@ -0,0 +1,274 @@
+/*
+ *  Copyright (C) 2010-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/AudioEngine/Utils/AERingBuffer.h"
+#include "utils/RingBuffer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+const unsigned int PLANES = 2;
+
+std::vector<unsigned char> MakeData(unsigned int size, unsigned char start)
+{
+  std::vector<unsigned char> data(size);
+  for (unsigned int i = 0; i < size; i++)
+    data[i] = static_cast<unsigned char>(start + i);
+  return data;
+}
+
+/*!
+ * \brief Run a writer and a reader thread, return the transfer rate in MB/s
+ */
+double Transfer(const std::function<void()>& writer, const std::function<void()>& reader, uint64_t bytes)
+{
+  const auto start = Clock::now();
+  std::thread thread(reader);
+  writer();
+  thread.join();
+  const std::chrono::duration<double> elapsed = Clock::now() - start;
+  return bytes / elapsed.count() / (1024 * 1024);
+}
+}
+
+TEST(TestAERingBuffer, ReadWrite)
+{
+  AERingBuffer buffer(100, PLANES);
+  EXPECT_EQ(100u, buffer.GetMaxSize());
+  EXPECT_EQ(100u, buffer.GetWriteSize());
+  EXPECT_EQ(0u, buffer.GetReadSize());
+
+  unsigned char out[100];
+  EXPECT_EQ(1, buffer.Read(out, 10, 0));
+
+  // wrap around the end of the buffer several times
+  for (unsigned int round = 0; round < 5; round++)
+  {
+    std::vector<unsigned char> data[PLANES] = { MakeData(70, round), MakeData(70, round + 100) };
+    for (unsigned int plane = 0; plane < PLANES; plane++)
+    {
+      EXPECT_EQ(0, buffer.Write(data[plane].data(), 70, plane));
+      // the data is published once all planes are written
+      EXPECT_EQ(plane + 1 == PLANES ? 70u : 0u, buffer.GetReadSize());
+    }
+    EXPECT_EQ(30u, buffer.GetWriteSize());
+    EXPECT_EQ(2, buffer.Write(data[0].data(), 31, 0));
+    EXPECT_EQ(3, buffer.Read(out, 71, 0));
+
+    for (unsigned int plane = 0; plane < PLANES; plane++)
+    {
+      EXPECT_EQ(0, buffer.Read(out, 70, plane));
+      EXPECT_TRUE(std::equal(data[plane].begin(), data[plane].end(), out));
+    }
+    EXPECT_EQ(0u, buffer.GetReadSize());
+  }
+}
+
+TEST(TestAERingBuffer, ReserveCommit)
+{
+  AERingBuffer buffer(100, PLANES);
+  unsigned char* planes[PLANES];
+
+  EXPECT_EQ(0u, buffer.ReserveRead(planes));
+  EXPECT_EQ(100u, buffer.ReserveWrite(planes));
+  for (unsigned int plane = 0; plane < PLANES; plane++)
+    memset(planes[plane], plane, 60);
+  buffer.CommitWrite(60);
+  EXPECT_EQ(60u, buffer.GetReadSize());
+
+  // the reserved regions end at the end of the buffer
+  EXPECT_EQ(40u, buffer.ReserveWrite(planes));
+  buffer.CommitWrite(0);
+
+  unsigned char out[60];
+  EXPECT_EQ(0, buffer.Read(out, 50, 0));
+  EXPECT_EQ(0, buffer.Read(out, 50, 1));
+  EXPECT_EQ(10u, buffer.ReserveRead(planes));
+  EXPECT_EQ(1, planes[1][9]);
+
+  // writing in place continues at the start of the buffer
+  EXPECT_EQ(40u, buffer.ReserveWrite(planes));
+  buffer.CommitWrite(40);
+  EXPECT_EQ(50u, buffer.ReserveWrite(planes));
+  for (unsigned int plane = 0; plane < PLANES; plane++)
+  {
+    for (unsigned int i = 0; i < 50; i++)
+      planes[plane][i] = static_cast<unsigned char>(i);
+  }
+  buffer.CommitWrite(50);
+  EXPECT_EQ(0u, buffer.GetWriteSize());
+  EXPECT_EQ(0u, buffer.ReserveWrite(planes));
+
+  EXPECT_EQ(50u, buffer.ReserveRead(planes));
+  buffer.CommitRead(50);
+  EXPECT_EQ(50u, buffer.ReserveRead(planes));
+  EXPECT_EQ(49, planes[0][49]);
+  EXPECT_EQ(49, planes[1][49]);
+  buffer.CommitRead(50);
+  EXPECT_EQ(0u, buffer.GetReadSize());
+  EXPECT_EQ(100u, buffer.GetWriteSize());
+}
+
+TEST(TestAERingBuffer, Threaded)
+{
+  // a buffer size that doesn't divide the transfer size to cover partial regions
+  AERingBuffer buffer(1000, PLANES);
+  const unsigned int total = 1 << 22;
+  bool ok = true;
+
+  auto writer = [&]() {
+    unsigned int written = 0;
+    while (written < total)
+    {
+      unsigned char* planes[PLANES];
+      unsigned int size = std::min(buffer.ReserveWrite(planes), total - written);
+      for (unsigned int i = 0; i < size; i++)
+      {
+        planes[0][i] = static_cast<unsigned char>(written + i);
+        planes[1][i] = static_cast<unsigned char>(~(written + i));
+      }
+      buffer.CommitWrite(size);
+      written += size;
+      if (size == 0)
+        std::this_thread::yield();
+    }
+  };
+  auto reader = [&]() {
+    unsigned int read = 0;
+    while (read < total)
+    {
+      unsigned char* planes[PLANES];
+      unsigned int size = buffer.ReserveRead(planes);
+      for (unsigned int i = 0; i < size; i++)
+      {
+        if (planes[0][i] != static_cast<unsigned char>(read + i) ||
+            planes[1][i] != static_cast<unsigned char>(~(read + i)))
+          ok = false;
+      }
+      buffer.CommitRead(size);
+      read += size;
+      if (size == 0)
+        std::this_thread::yield();
+    }
+  };
+
+  Transfer(writer, reader, total);
+  EXPECT_TRUE(ok);
+  EXPECT_EQ(0u, buffer.GetReadSize());
+}
+
+/*
+ * Compares the transfer rate between two threads of the locked CRingBuffer,
+ * the copying and the in place API of the lock-free AERingBuffer. Run with
+ * --gtest_also_run_disabled_tests.
+ */
+TEST(TestAERingBuffer, DISABLED_Benchmark)
+{
+  const unsigned int bufferSize = 64 * 1024;
+  const unsigned int chunk = 4096;
+  const uint64_t total = 1024ull * 1024 * 1024;
+  std::vector<unsigned char> src(chunk, 1);
+  std::vector<unsigned char> dest(chunk);
+
+  for (unsigned int size : { 256u, chunk })
+  {
+    CRingBuffer locked;
+    locked.Create(bufferSize);
+    const double lockedRate = Transfer(
+        [&]() {
+          for (uint64_t written = 0; written < total;)
+          {
+            if (locked.WriteData(reinterpret_cast<const char*>(src.data()), size))
+              written += size;
+            else
+              std::this_thread::yield();
+          }
+        },
+        [&]() {
+          for (uint64_t read = 0; read < total;)
+          {
+            if (locked.ReadData(reinterpret_cast<char*>(dest.data()), size))
+              read += size;
+            else
+              std::this_thread::yield();
+          }
+        },
+        total);
+
+    AERingBuffer copying(bufferSize);
+    const double copyingRate = Transfer(
+        [&]() {
+          for (uint64_t written = 0; written < total;)
+          {
+            if (copying.Write(src.data(), size) == 0)
+              written += size;
+            else
+              std::this_thread::yield();
+          }
+        },
+        [&]() {
+          for (uint64_t read = 0; read < total;)
+          {
+            if (copying.Read(dest.data(), size) == 0)
+              read += size;
+            else
+              std::this_thread::yield();
+          }
+        },
+        total);
+
+    // the writer produces into the buffer, the reader copies to its device buffer from it
+    AERingBuffer inPlace(bufferSize);
+    const double inPlaceRate = Transfer(
+        [&]() {
+          for (uint64_t written = 0; written < total;)
+          {
+            unsigned char* planes[1];
+            unsigned int space = std::min(inPlace.ReserveWrite(planes), size);
+            if (space == 0)
+            {
+              std::this_thread::yield();
+              continue;
+            }
+            memset(planes[0], 1, space);
+            inPlace.CommitWrite(space);
+            written += space;
+          }
+        },
+        [&]() {
+          for (uint64_t read = 0; read < total;)
+          {
+            unsigned char* planes[1];
+            unsigned int data = std::min(inPlace.ReserveRead(planes), size);
+            if (data == 0)
+            {
+              std::this_thread::yield();
+              continue;
+            }
+            memcpy(dest.data(), planes[0], data);
+            inPlace.CommitRead(data);
+            read += data;
+          }
+        },
+        total);
+
+    printf("[ BENCHMARK] %4u byte chunks: CRingBuffer %.0f MB/s, AERingBuffer copying %.0f MB/s, "
+           "in place %.0f MB/s\n",
+           size, lockedRate, copyingRate, inPlaceRate);
+  }
+}
@@ -48,6 +48,21 @@ void CDataCacheCore::Reset()
     m_contentInfo.m_chapters.clear();
     m_contentInfo.m_cutList.clear();
   }
+
+  {
+    CSingleLock lock(m_queueSection);
+
+    m_videoQueueInfo = {};
+    m_audioQueueInfo = {};
+  }
+
+  {
+    CSingleLock lock(m_decodeTimesSection);
+
+    m_videoDecodeTimes = {};
+  }
+
+  m_playbackTrace.Reset();
 }
 
 bool CDataCacheCore::HasAVInfoChanges()
@@ -244,6 +259,48 @@ int CDataCacheCore::GetAudioBitsPerSample()
   return m_playerAudioInfo.bitsPerSample;
 }
 
+void CDataCacheCore::SetVideoQueueInfo(const SPlayerQueueInfo &info)
+{
+  CSingleLock lock(m_queueSection);
+
+  m_videoQueueInfo = info;
+}
+
+CDataCacheCore::SPlayerQueueInfo CDataCacheCore::GetVideoQueueInfo()
+{
+  CSingleLock lock(m_queueSection);
+
+  return m_videoQueueInfo;
+}
+
+void CDataCacheCore::SetAudioQueueInfo(const SPlayerQueueInfo &info)
+{
+  CSingleLock lock(m_queueSection);
+
+  m_audioQueueInfo = info;
+}
+
+CDataCacheCore::SPlayerQueueInfo CDataCacheCore::GetAudioQueueInfo()
+{
+  CSingleLock lock(m_queueSection);
+
+  return m_audioQueueInfo;
+}
+
+void CDataCacheCore::SetVideoDecodeTimes(const SVideoDecodeTimes &times)
+{
+  CSingleLock lock(m_decodeTimesSection);
+
+  m_videoDecodeTimes = times;
+}
+
+CDataCacheCore::SVideoDecodeTimes CDataCacheCore::GetVideoDecodeTimes()
+{
+  CSingleLock lock(m_decodeTimesSection);
+
+  return m_videoDecodeTimes;
+}
+
 void CDataCacheCore::SetCutList(const std::vector<EDL::Cut>& cutList)
 {
   CSingleLock lock(m_contentSection);
@@ -12,6 +12,7 @@
 #include <string>
 #include <vector>
 
+#include "PlaybackTrace.h"
 #include "threads/CriticalSection.h"
 
 namespace EDL
@@ -22,6 +23,36 @@ namespace EDL
 class CDataCacheCore
 {
 public:
+  /*!
+   * \brief Fill state of a player's packet queue
+   */
+  struct SPlayerQueueInfo
+  {
+    int level = 0; //!< fill level in percent
+    unsigned int packets = 0; //!< number of queued demuxer packets
+    int dataSize = 0; //!< bytes queued
+    int dataSizeMax = 0; //!< byte watermark the queue is considered full at
+    int dataSizePeak = 0; //!< highest number of bytes queued since the last flush
+    double timeSize = 0.0; //!< seconds of content queued
+    double timeSizeMax = 0.0; //!< time watermark the queue is considered full at
+    double timeSizePeak = 0.0; //!< highest number of seconds queued since the last flush
+  };
+
+  /*!
+   * \brief Average time per frame spent in the stages of the software video decoder
+   *
+   * Filtering runs on its own thread, so decode and filter add up to more than
+   * the time per frame when the stages overlap.
+   */
+  struct SVideoDecodeTimes
+  {
+    double decode = 0.0; //!< ms in avcodec_receive_frame
+    double filter = 0.0; //!< ms in the deinterlace and scale filter graph
+    double filterWait = 0.0; //!< ms the decoder blocked on the filter stage
+    double postProc = 0.0; //!< ms in libpostproc
+    unsigned int frames = 0; //!< number of frames the averages are taken over
+  };
+
   CDataCacheCore();
   virtual ~CDataCacheCore();
   static CDataCacheCore& GetInstance();
@@ -59,6 +90,19 @@ public:
   void SetAudioBitsPerSample(int bitsPerSample);
   int GetAudioBitsPerSample();
 
+  // player queues
+  void SetVideoQueueInfo(const SPlayerQueueInfo &info);
+  SPlayerQueueInfo GetVideoQueueInfo();
+  void SetAudioQueueInfo(const SPlayerQueueInfo &info);
+  SPlayerQueueInfo GetAudioQueueInfo();
+
+  // video decoder stages
+  void SetVideoDecodeTimes(const SVideoDecodeTimes &times);
+  SVideoDecodeTimes GetVideoDecodeTimes();
+
+  // per frame timing, thread-safe by itself
+  CPlaybackTrace& GetPlaybackTrace() { return m_playbackTrace; }
+
   // content info
   void SetCutList(const std::vector<EDL::Cut>& cutList);
   std::vector<EDL::Cut> GetCutList() const;
@@ -152,6 +196,15 @@ protected:
     int bitsPerSample;
   } m_playerAudioInfo;
 
+  CCriticalSection m_queueSection;
+  SPlayerQueueInfo m_videoQueueInfo;
+  SPlayerQueueInfo m_audioQueueInfo;
+
+  CCriticalSection m_decodeTimesSection;
+  SVideoDecodeTimes m_videoDecodeTimes;
+
+  CPlaybackTrace m_playbackTrace;
+
   mutable CCriticalSection m_contentSection;
   struct SContentInfo
   {
@@ -0,0 +1,225 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "PlaybackTrace.h"
+#include "cores/VideoPlayer/Interface/Addon/TimingConstants.h"
+#include "filesystem/File.h"
+#include "threads/SingleLock.h"
+#include "utils/JSONVariantWriter.h"
+#include "utils/log.h"
+#include "utils/TimeUtils.h"
+#include "utils/Variant.h"
+
+#include <algorithm>
+
+namespace
+{
+// intervals longer than this are pauses or seeks, not stutter
+const double MAX_PRESENT_INTERVAL_MS = 1000.0;
+
+const double FIRST_BUCKET_LIMIT_MS = 0.125;
+}
+
+const unsigned int CPlaybackTrace::CAPACITY;
+const unsigned int CPlaybackTrace::BUCKETS;
+
+CPlaybackTrace::CPlaybackTrace() : m_frames(CAPACITY)
+{
+}
+
+void CPlaybackTrace::Reset()
+{
+  CSingleLock lock(m_section);
+  m_next = 0;
+  m_summary = Summary();
+  m_lastPresent = 0;
+}
+
+void CPlaybackTrace::AddFrame(const Frame& frame)
+{
+  CSingleLock lock(m_section);
+
+  m_frames[m_next % CAPACITY] = frame;
+  m_next++;
+
+  m_summary.frames++;
+  m_summary.drops[frame.drop]++;
+  AddTime(STAGE_DEMUX, frame.demux);
+  AddTime(STAGE_QUEUE, frame.queue);
+  AddTime(STAGE_DECODE, frame.decode);
+  AddTime(STAGE_RENDER_WAIT, frame.renderWait);
+}
+
+void CPlaybackTrace::AddPresent()
+{
+  const int64_t now = CurrentHostCounter();
+
+  CSingleLock lock(m_section);
+
+  if (m_lastPresent)
+  {
+    const double ms = static_cast<double>(now - m_lastPresent) * 1000.0 / CurrentHostFrequency();
+    if (ms < MAX_PRESENT_INTERVAL_MS)
+      AddTime(STAGE_PRESENT_INTERVAL, ms);
+  }
+  m_lastPresent = now;
+}
+
+void CPlaybackTrace::AddSkipped(unsigned int frames)
+{
+  CSingleLock lock(m_section);
+  m_summary.drops[DROP_SKIPPED] += frames;
+}
+
+void CPlaybackTrace::AddTime(Stage stage, double ms)
+{
+  m_summary.histograms[stage][GetBucket(ms)]++;
+  m_summary.totalMs[stage] += ms;
+  m_summary.maxMs[stage] = std::max(m_summary.maxMs[stage], ms);
+}
+
+CPlaybackTrace::Summary CPlaybackTrace::GetSummary() const
+{
+  CSingleLock lock(m_section);
+  return m_summary;
+}
+
+std::vector<CPlaybackTrace::Frame> CPlaybackTrace::GetFrames(unsigned int maxFrames) const
+{
+  CSingleLock lock(m_section);
+
+  const size_t count = std::min<size_t>(std::min<size_t>(maxFrames, CAPACITY), m_next);
+  std::vector<Frame> frames;
+  frames.reserve(count);
+  for (size_t i = m_next - count; i < m_next; i++)
+    frames.push_back(m_frames[i % CAPACITY]);
+  return frames;
+}
+
+void CPlaybackTrace::Serialize(CVariant& value, unsigned int maxFrames) const
+{
+  const Summary summary = GetSummary();
+
+  value["frames"] = summary.frames;
+  value["shown"] = summary.drops[DROP_NONE];
+  value["dropped"] = CVariant(CVariant::VariantTypeObject);
+  for (unsigned int cause = DROP_NONE + 1; cause < DROP_CAUSES; cause++)
+    value["dropped"][GetDropCauseName(static_cast<DropCause>(cause))] = summary.drops[cause];
+
+  value["bucketlimits"] = CVariant(CVariant::VariantTypeArray);
+  for (unsigned int bucket = 0; bucket + 1 < BUCKETS; bucket++)
+    value["bucketlimits"].push_back(GetBucketLimit(bucket));
+
+  value["stages"] = CVariant(CVariant::VariantTypeObject);
+  for (unsigned int stage = 0; stage < STAGES; stage++)
+  {
+    CVariant histogram(CVariant::VariantTypeArray);
+    uint64_t count = 0;
+    for (unsigned int bucket = 0; bucket < BUCKETS; bucket++)
+    {
+      histogram.push_back(summary.histograms[stage][bucket]);
+      count += summary.histograms[stage][bucket];
+    }
+
+    CVariant& entry = value["stages"][GetStageName(static_cast<Stage>(stage))];
+    entry["histogram"] = histogram;
+    entry["averagems"] = count ? summary.totalMs[stage] / count : 0.0;
+    entry["maxms"] = summary.maxMs[stage];
+  }
+
+  value["trace"] = CVariant(CVariant::VariantTypeArray);
+  for (const Frame& frame : GetFrames(maxFrames))
+  {
+    CVariant entry;
+    entry["pts"] = frame.pts / DVD_TIME_BASE;
+    entry["demux"] = frame.demux;
+    entry["queue"] = frame.queue;
+    entry["decode"] = frame.decode;
+    entry["renderwait"] = frame.renderWait;
+    entry["drop"] = GetDropCauseName(frame.drop);
+    value["trace"].push_back(std::move(entry));
+  }
+}
+
+bool CPlaybackTrace::Dump(const std::string& file) const
+{
+  CVariant value;
+  Serialize(value, CAPACITY);
+
+  std::string json;
+  if (!CJSONVariantWriter::Write(value, json, false))
+    return false;
+
+  XFILE::CFile out;
+  if (!out.OpenForWrite(file, true) ||
+      out.Write(json.c_str(), json.size()) != static_cast<ssize_t>(json.size()))
+  {
+    CLog::Log(LOGERROR, "CPlaybackTrace::Dump - failed to write %s", file.c_str());
+    return false;
+  }
+
+  CLog::Log(LOGNOTICE, "CPlaybackTrace::Dump - wrote %s", file.c_str());
+  return true;
+}
+
+double CPlaybackTrace::GetBucketLimit(unsigned int bucket)
+{
+  return FIRST_BUCKET_LIMIT_MS * (1 << bucket);
+}
+
+unsigned int CPlaybackTrace::GetBucket(double ms)
+{
+  for (unsigned int bucket = 0; bucket + 1 < BUCKETS; bucket++)
+  {
+    if (ms < GetBucketLimit(bucket))
+      return bucket;
+  }
+  return BUCKETS - 1;
+}
+
+const char* CPlaybackTrace::GetDropCauseName(DropCause cause)
+{
+  switch (cause)
+  {
+    case DROP_NONE:
+      return "none";
+    case DROP_PLAYER:
+      return "player";
+    case DROP_LATE:
+      return "late";
+    case DROP_DECODER:
+      return "decoder";
+    case DROP_SPEED:
+      return "speed";
+    case DROP_RENDERER:
+      return "renderer";
+    case DROP_SKIPPED:
+      return "skipped";
+    default:
+      return "unknown";
+  }
+}
+
+const char* CPlaybackTrace::GetStageName(Stage stage)
+{
+  switch (stage)
+  {
+    case STAGE_DEMUX:
+      return "demux";
+    case STAGE_QUEUE:
+      return "queue";
+    case STAGE_DECODE:
+      return "decode";
+    case STAGE_RENDER_WAIT:
+      return "renderwait";
+    case STAGE_PRESENT_INTERVAL:
+      return "presentinterval";
+    default:
+      return "unknown";
+  }
+}
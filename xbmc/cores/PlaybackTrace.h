@@ -0,0 +1,129 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "threads/CriticalSection.h"
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+class CVariant;
+
+/*!
+ * \brief Per frame timing of video playback
+ *
+ * The video player adds a record for every picture that leaves the decoder,
+ * with the time its packet spent in the demuxer, in the message queue, in
+ * the decoder and waiting for a render buffer, and why it was dropped if it
+ * was. The records are kept in a ring of the last CAPACITY frames, while the
+ * histograms and drop counters cover the whole playback. The renderer adds
+ * the interval between two frames it presented and the frames it skipped
+ * because they were late.
+ *
+ * Adding a frame takes a lock and a copy, so it can stay enabled all the
+ * time. The trace is reset when a new player is created.
+ */
+class CPlaybackTrace
+{
+public:
+  static const unsigned int CAPACITY = 4096;
+  static const unsigned int BUCKETS = 16; //!< bucket i counts times below GetBucketLimit(i)
+
+  enum DropCause
+  {
+    DROP_NONE = 0,
+    DROP_PLAYER, //!< the player dropped the packet, e.g. while syncing after a seek
+    DROP_LATE, //!< the player asked the decoder to drop, video was too late
+    DROP_DECODER, //!< the decoder dropped the picture itself
+    DROP_SPEED, //!< not shown while rewinding
+    DROP_RENDERER, //!< the renderer had no buffer for the picture
+    DROP_SKIPPED, //!< the renderer skipped the queued picture because it was late
+    DROP_CAUSES
+  };
+
+  enum Stage
+  {
+    STAGE_DEMUX = 0,
+    STAGE_QUEUE,
+    STAGE_DECODE,
+    STAGE_RENDER_WAIT,
+    STAGE_PRESENT_INTERVAL, //!< time between two frames the renderer presented
+    STAGES
+  };
+
+  struct Frame
+  {
+    double pts = 0.0; //!< presentation time stamp in DVD_TIME_BASE units
+    float demux = 0.0f; //!< ms the demuxer took to read the packet
+    float queue = 0.0f; //!< ms the packet waited in the message queue of the video player
+    float decode = 0.0f; //!< ms in the decoder until the picture came out
+    float renderWait = 0.0f; //!< ms the video player waited for a free render buffer
+    DropCause drop = DROP_NONE;
+  };
+
+  struct Summary
+  {
+    uint64_t frames = 0; //!< frames added since the reset
+    uint64_t drops[DROP_CAUSES] = {}; //!< frames per drop cause, DROP_NONE counts the shown ones
+    uint64_t histograms[STAGES][BUCKETS] = {};
+    double totalMs[STAGES] = {};
+    double maxMs[STAGES] = {};
+  };
+
+  CPlaybackTrace();
+
+  void Reset();
+
+  void AddFrame(const Frame& frame);
+
+  /*!
+   * \brief The renderer flipped to a new frame
+   */
+  void AddPresent();
+
+  /*!
+   * \brief The renderer skipped late frames in its queue
+   */
+  void AddSkipped(unsigned int frames);
+
+  Summary GetSummary() const;
+
+  /*!
+   * \brief Get the last frames, oldest first
+   */
+  std::vector<Frame> GetFrames(unsigned int maxFrames = CAPACITY) const;
+
+  /*!
+   * \brief Summary, histograms and the last maxFrames frames as object
+   */
+  void Serialize(CVariant& value, unsigned int maxFrames) const;
+
+  /*!
+   * \brief Write everything Serialize() gives with all frames as JSON file
+   */
+  bool Dump(const std::string& file) const;
+
+  /*!
+   * \brief Upper bound of a histogram bucket in ms, the last bucket has none
+   */
+  static double GetBucketLimit(unsigned int bucket);
+  static unsigned int GetBucket(double ms);
+  static const char* GetDropCauseName(DropCause cause);
+  static const char* GetStageName(Stage stage);
+
+private:
+  void AddTime(Stage stage, double ms);
+
+  mutable CCriticalSection m_section;
+  std::vector<Frame> m_frames;
+  size_t m_next = 0; //!< ring position the next frame goes to
+  Summary m_summary;
+  int64_t m_lastPresent = 0;
+};
@@ -9,7 +9,7 @@
 #include "ReversiblePlayback.h"
 #include "cores/RetroPlayer/savestates/ISavestate.h"
 #include "cores/RetroPlayer/savestates/SavestateDatabase.h"
-#include "cores/RetroPlayer/streams/memory/DeltaPairMemoryStream.h"
+#include "cores/RetroPlayer/streams/memory/RunLengthDeltaMemoryStream.h"
 #include "games/addons/GameClient.h"
 #include "games/GameServices.h"
 #include "games/GameSettings.h"
@@ -300,7 +300,7 @@ void CReversiblePlayback::UpdateMemoryStream()
 
     if (!m_memoryStream)
     {
-      m_memoryStream.reset(new CDeltaPairMemoryStream);
+      m_memoryStream.reset(new CRunLengthDeltaMemoryStream);
       m_memoryStream->Init(m_gameClient->SerializeSize(), frameCount);
     }
 
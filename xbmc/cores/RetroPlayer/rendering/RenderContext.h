@@ -51,6 +51,7 @@ namespace RETRO
     void GetViewPort(CRect &viewPort);
     void SetScissors(const CRect &rect);
     void ApplyStateBlock();
+    void FlushBatch();
     bool IsExtSupported(const char* extension);
 
     // OpenGL(ES) rendering functions
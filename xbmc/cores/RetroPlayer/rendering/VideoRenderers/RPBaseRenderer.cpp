@@ -99,6 +99,10 @@ void CRPBaseRenderer::RenderFrame(bool clear, uint8_t alpha)
 
   ManageRenderArea(*m_renderBuffer);
 
+  // The renderers set up textures and blending before their shader, draw what
+  // the GUI holds back first
+  m_context.FlushBatch();
+
   RenderInternal(clear, alpha);
   PostRender();
 
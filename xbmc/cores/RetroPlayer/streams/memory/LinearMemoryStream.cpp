@@ -64,12 +64,12 @@ uint8_t* CLinearMemoryStream::BeginFrame()
   if (!m_bHasCurrentFrame)
   {
     if (!m_currentFrame)
-      m_currentFrame.reset(new uint32_t[m_paddedFrameSize]);
+      m_currentFrame.reset(new uint32_t[m_paddedFrameSize / sizeof(uint32_t)]);
     return reinterpret_cast<uint8_t*>(m_currentFrame.get());
   }
 
   if (!m_nextFrame)
-    m_nextFrame.reset(new uint32_t[m_paddedFrameSize]);
+    m_nextFrame.reset(new uint32_t[m_paddedFrameSize / sizeof(uint32_t)]);
   return reinterpret_cast<uint8_t*>(m_nextFrame.get());
 }
 
@@ -0,0 +1,364 @@
+/*
+ *  Copyright (C) 2016-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "RunLengthDelta.h"
+#include "utils/CPUInfo.h"
+
+#include <algorithm>
+#include <string.h>
+
+#if defined(HAVE_SSE2) && defined(__SSE2__)
+#include <emmintrin.h>
+#define DELTA_HAS_SSE2
+#endif
+
+// AVX2 is detected at runtime, the rest of the build doesn't need to enable it
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define DELTA_HAS_AVX2
+#define DELTA_TARGET_AVX2 __attribute__((target("avx2")))
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <immintrin.h>
+#define DELTA_HAS_AVX2
+#define DELTA_TARGET_AVX2
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+using namespace KODI;
+using namespace RETRO;
+
+const size_t CRunLengthDelta::BLOCK_SIZE;
+
+namespace
+{
+  const size_t MAX_VARINT_SIZE = 10;
+  const uint32_t FULL_MASK = 0xFFFFFFFF;
+
+  /*!
+   * \brief Find the first block that differs between current and next
+   *
+   * \param block The block to start at
+   * \param blockCount Number of complete blocks in the frames
+   * \param[out] mask The bytes that changed in the returned block
+   *
+   * \return The index of the changed block, or blockCount if there is none
+   */
+  using FindChangedBlockFunc = size_t (*)(const uint8_t* current, const uint8_t* next, size_t block, size_t blockCount, uint32_t& mask);
+
+  inline unsigned int CountTrailingZeros(uint32_t value)
+  {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, value);
+    return static_cast<unsigned int>(index);
+#else
+    return static_cast<unsigned int>(__builtin_ctz(value));
+#endif
+  }
+
+  inline uint32_t GetChangedBytes(const uint8_t* current, const uint8_t* next, size_t size)
+  {
+    uint32_t mask = 0;
+    for (size_t i = 0; i < size; i++)
+    {
+      if (current[i] != next[i])
+        mask |= 1u << i;
+    }
+    return mask;
+  }
+
+  size_t FindChangedBlockScalar(const uint8_t* current, const uint8_t* next, size_t block, size_t blockCount, uint32_t& mask)
+  {
+    for (; block < blockCount; block++)
+    {
+      const size_t offset = block * CRunLengthDelta::BLOCK_SIZE;
+
+      uint64_t a[CRunLengthDelta::BLOCK_SIZE / sizeof(uint64_t)];
+      uint64_t b[CRunLengthDelta::BLOCK_SIZE / sizeof(uint64_t)];
+      memcpy(a, current + offset, sizeof(a));
+      memcpy(b, next + offset, sizeof(b));
+
+      if (((a[0] ^ b[0]) | (a[1] ^ b[1]) | (a[2] ^ b[2]) | (a[3] ^ b[3])) != 0)
+      {
+        mask = GetChangedBytes(current + offset, next + offset, CRunLengthDelta::BLOCK_SIZE);
+        return block;
+      }
+    }
+    return blockCount;
+  }
+
+#ifdef DELTA_HAS_SSE2
+  size_t FindChangedBlockSSE2(const uint8_t* current, const uint8_t* next, size_t block, size_t blockCount, uint32_t& mask)
+  {
+    for (; block < blockCount; block++)
+    {
+      const size_t offset = block * CRunLengthDelta::BLOCK_SIZE;
+      const __m128i* a = reinterpret_cast<const __m128i*>(current + offset);
+      const __m128i* b = reinterpret_cast<const __m128i*>(next + offset);
+
+      const uint32_t equalLow = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(a), _mm_loadu_si128(b)));
+      const uint32_t equalHigh = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(a + 1), _mm_loadu_si128(b + 1)));
+      const uint32_t equal = equalLow | (equalHigh << 16);
+      if (equal != FULL_MASK)
+      {
+        mask = ~equal;
+        return block;
+      }
+    }
+    return blockCount;
+  }
+#endif
+
+#ifdef DELTA_HAS_AVX2
+  DELTA_TARGET_AVX2
+  size_t FindChangedBlockAVX2(const uint8_t* current, const uint8_t* next, size_t block, size_t blockCount, uint32_t& mask)
+  {
+    // Test two blocks at once, unchanged blocks are by far the common case
+    for (; block + 1 < blockCount; block += 2)
+    {
+      const size_t offset = block * CRunLengthDelta::BLOCK_SIZE;
+      const __m256i* a = reinterpret_cast<const __m256i*>(current + offset);
+      const __m256i* b = reinterpret_cast<const __m256i*>(next + offset);
+
+      const __m256i diff0 = _mm256_xor_si256(_mm256_loadu_si256(a), _mm256_loadu_si256(b));
+      const __m256i diff1 = _mm256_xor_si256(_mm256_loadu_si256(a + 1), _mm256_loadu_si256(b + 1));
+      const __m256i diff = _mm256_or_si256(diff0, diff1);
+      if (!_mm256_testz_si256(diff, diff))
+      {
+        const __m256i zero = _mm256_setzero_si256();
+        const uint32_t equal0 = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(diff0, zero)));
+        if (equal0 != FULL_MASK)
+        {
+          mask = ~equal0;
+          return block;
+        }
+        const uint32_t equal1 = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(diff1, zero)));
+        mask = ~equal1;
+        return block + 1;
+      }
+    }
+
+    if (block < blockCount)
+    {
+      const size_t offset = block * CRunLengthDelta::BLOCK_SIZE;
+      const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(current + offset));
+      const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(next + offset));
+      const uint32_t equal = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, b)));
+      if (equal != FULL_MASK)
+      {
+        mask = ~equal;
+        return block;
+      }
+    }
+
+    return blockCount;
+  }
+#endif
+
+  FindChangedBlockFunc GetFindChangedBlock(CRunLengthDelta::Kernel kernel)
+  {
+    switch (kernel)
+    {
+#ifdef DELTA_HAS_AVX2
+    case CRunLengthDelta::Kernel::AVX2:
+      return FindChangedBlockAVX2;
+#endif
+#ifdef DELTA_HAS_SSE2
+    case CRunLengthDelta::Kernel::SSE2:
+      return FindChangedBlockSSE2;
+#endif
+    default:
+      break;
+    }
+    return FindChangedBlockScalar;
+  }
+
+  inline uint8_t* WriteVarint(uint8_t* out, size_t value)
+  {
+    while (value >= 0x80)
+    {
+      *out++ = static_cast<uint8_t>(value | 0x80);
+      value >>= 7;
+    }
+    *out++ = static_cast<uint8_t>(value);
+    return out;
+  }
+
+  inline bool ReadVarint(const uint8_t*& in, const uint8_t* end, size_t& value)
+  {
+    value = 0;
+    for (unsigned int shift = 0; in < end && shift < 64; shift += 7)
+    {
+      const uint8_t byte = *in++;
+      value |= static_cast<size_t>(byte & 0x7F) << shift;
+      if (!(byte & 0x80))
+        return true;
+    }
+    return false;
+  }
+
+  inline uint8_t* WriteBlock(uint8_t* out, size_t skipped, uint32_t mask, const uint8_t* current, const uint8_t* next)
+  {
+    out = WriteVarint(out, skipped);
+    out[0] = static_cast<uint8_t>(mask);
+    out[1] = static_cast<uint8_t>(mask >> 8);
+    out[2] = static_cast<uint8_t>(mask >> 16);
+    out[3] = static_cast<uint8_t>(mask >> 24);
+    out += 4;
+
+    if (mask == FULL_MASK)
+    {
+      for (size_t i = 0; i < CRunLengthDelta::BLOCK_SIZE; i++)
+        out[i] = current[i] ^ next[i];
+      return out + CRunLengthDelta::BLOCK_SIZE;
+    }
+
+    while (mask != 0)
+    {
+      const unsigned int i = CountTrailingZeros(mask);
+      *out++ = current[i] ^ next[i];
+      mask &= mask - 1;
+    }
+    return out;
+  }
+}
+
+bool CRunLengthDelta::IsSupported(Kernel kernel)
+{
+  switch (kernel)
+  {
+  case Kernel::SCALAR:
+    return true;
+#ifdef DELTA_HAS_SSE2
+  case Kernel::SSE2:
+    return (g_cpuInfo.GetCPUFeatures() & CPU_FEATURE_SSE2) != 0;
+#endif
+#ifdef DELTA_HAS_AVX2
+  case Kernel::AVX2:
+    return (g_cpuInfo.GetCPUFeatures() & CPU_FEATURE_AVX2) != 0;
+#endif
+  default:
+    break;
+  }
+  return false;
+}
+
+CRunLengthDelta::Kernel CRunLengthDelta::GetBestKernel()
+{
+  static const Kernel bestKernel = IsSupported(Kernel::AVX2) ? Kernel::AVX2 :
+                                   IsSupported(Kernel::SSE2) ? Kernel::SSE2 :
+                                   Kernel::SCALAR;
+  return bestKernel;
+}
+
+size_t CRunLengthDelta::GetMaxEncodedSize(size_t frameSize)
+{
+  // Every block, including a partial one at the end, may be stored completely
+  const size_t blockCount = (frameSize + BLOCK_SIZE - 1) / BLOCK_SIZE;
+  return blockCount * (1 + 4 + BLOCK_SIZE) + MAX_VARINT_SIZE;
+}
+
+size_t CRunLengthDelta::Encode(const uint8_t* current, const uint8_t* next, size_t frameSize, uint8_t* delta)
+{
+  return Encode(current, next, frameSize, delta, GetBestKernel());
+}
+
+size_t CRunLengthDelta::Encode(const uint8_t* current, const uint8_t* next, size_t frameSize, uint8_t* delta, Kernel kernel)
+{
+  const FindChangedBlockFunc findChangedBlock = GetFindChangedBlock(kernel);
+  const size_t blockCount = frameSize / BLOCK_SIZE;
+
+  uint8_t* out = delta;
+  size_t block = 0;
+
+  while (true)
+  {
+    uint32_t mask = 0;
+    const size_t changedBlock = findChangedBlock(current, next, block, blockCount, mask);
+    if (changedBlock >= blockCount)
+      break;
+
+    const size_t offset = changedBlock * BLOCK_SIZE;
+    out = WriteBlock(out, changedBlock - block, mask, current + offset, next + offset);
+    block = changedBlock + 1;
+  }
+
+  // Partial block at the end of the frame
+  const size_t tailSize = frameSize % BLOCK_SIZE;
+  if (tailSize > 0)
+  {
+    const size_t offset = blockCount * BLOCK_SIZE;
+    const uint32_t mask = GetChangedBytes(current + offset, next + offset, tailSize);
+    if (mask != 0)
+      out = WriteBlock(out, blockCount - block, mask, current + offset, next + offset);
+  }
+
+  return static_cast<size_t>(out - delta);
+}
+
+bool CRunLengthDelta::Apply(const uint8_t* delta, size_t deltaSize, uint8_t* frame, size_t frameSize)
+{
+  const uint8_t* in = delta;
+  const uint8_t* const end = delta + deltaSize;
+  size_t offset = 0;
+
+  while (in < end)
+  {
+    size_t skipped;
+    if (!ReadVarint(in, end, skipped) || end - in < 4)
+      return false;
+
+    if (skipped > (frameSize - offset) / BLOCK_SIZE)
+      return false;
+    offset += skipped * BLOCK_SIZE;
+
+    uint32_t mask = static_cast<uint32_t>(in[0]) |
+                    static_cast<uint32_t>(in[1]) << 8 |
+                    static_cast<uint32_t>(in[2]) << 16 |
+                    static_cast<uint32_t>(in[3]) << 24;
+    in += 4;
+
+    const size_t blockSize = std::min(frameSize - offset, BLOCK_SIZE);
+    if (blockSize == 0 || (blockSize < BLOCK_SIZE && (mask >> blockSize) != 0))
+      return false;
+
+    uint8_t* block = frame + offset;
+
+    if (mask == FULL_MASK)
+    {
+      if (static_cast<size_t>(end - in) < BLOCK_SIZE)
+        return false;
+
+      uint64_t words[BLOCK_SIZE / sizeof(uint64_t)];
+      uint64_t changes[BLOCK_SIZE / sizeof(uint64_t)];
+      memcpy(words, block, BLOCK_SIZE);
+      memcpy(changes, in, BLOCK_SIZE);
+      for (size_t i = 0; i < BLOCK_SIZE / sizeof(uint64_t); i++)
+        words[i] ^= changes[i];
+      memcpy(block, words, BLOCK_SIZE);
+      in += BLOCK_SIZE;
+    }
+    else
+    {
+      while (mask != 0)
+      {
+        if (in >= end)
+          return false;
+        block[CountTrailingZeros(mask)] ^= *in++;
+        mask &= mask - 1;
+      }
+    }
+
+    offset += blockSize;
+  }
+
+  return true;
+}
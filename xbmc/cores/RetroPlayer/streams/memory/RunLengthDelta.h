@@ -0,0 +1,81 @@
+/*
+ *  Copyright (C) 2016-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace KODI
+{
+namespace RETRO
+{
+  /*!
+   * \brief Run-length encoded XOR delta between two frames of equal size
+   *
+   * The frames are compared in blocks of BLOCK_SIZE bytes. Runs of unchanged
+   * blocks are only stored as their length. A changed block is stored as a
+   * bit mask of its changed bytes, followed by the XOR of just these bytes.
+   *
+   * Savestates usually change in a few scattered bytes per frame (counters,
+   * positions, RNG state), so most blocks are skipped and most changed blocks
+   * hold only a few bytes. Finding the changed blocks is vectorized where
+   * supported by the CPU.
+   */
+  class CRunLengthDelta
+  {
+  public:
+    static const size_t BLOCK_SIZE = 32;
+
+    enum class Kernel
+    {
+      SCALAR,
+      SSE2,
+      AVX2,
+    };
+
+    /*!
+     * \brief Check if the kernel can be used on this CPU
+     */
+    static bool IsSupported(Kernel kernel);
+
+    /*!
+     * \brief Get the fastest kernel supported by this CPU
+     */
+    static Kernel GetBestKernel();
+
+    /*!
+     * \brief Get the size a delta between frames of the given size can grow to
+     */
+    static size_t GetMaxEncodedSize(size_t frameSize);
+
+    /*!
+     * \brief Encode the difference between two frames
+     *
+     * \param current The frame being replaced
+     * \param next The frame replacing current
+     * \param frameSize The size of both frames
+     * \param delta Buffer of at least GetMaxEncodedSize(frameSize) bytes
+     *
+     * \return The number of bytes written to delta, 0 if the frames are equal
+     */
+    static size_t Encode(const uint8_t* current, const uint8_t* next, size_t frameSize, uint8_t* delta);
+    static size_t Encode(const uint8_t* current, const uint8_t* next, size_t frameSize, uint8_t* delta, Kernel kernel);
+
+    /*!
+     * \brief Apply a delta to a frame
+     *
+     * As XOR is its own inverse, applying the delta to either of the encoded
+     * frames yields the other one.
+     *
+     * \return False if the delta doesn't fit the frame size
+     */
+    static bool Apply(const uint8_t* delta, size_t deltaSize, uint8_t* frame, size_t frameSize);
+  };
+}
+}
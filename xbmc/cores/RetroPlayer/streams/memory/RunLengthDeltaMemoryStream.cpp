@@ -0,0 +1,96 @@
+/*
+ *  Copyright (C) 2016-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "RunLengthDeltaMemoryStream.h"
+#include "RunLengthDelta.h"
+#include "utils/log.h"
+
+using namespace KODI;
+using namespace RETRO;
+
+void CRunLengthDeltaMemoryStream::Reset()
+{
+  CLinearMemoryStream::Reset();
+
+  m_rewindBuffer.clear();
+  m_encodeBuffer.clear();
+  m_encodeBuffer.shrink_to_fit();
+  m_deltaSize = 0;
+}
+
+void CRunLengthDeltaMemoryStream::SubmitFrameInternal()
+{
+  m_rewindBuffer.push_back(MemoryFrame());
+  MemoryFrame& frame = m_rewindBuffer.back();
+
+  // Record frame history
+  frame.frameHistoryCount = m_currentFrameHistory++;
+
+  const size_t maxSize = CRunLengthDelta::GetMaxEncodedSize(FrameSize());
+  if (m_encodeBuffer.size() < maxSize)
+    m_encodeBuffer.resize(maxSize);
+
+  const size_t deltaSize = CRunLengthDelta::Encode(reinterpret_cast<const uint8_t*>(m_currentFrame.get()),
+                                                   reinterpret_cast<const uint8_t*>(m_nextFrame.get()),
+                                                   FrameSize(), m_encodeBuffer.data());
+
+  frame.delta.assign(m_encodeBuffer.begin(), m_encodeBuffer.begin() + deltaSize);
+  m_deltaSize += deltaSize;
+
+  // Delta is generated, bring the new frame forward (m_nextFrame is now disposable)
+  std::swap(m_currentFrame, m_nextFrame);
+
+  m_bHasNextFrame = false;
+
+  if (PastFramesAvailable() + 1 > MaxFrameCount())
+    CullPastFrames(1);
+}
+
+uint64_t CRunLengthDeltaMemoryStream::PastFramesAvailable() const
+{
+  return static_cast<uint64_t>(m_rewindBuffer.size());
+}
+
+uint64_t CRunLengthDeltaMemoryStream::RewindFrames(uint64_t frameCount)
+{
+  uint64_t rewound;
+
+  for (rewound = 0; rewound < frameCount; rewound++)
+  {
+    if (m_rewindBuffer.empty())
+      break;
+
+    const MemoryFrame& frame = m_rewindBuffer.back();
+
+    if (!CRunLengthDelta::Apply(frame.delta.data(), frame.delta.size(),
+                                reinterpret_cast<uint8_t*>(m_currentFrame.get()), FrameSize()))
+      CLog::Log(LOGERROR, "CRunLengthDeltaMemoryStream: Invalid delta for frame %llu", static_cast<unsigned long long>(frame.frameHistoryCount));
+
+    // Restore frame history
+    m_currentFrameHistory = frame.frameHistoryCount;
+
+    m_deltaSize -= frame.delta.size();
+    m_rewindBuffer.pop_back();
+  }
+
+  return rewound;
+}
+
+void CRunLengthDeltaMemoryStream::CullPastFrames(uint64_t frameCount)
+{
+  for (uint64_t removedCount = 0; removedCount < frameCount; removedCount++)
+  {
+    if (m_rewindBuffer.empty())
+    {
+      CLog::Log(LOGDEBUG, "CRunLengthDeltaMemoryStream: Tried to cull %llu frames too many. Check your math!", static_cast<unsigned long long>(frameCount - removedCount));
+      break;
+    }
+    m_deltaSize -= m_rewindBuffer.front().delta.size();
+    m_rewindBuffer.pop_front();
+  }
+}
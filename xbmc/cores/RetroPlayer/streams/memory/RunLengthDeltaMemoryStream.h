@@ -0,0 +1,63 @@
+/*
+ *  Copyright (C) 2016-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "LinearMemoryStream.h"
+
+#include <deque>
+#include <vector>
+
+namespace KODI
+{
+namespace RETRO
+{
+  /*!
+   * \brief Implementation of a linear memory stream using run-length encoded
+   *        XOR deltas
+   *
+   * \sa CRunLengthDelta
+   */
+  class CRunLengthDeltaMemoryStream : public CLinearMemoryStream
+  {
+  public:
+    CRunLengthDeltaMemoryStream() = default;
+
+    virtual ~CRunLengthDeltaMemoryStream() = default;
+
+    // implementation of IMemoryStream via CLinearMemoryStream
+    virtual void Reset() override;
+    virtual uint64_t PastFramesAvailable() const override;
+    virtual uint64_t RewindFrames(uint64_t frameCount) override;
+
+    /*!
+     * \brief Get the number of bytes used by the deltas of the past frames
+     */
+    uint64_t DeltaSize() const { return m_deltaSize; }
+
+  protected:
+    // implementation of CLinearMemoryStream
+    virtual void SubmitFrameInternal() override;
+    virtual void CullPastFrames(uint64_t frameCount) override;
+
+    struct MemoryFrame
+    {
+      std::vector<uint8_t> delta;
+      uint64_t frameHistoryCount;
+    };
+
+    // Use std::deque here to achieve amortized O(1) on pop/push to front and back
+    std::deque<MemoryFrame> m_rewindBuffer;
+
+    // Deltas are encoded here first, so frames only keep the bytes they need
+    std::vector<uint8_t> m_encodeBuffer;
+
+    uint64_t m_deltaSize = 0;
+  };
+}
+}
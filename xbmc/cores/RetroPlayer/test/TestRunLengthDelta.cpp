@@ -0,0 +1,302 @@
+/*
+ *  Copyright (C) 2016-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/RetroPlayer/streams/memory/DeltaPairMemoryStream.h"
+#include "cores/RetroPlayer/streams/memory/RunLengthDelta.h"
+#include "cores/RetroPlayer/streams/memory/RunLengthDeltaMemoryStream.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <stdint.h>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace KODI;
+using namespace RETRO;
+
+namespace
+{
+const CRunLengthDelta::Kernel KERNELS[] = {
+  CRunLengthDelta::Kernel::SCALAR,
+  CRunLengthDelta::Kernel::SSE2,
+  CRunLengthDelta::Kernel::AVX2,
+};
+
+const char* GetKernelName(CRunLengthDelta::Kernel kernel)
+{
+  switch (kernel)
+  {
+  case CRunLengthDelta::Kernel::SSE2:
+    return "SSE2";
+  case CRunLengthDelta::Kernel::AVX2:
+    return "AVX2";
+  default:
+    break;
+  }
+  return "scalar";
+}
+
+/*!
+ * Emulates the next frame of a savestate: a few hundred counters and
+ * variables change by small amounts, and a contiguous buffer (e.g. audio or
+ * a DMA area) is rewritten completely.
+ */
+void AdvanceState(std::vector<uint8_t>& state, std::mt19937& rng)
+{
+  std::uniform_int_distribution<size_t> position(0, state.size() - 1);
+  for (unsigned int i = 0; i < 500; i++)
+    state[position(rng)] += 1;
+
+  const size_t bufferSize = std::min<size_t>(16 * 1024, state.size() / 4);
+  const size_t bufferStart = state.size() / 2;
+  for (size_t i = 0; i < bufferSize; i++)
+    state[bufferStart + i] = static_cast<uint8_t>(rng());
+}
+
+void ExpectRoundTrip(const std::vector<uint8_t>& current, const std::vector<uint8_t>& next)
+{
+  std::vector<uint8_t> reference;
+
+  for (CRunLengthDelta::Kernel kernel : KERNELS)
+  {
+    if (!CRunLengthDelta::IsSupported(kernel))
+      continue;
+
+    std::vector<uint8_t> delta(CRunLengthDelta::GetMaxEncodedSize(current.size()));
+    delta.resize(CRunLengthDelta::Encode(current.data(), next.data(), current.size(), delta.data(), kernel));
+
+    // All kernels produce the same stream
+    if (reference.empty())
+      reference = delta;
+    else
+      EXPECT_EQ(reference, delta) << GetKernelName(kernel);
+
+    std::vector<uint8_t> frame = current;
+    ASSERT_TRUE(CRunLengthDelta::Apply(delta.data(), delta.size(), frame.data(), frame.size()));
+    EXPECT_EQ(next, frame) << GetKernelName(kernel);
+
+    ASSERT_TRUE(CRunLengthDelta::Apply(delta.data(), delta.size(), frame.data(), frame.size()));
+    EXPECT_EQ(current, frame) << GetKernelName(kernel);
+  }
+}
+}
+
+TEST(TestRunLengthDelta, EqualFrames)
+{
+  std::vector<uint8_t> frame(1000, 0x55);
+  std::vector<uint8_t> delta(CRunLengthDelta::GetMaxEncodedSize(frame.size()));
+  EXPECT_EQ(0u, CRunLengthDelta::Encode(frame.data(), frame.data(), frame.size(), delta.data()));
+}
+
+TEST(TestRunLengthDelta, RoundTrip)
+{
+  std::mt19937 rng(1234);
+
+  // Include sizes that are not a multiple of the block size
+  for (size_t frameSize : { 1, 31, 32, 33, 64, 1000, 65536 + 13 })
+  {
+    std::vector<uint8_t> current(frameSize);
+    for (uint8_t& byte : current)
+      byte = static_cast<uint8_t>(rng());
+
+    // Sparse changes
+    std::vector<uint8_t> next = current;
+    AdvanceState(next, rng);
+    ExpectRoundTrip(current, next);
+
+    // Every byte changed
+    for (uint8_t& byte : next)
+      byte = ~byte;
+    ExpectRoundTrip(current, next);
+
+    // Only the last byte changed, after a long unchanged run
+    next = current;
+    next.back() ^= 0x80;
+    ExpectRoundTrip(current, next);
+  }
+}
+
+TEST(TestRunLengthDelta, InvalidDelta)
+{
+  std::vector<uint8_t> current(100, 0);
+  std::vector<uint8_t> next = current;
+  next[99] = 1;
+
+  std::vector<uint8_t> delta(CRunLengthDelta::GetMaxEncodedSize(current.size()));
+  delta.resize(CRunLengthDelta::Encode(current.data(), next.data(), current.size(), delta.data()));
+  ASSERT_FALSE(delta.empty());
+
+  // Frame too small
+  std::vector<uint8_t> frame(50, 0);
+  EXPECT_FALSE(CRunLengthDelta::Apply(delta.data(), delta.size(), frame.data(), frame.size()));
+
+  // Truncated
+  frame.resize(100);
+  EXPECT_FALSE(CRunLengthDelta::Apply(delta.data(), delta.size() - 1, frame.data(), frame.size()));
+}
+
+TEST(TestRunLengthDelta, Rewind)
+{
+  const size_t frameSize = 10 * 1024 + 3;
+  std::mt19937 rng(42);
+
+  CRunLengthDeltaMemoryStream stream;
+  stream.Init(frameSize, 10);
+
+  std::vector<uint8_t> state(frameSize, 0);
+  std::vector<std::vector<uint8_t>> history;
+  for (unsigned int i = 0; i < 15; i++)
+  {
+    AdvanceState(state, rng);
+    memcpy(stream.BeginFrame(), state.data(), frameSize);
+    stream.SubmitFrame();
+    history.push_back(state);
+  }
+
+  // One frame is the current one, the others are culled
+  EXPECT_EQ(9u, stream.PastFramesAvailable());
+  EXPECT_EQ(14u, stream.GetFrameCounter());
+  EXPECT_GT(stream.DeltaSize(), 0u);
+
+  EXPECT_EQ(3u, stream.RewindFrames(3));
+  EXPECT_EQ(0, memcmp(history[11].data(), stream.CurrentFrame(), frameSize));
+  EXPECT_EQ(11u, stream.GetFrameCounter());
+
+  EXPECT_EQ(6u, stream.RewindFrames(100));
+  EXPECT_EQ(0, memcmp(history[5].data(), stream.CurrentFrame(), frameSize));
+  EXPECT_EQ(0u, stream.PastFramesAvailable());
+  EXPECT_EQ(0u, stream.DeltaSize());
+}
+
+TEST(TestRunLengthDelta, SmallerThanDeltaPair)
+{
+  const size_t frameSize = 256 * 1024;
+  std::mt19937 rng(7);
+
+  CRunLengthDeltaMemoryStream stream;
+  stream.Init(frameSize, 11);
+
+  std::vector<uint8_t> state(frameSize);
+  for (uint8_t& byte : state)
+    byte = static_cast<uint8_t>(rng());
+
+  memcpy(stream.BeginFrame(), state.data(), frameSize);
+  stream.SubmitFrame();
+
+  // 16 bytes per changed 32-bit word in a delta pair stream
+  uint64_t changedWords = 0;
+  for (unsigned int i = 0; i < 10; i++)
+  {
+    std::vector<uint8_t> next = state;
+    AdvanceState(next, rng);
+    for (size_t pos = 0; pos < frameSize; pos += sizeof(uint32_t))
+    {
+      if (memcmp(state.data() + pos, next.data() + pos, sizeof(uint32_t)) != 0)
+        changedWords++;
+    }
+    state.swap(next);
+
+    memcpy(stream.BeginFrame(), state.data(), frameSize);
+    stream.SubmitFrame();
+  }
+
+  EXPECT_LT(stream.DeltaSize(), changedWords * 16);
+}
+
+TEST(TestRunLengthDelta, DISABLED_Benchmark)
+{
+  const size_t frameSize = 4 * 1024 * 1024;
+  const unsigned int frameCount = 300;
+
+  // Generate the savestates up front so only the streams are measured
+  std::mt19937 rng(7);
+  std::vector<std::vector<uint8_t>> states;
+  std::vector<uint8_t> state(frameSize);
+  for (uint8_t& byte : state)
+    byte = static_cast<uint8_t>(rng());
+  for (unsigned int i = 0; i < 16; i++)
+  {
+    AdvanceState(state, rng);
+    states.push_back(state);
+  }
+
+  std::vector<uint8_t> delta(CRunLengthDelta::GetMaxEncodedSize(frameSize));
+  for (CRunLengthDelta::Kernel kernel : KERNELS)
+  {
+    if (!CRunLengthDelta::IsSupported(kernel))
+      continue;
+
+    size_t deltaSize = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (unsigned int i = 0; i < frameCount; i++)
+    {
+      const std::vector<uint8_t>& current = states[i % states.size()];
+      const std::vector<uint8_t>& next = states[(i + 1) % states.size()];
+      deltaSize += CRunLengthDelta::Encode(current.data(), next.data(), frameSize, delta.data(), kernel);
+    }
+    const std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+
+    printf("[ BENCHMARK] %s encode: %.0f us/frame, %.0f bytes/frame\n", GetKernelName(kernel),
+           elapsed.count() / frameCount, static_cast<double>(deltaSize) / frameCount);
+  }
+
+  // Compare with the delta pair stream, both keep all frames
+  CDeltaPairMemoryStream deltaPairStream;
+  CRunLengthDeltaMemoryStream runLengthStream;
+  IMemoryStream* streams[] = { &deltaPairStream, &runLengthStream };
+  const char* names[] = { "delta pair", "run-length" };
+
+  for (unsigned int s = 0; s < 2; s++)
+  {
+    IMemoryStream& stream = *streams[s];
+    stream.Init(frameSize, frameCount + 1);
+
+    std::chrono::duration<double, std::micro> submitTime(0);
+    for (unsigned int i = 0; i <= frameCount; i++)
+    {
+      memcpy(stream.BeginFrame(), states[i % states.size()].data(), frameSize);
+      const auto start = std::chrono::steady_clock::now();
+      stream.SubmitFrame();
+      submitTime += std::chrono::steady_clock::now() - start;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ(frameCount, stream.RewindFrames(frameCount));
+    const std::chrono::duration<double, std::micro> rewindTime = std::chrono::steady_clock::now() - start;
+    EXPECT_EQ(0, memcmp(states[0].data(), stream.CurrentFrame(), frameSize));
+
+    printf("[ BENCHMARK] %s stream: submit %.0f us/frame, rewind %.0f us/frame\n", names[s],
+           submitTime.count() / frameCount, rewindTime.count() / frameCount);
+  }
+
+  // 16 bytes per changed 32-bit word vs. the run-length encoding
+  runLengthStream.Init(frameSize, frameCount + 1);
+  uint64_t changedWords = 0;
+  for (unsigned int i = 0; i <= frameCount; i++)
+  {
+    const std::vector<uint8_t>& next = states[i % states.size()];
+    if (i > 0)
+    {
+      const std::vector<uint8_t>& current = states[(i - 1) % states.size()];
+      for (size_t pos = 0; pos < frameSize; pos += sizeof(uint32_t))
+      {
+        if (memcmp(current.data() + pos, next.data() + pos, sizeof(uint32_t)) != 0)
+          changedWords++;
+      }
+    }
+    memcpy(runLengthStream.BeginFrame(), next.data(), frameSize);
+    runLengthStream.SubmitFrame();
+  }
+
+  printf("[ BENCHMARK] history of %u frames: delta pair %.1f MiB, run-length %.1f MiB\n", frameCount,
+         changedWords * 16 / (1024.0 * 1024.0), runLengthStream.DeltaSize() / (1024.0 * 1024.0));
+  EXPECT_LT(runLengthStream.DeltaSize(), changedWords * 16);
+}
@@ -21,6 +21,8 @@
 #include "utils/log.h"
 #include "cores/VideoPlayer/VideoRenderers/RenderManager.h"
 #include "utils/StringUtils.h"
+#include "utils/TimeUtils.h"
+#include <inttypes.h>
 #include <memory>
 
 extern "C" {
@@ -266,7 +268,7 @@ enum AVPixelFormat CDVDVideoCodecFFmpeg::GetFormat(struct AVCodecContext * avctx
   if (ctx->HasHardware())
   {
     ctx->SetHardware(nullptr);
-    avctx->get_buffer2 = avcodec_default_get_buffer2;
+    avctx->get_buffer2 = CDVDVideoFramePoolFFmpeg::IsEnabled() ? GetBuffer : avcodec_default_get_buffer2;
     avctx->slice_flags = 0;
     av_buffer_unref(&avctx->hw_frames_ctx);
   }
@@ -313,6 +315,14 @@ CDVDVideoCodecFFmpeg::~CDVDVideoCodecFFmpeg()
   Dispose();
 }
 
+int CDVDVideoCodecFFmpeg::GetBuffer(AVCodecContext* avctx, AVFrame* frame, int flags)
+{
+  ICallbackHWAccel *cb = static_cast<ICallbackHWAccel*>(avctx->opaque);
+  CDVDVideoCodecFFmpeg* ctx = dynamic_cast<CDVDVideoCodecFFmpeg*>(cb);
+
+  return ctx->m_framePool.GetBuffer(avctx, frame, flags);
+}
+
 bool CDVDVideoCodecFFmpeg::Open(CDVDStreamInfo &hints, CDVDCodecOptions &options)
 {
   if (hints.cryptoSession)
@@ -354,6 +364,8 @@ bool CDVDVideoCodecFFmpeg::Open(CDVDStreamInfo &hints, CDVDCodecOptions &options
   m_pCodecContext->workaround_bugs = FF_BUG_AUTODETECT;
   m_pCodecContext->get_format = GetFormat;
   m_pCodecContext->codec_tag = hints.codec_tag;
+  if (CDVDVideoFramePoolFFmpeg::IsEnabled())
+    m_pCodecContext->get_buffer2 = GetBuffer;
 
   // setup threading model
   if (!(hints.codecOptions & CODEC_FORCE_SOFTWARE))
@@ -423,15 +435,6 @@ bool CDVDVideoCodecFFmpeg::Open(CDVDStreamInfo &hints, CDVDCodecOptions &options
     return false;
   }
 
-  m_pFilterFrame = av_frame_alloc();
-  if (!m_pFilterFrame)
-  {
-    av_frame_free(&m_pFrame);
-    av_frame_free(&m_pDecodedFrame);
-    avcodec_free_context(&m_pCodecContext);
-    return false;
-  }
-
   UpdateName();
   const char* pixFmtName = av_get_pix_fmt_name(m_pCodecContext->pix_fmt);
   m_processInfo.SetVideoDimensions(m_pCodecContext->coded_width, m_pCodecContext->coded_height);
@@ -444,9 +447,15 @@ bool CDVDVideoCodecFFmpeg::Open(CDVDStreamInfo &hints, CDVDCodecOptions &options
 
 void CDVDVideoCodecFFmpeg::Dispose()
 {
+  if (m_pCodecContext)
+  {
+    CDVDVideoFramePoolFFmpeg::Stats stats = m_framePool.GetStats();
+    CLog::Log(LOGDEBUG, LOGVIDEO, "CDVDVideoCodecFFmpeg::Dispose - %" PRIu64 " pooled frames, %" PRIu64 " fallbacks, %u pool configurations",
+              stats.frames, stats.fallbacks, stats.configurations);
+  }
+
   av_frame_free(&m_pFrame);
   av_frame_free(&m_pDecodedFrame);
-  av_frame_free(&m_pFilterFrame);
   avcodec_free_context(&m_pCodecContext);
   SAFE_RELEASE(m_pHardware);
 
@@ -653,7 +662,9 @@ CDVDVideoCodec::VCReturn CDVDVideoCodecFFmpeg::GetPicture(VideoPicture* pVideoPi
     avcodec_send_packet(m_pCodecContext, &avpkt);
   }
 
+  const int64_t decodeStart = CurrentHostCounter();
   int ret = avcodec_receive_frame(m_pCodecContext, m_pDecodedFrame);
+  m_decodeTime += CurrentHostCounter() - decodeStart;
 
   if (m_decoderState == STATE_HW_FAILED && !m_pHardware)
     return VC_REOPEN;
@@ -686,7 +697,7 @@ CDVDVideoCodec::VCReturn CDVDVideoCodecFFmpeg::GetPicture(VideoPicture* pVideoPi
     }
     else if (m_pFilterGraph && !m_filterEof)
     {
-      int ret = FilterProcess(nullptr);
+      int ret = FilterProcess(nullptr, true);
       if (ret == VC_PICTURE)
       {
         if (!SetPictureParams(pVideoPicture))
@@ -808,9 +819,9 @@ CDVDVideoCodec::VCReturn CDVDVideoCodecFFmpeg::GetPicture(VideoPicture* pVideoPi
 
     if (m_pFilterIn)
     {
-      if (m_pFilterIn->outputs[0]->format != m_pCodecContext->pix_fmt ||
-          m_pFilterIn->outputs[0]->w != m_pCodecContext->width ||
-          m_pFilterIn->outputs[0]->h != m_pCodecContext->height)
+      if (m_filterFormat != m_pCodecContext->pix_fmt ||
+          m_filterWidth != m_pCodecContext->width ||
+          m_filterHeight != m_pCodecContext->height)
         need_reopen = true;
     }
 
@@ -861,13 +872,43 @@ bool CDVDVideoCodecFFmpeg::SetPictureParams(VideoPicture* pVideoPicture)
 
   if (m_processInfo.GetVideoSettings().m_PostProcess)
   {
+    const int64_t start = CurrentHostCounter();
     m_postProc.SetType(CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_videoPPFFmpegPostProc, false);
     m_postProc.Process(pVideoPicture);
+    m_postProcTime += CurrentHostCounter() - start;
   }
 
+  UpdateDecodeTimes();
   return true;
 }
 
+void CDVDVideoCodecFFmpeg::UpdateDecodeTimes()
+{
+  // publish averages over a few seconds of video
+  if (++m_timedFrames < 100)
+    return;
+
+  const double ticksPerMs = CurrentHostFrequency() / 1000.0;
+  CDataCacheCore::SVideoDecodeTimes times;
+  times.decode = m_decodeTime / ticksPerMs / m_timedFrames;
+  times.filterWait = m_filterWaitTime / ticksPerMs / m_timedFrames;
+  times.postProc = m_postProcTime / ticksPerMs / m_timedFrames;
+  times.frames = m_timedFrames;
+
+  double filterMs;
+  unsigned int filterFrames;
+  m_filterThread.GetFilterTime(filterMs, filterFrames);
+  if (filterFrames > 0)
+    times.filter = filterMs / filterFrames;
+
+  m_processInfo.SetVideoDecodeTimes(times);
+
+  m_decodeTime = 0;
+  m_filterWaitTime = 0;
+  m_postProcTime = 0;
+  m_timedFrames = 0;
+}
+
 void CDVDVideoCodecFFmpeg::Reset()
 {
   m_started = false;
@@ -1067,6 +1108,10 @@ int CDVDVideoCodecFFmpeg::FilterOpen(const std::string& filters, bool scale)
     return -1;
   }
 
+  // filters run on the filter thread concurrently with the frame threads of
+  // the decoder, leave them some of the cores for slice threading
+  m_pFilterGraph->nb_threads = std::max(1, g_cpuInfo.getCPUCount() / 2);
+
   const AVFilter* srcFilter = avfilter_get_by_name("buffer");
   const AVFilter* outFilter = avfilter_get_by_name("buffersink"); // should be last filter in the graph for now
 
@@ -1157,6 +1202,11 @@ int CDVDVideoCodecFFmpeg::FilterOpen(const std::string& filters, bool scale)
     }
   }
 
+  m_filterFormat = m_pFilterIn->outputs[0]->format;
+  m_filterWidth = m_pFilterIn->outputs[0]->w;
+  m_filterHeight = m_pFilterIn->outputs[0]->h;
+
+  m_filterThread.Start(m_pFilterIn, m_pFilterOut);
   m_filterEof = false;
   return result;
 }
@@ -1166,6 +1216,7 @@ void CDVDVideoCodecFFmpeg::FilterClose()
   if (m_pFilterGraph)
   {
     CLog::Log(LOGDEBUG, LOGVIDEO, "CDVDVideoCodecFFmpeg::FilterClose - Freeing filter graph");
+    m_filterThread.Stop();
     avfilter_graph_free(&m_pFilterGraph);
 
     // Disposed by above code
@@ -1174,41 +1225,35 @@ void CDVDVideoCodecFFmpeg::FilterClose()
   }
 }
 
-CDVDVideoCodec::VCReturn CDVDVideoCodecFFmpeg::FilterProcess(AVFrame* frame)
+CDVDVideoCodec::VCReturn CDVDVideoCodecFFmpeg::FilterProcess(AVFrame* frame, bool drain)
 {
-  int result;
+  // without a frame or a drain request only pick up what the filter thread has done by now
+  drain = drain || (m_codecControlFlags & DVD_CODEC_CTRL_DRAIN);
+  const int64_t start = CurrentHostCounter();
 
-  if (frame || (m_codecControlFlags & DVD_CODEC_CTRL_DRAIN))
+  if (frame)
   {
-    result = av_buffersrc_add_frame(m_pFilterIn, frame);
-    if (result < 0)
-    {
-      CLog::Log(LOGERROR, "CDVDVideoCodecFFmpeg::FilterProcess - av_buffersrc_add_frame");
+    if (!m_filterThread.AddFrame(frame))
       return VC_ERROR;
-    }
   }
+  else if (drain)
+    m_filterThread.Drain();
 
-  result = av_buffersink_get_frame(m_pFilterOut, m_pFilterFrame);
+  CDVDVideoCodec::VCReturn ret = m_filterThread.GetFrame(m_pFrame, drain);
+  m_filterWaitTime += CurrentHostCounter() - start;
 
-  if (result  == AVERROR(EAGAIN))
-    return VC_BUFFER;
-  else if (result == AVERROR_EOF)
+  if (ret == VC_EOF)
   {
-    result = av_buffersink_get_frame(m_pFilterOut, m_pFilterFrame);
     m_filterEof = true;
-    if (result < 0)
-      return VC_BUFFER;
+    return VC_BUFFER;
   }
-  else if (result < 0)
+  else if (ret == VC_ERROR)
   {
-    CLog::Log(LOGERROR, "CDVDVideoCodecFFmpeg::FilterProcess - av_buffersink_get_frame");
+    CLog::Log(LOGERROR, "CDVDVideoCodecFFmpeg::FilterProcess - filtering failed");
     return VC_ERROR;
   }
 
-  av_frame_unref(m_pFrame);
-  av_frame_move_ref(m_pFrame, m_pFilterFrame);
-
-  return VC_PICTURE;
+  return ret;
 }
 
 unsigned CDVDVideoCodecFFmpeg::GetConvergeCount()
@@ -1273,6 +1318,9 @@ void CDVDVideoCodecFFmpeg::SetCodecControl(int flags)
       m_pCodecContext->skip_idct = AVDISCARD_DEFAULT;
       m_pCodecContext->skip_loop_filter = AVDISCARD_DEFAULT;
     }
+
+    if (flags & DVD_CODEC_CTRL_KEYFRAMES)
+      m_pCodecContext->skip_frame = AVDISCARD_NONKEY;
   }
 
   if (m_pHardware)
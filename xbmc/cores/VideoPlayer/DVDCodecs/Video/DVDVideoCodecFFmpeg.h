@@ -11,6 +11,8 @@
 #include "cores/VideoPlayer/DVDCodecs/DVDCodecs.h"
 #include "cores/VideoPlayer/DVDStreamInfo.h"
 #include "DVDVideoCodec.h"
+#include "DVDVideoFilterThread.h"
+#include "DVDVideoFramePoolFFmpeg.h"
 #include "DVDVideoPPFFmpeg.h"
 #include <string>
 #include <vector>
@@ -48,13 +50,15 @@ public:
 protected:
   void Dispose();
   static enum AVPixelFormat GetFormat(struct AVCodecContext * avctx, const AVPixelFormat * fmt);
+  static int GetBuffer(struct AVCodecContext* avctx, AVFrame* frame, int flags);
 
   int  FilterOpen(const std::string& filters, bool scale);
   void FilterClose();
-  CDVDVideoCodec::VCReturn FilterProcess(AVFrame* frame);
+  CDVDVideoCodec::VCReturn FilterProcess(AVFrame* frame, bool drain = false);
   void SetFilters();
   void UpdateName();
   bool SetPictureParams(VideoPicture* pVideoPicture);
+  void UpdateDecodeTimes();
 
   bool HasHardware() { return m_pHardware != nullptr; };
   void SetHardware(IHardwareDecoder *hardware);
@@ -63,18 +67,29 @@ protected:
   AVFrame* m_pDecodedFrame = nullptr;;
   AVCodecContext* m_pCodecContext = nullptr;;
   std::shared_ptr<CVideoBufferPoolFFmpeg> m_videoBufferPool;
+  CDVDVideoFramePoolFFmpeg m_framePool;
 
   std::string m_filters;
   std::string m_filters_next;
   AVFilterGraph* m_pFilterGraph = nullptr;
   AVFilterContext* m_pFilterIn = nullptr;
   AVFilterContext* m_pFilterOut = nullptr;;
-  AVFrame* m_pFilterFrame = nullptr;;
+  CDVDVideoFilterThread m_filterThread;
+  // input of the graph as configured, the graph itself belongs to the filter thread
+  int m_filterFormat = -1;
+  int m_filterWidth = 0;
+  int m_filterHeight = 0;
   bool m_filterEof = false;
   bool m_eof = false;
 
   CDVDVideoPPFFmpeg m_postProc;
 
+  // host counter ticks spent per stage since the last update of the process info
+  int64_t m_decodeTime = 0;
+  int64_t m_filterWaitTime = 0;
+  int64_t m_postProcTime = 0;
+  unsigned int m_timedFrames = 0;
+
   int m_iPictureWidth = 0;
   int m_iPictureHeight = 0;
   int m_iScreenWidth = 0;
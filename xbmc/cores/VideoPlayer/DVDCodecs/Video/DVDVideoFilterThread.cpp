@@ -0,0 +1,235 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "DVDVideoFilterThread.h"
+#include "threads/SingleLock.h"
+#include "utils/log.h"
+#include "utils/TimeUtils.h"
+
+extern "C" {
+#include <libavfilter/buffersink.h>
+#include <libavfilter/buffersrc.h>
+}
+
+CDVDVideoFilterThread::CDVDVideoFilterThread() : CThread("VideoFilter")
+{
+}
+
+CDVDVideoFilterThread::~CDVDVideoFilterThread()
+{
+  Stop();
+}
+
+void CDVDVideoFilterThread::Start(AVFilterContext* in, AVFilterContext* out)
+{
+  Stop();
+
+  m_filterIn = in;
+  m_filterOut = out;
+  m_busy = false;
+  m_drain = false;
+  m_eof = false;
+  m_error = false;
+  Create();
+}
+
+void CDVDVideoFilterThread::Stop()
+{
+  if (!IsStarted())
+    return;
+
+  {
+    CSingleLock lock(m_section);
+    m_bStop = true;
+  }
+  m_inputCond.notifyAll();
+  StopThread();
+
+  Clear();
+  m_filterIn = nullptr;
+  m_filterOut = nullptr;
+}
+
+void CDVDVideoFilterThread::Clear()
+{
+  CSingleLock lock(m_section);
+
+  for (AVFrame* frame : m_input)
+    av_frame_free(&frame);
+  m_input.clear();
+
+  for (AVFrame* frame : m_output)
+    av_frame_free(&frame);
+  m_output.clear();
+}
+
+bool CDVDVideoFilterThread::AddFrame(AVFrame* frame)
+{
+  AVFrame* queued = av_frame_alloc();
+  if (!queued)
+    return false;
+  av_frame_move_ref(queued, frame);
+
+  {
+    CSingleLock lock(m_section);
+
+    while (m_input.size() >= MAX_INPUT_FRAMES && !m_error)
+      m_inputCond.wait(lock);
+
+    if (m_error)
+    {
+      av_frame_free(&queued);
+      return false;
+    }
+
+    m_input.push_back(queued);
+  }
+  m_inputCond.notifyAll();
+
+  return true;
+}
+
+void CDVDVideoFilterThread::Drain()
+{
+  {
+    CSingleLock lock(m_section);
+
+    if (m_drain)
+      return;
+
+    m_drain = true;
+    m_input.push_back(nullptr);
+  }
+  m_inputCond.notifyAll();
+}
+
+CDVDVideoCodec::VCReturn CDVDVideoFilterThread::GetFrame(AVFrame* frame, bool wait)
+{
+  CSingleLock lock(m_section);
+
+  if (wait)
+  {
+    while (m_output.empty() && !m_eof && !m_error && (m_busy || !m_input.empty()))
+      m_outputCond.wait(lock);
+  }
+
+  if (!m_output.empty())
+  {
+    AVFrame* filtered = m_output.front();
+    m_output.pop_front();
+    av_frame_unref(frame);
+    av_frame_move_ref(frame, filtered);
+    av_frame_free(&filtered);
+    return CDVDVideoCodec::VC_PICTURE;
+  }
+
+  if (m_error)
+    return CDVDVideoCodec::VC_ERROR;
+  else if (m_eof)
+    return CDVDVideoCodec::VC_EOF;
+
+  return CDVDVideoCodec::VC_BUFFER;
+}
+
+void CDVDVideoFilterThread::GetFilterTime(double& ms, unsigned int& frames)
+{
+  CSingleLock lock(m_section);
+
+  ms = static_cast<double>(m_filterTime) * 1000.0 / CurrentHostFrequency();
+  frames = m_filterFrames;
+  m_filterTime = 0;
+  m_filterFrames = 0;
+}
+
+void CDVDVideoFilterThread::Process()
+{
+  while (!m_bStop)
+  {
+    AVFrame* frame;
+    bool done;
+    {
+      CSingleLock lock(m_section);
+
+      while (m_input.empty() && !m_bStop)
+        m_inputCond.wait(lock);
+
+      if (m_bStop)
+        break;
+
+      frame = m_input.front();
+      m_input.pop_front();
+      done = m_eof || m_error;
+      m_busy = !done;
+    }
+    m_inputCond.notifyAll();
+
+    // the graph doesn't take input after it was drained or failed
+    if (done)
+      av_frame_free(&frame);
+    else if (!Filter(frame))
+      m_inputCond.notifyAll();
+  }
+}
+
+bool CDVDVideoFilterThread::Filter(AVFrame* frame)
+{
+  const int64_t start = CurrentHostCounter();
+  unsigned int frames = 0;
+  bool eof = false;
+  bool error = false;
+
+  if (av_buffersrc_add_frame(m_filterIn, frame) < 0)
+  {
+    CLog::Log(LOGERROR, "CDVDVideoFilterThread::Filter - av_buffersrc_add_frame");
+    error = true;
+  }
+  av_frame_free(&frame);
+
+  while (!error)
+  {
+    AVFrame* filtered = av_frame_alloc();
+    if (!filtered)
+    {
+      error = true;
+      break;
+    }
+
+    int result = av_buffersink_get_frame(m_filterOut, filtered);
+    if (result < 0)
+    {
+      av_frame_free(&filtered);
+      if (result == AVERROR_EOF)
+        eof = true;
+      else if (result != AVERROR(EAGAIN))
+      {
+        CLog::Log(LOGERROR, "CDVDVideoFilterThread::Filter - av_buffersink_get_frame");
+        error = true;
+      }
+      break;
+    }
+
+    {
+      CSingleLock lock(m_section);
+      m_output.push_back(filtered);
+    }
+    m_outputCond.notifyAll();
+    frames++;
+  }
+
+  {
+    CSingleLock lock(m_section);
+    m_filterTime += CurrentHostCounter() - start;
+    m_filterFrames += frames;
+    m_eof = m_eof || eof;
+    m_error = m_error || error;
+    m_busy = false;
+  }
+  m_outputCond.notifyAll();
+
+  return !error;
+}
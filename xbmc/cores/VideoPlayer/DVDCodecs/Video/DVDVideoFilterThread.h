@@ -0,0 +1,102 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "DVDVideoCodec.h"
+#include "threads/Condition.h"
+#include "threads/CriticalSection.h"
+#include "threads/Thread.h"
+
+#include <deque>
+#include <stdint.h>
+
+extern "C" {
+#include <libavfilter/avfilter.h>
+#include <libavutil/frame.h>
+}
+
+/*!
+ * \brief Runs a configured libavfilter graph on its own thread
+ *
+ * Decoded frames are queued to the input of the graph and processed while the
+ * decoder works on the next frames, the filtered frames are picked up from the
+ * output queue. The input queue is bounded, AddFrame() blocks while it is
+ * full. The graph stays owned by the caller and must not be touched between
+ * Start() and Stop().
+ */
+class CDVDVideoFilterThread : private CThread
+{
+public:
+  CDVDVideoFilterThread();
+  ~CDVDVideoFilterThread() override;
+
+  /*!
+   * \brief Start filtering into the graph between the buffer source in and the buffer sink out
+   */
+  void Start(AVFilterContext* in, AVFilterContext* out);
+
+  /*!
+   * \brief Stop the thread and drop all queued frames
+   */
+  void Stop();
+
+  bool IsStarted() const { return m_filterIn != nullptr; }
+
+  /*!
+   * \brief Queue a frame for filtering
+   * \param frame the reference is moved to the queue, frame is unreferenced afterwards
+   * \return false if filtering failed
+   */
+  bool AddFrame(AVFrame* frame);
+
+  /*!
+   * \brief Signal the end of input, the graph flushes the frames it holds back
+   */
+  void Drain();
+
+  /*!
+   * \brief Get the next filtered frame
+   * \param frame receives the reference of the filtered frame
+   * \param wait block until the queued input is filtered if there is no frame yet
+   * \return VC_PICTURE if there is a frame, VC_EOF after the graph is drained,
+   *         VC_ERROR if filtering failed, VC_BUFFER otherwise
+   */
+  CDVDVideoCodec::VCReturn GetFrame(AVFrame* frame, bool wait);
+
+  /*!
+   * \brief Get and reset the time spent filtering
+   * \param ms milliseconds spent in the graph since the last call
+   * \param frames number of frames the graph returned since the last call
+   */
+  void GetFilterTime(double& ms, unsigned int& frames);
+
+protected:
+  void Process() override;
+
+private:
+  static const size_t MAX_INPUT_FRAMES = 4;
+
+  void Clear();
+  bool Filter(AVFrame* frame);
+
+  AVFilterContext* m_filterIn = nullptr;
+  AVFilterContext* m_filterOut = nullptr;
+
+  CCriticalSection m_section;
+  XbmcThreads::ConditionVariable m_inputCond;
+  XbmcThreads::ConditionVariable m_outputCond;
+  std::deque<AVFrame*> m_input; //!< nullptr signals the end of input
+  std::deque<AVFrame*> m_output;
+  bool m_busy = false;
+  bool m_drain = false;
+  bool m_eof = false;
+  bool m_error = false;
+  int64_t m_filterTime = 0;
+  unsigned int m_filterFrames = 0;
+};
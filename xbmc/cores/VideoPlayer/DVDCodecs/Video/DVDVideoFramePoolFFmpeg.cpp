@@ -0,0 +1,166 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "DVDVideoFramePoolFFmpeg.h"
+#include "threads/SingleLock.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <atomic>
+
+extern "C" {
+#include <libavutil/imgutils.h>
+#include <libavutil/pixdesc.h>
+}
+
+namespace
+{
+std::atomic<bool> poolEnabled(true);
+
+// decoders may read and write a few bytes past the end of a plane
+const int PLANE_PADDING = 16;
+
+uint8_t* AlignPointer(uint8_t* ptr)
+{
+  const uintptr_t align = CDVDVideoFramePoolFFmpeg::ALIGNMENT;
+  return reinterpret_cast<uint8_t*>((reinterpret_cast<uintptr_t>(ptr) + align - 1) & ~(align - 1));
+}
+}
+
+const int CDVDVideoFramePoolFFmpeg::ALIGNMENT;
+
+CDVDVideoFramePoolFFmpeg::~CDVDVideoFramePoolFFmpeg()
+{
+  Uninit();
+}
+
+void CDVDVideoFramePoolFFmpeg::SetEnabled(bool enabled)
+{
+  poolEnabled = enabled;
+}
+
+bool CDVDVideoFramePoolFFmpeg::IsEnabled()
+{
+  return poolEnabled;
+}
+
+CDVDVideoFramePoolFFmpeg::Stats CDVDVideoFramePoolFFmpeg::GetStats()
+{
+  CSingleLock lock(m_section);
+  return m_stats;
+}
+
+int CDVDVideoFramePoolFFmpeg::GetBuffer(AVCodecContext* avctx, AVFrame* frame, int flags)
+{
+  const AVPixFmtDescriptor* desc = av_pix_fmt_desc_get(static_cast<AVPixelFormat>(frame->format));
+  const bool supported = desc && !(desc->flags & (AV_PIX_FMT_FLAG_HWACCEL | AV_PIX_FMT_FLAG_PAL)) &&
+                         (avctx->codec->capabilities & AV_CODEC_CAP_DR1);
+
+  CSingleLock lock(m_section);
+
+  if (!supported || (!IsCompatible(frame) && !Configure(avctx, frame)))
+  {
+    m_stats.fallbacks++;
+    lock.Leave();
+    return avcodec_default_get_buffer2(avctx, frame, flags);
+  }
+
+  for (int i = 0; i < MAX_PLANES && m_pools[i]; i++)
+  {
+    frame->buf[i] = av_buffer_pool_get(m_pools[i]);
+    if (!frame->buf[i])
+    {
+      av_frame_unref(frame);
+      return AVERROR(ENOMEM);
+    }
+    frame->data[i] = AlignPointer(frame->buf[i]->data);
+    frame->linesize[i] = m_linesize[i];
+  }
+  frame->extended_data = frame->data;
+
+  m_stats.frames++;
+  return 0;
+}
+
+bool CDVDVideoFramePoolFFmpeg::IsCompatible(const AVFrame* frame) const
+{
+  return m_pools[0] &&
+         m_format == frame->format &&
+         m_width == frame->width &&
+         m_height == frame->height;
+}
+
+bool CDVDVideoFramePoolFFmpeg::Configure(AVCodecContext* avctx, const AVFrame* frame)
+{
+  Uninit();
+
+  const AVPixelFormat format = static_cast<AVPixelFormat>(frame->format);
+  int width = frame->width;
+  int height = frame->height;
+  int linesizeAlign[AV_NUM_DATA_POINTERS];
+  avcodec_align_dimensions2(avctx, &width, &height, linesizeAlign);
+
+  // widen the picture until all lines start at the alignment
+  int linesize[MAX_PLANES];
+  for (;;)
+  {
+    if (av_image_fill_linesizes(linesize, format, width) < 0)
+      return false;
+
+    bool aligned = true;
+    for (int i = 0; i < MAX_PLANES; i++)
+    {
+      if (linesize[i] % std::max(ALIGNMENT, linesizeAlign[i]))
+        aligned = false;
+    }
+    if (aligned)
+      break;
+
+    width += width & ~(width - 1);
+  }
+
+  // plane offsets in a single picture buffer give the size of every plane
+  uint8_t* data[MAX_PLANES];
+  const int size = av_image_fill_pointers(data, format, height, nullptr, linesize);
+  if (size < 0)
+    return false;
+
+  for (int i = 0; i < MAX_PLANES && linesize[i]; i++)
+  {
+    const int planeSize = (i + 1 < MAX_PLANES && data[i + 1] ? data[i + 1] - data[i] : size - (data[i] - data[0]));
+    m_pools[i] = av_buffer_pool_init(planeSize + PLANE_PADDING + ALIGNMENT - 1, av_buffer_allocz);
+    if (!m_pools[i])
+    {
+      Uninit();
+      return false;
+    }
+    m_linesize[i] = linesize[i];
+  }
+
+  m_format = frame->format;
+  m_width = frame->width;
+  m_height = frame->height;
+  m_stats.configurations++;
+
+  CLog::Log(LOGDEBUG, "CDVDVideoFramePoolFFmpeg::Configure - %s %dx%d, line size %d",
+            av_get_pix_fmt_name(format), m_width, m_height, m_linesize[0]);
+  return true;
+}
+
+void CDVDVideoFramePoolFFmpeg::Uninit()
+{
+  // frames still in use keep their pool alive
+  for (int i = 0; i < MAX_PLANES; i++)
+  {
+    av_buffer_pool_uninit(&m_pools[i]);
+    m_linesize[i] = 0;
+  }
+  m_format = -1;
+  m_width = 0;
+  m_height = 0;
+}
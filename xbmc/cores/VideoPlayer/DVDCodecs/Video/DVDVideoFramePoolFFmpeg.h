@@ -0,0 +1,78 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "threads/CriticalSection.h"
+
+#include <stdint.h>
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+#include <libavutil/buffer.h>
+}
+
+/*!
+ * \brief Picture memory software decoders decode into
+ *
+ * Implements get_buffer2 with one AVBufferPool per plane. Plane pointers and
+ * line sizes are aligned to 64 bytes, so SIMD code of the decoder, the filters
+ * and the renderer can use aligned loads, and row copies of common widths
+ * collapse into a single memcpy. The frames are reference counted by the
+ * AVBuffers, they are passed on to the renderer without being copied and the
+ * memory goes back to the pool when the last reference is dropped, even after
+ * the pool was reconfigured or destroyed.
+ *
+ * Hardware and paletted formats and codecs without direct rendering support
+ * fall back to avcodec_default_get_buffer2().
+ */
+class CDVDVideoFramePoolFFmpeg
+{
+public:
+  static const int ALIGNMENT = 64;
+
+  struct Stats
+  {
+    uint64_t frames = 0; //!< frames allocated from the pools
+    uint64_t fallbacks = 0; //!< frames allocated by avcodec_default_get_buffer2()
+    unsigned int configurations = 0; //!< times the pools were set up for a new format or size
+  };
+
+  CDVDVideoFramePoolFFmpeg() = default;
+  ~CDVDVideoFramePoolFFmpeg();
+  CDVDVideoFramePoolFFmpeg(const CDVDVideoFramePoolFFmpeg&) = delete;
+  CDVDVideoFramePoolFFmpeg& operator=(const CDVDVideoFramePoolFFmpeg&) = delete;
+
+  /*!
+   * \brief get_buffer2 implementation, safe to be called from the frame threads of the decoder
+   */
+  int GetBuffer(AVCodecContext* avctx, AVFrame* frame, int flags);
+
+  Stats GetStats();
+
+  /*!
+   * \brief Enable or disable the pools of decoders opened afterwards, for comparisons
+   */
+  static void SetEnabled(bool enabled);
+  static bool IsEnabled();
+
+private:
+  static const int MAX_PLANES = 4;
+
+  bool IsCompatible(const AVFrame* frame) const;
+  bool Configure(AVCodecContext* avctx, const AVFrame* frame);
+  void Uninit();
+
+  CCriticalSection m_section;
+  AVBufferPool* m_pools[MAX_PLANES] = {};
+  int m_linesize[MAX_PLANES] = {};
+  int m_format = -1;
+  int m_width = 0;
+  int m_height = 0;
+  Stats m_stats;
+};
@@ -58,6 +58,11 @@ CDVDDemuxClient::~CDVDDemuxClient()
   Dispose();
 }
 
+void CDVDDemuxClient::PacketDeleter::operator()(DemuxPacket* packet) const
+{
+  CDVDDemuxUtils::FreeDemuxPacket(packet);
+}
+
 bool CDVDDemuxClient::Open(std::shared_ptr<CDVDInputStream> pInput)
 {
   Abort();
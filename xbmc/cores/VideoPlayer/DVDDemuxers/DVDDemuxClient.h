@@ -55,7 +55,12 @@ protected:
   std::map<int, std::shared_ptr<CDemuxStream>> m_streams;
   int m_displayTime;
   double m_dtsAtDisplayTime;
-  std::unique_ptr<DemuxPacket> m_packet;
+  // packets come from the packet pool and go back to it
+  struct PacketDeleter
+  {
+    void operator()(DemuxPacket* packet) const;
+  };
+  std::unique_ptr<DemuxPacket, PacketDeleter> m_packet;
   int m_videoStreamPlaying = -1;
 
 private:
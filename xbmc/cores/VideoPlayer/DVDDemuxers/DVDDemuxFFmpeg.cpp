@@ -8,12 +8,15 @@
 
 #include "DVDDemuxFFmpeg.h"
 
+#include <inttypes.h>
 #include <sstream>
 #include <utility>
 
 #include "commons/Exception.h"
 #include "cores/FFmpeg.h"
 #include "cores/VideoPlayer/Interface/Addon/TimingConstants.h" // for DVD_TIME_BASE
+#include "DVDDemuxReadAhead.h"
+#include "DVDDemuxSeekIndex.h"
 #include "DVDDemuxUtils.h"
 #include "DVDInputStreams/DVDInputStream.h"
 #include "DVDInputStreams/DVDInputStreamFFmpeg.h"
@@ -70,6 +73,9 @@ static const struct StereoModeConversionMap WmvToInternalStereoModeMap[] =
 
 #define FF_MAX_EXTRADATA_SIZE ((1 << 28) - AV_INPUT_BUFFER_PADDING_SIZE)
 
+// bytes read ahead of remote files without a file cache
+#define READ_AHEAD_SIZE (8 * 1024 * 1024)
+
 std::string CDemuxStreamAudioFFmpeg::GetStreamName()
 {
   if(!m_stream)
@@ -134,8 +140,12 @@ static int dvd_file_read(void *h, uint8_t* buf, int size)
   if(interrupt_cb(h))
     return AVERROR_EXIT;
 
-  std::shared_ptr<CDVDInputStream> pInputStream = static_cast<CDVDDemuxFFmpeg*>(h)->m_pInput;
-  int len = pInputStream->Read(buf, size);
+  CDVDDemuxFFmpeg* demuxer = static_cast<CDVDDemuxFFmpeg*>(h);
+  int len;
+  if (demuxer->m_readAhead)
+    len = demuxer->m_readAhead->Read(buf, size);
+  else
+    len = demuxer->m_pInput->Read(buf, size);
   if (len == 0)
     return AVERROR_EOF;
   else
@@ -152,11 +162,13 @@ static int64_t dvd_file_seek(void *h, int64_t pos, int whence)
   if(interrupt_cb(h))
     return AVERROR_EXIT;
 
-  std::shared_ptr<CDVDInputStream> pInputStream = static_cast<CDVDDemuxFFmpeg*>(h)->m_pInput;
+  CDVDDemuxFFmpeg* demuxer = static_cast<CDVDDemuxFFmpeg*>(h);
   if(whence == AVSEEK_SIZE)
-    return pInputStream->GetLength();
+    return demuxer->m_pInput->GetLength();
+  else if (demuxer->m_readAhead)
+    return demuxer->m_readAhead->Seek(pos, whence & ~AVSEEK_FORCE);
   else
-    return pInputStream->Seek(pos, whence & ~AVSEEK_FORCE);
+    return demuxer->m_pInput->Seek(pos, whence & ~AVSEEK_FORCE);
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////
@@ -290,6 +302,15 @@ bool CDVDDemuxFFmpeg::Open(std::shared_ptr<CDVDInputStream> pInput, bool streami
     if (!seekable)
       m_ioContext->seekable = 0;
 
+    // every read of a remote file without a file cache is a round trip
+    XFILE::SCacheStatus status;
+    if (seekable && !fileinfo && m_pInput->IsStreamType(DVDSTREAM_TYPE_FILE) &&
+        !m_pInput->IsRealtime() && URIUtils::IsRemote(strFile) && !m_pInput->GetCacheStatus(&status))
+    {
+      CLog::Log(LOGDEBUG, "%s - reading ahead of %s", __FUNCTION__, CURL::GetRedacted(strFile).c_str());
+      m_readAhead.reset(new CDVDDemuxReadAhead(m_pInput, READ_AHEAD_SIZE, [this]() { return Aborted(); }));
+    }
+
     std::string content = m_pInput->GetContent();
     StringUtils::ToLower(content);
     if (StringUtils::StartsWith(content, "audio/l16"))
@@ -502,6 +523,10 @@ bool CDVDDemuxFFmpeg::Open(std::shared_ptr<CDVDInputStream> pInput, bool streami
   // reset any timeout
   m_timeout.SetInfinite();
 
+  // keyframes found while the file was played before
+  if (m_pInput->IsStreamType(DVDSTREAM_TYPE_FILE) && !m_pInput->IsRealtime())
+    CDVDDemuxSeekIndexCache::GetInstance().Restore(strFile, m_pInput->GetLength(), m_pFormatContext);
+
   // if format can be nonblocking, let's use that
   m_pFormatContext->flags |= AVFMT_FLAG_NONBLOCK;
 
@@ -584,8 +609,19 @@ void CDVDDemuxFFmpeg::Dispose()
   m_pkt.result = -1;
   av_packet_unref(&m_pkt.pkt);
 
+  if (m_readAhead)
+  {
+    CDVDDemuxReadAhead::Stats stats = m_readAhead->GetStats();
+    CLog::Log(LOGDEBUG, "CDVDDemuxFFmpeg::Dispose - read ahead %" PRIu64 " bytes, %u seeks in the buffer, %u on the input, waited %u times",
+              stats.bytesFetched, stats.bufferedSeeks, stats.inputSeeks, stats.waits);
+    m_readAhead.reset();
+  }
+
   if (m_pFormatContext)
   {
+    if (m_pInput && m_pInput->IsStreamType(DVDSTREAM_TYPE_FILE) && !m_pInput->IsRealtime())
+      CDVDDemuxSeekIndexCache::GetInstance().Store(m_pInput->GetFileName(), m_pInput->GetLength(), m_pFormatContext);
+
     if (m_ioContext && m_pFormatContext->pb && m_pFormatContext->pb != m_ioContext)
     {
       CLog::Log(LOGWARNING, "CDVDDemuxFFmpeg::Dispose - demuxer changed our byte context behind our back, possible memleak");
@@ -1149,11 +1185,14 @@ bool CDVDDemuxFFmpeg::SeekTime(double time, bool backwards, double *startpts)
         // force eof
         // files of realtime streams may grow
         if (!m_pInput->IsRealtime())
+        {
+          m_readAhead.reset();
           m_pInput->Close();
+        }
         else
           ret = 0;
       }
-      else if (m_pInput->IsEOF())
+      else if (IsInputEOF())
         ret = 0;
     }
 
@@ -1940,6 +1979,14 @@ unsigned int CDVDDemuxFFmpeg::HLSSelectProgram()
   return prog;
 }
 
+bool CDVDDemuxFFmpeg::IsInputEOF()
+{
+  // the input reaches its end before the demuxer read the bytes buffered ahead
+  if (m_readAhead)
+    return m_readAhead->IsEOF();
+  return m_pInput->IsEOF();
+}
+
 std::string CDVDDemuxFFmpeg::GetStereoModeFromMetadata(AVDictionary *pMetadata)
 {
   std::string stereoMode;
@@ -20,6 +20,7 @@ extern "C" {
 }
 
 class CDVDDemuxFFmpeg;
+class CDVDDemuxReadAhead;
 class CURL;
 
 class CDemuxStreamVideoFFmpeg : public CDemuxStreamVideo
@@ -106,6 +107,7 @@ public:
 
   AVFormatContext* m_pFormatContext;
   std::shared_ptr<CDVDInputStream> m_pInput;
+  std::unique_ptr<CDVDDemuxReadAhead> m_readAhead; //!< reads m_pInput if set
 
 protected:
   friend class CDemuxStreamAudioFFmpeg;
@@ -124,6 +126,7 @@ protected:
   void UpdateCurrentPTS();
   bool IsProgramChange();
   unsigned int HLSSelectProgram();
+  bool IsInputEOF();
 
   std::string GetStereoModeFromMetadata(AVDictionary *pMetadata);
   std::string ConvertCodecToInternalStereoMode(const std::string &mode, const StereoModeConversionMap *conversionMap);
@@ -0,0 +1,190 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "DVDDemuxPacketPool.h"
+#include "threads/SingleLock.h"
+
+#ifdef TARGET_POSIX
+#include "platform/linux/XMemUtils.h"
+#endif
+
+#include <new>
+
+namespace
+{
+const size_t PACKET_ALIGNMENT = 64;
+}
+
+const size_t CDVDDemuxPacketPool::DEFAULT_MAX_CACHED_BYTES;
+
+CDVDDemuxPacketPool& CDVDDemuxPacketPool::GetInstance()
+{
+  static CDVDDemuxPacketPool pool;
+  return pool;
+}
+
+CDVDDemuxPacketPool::CDVDDemuxPacketPool(size_t maxCachedBytes)
+  : m_maxCachedBytes(maxCachedBytes)
+{
+}
+
+CDVDDemuxPacketPool::~CDVDDemuxPacketPool()
+{
+  Clear();
+}
+
+unsigned int CDVDDemuxPacketPool::GetSizeClass(size_t bufferSize)
+{
+  if (bufferSize == 0)
+    return 0;
+  if (bufferSize > (static_cast<size_t>(1) << MAX_CLASS_SHIFT))
+    return UNPOOLED;
+
+  unsigned int shift = MIN_CLASS_SHIFT;
+  while ((static_cast<size_t>(1) << shift) < bufferSize)
+    shift++;
+  return shift - MIN_CLASS_SHIFT + 1;
+}
+
+size_t CDVDDemuxPacketPool::GetClassCapacity(unsigned int sizeClass)
+{
+  if (sizeClass == 0)
+    return 0;
+  return static_cast<size_t>(1) << (MIN_CLASS_SHIFT + sizeClass - 1);
+}
+
+size_t CDVDDemuxPacketPool::GetMemorySize(const Packet* packet)
+{
+  return sizeof(Packet) + packet->capacity;
+}
+
+void CDVDDemuxPacketPool::Free(Packet* packet)
+{
+  if (packet->pData)
+    _aligned_free(packet->pData);
+  delete packet;
+}
+
+DemuxPacket* CDVDDemuxPacketPool::Allocate(size_t bufferSize)
+{
+  const unsigned int sizeClass = GetSizeClass(bufferSize);
+
+  Packet* packet = nullptr;
+  {
+    CSingleLock lock(m_section);
+    m_stats.allocations++;
+    m_stats.outstanding++;
+    if (sizeClass != UNPOOLED && !m_free[sizeClass].empty())
+    {
+      packet = m_free[sizeClass].back();
+      m_free[sizeClass].pop_back();
+      m_stats.reused++;
+      m_stats.cachedPackets--;
+      m_stats.cachedBytes -= GetMemorySize(packet);
+      return packet;
+    }
+  }
+
+  packet = new (std::nothrow) Packet();
+  if (packet)
+  {
+    packet->sizeClass = sizeClass;
+    packet->capacity = sizeClass == UNPOOLED ? bufferSize : GetClassCapacity(sizeClass);
+    if (packet->capacity > 0)
+    {
+      packet->pData = static_cast<uint8_t*>(_aligned_malloc(packet->capacity, PACKET_ALIGNMENT));
+      if (!packet->pData)
+      {
+        delete packet;
+        packet = nullptr;
+      }
+    }
+  }
+
+  if (!packet)
+  {
+    CSingleLock lock(m_section);
+    m_stats.allocations--;
+    m_stats.outstanding--;
+  }
+  return packet;
+}
+
+void CDVDDemuxPacketPool::Release(DemuxPacket* demuxPacket)
+{
+  if (!demuxPacket)
+    return;
+
+  Packet* packet = static_cast<Packet*>(demuxPacket);
+
+  // reset everything but the payload buffer, the crypto info may hold the last reference
+  uint8_t* data = packet->pData;
+  static_cast<DemuxPacket&>(*packet) = DemuxPacket();
+  packet->pData = data;
+
+  {
+    CSingleLock lock(m_section);
+    m_stats.releases++;
+    m_stats.outstanding--;
+    if (packet->sizeClass != UNPOOLED &&
+        m_stats.cachedBytes + GetMemorySize(packet) <= m_maxCachedBytes)
+    {
+      m_free[packet->sizeClass].push_back(packet);
+      m_stats.cachedPackets++;
+      m_stats.cachedBytes += GetMemorySize(packet);
+      return;
+    }
+    m_stats.discarded++;
+  }
+
+  Free(packet);
+}
+
+void CDVDDemuxPacketPool::Clear()
+{
+  std::vector<Packet*> packets;
+  {
+    CSingleLock lock(m_section);
+    for (auto& list : m_free)
+    {
+      packets.insert(packets.end(), list.begin(), list.end());
+      list.clear();
+    }
+    m_stats.cachedPackets = 0;
+    m_stats.cachedBytes = 0;
+  }
+
+  for (Packet* packet : packets)
+    Free(packet);
+}
+
+void CDVDDemuxPacketPool::SetMaxCachedBytes(size_t maxCachedBytes)
+{
+  {
+    CSingleLock lock(m_section);
+    m_maxCachedBytes = maxCachedBytes;
+    if (m_stats.cachedBytes <= m_maxCachedBytes)
+      return;
+  }
+  Clear();
+}
+
+CDVDDemuxPacketPool::Stats CDVDDemuxPacketPool::GetStats() const
+{
+  CSingleLock lock(m_section);
+  return m_stats;
+}
+
+void CDVDDemuxPacketPool::ResetStats()
+{
+  CSingleLock lock(m_section);
+  m_stats.allocations = 0;
+  m_stats.reused = 0;
+  m_stats.releases = 0;
+  m_stats.discarded = 0;
+}
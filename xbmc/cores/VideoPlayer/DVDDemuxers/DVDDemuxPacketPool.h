@@ -0,0 +1,104 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "cores/VideoPlayer/Interface/Addon/DemuxPacket.h"
+#include "threads/CriticalSection.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+/*!
+ \brief Size-classed cache of demux packets and their payload buffers.
+
+ Demuxers allocate one packet per read and the players free it once it has been decoded,
+ so during playback the same few buffer sizes are allocated and freed all the time. The
+ pool keeps released packets together with their payload buffer in power-of-two size
+ classes and hands them out again on the next allocation of that class. Packets with a
+ payload larger than the biggest class are not cached.
+
+ All methods are thread-safe. Packets must be allocated and released through the pool
+ (CDVDDemuxUtils::AllocateDemuxPacket and CDVDDemuxUtils::FreeDemuxPacket do so), they
+ must never be deleted directly.
+ */
+class CDVDDemuxPacketPool
+{
+public:
+  struct Stats
+  {
+    uint64_t allocations = 0; //!< packets handed out
+    uint64_t reused = 0; //!< allocations served from the cache
+    uint64_t releases = 0; //!< packets given back
+    uint64_t discarded = 0; //!< released packets freed because they could not be cached
+    unsigned int outstanding = 0; //!< packets currently in use
+    unsigned int cachedPackets = 0; //!< packets ready for reuse
+    size_t cachedBytes = 0; //!< memory held by the packets ready for reuse
+  };
+
+  static CDVDDemuxPacketPool& GetInstance();
+
+  explicit CDVDDemuxPacketPool(size_t maxCachedBytes = DEFAULT_MAX_CACHED_BYTES);
+  ~CDVDDemuxPacketPool();
+
+  CDVDDemuxPacketPool(const CDVDDemuxPacketPool&) = delete;
+  CDVDDemuxPacketPool& operator=(const CDVDDemuxPacketPool&) = delete;
+
+  /*!
+   \brief Get a packet with a payload buffer of at least bufferSize bytes
+   \param bufferSize the size of the payload buffer, including any padding. 0 gets a packet
+                     without payload.
+   \return the packet with all members reset to their defaults, or nullptr on out of memory.
+   */
+  DemuxPacket* Allocate(size_t bufferSize);
+
+  /*!
+   \brief Give a packet back to the pool
+   Side data must have been freed by the caller.
+   */
+  void Release(DemuxPacket* packet);
+
+  /*!
+   \brief Free all cached packets
+   */
+  void Clear();
+
+  /*!
+   \brief Limit the memory held by cached packets
+   */
+  void SetMaxCachedBytes(size_t maxCachedBytes);
+
+  Stats GetStats() const;
+  void ResetStats();
+
+  static const size_t DEFAULT_MAX_CACHED_BYTES = 32 * 1024 * 1024;
+
+private:
+  struct Packet : DemuxPacket
+  {
+    unsigned int sizeClass;
+    size_t capacity;
+  };
+
+  static unsigned int GetSizeClass(size_t bufferSize);
+  static size_t GetClassCapacity(unsigned int sizeClass);
+  static size_t GetMemorySize(const Packet* packet);
+  static void Free(Packet* packet);
+
+  // class 0 holds packets without payload, class n payloads of 2^(MIN_CLASS_SHIFT + n - 1)
+  static const unsigned int MIN_CLASS_SHIFT = 10;
+  static const unsigned int MAX_CLASS_SHIFT = 22;
+  static const unsigned int SIZE_CLASSES = MAX_CLASS_SHIFT - MIN_CLASS_SHIFT + 2;
+  static const unsigned int UNPOOLED = SIZE_CLASSES;
+
+  std::vector<Packet*> m_free[SIZE_CLASSES];
+  size_t m_maxCachedBytes;
+  Stats m_stats;
+  mutable CCriticalSection m_section;
+};
@@ -0,0 +1,201 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "DVDDemuxReadAhead.h"
+#include "cores/VideoPlayer/DVDInputStreams/DVDInputStream.h"
+#include "threads/SingleLock.h"
+
+#include <algorithm>
+#include <stdio.h>
+#include <string.h>
+
+CDVDDemuxReadAhead::CDVDDemuxReadAhead(std::shared_ptr<CDVDInputStream> input, size_t size,
+                                       std::function<bool()> interrupted)
+  : CThread("DemuxReadAhead"),
+    m_input(std::move(input)),
+    m_interrupted(std::move(interrupted)),
+    m_buffer(size),
+    m_chunk(CHUNK_SIZE)
+{
+  int64_t pos = m_input->Seek(0, SEEK_CUR);
+  if (pos < 0)
+    pos = 0;
+  m_keepPos = m_readPos = m_fetchPos = pos;
+
+  Create();
+}
+
+CDVDDemuxReadAhead::~CDVDDemuxReadAhead()
+{
+  {
+    CSingleLock lock(m_section);
+    m_bStop = true;
+  }
+  m_spaceCond.notifyAll();
+  StopThread();
+}
+
+int CDVDDemuxReadAhead::Read(uint8_t* buf, int size)
+{
+  if (size <= 0)
+    return 0;
+
+  CSingleLock lock(m_section);
+
+  if (m_readPos >= m_fetchPos && !m_eof && !m_error)
+  {
+    m_stats.waits++;
+    while (m_readPos >= m_fetchPos && !m_eof && !m_error)
+    {
+      if (m_interrupted && m_interrupted())
+        return -1;
+      m_dataCond.wait(lock, WAIT_MS);
+    }
+  }
+
+  const size_t available = static_cast<size_t>(m_fetchPos - m_readPos);
+  if (available == 0)
+    return m_error ? -1 : 0;
+
+  const size_t bytes = std::min(available, static_cast<size_t>(size));
+  CopyOut(buf, m_readPos, bytes);
+  m_readPos += bytes;
+  m_stats.bytesRead += bytes;
+  lock.Leave();
+
+  m_spaceCond.notifyAll();
+  return static_cast<int>(bytes);
+}
+
+int64_t CDVDDemuxReadAhead::Seek(int64_t offset, int whence)
+{
+  int64_t target = offset;
+  if (whence == SEEK_CUR || whence == SEEK_SET)
+  {
+    CSingleLock lock(m_section);
+
+    if (whence == SEEK_CUR)
+      target = m_readPos + offset;
+
+    if (target >= m_keepPos && target <= m_fetchPos)
+    {
+      m_readPos = target;
+      m_stats.bufferedSeeks++;
+      lock.Leave();
+
+      m_spaceCond.notifyAll();
+      return target;
+    }
+  }
+  else if (whence != SEEK_END)
+    return -1;
+
+  // waits for a read of the worker to finish
+  CSingleLock inputLock(m_inputSection);
+  const int64_t pos = (whence == SEEK_END) ? m_input->Seek(offset, SEEK_END) : m_input->Seek(target, SEEK_SET);
+  if (pos < 0)
+    return pos;
+
+  {
+    CSingleLock lock(m_section);
+    m_generation++;
+    m_keepPos = m_readPos = m_fetchPos = pos;
+    m_eof = false;
+    m_error = false;
+    m_stats.inputSeeks++;
+  }
+  m_spaceCond.notifyAll();
+
+  return pos;
+}
+
+bool CDVDDemuxReadAhead::IsEOF()
+{
+  CSingleLock lock(m_section);
+  return m_eof && m_readPos >= m_fetchPos;
+}
+
+CDVDDemuxReadAhead::Stats CDVDDemuxReadAhead::GetStats()
+{
+  CSingleLock lock(m_section);
+  return m_stats;
+}
+
+void CDVDDemuxReadAhead::Process()
+{
+  const int64_t capacity = static_cast<int64_t>(m_buffer.size());
+
+  while (!m_bStop)
+  {
+    int64_t pos;
+    unsigned int generation;
+    size_t size;
+    {
+      CSingleLock lock(m_section);
+
+      for (;;)
+      {
+        // bytes far behind the read position make room for the next ones
+        m_keepPos = std::max(m_keepPos, m_readPos - capacity / 4);
+        if (m_bStop || (!m_eof && !m_error && m_fetchPos - m_keepPos < capacity))
+          break;
+        m_spaceCond.wait(lock);
+      }
+
+      if (m_bStop)
+        break;
+
+      pos = m_fetchPos;
+      generation = m_generation;
+      size = std::min(CHUNK_SIZE, static_cast<size_t>(capacity - (m_fetchPos - m_keepPos)));
+    }
+
+    CSingleLock inputLock(m_inputSection);
+    {
+      // the demuxer moved the input in the meantime
+      CSingleLock lock(m_section);
+      if (generation != m_generation)
+        continue;
+    }
+
+    const int bytes = m_input->Read(m_chunk.data(), static_cast<int>(size));
+
+    {
+      CSingleLock lock(m_section);
+      if (bytes > 0)
+      {
+        CopyIn(m_chunk.data(), pos, bytes);
+        m_fetchPos += bytes;
+        m_stats.bytesFetched += bytes;
+      }
+      else if (bytes == 0)
+        m_eof = true;
+      else
+        m_error = true;
+    }
+    inputLock.Leave();
+
+    m_dataCond.notifyAll();
+  }
+}
+
+void CDVDDemuxReadAhead::CopyOut(uint8_t* buf, int64_t pos, size_t size) const
+{
+  const size_t offset = static_cast<size_t>(pos % m_buffer.size());
+  const size_t first = std::min(size, m_buffer.size() - offset);
+  memcpy(buf, m_buffer.data() + offset, first);
+  memcpy(buf + first, m_buffer.data(), size - first);
+}
+
+void CDVDDemuxReadAhead::CopyIn(const uint8_t* buf, int64_t pos, size_t size)
+{
+  const size_t offset = static_cast<size_t>(pos % m_buffer.size());
+  const size_t first = std::min(size, m_buffer.size() - offset);
+  memcpy(m_buffer.data() + offset, buf, first);
+  memcpy(m_buffer.data(), buf + first, size - first);
+}
@@ -0,0 +1,101 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "threads/Condition.h"
+#include "threads/CriticalSection.h"
+#include "threads/Thread.h"
+
+#include <functional>
+#include <memory>
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+class CDVDInputStream;
+
+/*!
+ \brief Reads an input stream ahead of the demuxer on its own thread.
+
+ Remote files without a file cache are read with one blocking request per
+ buffer the demuxer asks for, so every cluster costs a round trip while
+ playback waits. The worker keeps reading the bytes after the read position
+ into a ring buffer. Seeks inside the buffered range, including a short range
+ behind the read position, don't touch the input at all. Other seeks are
+ passed to the input right away and the worker continues from there.
+
+ While it runs, the input stream must only be read and seeked through it.
+ */
+class CDVDDemuxReadAhead : private CThread
+{
+public:
+  struct Stats
+  {
+    uint64_t bytesRead = 0; //!< bytes handed to the demuxer
+    uint64_t bytesFetched = 0; //!< bytes read from the input by the worker
+    unsigned int bufferedSeeks = 0; //!< seeks that stayed in the buffer
+    unsigned int inputSeeks = 0; //!< seeks passed to the input
+    unsigned int waits = 0; //!< reads that had to wait for the worker
+  };
+
+  /*!
+   \param input the stream to read, positioned at the start of the data
+   \param size size of the ring buffer, a quarter of it is kept behind the read position
+   \param interrupted returns true if a waiting read should give up
+   */
+  CDVDDemuxReadAhead(std::shared_ptr<CDVDInputStream> input, size_t size,
+                     std::function<bool()> interrupted);
+  ~CDVDDemuxReadAhead() override;
+
+  /*!
+   \brief Read from the current position, waits for the worker if nothing is buffered
+   \return number of bytes read, 0 at the end of the stream, -1 on error or interruption
+   */
+  int Read(uint8_t* buf, int size);
+
+  /*!
+   \brief Seek like CDVDInputStream::Seek with SEEK_SET, SEEK_CUR or SEEK_END
+   \return the new position or -1 on error
+   */
+  int64_t Seek(int64_t offset, int whence);
+
+  /*!
+   \brief Whether all bytes of the input have been read
+   */
+  bool IsEOF();
+
+  Stats GetStats();
+
+protected:
+  void Process() override;
+
+private:
+  static const size_t CHUNK_SIZE = 256 * 1024;
+  static const unsigned int WAIT_MS = 100;
+
+  void CopyOut(uint8_t* buf, int64_t pos, size_t size) const;
+  void CopyIn(const uint8_t* buf, int64_t pos, size_t size);
+
+  std::shared_ptr<CDVDInputStream> m_input;
+  std::function<bool()> m_interrupted;
+  std::vector<uint8_t> m_buffer; //!< byte at file offset pos is at pos % size
+  std::vector<uint8_t> m_chunk;
+
+  CCriticalSection m_section;
+  CCriticalSection m_inputSection; //!< serializes reads of the worker and seeks of the demuxer
+  XbmcThreads::ConditionVariable m_dataCond;
+  XbmcThreads::ConditionVariable m_spaceCond;
+  int64_t m_keepPos = 0; //!< first buffered byte
+  int64_t m_readPos = 0; //!< position of the demuxer
+  int64_t m_fetchPos = 0; //!< end of the buffered bytes, the worker reads on from here
+  unsigned int m_generation = 0; //!< changes with every seek of the input
+  bool m_eof = false;
+  bool m_error = false;
+  Stats m_stats;
+};
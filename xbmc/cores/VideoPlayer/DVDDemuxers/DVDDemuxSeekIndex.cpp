@@ -0,0 +1,161 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "DVDDemuxSeekIndex.h"
+#include "threads/SingleLock.h"
+#include "utils/log.h"
+
+extern "C" {
+#include <libavformat/avformat.h>
+}
+
+namespace
+{
+int GetIndexEntryCount(AVStream* stream)
+{
+#if LIBAVFORMAT_VERSION_INT >= AV_VERSION_INT(58, 78, 100)
+  return avformat_index_get_entries_count(stream);
+#else
+  return stream->nb_index_entries;
+#endif
+}
+
+const AVIndexEntry* GetIndexEntry(AVStream* stream, int idx)
+{
+#if LIBAVFORMAT_VERSION_INT >= AV_VERSION_INT(58, 78, 100)
+  return avformat_index_get_entry(stream, idx);
+#else
+  return &stream->index_entries[idx];
+#endif
+}
+}
+
+const size_t CDVDDemuxSeekIndexCache::DEFAULT_MAX_FILES;
+
+CDVDDemuxSeekIndexCache& CDVDDemuxSeekIndexCache::GetInstance()
+{
+  static CDVDDemuxSeekIndexCache cache;
+  return cache;
+}
+
+CDVDDemuxSeekIndexCache::CDVDDemuxSeekIndexCache(size_t maxFiles)
+  : m_maxFiles(maxFiles)
+{
+}
+
+std::string CDVDDemuxSeekIndexCache::GetKey(const std::string& file, int64_t length)
+{
+  return file + "|" + std::to_string(length);
+}
+
+void CDVDDemuxSeekIndexCache::Store(const std::string& file, int64_t length, AVFormatContext* context)
+{
+  if (!context || length <= 0 || m_maxFiles == 0)
+    return;
+
+  // the stream av_seek_frame() uses without a stream index
+  const int streamIndex = av_find_default_stream_index(context);
+  if (streamIndex < 0 || static_cast<unsigned int>(streamIndex) >= context->nb_streams)
+    return;
+
+  AVStream* stream = context->streams[streamIndex];
+  const int count = GetIndexEntryCount(stream);
+  if (count <= 0)
+    return;
+
+  File entry;
+  entry.key = GetKey(file, length);
+  entry.streams = context->nb_streams;
+  entry.streamIndex = streamIndex;
+  entry.codecId = stream->codecpar->codec_id;
+  entry.entries.reserve(count);
+  for (int i = 0; i < count; i++)
+  {
+    const AVIndexEntry* index = GetIndexEntry(stream, i);
+    if (index && (index->flags & AVINDEX_KEYFRAME))
+      entry.entries.push_back({ index->pos, index->timestamp, index->size, index->min_distance });
+  }
+  if (entry.entries.empty())
+    return;
+
+  CSingleLock lock(m_section);
+
+  for (auto it = m_files.begin(); it != m_files.end(); ++it)
+  {
+    if (it->key == entry.key)
+    {
+      if (it->streamIndex == entry.streamIndex && it->entries.size() > entry.entries.size())
+      {
+        m_files.splice(m_files.begin(), m_files, it);
+        return;
+      }
+      m_files.erase(it);
+      break;
+    }
+  }
+
+  m_files.push_front(std::move(entry));
+  while (m_files.size() > m_maxFiles)
+    m_files.pop_back();
+
+  m_stats.stored++;
+}
+
+unsigned int CDVDDemuxSeekIndexCache::Restore(const std::string& file, int64_t length, AVFormatContext* context)
+{
+  if (!context || length <= 0)
+    return 0;
+
+  const std::string key = GetKey(file, length);
+
+  CSingleLock lock(m_section);
+
+  auto it = m_files.begin();
+  while (it != m_files.end() && it->key != key)
+    ++it;
+  if (it == m_files.end())
+    return 0;
+
+  // a different program or a changed file
+  if (it->streams != context->nb_streams ||
+      it->streamIndex != av_find_default_stream_index(context) ||
+      it->codecId != context->streams[it->streamIndex]->codecpar->codec_id)
+    return 0;
+
+  AVStream* stream = context->streams[it->streamIndex];
+  const int before = GetIndexEntryCount(stream);
+  if (static_cast<size_t>(before) >= it->entries.size())
+    return 0;
+
+  // entries already known are replaced by av_add_index_entry
+  for (const Entry& entry : it->entries)
+    av_add_index_entry(stream, entry.pos, entry.timestamp, entry.size, entry.distance, AVINDEX_KEYFRAME);
+
+  const int after = GetIndexEntryCount(stream);
+  const unsigned int added = after > before ? after - before : 0;
+
+  m_files.splice(m_files.begin(), m_files, it);
+  m_stats.restored++;
+  m_stats.restoredEntries += added;
+
+  CLog::Log(LOGDEBUG, "CDVDDemuxSeekIndexCache::Restore - added %u keyframes to the index of stream %d",
+            added, stream->index);
+  return added;
+}
+
+void CDVDDemuxSeekIndexCache::Clear()
+{
+  CSingleLock lock(m_section);
+  m_files.clear();
+}
+
+CDVDDemuxSeekIndexCache::Stats CDVDDemuxSeekIndexCache::GetStats() const
+{
+  CSingleLock lock(m_section);
+  return m_stats;
+}
@@ -0,0 +1,93 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "threads/CriticalSection.h"
+
+#include <list>
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+struct AVFormatContext;
+
+/*!
+ \brief Keyframe index of files played before in this session.
+
+ Formats without an index in the header, like MPEG-TS, MPEG-PS or raw
+ elementary streams, only learn where the keyframes are while they are read.
+ Seeks to positions that were not read yet have to be found by bisecting the
+ file, which costs several reads on remote files. The cache keeps the keyframe
+ entries of the stream ffmpeg seeks on when a demuxer is closed, and adds them
+ to the index again when the same file is opened next, e.g. after a stream
+ change, a resume or a demuxer reset.
+
+ Files are identified by their path and size. The cache only lives in memory
+ and holds the most recently closed files. All methods are thread-safe.
+ */
+class CDVDDemuxSeekIndexCache
+{
+public:
+  struct Stats
+  {
+    unsigned int stored = 0; //!< indexes kept when a demuxer was closed
+    unsigned int restored = 0; //!< indexes added to a demuxer when it was opened
+    uint64_t restoredEntries = 0; //!< index entries added to demuxers
+  };
+
+  static CDVDDemuxSeekIndexCache& GetInstance();
+
+  explicit CDVDDemuxSeekIndexCache(size_t maxFiles = DEFAULT_MAX_FILES);
+
+  CDVDDemuxSeekIndexCache(const CDVDDemuxSeekIndexCache&) = delete;
+  CDVDDemuxSeekIndexCache& operator=(const CDVDDemuxSeekIndexCache&) = delete;
+
+  /*!
+   \brief Keep the keyframe index of the default stream of a demuxer about to be closed
+   An index with fewer entries than the one already cached for the file is ignored.
+   */
+  void Store(const std::string& file, int64_t length, AVFormatContext* context);
+
+  /*!
+   \brief Add the cached keyframe index of the file to a demuxer that knows fewer entries
+   \return the number of entries added
+   */
+  unsigned int Restore(const std::string& file, int64_t length, AVFormatContext* context);
+
+  void Clear();
+  Stats GetStats() const;
+
+  static const size_t DEFAULT_MAX_FILES = 64;
+
+private:
+  struct Entry
+  {
+    int64_t pos;
+    int64_t timestamp;
+    int size;
+    int distance;
+  };
+
+  struct File
+  {
+    std::string key;
+    unsigned int streams;
+    int streamIndex;
+    int codecId;
+    std::vector<Entry> entries;
+  };
+
+  static std::string GetKey(const std::string& file, int64_t length);
+
+  std::list<File> m_files; //!< most recently stored first
+  size_t m_maxFiles;
+  Stats m_stats;
+  mutable CCriticalSection m_section;
+};
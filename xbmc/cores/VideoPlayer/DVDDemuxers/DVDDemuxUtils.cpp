@@ -7,13 +7,10 @@
  */
 
 #include "DVDDemuxUtils.h"
+#include "DVDDemuxPacketPool.h"
 #include "cores/VideoPlayer/Interface/Addon/DemuxCrypto.h"
 #include "utils/log.h"
 
-#ifdef TARGET_POSIX
-#include "platform/linux/XMemUtils.h"
-#endif
-
 extern "C" {
 #include <libavcodec/avcodec.h>
 }
@@ -22,8 +19,6 @@ void CDVDDemuxUtils::FreeDemuxPacket(DemuxPacket* pPacket)
 {
   if (pPacket)
   {
-    if (pPacket->pData)
-      _aligned_free(pPacket->pData);
     if (pPacket->iSideDataElems)
     {
       AVPacket avPkt;
@@ -32,35 +27,34 @@ void CDVDDemuxUtils::FreeDemuxPacket(DemuxPacket* pPacket)
       avPkt.side_data_elems = pPacket->iSideDataElems;
       av_packet_free_side_data(&avPkt);
     }
-    delete pPacket;
+    CDVDDemuxPacketPool::GetInstance().Release(pPacket);
   }
 }
 
 DemuxPacket* CDVDDemuxUtils::AllocateDemuxPacket(int iDataSize)
 {
-  DemuxPacket* pPacket = new DemuxPacket();
+  if (iDataSize < 0)
+    iDataSize = 0;
 
-  if (iDataSize > 0)
-  {
-    // need to allocate a few bytes more.
-    // From avcodec.h (ffmpeg)
-    /**
-     * Required number of additionally allocated bytes at the end of the input bitstream for decoding.
-     * this is mainly needed because some optimized bitstream readers read
-     * 32 or 64 bit at once and could read over the end<br>
-     * Note, if the first 23 bits of the additional bytes are not 0 then damaged
-     * MPEG bitstreams could cause overread and segfault
-     */
-    pPacket->pData =(uint8_t*)_aligned_malloc(iDataSize + AV_INPUT_BUFFER_PADDING_SIZE, 16);
-    if (!pPacket->pData)
-    {
-      FreeDemuxPacket(pPacket);
-      return NULL;
-    }
+  // need to allocate a few bytes more.
+  // From avcodec.h (ffmpeg)
+  /**
+   * Required number of additionally allocated bytes at the end of the input bitstream for decoding.
+   * this is mainly needed because some optimized bitstream readers read
+   * 32 or 64 bit at once and could read over the end<br>
+   * Note, if the first 23 bits of the additional bytes are not 0 then damaged
+   * MPEG bitstreams could cause overread and segfault
+   */
+  size_t bufferSize = iDataSize > 0 ? iDataSize + AV_INPUT_BUFFER_PADDING_SIZE : 0;
+
+  // packets and their buffers are recycled by the pool, see CDVDDemuxPacketPool
+  DemuxPacket* pPacket = CDVDDemuxPacketPool::GetInstance().Allocate(bufferSize);
+  if (!pPacket)
+    return NULL;
 
-    // reset the last 8 bytes to 0;
+  // reset the padding to 0, a recycled buffer holds the data of a previous packet
+  if (iDataSize > 0)
     memset(pPacket->pData + iDataSize, 0, AV_INPUT_BUFFER_PADDING_SIZE);
-  }
 
   return pPacket;
 }
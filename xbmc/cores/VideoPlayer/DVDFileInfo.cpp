@@ -32,6 +32,7 @@
 #include "DVDCodecs/Video/DVDVideoCodecFFmpeg.h"
 #include "DVDDemuxers/DVDDemuxVobsub.h"
 #include "Process/ProcessInfo.h"
+#include "threads/SingleLock.h"
 
 #include <libavcodec/avcodec.h>
 #include <libswscale/swscale.h>
@@ -42,6 +43,7 @@
 #include "utils/LangCodeExpander.h"
 
 #include <cstdlib>
+#include <list>
 #include <memory>
 
 extern "C" {
@@ -71,6 +73,134 @@ bool CDVDFileInfo::GetFileDuration(const std::string &path, int& duration)
     return false;
 }
 
+namespace
+{
+/*!
+ * \brief Software decoder of a thumb extraction with the process info it reports to
+ */
+struct ThumbDecoder
+{
+  CDVDStreamInfo hint;
+  std::unique_ptr<CProcessInfo> processInfo;
+  std::unique_ptr<CDVDVideoCodec> codec;
+};
+
+// The files of a library mostly share codec, size and extradata. Opening the
+// decoder costs more than the single picture it decodes, so a few decoders of
+// previous extractions are kept for the next files of the same format.
+const size_t MAX_IDLE_THUMB_DECODERS = 4;
+CCriticalSection thumbDecoderSection;
+std::list<ThumbDecoder> idleThumbDecoders;
+
+bool AcquireThumbDecoder(CDVDStreamInfo& hint, ThumbDecoder& decoder)
+{
+  {
+    CSingleLock lock(thumbDecoderSection);
+    for (auto it = idleThumbDecoders.begin(); it != idleThumbDecoders.end(); ++it)
+    {
+      if (it->hint.Equal(hint, true))
+      {
+        decoder = std::move(*it);
+        idleThumbDecoders.erase(it);
+        lock.Leave();
+
+        decoder.codec->Reset();
+        decoder.codec->SetCodecControl(0);
+        return true;
+      }
+    }
+  }
+
+  decoder.hint = hint;
+  decoder.processInfo.reset(CProcessInfo::CreateInstance());
+  std::vector<AVPixelFormat> pixFmts;
+  pixFmts.push_back(AV_PIX_FMT_YUV420P);
+  decoder.processInfo->SetPixFormats(pixFmts);
+
+  // add-on codecs go through the factory, software decoders don't need its lock
+  if (hint.externalInterfaces)
+  {
+    decoder.codec.reset(CDVDFactoryCodec::CreateVideoCodec(hint, *decoder.processInfo));
+  }
+  else
+  {
+    CDVDCodecOptions options;
+    decoder.codec.reset(new CDVDVideoCodecFFmpeg(*decoder.processInfo));
+    if (!decoder.codec->Open(hint, options))
+      decoder.codec.reset();
+  }
+
+  return decoder.codec != nullptr;
+}
+
+void ReleaseThumbDecoder(ThumbDecoder& decoder)
+{
+  // add-on instances are not shared between files
+  if (!decoder.codec || decoder.hint.externalInterfaces)
+    return;
+
+  CSingleLock lock(thumbDecoderSection);
+  idleThumbDecoders.push_front(std::move(decoder));
+  if (idleThumbDecoders.size() > MAX_IDLE_THUMB_DECODERS)
+    idleThumbDecoders.pop_back();
+}
+
+/*!
+ * \brief Decode packets of the video stream until the decoder returns a picture
+ * \param keyFramesOnly skip all but key frames and drain the decoder after each
+ *        one, a single key frame doesn't leave the reorder delay otherwise
+ */
+bool DecodeThumbPicture(CDVDDemux* demuxer, CDVDVideoCodec* codec, int streamId,
+                        bool keyFramesOnly, VideoPicture& picture, int& packetsTried)
+{
+  const int flags = keyFramesOnly ? DVD_CODEC_CTRL_KEYFRAMES : 0;
+  codec->SetCodecControl(flags);
+
+  // num streams * 160 frames, should get a valid frame, if not abort.
+  int abort_index = demuxer->GetNrOfStreams() * 160;
+  do
+  {
+    DemuxPacket* pPacket = demuxer->Read();
+    packetsTried++;
+
+    if (!pPacket)
+      break;
+
+    if (pPacket->iStreamId != streamId)
+    {
+      CDVDDemuxUtils::FreeDemuxPacket(pPacket);
+      continue;
+    }
+
+    codec->AddData(*pPacket);
+    CDVDDemuxUtils::FreeDemuxPacket(pPacket);
+
+    CDVDVideoCodec::VCReturn iDecoderState = CDVDVideoCodec::VC_NONE;
+    while (iDecoderState == CDVDVideoCodec::VC_NONE)
+      iDecoderState = codec->GetPicture(&picture);
+
+    if (iDecoderState == CDVDVideoCodec::VC_BUFFER && keyFramesOnly)
+    {
+      codec->SetCodecControl(flags | DVD_CODEC_CTRL_DRAIN);
+      iDecoderState = CDVDVideoCodec::VC_NONE;
+      while (iDecoderState == CDVDVideoCodec::VC_NONE || iDecoderState == CDVDVideoCodec::VC_BUFFER)
+        iDecoderState = codec->GetPicture(&picture);
+      codec->SetCodecControl(flags);
+
+      // a drained decoder stays at eof and would reject every later packet
+      if (iDecoderState != CDVDVideoCodec::VC_PICTURE || (picture.iFlags & DVP_FLAG_DROPPED))
+        codec->Reset();
+    }
+
+    if (iDecoderState == CDVDVideoCodec::VC_PICTURE && !(picture.iFlags & DVP_FLAG_DROPPED))
+      return true;
+
+  } while (abort_index--);
+
+  return false;
+}
+}
+
 int DegreeToOrientation(int degrees)
 {
   switch(degrees)
@@ -186,18 +316,11 @@ bool CDVDFileInfo::ExtractThumb(const CFileItem& fileItem,
 
   if (nVideoStream != -1)
   {
-    CDVDVideoCodec *pVideoCodec;
-    std::unique_ptr<CProcessInfo> pProcessInfo(CProcessInfo::CreateInstance());
-    std::vector<AVPixelFormat> pixFmts;
-    pixFmts.push_back(AV_PIX_FMT_YUV420P);
-    pProcessInfo->SetPixFormats(pixFmts);
-
     CDVDStreamInfo hint(*pDemuxer->GetStream(demuxerId, nVideoStream), true);
     hint.codecOptions = CODEC_FORCE_SOFTWARE;
 
-    pVideoCodec = CDVDFactoryCodec::CreateVideoCodec(hint, *pProcessInfo);
-
-    if (pVideoCodec)
+    ThumbDecoder decoder;
+    if (AcquireThumbDecoder(hint, decoder))
     {
       int nTotalLen = pDemuxer->GetStreamLength();
       int nSeekTo = (pos == -1) ? nTotalLen / 3 : pos;
@@ -205,43 +328,20 @@ bool CDVDFileInfo::ExtractThumb(const CFileItem& fileItem,
       CLog::Log(LOGDEBUG,"%s - seeking to pos %dms (total: %dms) in %s", __FUNCTION__, nSeekTo, nTotalLen, redactPath.c_str());
       if (pDemuxer->SeekTime(nSeekTo, true))
       {
-        CDVDVideoCodec::VCReturn iDecoderState = CDVDVideoCodec::VC_NONE;
         VideoPicture picture = {};
 
-        // num streams * 160 frames, should get a valid frame, if not abort.
-        int abort_index = pDemuxer->GetNrOfStreams() * 160;
-        do
+        // the demuxer seeked to the key frame before the position, everything
+        // after it only costs time. Streams without flagged key frames are
+        // decoded in full from the same position.
+        bool decoded = DecodeThumbPicture(pDemuxer, decoder.codec.get(), nVideoStream, true, picture, packetsTried);
+        if (!decoded && pDemuxer->SeekTime(nSeekTo, true))
         {
-          DemuxPacket* pPacket = pDemuxer->Read();
-          packetsTried++;
-
-          if (!pPacket)
-            break;
-
-          if (pPacket->iStreamId != nVideoStream)
-          {
-            CDVDDemuxUtils::FreeDemuxPacket(pPacket);
-            continue;
-          }
-
-          pVideoCodec->AddData(*pPacket);
-          CDVDDemuxUtils::FreeDemuxPacket(pPacket);
-
-          iDecoderState = CDVDVideoCodec::VC_NONE;
-          while (iDecoderState == CDVDVideoCodec::VC_NONE)
-          {
-            iDecoderState = pVideoCodec->GetPicture(&picture);
-          }
-
-          if (iDecoderState == CDVDVideoCodec::VC_PICTURE)
-          {
-            if(!(picture.iFlags & DVP_FLAG_DROPPED))
-              break;
-          }
-
-        } while (abort_index--);
+          CLog::Log(LOGDEBUG, "%s - no key frame in %s, decoding all frames", __FUNCTION__, redactPath.c_str());
+          decoder.codec->Reset();
+          decoded = DecodeThumbPicture(pDemuxer, decoder.codec.get(), nVideoStream, false, picture, packetsTried);
+        }
 
-        if (iDecoderState == CDVDVideoCodec::VC_PICTURE && !(picture.iFlags & DVP_FLAG_DROPPED))
+        if (decoded)
         {
           {
             unsigned int nWidth = std::min(picture.iDisplayWidth, CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_imageRes);
@@ -281,7 +381,7 @@ bool CDVDFileInfo::ExtractThumb(const CFileItem& fileItem,
           CLog::Log(LOGDEBUG,"%s - decode failed in %s after %d packets.", __FUNCTION__, redactPath.c_str(), packetsTried);
         }
       }
-      delete pVideoCodec;
+      ReleaseThumbDecoder(decoder);
     }
   }
 
@@ -300,6 +400,15 @@ bool CDVDFileInfo::ExtractThumb(const CFileItem& fileItem,
   return bOk;
 }
 
+void CDVDFileInfo::ClearThumbDecoders()
+{
+  std::list<ThumbDecoder> decoders;
+  {
+    CSingleLock lock(thumbDecoderSection);
+    decoders.swap(idleThumbDecoders);
+  }
+}
+
 /**
  * \brief Open the item pointed to by pItem and extract streamdetails
  * \return true if the stream details have changed
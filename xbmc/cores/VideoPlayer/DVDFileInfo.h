@@ -28,6 +28,10 @@ public:
                            CStreamDetails *pStreamDetails,
                            int64_t pos);
 
+  /** \brief Free the decoders ExtractThumb keeps for following files of the same format.
+  */
+  static void ClearThumbDecoders();
+
   // Probe the files streams and store the info in the VideoInfoTag
   static bool GetFileStreamDetails(CFileItem *pItem);
   static bool DemuxerToStreamDetails(std::shared_ptr<CDVDInputStream> pInputStream, CDVDDemux *pDemux, CStreamDetails &details, const std::string &path = "");
@@ -13,6 +13,7 @@
 #include "threads/CriticalSection.h"
 #include "threads/Condition.h"
 #include "utils/MathUtils.h"
+#include "utils/TimeUtils.h"
 #include "utils/log.h"
 
 class CDVDMsgGeneralSynchronizePriv
@@ -98,6 +99,7 @@ CDVDMsgDemuxerPacket::CDVDMsgDemuxerPacket(DemuxPacket* packet, bool drop) : CDV
 {
   m_packet = packet;
   m_drop   = drop;
+  m_created = CurrentHostCounter();
 }
 
 CDVDMsgDemuxerPacket::~CDVDMsgDemuxerPacket()
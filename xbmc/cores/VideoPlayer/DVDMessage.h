@@ -286,6 +286,8 @@ public:
   bool GetPacketDrop() { return m_drop; }
   DemuxPacket* m_packet;
   bool m_drop;
+  int64_t m_created; //!< host counter when the packet was sent to the player
+  int64_t m_demuxDuration = 0; //!< host counter ticks the demuxer took to read the packet
 };
 
 class CDVDMsgDemuxerReset : public CDVDMsg
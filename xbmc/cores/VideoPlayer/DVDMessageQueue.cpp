@@ -13,6 +13,41 @@
 #include "cores/VideoPlayer/Interface/Addon/TimingConstants.h"
 #include "math.h"
 
+void CDVDMessageRing::emplace_front(CDVDMsg* msg, int priority)
+{
+  if (m_count == m_items.size())
+    Grow();
+
+  m_head = (m_head + m_items.size() - 1) & (m_items.size() - 1);
+  m_items[m_head] = DVDMessageListItem(msg, priority);
+  m_count++;
+}
+
+void CDVDMessageRing::emplace_back(CDVDMsg* msg, int priority)
+{
+  if (m_count == m_items.size())
+    Grow();
+
+  m_items[Index(m_count)] = DVDMessageListItem(msg, priority);
+  m_count++;
+}
+
+void CDVDMessageRing::pop_back()
+{
+  back() = DVDMessageListItem();
+  m_count--;
+}
+
+void CDVDMessageRing::Grow()
+{
+  std::vector<DVDMessageListItem> items(std::max<size_t>(64, m_items.size() * 2));
+  for (size_t i = 0; i < m_count; i++)
+    items[i] = std::move(m_items[Index(i)]);
+
+  m_items.swap(items);
+  m_head = 0;
+}
+
 CDVDMessageQueue::CDVDMessageQueue(const std::string &owner) : m_hEvent(true), m_owner(owner)
 {
   m_iDataSize     = 0;
@@ -39,25 +74,34 @@ void CDVDMessageQueue::Init()
   m_TimeBack = DVD_NOPTS_VALUE;
   m_TimeFront = DVD_NOPTS_VALUE;
   m_drain = false;
+  m_packetCount = 0;
+  ResetPeaks();
 }
 
 void CDVDMessageQueue::Flush(CDVDMsg::Message type)
 {
   CSingleLock lock(m_section);
 
-  m_messages.remove_if([type](const DVDMessageListItem &item){
+  auto matches = [type](const DVDMessageListItem &item){
     return type == CDVDMsg::NONE || item.message->IsType(type);
-  });
+  };
 
-  m_prioMessages.remove_if([type](const DVDMessageListItem &item){
-    return type == CDVDMsg::NONE || item.message->IsType(type);
-  });
+  m_messages.remove_if(matches);
+
+  m_prioCount = 0;
+  for (auto &prio : m_prioMessages)
+  {
+    prio.second.remove_if(matches);
+    m_prioCount += prio.second.size();
+  }
 
   if (type == CDVDMsg::DEMUXER_PACKET ||  type == CDVDMsg::NONE)
   {
     m_iDataSize = 0;
+    m_packetCount = 0;
     m_TimeBack = DVD_NOPTS_VALUE;
     m_TimeFront = DVD_NOPTS_VALUE;
+    ResetPeaks();
   }
 }
 
@@ -110,15 +154,15 @@ MsgQueueReturnCode CDVDMessageQueue::Put(CDVDMsg* pMsg, int priority, bool front
 
   if (priority > 0)
   {
-    int prio = priority;
-    if (!front)
-      prio++;
-
-    auto it = std::find_if(m_prioMessages.begin(), m_prioMessages.end(),
-                           [prio](const DVDMessageListItem &item){
-                             return prio <= item.priority;
-                           });
-    m_prioMessages.emplace(it, pMsg, priority);
+    // Get takes from the back of the ring: messages put to the front are
+    // served in the order they were put (fifo), a message put back is served
+    // before any other message of its priority
+    CDVDMessageRing &msgs = m_prioMessages[priority];
+    if (front)
+      msgs.emplace_front(pMsg, priority);
+    else
+      msgs.emplace_back(pMsg, priority);
+    m_prioCount++;
   }
   else
   {
@@ -129,6 +173,7 @@ MsgQueueReturnCode CDVDMessageQueue::Put(CDVDMsg* pMsg, int priority, bool front
       m_TimeFront = DVD_NOPTS_VALUE;
     }
 
+    // same order as above
     if (front)
       m_messages.emplace_front(pMsg, priority);
     else
@@ -145,9 +190,13 @@ MsgQueueReturnCode CDVDMessageQueue::Put(CDVDMsg* pMsg, int priority, bool front
         UpdateTimeFront();
       else
         UpdateTimeBack();
+      UpdatePeaks();
     }
   }
 
+  if (pMsg->IsType(CDVDMsg::DEMUXER_PACKET))
+    m_packetCount++;
+
   pMsg->Release();
 
   // inform waiter for new packet
@@ -172,11 +221,25 @@ MsgQueueReturnCode CDVDMessageQueue::Get(CDVDMsg** pMsg, unsigned int iTimeoutIn
 
   while (!m_bAbortRequest)
   {
-    std::list<DVDMessageListItem> &msgs = (priority > 0 || !m_prioMessages.empty()) ? m_prioMessages : m_messages;
+    CDVDMessageRing *msgs = nullptr;
+    if (m_prioCount > 0)
+    {
+      // highest priority that has messages waiting
+      for (auto it = m_prioMessages.rbegin(); it != m_prioMessages.rend(); ++it)
+      {
+        if (!it->second.empty())
+        {
+          msgs = &it->second;
+          break;
+        }
+      }
+    }
+    else if (priority == 0)
+      msgs = &m_messages;
 
-    if (!msgs.empty() && (msgs.back().priority >= priority || m_drain))
+    if (msgs && !msgs->empty() && (msgs->back().priority >= priority || m_drain))
     {
-      DVDMessageListItem& item(msgs.back());
+      DVDMessageListItem& item(msgs->back());
       priority = item.priority;
 
       if (item.message->IsType(CDVDMsg::DEMUXER_PACKET) && item.priority == 0)
@@ -188,8 +251,13 @@ MsgQueueReturnCode CDVDMessageQueue::Get(CDVDMsg** pMsg, unsigned int iTimeoutIn
         }
       }
 
+      if (item.message->IsType(CDVDMsg::DEMUXER_PACKET))
+        m_packetCount--;
+
       *pMsg = item.message->Acquire();
-      msgs.pop_back();
+      msgs->pop_back();
+      if (msgs != &m_messages)
+        m_prioCount--;
       UpdateTimeBack();
       ret = MSGQ_OK;
       break;
@@ -269,17 +337,17 @@ unsigned CDVDMessageQueue::GetPacketCount(CDVDMsg::Message type)
   if (!m_bInitialized)
     return 0;
 
+  if (type == CDVDMsg::DEMUXER_PACKET)
+    return m_packetCount;
+
   unsigned count = 0;
-  for (const auto &item : m_messages)
-  {
-    if(item.message->IsType(type))
-      count++;
-  }
-  for (const auto &item : m_prioMessages)
-  {
+  auto countType = [type, &count](const DVDMessageListItem &item){
     if(item.message->IsType(type))
       count++;
-  }
+  };
+  m_messages.for_each(countType);
+  for (const auto &prio : m_prioMessages)
+    prio.second.for_each(countType);
 
   return count;
 }
@@ -307,6 +375,11 @@ int CDVDMessageQueue::GetLevel() const
 {
   CSingleLock lock(m_section);
 
+  return GetLevelInternal();
+}
+
+int CDVDMessageQueue::GetLevelInternal() const
+{
   if (m_iDataSize > m_iMaxDataSize)
     return 100;
   if (m_iDataSize == 0)
@@ -333,10 +406,43 @@ int CDVDMessageQueue::GetTimeSize() const
 {
   CSingleLock lock(m_section);
 
+  return (int)GetTimeSizeInternal();
+}
+
+double CDVDMessageQueue::GetTimeSizeInternal() const
+{
   if (IsDataBased())
-    return 0;
+    return 0.0;
   else
-    return (int)((m_TimeFront - m_TimeBack) / DVD_TIME_BASE);
+    return (m_TimeFront - m_TimeBack) / DVD_TIME_BASE;
+}
+
+void CDVDMessageQueue::UpdatePeaks()
+{
+  m_iDataSizePeak = std::max(m_iDataSizePeak, m_iDataSize);
+  m_TimeSizePeak = std::max(m_TimeSizePeak, GetTimeSizeInternal());
+}
+
+void CDVDMessageQueue::ResetPeaks()
+{
+  m_iDataSizePeak = 0;
+  m_TimeSizePeak = 0.0;
+}
+
+CDataCacheCore::SPlayerQueueInfo CDVDMessageQueue::GetQueueInfo() const
+{
+  CSingleLock lock(m_section);
+
+  CDataCacheCore::SPlayerQueueInfo info;
+  info.level = GetLevelInternal();
+  info.packets = m_packetCount;
+  info.dataSize = m_iDataSize;
+  info.dataSizeMax = m_iMaxDataSize;
+  info.dataSizePeak = m_iDataSizePeak;
+  info.timeSize = GetTimeSizeInternal();
+  info.timeSizeMax = 1.0 / m_TimeSize;
+  info.timeSizePeak = m_TimeSizePeak;
+  return info;
 }
 
 bool CDVDMessageQueue::IsDataBased() const
@@ -9,9 +9,12 @@
 #pragma once
 
 #include "DVDMessage.h"
+#include "cores/DataCacheCore.h"
 #include <atomic>
 #include <string>
 #include <list>
+#include <map>
+#include <vector>
 #include <algorithm>
 #include "threads/CriticalSection.h"
 #include "threads/Event.h"
@@ -29,6 +32,12 @@ struct DVDMessageListItem
     priority = 0;
   }
   DVDMessageListItem(const DVDMessageListItem&) = delete;
+  DVDMessageListItem(DVDMessageListItem&& other) noexcept
+  {
+    message = other.message;
+    priority = other.priority;
+    other.message = NULL;
+  }
  ~DVDMessageListItem()
   {
     if(message)
@@ -36,11 +45,79 @@ struct DVDMessageListItem
   }
 
   DVDMessageListItem& operator=(const DVDMessageListItem&) = delete;
+  DVDMessageListItem& operator=(DVDMessageListItem&& other) noexcept
+  {
+    if (this != &other)
+    {
+      if (message)
+        message->Release();
+      message = other.message;
+      priority = other.priority;
+      other.message = NULL;
+    }
+    return *this;
+  }
 
   CDVDMsg* message;
   int priority;
 };
 
+/*!
+ * \brief Double ended ring of messages
+ *
+ * Items live in one contiguous, power of two sized array that only ever grows,
+ * so once the queue has reached its working size putting and getting messages
+ * does not allocate. Front is where new messages are put, back is where they
+ * are taken from.
+ */
+class CDVDMessageRing
+{
+public:
+  bool empty() const { return m_count == 0; }
+  size_t size() const { return m_count; }
+
+  DVDMessageListItem& front() { return m_items[m_head]; }
+  DVDMessageListItem& back() { return m_items[Index(m_count - 1)]; }
+
+  void emplace_front(CDVDMsg* msg, int priority);
+  void emplace_back(CDVDMsg* msg, int priority);
+  void pop_back();
+
+  template<typename Pred>
+  void remove_if(Pred pred)
+  {
+    size_t kept = 0;
+    for (size_t i = 0; i < m_count; i++)
+    {
+      DVDMessageListItem &item = m_items[Index(i)];
+      if (pred(item))
+        item = DVDMessageListItem();
+      else
+      {
+        if (kept != i)
+          m_items[Index(kept)] = std::move(item);
+        kept++;
+      }
+    }
+    m_count = kept;
+  }
+
+  template<typename Func>
+  void for_each(Func func) const
+  {
+    for (size_t i = 0; i < m_count; i++)
+      func(m_items[Index(i)]);
+  }
+
+private:
+  size_t Index(size_t i) const { return (m_head + i) & (m_items.size() - 1); }
+  void Grow();
+
+  std::vector<DVDMessageListItem> m_items;
+  size_t m_head = 0;
+  size_t m_count = 0;
+};
+
 enum MsgQueueReturnCode
 {
   MSGQ_OK = 1,
@@ -64,6 +141,11 @@ public:
   void Abort();
   void End();
 
+  /**
+   * Higher priorities are served first, messages of equal priority in the
+   * order they were put. PutBack returns a message to the queue so that it
+   * is served before any other message of its priority.
+   */
   MsgQueueReturnCode Put(CDVDMsg* pMsg, int priority = 0);
   MsgQueueReturnCode PutBack(CDVDMsg* pMsg, int priority = 0);
 
@@ -82,6 +164,11 @@ public:
   int GetDataSize() const { return m_iDataSize; }
   int GetTimeSize() const;
   unsigned GetPacketCount(CDVDMsg::Message type);
+
+  /*!
+   * \brief Get fill level, byte and time watermarks of the queue
+   */
+  CDataCacheCore::SPlayerQueueInfo GetQueueInfo() const;
   bool ReceivedAbortRequest() { return m_bAbortRequest; }
   void WaitUntilEmpty();
 
@@ -98,9 +185,14 @@ public:
 
 private:
 
+  // front is set for Put and cleared for PutBack
   MsgQueueReturnCode Put(CDVDMsg* pMsg, int priority, bool front);
   void UpdateTimeFront();
   void UpdateTimeBack();
+  void UpdatePeaks();
+  void ResetPeaks();
+  int GetLevelInternal() const;
+  double GetTimeSizeInternal() const;
 
   CEvent m_hEvent;
   mutable CCriticalSection m_section;
@@ -110,6 +202,9 @@ private:
   bool m_drain = false;
 
   int m_iDataSize;
+  int m_iDataSizePeak = 0;
+  double m_TimeSizePeak = 0.0;
+  unsigned int m_packetCount = 0;
   double m_TimeFront;
   double m_TimeBack;
   double m_TimeSize;
@@ -117,7 +212,8 @@ private:
   int m_iMaxDataSize;
   std::string m_owner;
 
-  std::list<DVDMessageListItem> m_messages;
-  std::list<DVDMessageListItem> m_prioMessages;
+  CDVDMessageRing m_messages;
+  std::map<int, CDVDMessageRing> m_prioMessages; // one ring per priority, highest is served first
+  size_t m_prioCount = 0;
 };
 
@@ -7,104 +7,114 @@
  */
 
 #include "DVDSubtitleLineCollection.h"
-#include <stddef.h>
 
+#include <algorithm>
+#include <limits>
 
-CDVDSubtitleLineCollection::CDVDSubtitleLineCollection()
-{
-  m_pHead = NULL;
-  m_pCurrent = NULL;
-  m_pTail = NULL;
-
-  m_iSize = 0;
-}
+CDVDSubtitleLineCollection::CDVDSubtitleLineCollection() = default;
 
 CDVDSubtitleLineCollection::~CDVDSubtitleLineCollection()
 {
   Clear();
 }
 
+void CDVDSubtitleLineCollection::Reserve(size_t count)
+{
+  m_overlays.reserve(count);
+}
+
 void CDVDSubtitleLineCollection::Add(CDVDOverlay* pOverlay)
 {
-  ListElement* pElement = new ListElement;
-  pElement->pOverlay = pOverlay;
-  pElement->pNext = NULL;
+  m_overlays.push_back(pOverlay);
+  m_indexed = false;
+}
 
-  if (!m_pHead)
-  {
-    m_pHead = m_pTail = pElement;
-    m_pCurrent = m_pHead;
-  }
-  else
+void CDVDSubtitleLineCollection::Sort()
+{
+  std::stable_sort(m_overlays.begin(), m_overlays.end(), [](const CDVDOverlay* a, const CDVDOverlay* b)
   {
-    m_pTail->pNext = pElement;
-    m_pTail = pElement;
-  }
+    return a->iPTSStartTime < b->iPTSStartTime;
+  });
+  m_indexed = false;
+}
 
-  m_iSize++;
+void CDVDSubtitleLineCollection::BuildIndex()
+{
+  m_leaves = 1;
+  while (m_leaves < m_overlays.size())
+    m_leaves *= 2;
+
+  // node i covers the nodes 2i and 2i + 1, the leaves start at m_leaves
+  m_maxStop.assign(2 * m_leaves, std::numeric_limits<double>::lowest());
+  for (size_t i = 0; i < m_overlays.size(); i++)
+    m_maxStop[m_leaves + i] = m_overlays[i]->iPTSStopTime;
+  for (size_t i = m_leaves - 1; i > 0; i--)
+    m_maxStop[i] = std::max(m_maxStop[2 * i], m_maxStop[2 * i + 1]);
+
+  m_indexed = true;
 }
 
-void CDVDSubtitleLineCollection::Sort()
+size_t CDVDSubtitleLineCollection::FindFirst(size_t start, double iPts) const
 {
-  if (!m_pHead || !m_pHead->pNext)
-    return;
+  if (start >= m_overlays.size())
+    return m_overlays.size();
 
-  for (ListElement* p1 = m_pHead; p1->pNext != NULL; p1 = p1->pNext)
+  // walk up from the leaf of start until a right hand subtree holds a stop time at iPts or later
+  size_t node = m_leaves + start;
+  if (m_maxStop[node] >= iPts)
+    return start;
+
+  for (;;)
   {
-    for (ListElement* p2 = p1->pNext; p2 != NULL; p2 = p2->pNext)
+    // the subtree of the root was searched already
+    if (node == 1)
+      return m_overlays.size();
+
+    if (node % 2 == 0 && m_maxStop[node + 1] >= iPts)
     {
-      if (p1->pOverlay->iPTSStartTime > p2->pOverlay->iPTSStartTime)
-      {
-        CDVDOverlay* temp = p1->pOverlay;
-        p1->pOverlay = p2->pOverlay;
-        p2->pOverlay = temp;
-      }
+      node++;
+      break;
     }
+    node /= 2;
   }
+
+  // walk down to the leftmost leaf in that subtree
+  while (node < m_leaves)
+  {
+    node *= 2;
+    if (m_maxStop[node] < iPts)
+      node++;
+  }
+
+  return node - m_leaves;
 }
 
 CDVDOverlay* CDVDSubtitleLineCollection::Get(double iPts)
 {
-  CDVDOverlay* pOverlay = NULL;
-
-  if (m_pCurrent)
-  {
-    while (m_pCurrent && m_pCurrent->pOverlay->iPTSStopTime < iPts)
-    {
-      m_pCurrent = m_pCurrent->pNext;
-    }
+  if (!m_indexed)
+    BuildIndex();
 
-    if (m_pCurrent)
-    {
-      pOverlay = m_pCurrent->pOverlay;
+  m_current = FindFirst(m_current, iPts);
+  if (m_current >= m_overlays.size())
+    return NULL;
 
-      // advance to the next overlay
-      m_pCurrent = m_pCurrent->pNext;
-    }
-  }
-  return pOverlay;
+  // advance to the next overlay
+  return m_overlays[m_current++];
 }
 
 void CDVDSubtitleLineCollection::Reset()
 {
-  m_pCurrent = m_pHead;
+  m_current = 0;
 }
 
 void CDVDSubtitleLineCollection::Clear()
 {
-  ListElement* pElement = NULL;
-
-  while (m_pHead)
-  {
-    pElement = m_pHead;
-    m_pHead = pElement->pNext;
-
-    pElement->pOverlay->Release();
-    delete pElement;
-  }
-
-  m_pTail    = NULL;
-  m_pHead    = NULL;
-  m_pCurrent = NULL;
-  m_iSize    = 0;
+  for (CDVDOverlay* pOverlay : m_overlays)
+    pOverlay->Release();
+
+  m_overlays.clear();
+  m_maxStop.clear();
+  m_leaves = 0;
+  m_current = 0;
+  m_indexed = false;
 }
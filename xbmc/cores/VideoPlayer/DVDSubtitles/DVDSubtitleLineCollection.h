@@ -10,39 +10,55 @@
 
 #include "../DVDCodecs/Overlay/DVDOverlay.h"
 
-typedef struct stListElement
-{
-  CDVDOverlay* pOverlay;
-  struct stListElement* pNext;
-
-} ListElement;
+#include <cstddef>
+#include <vector>
 
+/*!
+ * \brief Timeline of the overlays of a subtitle file
+ *
+ * The overlays are kept in a vector in the order of their start times after
+ * Sort(). A max tree over the stop times indexes the vector, so finding the
+ * first overlay that is still shown at a pts takes O(log n) after a seek
+ * instead of walking all earlier overlays.
+ */
 class CDVDSubtitleLineCollection
 {
 public:
   CDVDSubtitleLineCollection();
   virtual ~CDVDSubtitleLineCollection();
 
-  //void Lock()   { EnterCriticalSection(&m_critSection); }
-  //void Unlock() { LeaveCriticalSection(&m_critSection); }
+  /*!
+   * \brief Reserve room for the given number of overlays before parsing
+   */
+  void Reserve(size_t count);
 
   void Add(CDVDOverlay* pSubtitle);
+
+  /*!
+   * \brief Order the overlays by start time, overlays starting at the same time keep their order
+   */
   void Sort();
 
-  CDVDOverlay* Get(double iPts = 0LL); // get the first overlay in this fifo
+  /*!
+   * \brief Get the next overlay that is not over at iPts yet, following overlays are returned by the next calls
+   */
+  CDVDOverlay* Get(double iPts = 0LL);
 
+  /*!
+   * \brief Start over at the first overlay, after seeking backwards
+   */
   void Reset();
 
-  void Remove();
   void Clear();
-  int GetSize() { return m_iSize; }
+  int GetSize() { return static_cast<int>(m_overlays.size()); }
 
 private:
-  ListElement* m_pHead;
-  ListElement* m_pCurrent;
-  ListElement* m_pTail;
+  void BuildIndex();
+  size_t FindFirst(size_t start, double iPts) const;
 
-  int m_iSize;
-  //CRITICAL_SECTION m_critSection;
+  std::vector<CDVDOverlay*> m_overlays;
+  std::vector<double> m_maxStop; //!< max tree, leaves hold the stop times of m_overlays
+  size_t m_leaves = 0;
+  size_t m_current = 0;
+  bool m_indexed = false;
 };
-
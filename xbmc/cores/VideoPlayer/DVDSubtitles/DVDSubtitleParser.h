@@ -76,5 +76,17 @@ protected:
     return m_pStream->Open(m_filename);
   }
 
+  /*!
+   \brief Reserve room in the collection for the overlays of the opened stream
+   \param bytesPerEvent typical size of an event in the format of the stream
+   */
+  void ReserveEvents(long bytesPerEvent)
+  {
+    const long size = m_pStream->Seek(0, SEEK_END);
+    m_pStream->Seek(0, SEEK_SET);
+    if (size > 0)
+      m_collection.Reserve(size / bytesPerEvent + 1);
+  }
+
   std::unique_ptr<CDVDSubtitleStream> m_pStream;
 };
@@ -29,6 +29,9 @@ bool CDVDSubtitleParserMPL2::Open(CDVDStreamInfo &hints)
   if (!CDVDSubtitleParserText::Open())
     return false;
 
+  // one line per event, about 40 bytes
+  ReserveEvents(40);
+
   // MPL2 is time-based, with 0.1s accuracy
   m_framerate = DVD_TIME_BASE / 10.0;
 
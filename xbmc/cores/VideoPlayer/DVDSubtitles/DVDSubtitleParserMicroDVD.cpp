@@ -30,6 +30,9 @@ bool CDVDSubtitleParserMicroDVD::Open(CDVDStreamInfo &hints)
   if (!CDVDSubtitleParserText::Open())
     return false;
 
+  // one line per event with frame numbers, about 40 bytes
+  ReserveEvents(40);
+
   CLog::Log(LOGDEBUG, "%s - framerate %d:%d", __FUNCTION__, hints.fpsrate, hints.fpsscale);
   if (hints.fpsscale > 0 && hints.fpsrate > 0)
   {
@@ -35,6 +35,7 @@ bool CDVDSubtitleParserSSA::Open(CDVDStreamInfo &hints)
   //Creating the overlays by going through the list of ass_events
   ASS_Event* assEvent = m_libass->GetEvents();
   int numEvents = m_libass->GetNrOfEvents();
+  m_collection.Reserve(numEvents);
 
   for(int i=0; i < numEvents; i++)
   {
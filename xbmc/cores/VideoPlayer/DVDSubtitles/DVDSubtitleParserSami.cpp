@@ -31,6 +31,9 @@ bool CDVDSubtitleParserSami::Open(CDVDStreamInfo &hints)
   if (!CDVDSubtitleParserText::Open())
     return false;
 
+  // a SYNC and a P tag around the text, about 100 bytes
+  ReserveEvents(100);
+
   char line[1024];
 
   CRegExp reg(true);
@@ -27,6 +27,9 @@ bool CDVDSubtitleParserSubrip::Open(CDVDStreamInfo &hints)
   if (!CDVDSubtitleParserText::Open())
     return false;
 
+  // number, time line, text and blank line, about 70 bytes
+  ReserveEvents(70);
+
   CDVDSubtitleTagSami TagConv;
   if (!TagConv.Init())
     return false;
@@ -26,6 +26,9 @@ bool CDVDSubtitleParserVplayer::Open(CDVDStreamInfo &hints)
   if (!CDVDSubtitleParserText::Open())
     return false;
 
+  // a start time and the text on one line, about 30 bytes
+  ReserveEvents(30);
+
   // Vplayer subtitles have 1-second resolution
   m_framerate = DVD_TIME_BASE;
 
@@ -595,6 +595,30 @@ int CProcessInfo::GetLevelVQ()
   return m_levelVQ;
 }
 
+void CProcessInfo::SetVideoQueueInfo(const CDataCacheCore::SPlayerQueueInfo &info)
+{
+  if (m_dataCache)
+    m_dataCache->SetVideoQueueInfo(info);
+}
+
+void CProcessInfo::SetAudioQueueInfo(const CDataCacheCore::SPlayerQueueInfo &info)
+{
+  if (m_dataCache)
+    m_dataCache->SetAudioQueueInfo(info);
+}
+
+void CProcessInfo::SetVideoDecodeTimes(const CDataCacheCore::SVideoDecodeTimes &times)
+{
+  if (m_dataCache)
+    m_dataCache->SetVideoDecodeTimes(times);
+}
+
+void CProcessInfo::AddTraceFrame(const CPlaybackTrace::Frame &frame)
+{
+  if (m_dataCache)
+    m_dataCache->GetPlaybackTrace().AddFrame(frame);
+}
+
 void CProcessInfo::SetGuiRender(bool gui)
 {
   CSingleLock lock(m_stateSection);
@@ -9,6 +9,7 @@
 #pragma once
 
 #include "VideoBuffer.h"
+#include "cores/DataCacheCore.h"
 #include "cores/VideoSettings.h"
 #include "cores/VideoPlayer/VideoRenderers/RenderInfo.h"
 #include "threads/CriticalSection.h"
@@ -18,7 +19,6 @@
 #include <string>
 
 class CProcessInfo;
-class CDataCacheCore;
 
 using CreateProcessControl = CProcessInfo* (*)();
 
@@ -97,6 +97,10 @@ public:
   virtual float MaxTempoPlatform();
   void SetLevelVQ(int level);
   int GetLevelVQ();
+  void SetVideoQueueInfo(const CDataCacheCore::SPlayerQueueInfo &info);
+  void SetAudioQueueInfo(const CDataCacheCore::SPlayerQueueInfo &info);
+  void SetVideoDecodeTimes(const CDataCacheCore::SVideoDecodeTimes &times);
+  void AddTraceFrame(const CPlaybackTrace::Frame &frame);
   void SetGuiRender(bool gui);
   bool GetGuiRender();
   void SetVideoRender(bool video);
@@ -10,6 +10,10 @@
 #include "threads/SingleLock.h"
 #include <string.h>
 
+#ifdef TARGET_POSIX
+#include "platform/linux/XMemUtils.h"
+#endif
+
 //-----------------------------------------------------------------------------
 // CVideoBuffer
 //-----------------------------------------------------------------------------
@@ -179,7 +183,7 @@ CVideoBufferSysMem::CVideoBufferSysMem(IVideoBufferPool &pool, int id, AVPixelFo
 
 CVideoBufferSysMem::~CVideoBufferSysMem()
 {
-  delete[] m_data;
+  _aligned_free(m_data);
 }
 
 uint8_t* CVideoBufferSysMem::GetMemPtr()
@@ -265,8 +269,8 @@ void CVideoBufferSysMem::SetDimensions(int width, int height, const int (&stride
 
 bool CVideoBufferSysMem::Alloc()
 {
-  m_data = new uint8_t[m_size];
-  return true;
+  m_data = static_cast<uint8_t*>(_aligned_malloc(m_size, BUFFER_ALIGNMENT));
+  return m_data != nullptr;
 }
 
 
@@ -114,6 +114,9 @@ protected:
 class CVideoBufferSysMem : public CVideoBuffer
 {
 public:
+  //! alignment of the buffer memory, enough for the widest SIMD loads
+  static const int BUFFER_ALIGNMENT = 64;
+
   CVideoBufferSysMem(IVideoBufferPool &pool, int id, AVPixelFormat format, int size);
   ~CVideoBufferSysMem() override;
   uint8_t* GetMemPtr() override;
@@ -19,6 +19,7 @@
 #include "DVDInputStreams/InputStreamPVRBase.h"
 
 #include "DVDDemuxers/DVDDemux.h"
+#include "DVDDemuxers/DVDDemuxPacketPool.h"
 #include "DVDDemuxers/DVDDemuxUtils.h"
 #include "DVDDemuxers/DVDDemuxVobsub.h"
 #include "DVDDemuxers/DVDFactoryDemuxer.h"
@@ -59,6 +60,7 @@
 #include "dialogs/GUIDialogKaiToast.h"
 #include "utils/JobManager.h"
 #include "utils/StringUtils.h"
+#include "utils/TimeUtils.h"
 #include "video/Bookmark.h"
 #include "video/VideoInfoTag.h"
 #include "Util.h"
@@ -1069,7 +1071,11 @@ bool CVideoPlayer::ReadPacket(DemuxPacket*& packet, CDemuxStream*& stream)
   }
   // read a data frame from stream.
   if (m_pDemuxer)
+  {
+    const int64_t start = CurrentHostCounter();
     packet = m_pDemuxer->Read();
+    m_demuxDuration = CurrentHostCounter() - start;
+  }
 
   if (packet)
   {
@@ -1764,7 +1770,9 @@ void CVideoPlayer::ProcessVideoData(CDemuxStream* pStream, DemuxPacket* pPacket)
   if (CheckSceneSkip(m_CurrentVideo))
     drop = true;
 
-  m_VideoPlayerVideo->SendMessage(new CDVDMsgDemuxerPacket(pPacket, drop));
+  CDVDMsgDemuxerPacket* msg = new CDVDMsgDemuxerPacket(pPacket, drop);
+  msg->m_demuxDuration = m_demuxDuration;
+  m_VideoPlayerVideo->SendMessage(msg);
   m_CurrentVideo.packets++;
 }
 
@@ -2517,6 +2525,13 @@ void CVideoPlayer::OnExit()
   // subtitles are added from video player. after video player has finished, overlays have to be cleared.
   CloseStream(m_CurrentSubtitle, false);  // clear overlay container
 
+  CDVDDemuxPacketPool::Stats poolStats = CDVDDemuxPacketPool::GetInstance().GetStats();
+  CLog::Log(LOGDEBUG, "VideoPlayer: demux packet pool, {} allocations, {} reused, {} discarded, {} in use, {} cached ({} bytes)",
+            poolStats.allocations, poolStats.reused, poolStats.discarded, poolStats.outstanding,
+            poolStats.cachedPackets, poolStats.cachedBytes);
+  CDVDDemuxPacketPool::GetInstance().ResetStats();
+  CDVDDemuxPacketPool::GetInstance().Clear();
+
   CServiceBroker::GetWinSystem()->UnregisterRenderLoop(this);
 
   IPlayerCallback *cb = &m_callback;
@@ -525,6 +525,7 @@ protected:
   } m_SpeedState;
 
   double m_offset_pts;
+  int64_t m_demuxDuration = 0; //!< host counter ticks the last read of the demuxer took
 
   CDVDMessageQueue m_messenger;
   std::unique_ptr<CJobQueue> m_outboundEvents;
@@ -195,7 +195,9 @@ void CVideoPlayerAudio::OnStartup()
 void CVideoPlayerAudio::UpdatePlayerInfo()
 {
   std::ostringstream s;
-  s << "aq:"     << std::setw(2) << std::min(99,m_messageQueue.GetLevel()) << "%";
+  CDataCacheCore::SPlayerQueueInfo queue = CServiceBroker::GetDataCacheCore().GetAudioQueueInfo();
+  s << "aq:"     << std::setw(2) << std::min(99, queue.level) << "%";
+  s << " (peak:" << queue.dataSizePeak / 1024 << "KB, " << std::fixed << std::setprecision(1) << queue.timeSizePeak << "s)";
   s << ", Kb/s:" << std::fixed << std::setprecision(2) << m_audioStats.GetBitrate() / 1024.0;
 
   //print the inverse of the resample ratio, since that makes more sense
@@ -251,6 +253,7 @@ void CVideoPlayerAudio::Process()
     }
 
     MsgQueueReturnCode ret = m_messageQueue.Get(&pMsg, timeout, priority);
+    m_processInfo.SetAudioQueueInfo(m_messageQueue.GetQueueInfo());
 
     onlyPrioMsgs = false;
 
@@ -7,10 +7,12 @@
  */
 
 #include "ServiceBroker.h"
+#include "cores/DataCacheCore.h"
 #include "windowing/WinSystem.h"
 #include "settings/AdvancedSettings.h"
 #include "settings/SettingsComponent.h"
 #include "utils/MathUtils.h"
+#include "utils/TimeUtils.h"
 #include "VideoPlayerVideo.h"
 #include "DVDCodecs/DVDFactoryCodec.h"
 #include "DVDCodecs/DVDCodecUtils.h"
@@ -290,7 +292,9 @@ inline void CVideoPlayerVideo::FlushMessages()
 inline MsgQueueReturnCode CVideoPlayerVideo::GetMessage(CDVDMsg** pMsg, unsigned int iTimeoutInMilliSeconds, int &priority)
 {
   MsgQueueReturnCode ret = m_messageQueue.Get(pMsg, iTimeoutInMilliSeconds, priority);
-  m_processInfo.SetLevelVQ(m_messageQueue.GetLevel());
+  CDataCacheCore::SPlayerQueueInfo info = m_messageQueue.GetQueueInfo();
+  m_processInfo.SetLevelVQ(info.level);
+  m_processInfo.SetVideoQueueInfo(info);
   return ret;
 }
 
@@ -518,6 +522,11 @@ void CVideoPlayerVideo::Process()
       DemuxPacket* pPacket = static_cast<CDVDMsgDemuxerPacket*>(pMsg)->GetPacket();
       bool bPacketDrop = static_cast<CDVDMsgDemuxerPacket*>(pMsg)->GetPacketDrop();
 
+      const CDVDMsgDemuxerPacket* packetMsg = static_cast<CDVDMsgDemuxerPacket*>(pMsg);
+      const double ticksPerMs = CurrentHostFrequency() / 1000.0;
+      m_traceFrame.demux = static_cast<float>(packetMsg->m_demuxDuration / ticksPerMs);
+      m_traceFrame.queue = static_cast<float>((CurrentHostCounter() - packetMsg->m_created) / ticksPerMs);
+
       if (m_stalled)
       {
         CLog::Log(LOGINFO, "CVideoPlayerVideo - Stillframe left, switching to normal playback");
@@ -557,7 +566,18 @@ void CVideoPlayerVideo::Process()
         codecControl |= DVD_CODEC_CTRL_ROTATE;
       m_pVideoCodec->SetCodecControl(codecControl);
 
-      if (m_pVideoCodec->AddData(*pPacket))
+      if (bPacketDrop)
+        m_traceDrop = CPlaybackTrace::DROP_PLAYER;
+      else if (bRequestDrop)
+        m_traceDrop = CPlaybackTrace::DROP_LATE;
+      else
+        m_traceDrop = CPlaybackTrace::DROP_DECODER;
+
+      const int64_t decodeStart = CurrentHostCounter();
+      const bool added = m_pVideoCodec->AddData(*pPacket);
+      m_traceFrame.decode = static_cast<float>((CurrentHostCounter() - decodeStart) / ticksPerMs);
+
+      if (added)
       {
         // buffer packets so we can recover should decoder flush for some reason
         if (m_pVideoCodec->GetConvergeCount() > 0)
@@ -589,7 +609,9 @@ void CVideoPlayerVideo::Process()
 
 bool CVideoPlayerVideo::ProcessDecoderOutput(double &frametime, double &pts)
 {
+  const int64_t start = CurrentHostCounter();
   CDVDVideoCodec::VCReturn decoderState = m_pVideoCodec->GetPicture(&m_picture);
+  m_traceFrame.decode += static_cast<float>((CurrentHostCounter() - start) * 1000.0 / CurrentHostFrequency());
 
   if (decoderState == CDVDVideoCodec::VC_BUFFER)
   {
@@ -824,6 +846,29 @@ void CVideoPlayerVideo::ProcessOverlays(const VideoPicture* pSource, double pts)
 }
 
 CVideoPlayerVideo::EOutputState CVideoPlayerVideo::OutputPicture(const VideoPicture* pPicture)
+{
+  EOutputState state = RenderPicture(pPicture);
+  if (state == OUTPUT_AGAIN || state == OUTPUT_ABORT)
+    return state;
+
+  m_traceFrame.pts = pPicture->pts;
+  if (state == OUTPUT_NORMAL)
+    m_traceFrame.drop = CPlaybackTrace::DROP_NONE;
+  else if (m_speed < 0)
+    m_traceFrame.drop = CPlaybackTrace::DROP_SPEED;
+  else if (pPicture->iFlags & DVP_FLAG_DROPPED)
+    m_traceFrame.drop = m_traceDrop;
+  else
+    m_traceFrame.drop = CPlaybackTrace::DROP_RENDERER;
+  m_processInfo.AddTraceFrame(m_traceFrame);
+
+  // more pictures out of the same packet only add their own time
+  m_traceFrame = CPlaybackTrace::Frame();
+
+  return state;
+}
+
+CVideoPlayerVideo::EOutputState CVideoPlayerVideo::RenderPicture(const VideoPicture* pPicture)
 {
   m_bAbortOutput = false;
 
@@ -906,7 +951,9 @@ CVideoPlayerVideo::EOutputState CVideoPlayerVideo::OutputPicture(const VideoPict
   // don't wait when going ff
   if (m_speed > DVD_PLAYSPEED_NORMAL)
     maxWaitTime = std::max(timeToDisplay, 0);
+  const int64_t waitStart = CurrentHostCounter();
   int buffer = m_renderManager.WaitForBuffer(m_bAbortOutput, maxWaitTime);
+  m_traceFrame.renderWait += static_cast<float>((CurrentHostCounter() - waitStart) * 1000.0 / CurrentHostFrequency());
   if (buffer < 0)
   {
     return OUTPUT_AGAIN;
@@ -931,12 +978,21 @@ CVideoPlayerVideo::EOutputState CVideoPlayerVideo::OutputPicture(const VideoPict
 std::string CVideoPlayerVideo::GetPlayerInfo()
 {
   std::ostringstream s;
-  s << "vq:"   << std::setw(2) << std::min(99, m_processInfo.GetLevelVQ()) << "%";
+  CDataCacheCore::SPlayerQueueInfo queue = CServiceBroker::GetDataCacheCore().GetVideoQueueInfo();
+  s << "vq:"   << std::setw(2) << std::min(99, queue.level) << "%";
+  s << " (peak:" << queue.dataSizePeak / 1024 << "KB, " << std::fixed << std::setprecision(1) << queue.timeSizePeak << "s)";
   s << ", Mb/s:" << std::fixed << std::setprecision(2) << (double)GetVideoBitrate() / (1024.0*1024.0);
   s << ", fr:"     << std::fixed << std::setprecision(3) << m_fFrameRate;
   s << ", drop:" << m_iDroppedFrames;
   s << ", skip:" << m_renderManager.GetSkippedFrames();
 
+  CDataCacheCore::SVideoDecodeTimes times = CServiceBroker::GetDataCacheCore().GetVideoDecodeTimes();
+  if (times.frames > 0)
+  {
+    s << ", dec:" << std::fixed << std::setprecision(1) << times.decode << "ms";
+    s << ", flt:" << std::fixed << std::setprecision(1) << times.filter << "ms";
+  }
+
   int pc = m_ptsTracker.GetPatternLength();
   if (pc > 0)
     s << ", pc:" << pc;
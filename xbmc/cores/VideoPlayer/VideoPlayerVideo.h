@@ -94,6 +94,7 @@ protected:
   MsgQueueReturnCode GetMessage(CDVDMsg** pMsg, unsigned int iTimeoutInMilliSeconds, int &priority);
 
   EOutputState OutputPicture(const VideoPicture* src);
+  EOutputState RenderPicture(const VideoPicture* src);
   void ProcessOverlays(const VideoPicture* pSource, double pts);
   void OpenStream(CDVDStreamInfo &hint, CDVDVideoCodec* codec);
 
@@ -138,4 +139,7 @@ protected:
   VideoPicture m_picture;
 
   EOutputState m_outputSate;
+
+  CPlaybackTrace::Frame m_traceFrame; //!< timing of the picture being output
+  CPlaybackTrace::DropCause m_traceDrop = CPlaybackTrace::DROP_DECODER; //!< cause if the decoder drops it
 };
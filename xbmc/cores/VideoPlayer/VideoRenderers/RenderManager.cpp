@@ -19,6 +19,7 @@
 
 #include "Application.h"
 #include "ServiceBroker.h"
+#include "cores/DataCacheCore.h"
 #include "messaging/ApplicationMessenger.h"
 #include "settings/AdvancedSettings.h"
 #include "settings/MediaSettings.h"
@@ -1149,12 +1150,14 @@ void CRenderManager::PrepareNextRender()
     }
 
     // skip late frames
+    unsigned int skipped = 0;
     while (m_queued.front() != idx)
     {
       if (m_presentsourcePast >= 0)
       {
         m_discard.push_back(m_presentsourcePast);
         m_QueueSkip++;
+        skipped++;
       }
       m_presentsourcePast = m_queued.front();
       m_queued.pop_front();
@@ -1173,6 +1176,11 @@ void CRenderManager::PrepareNextRender()
     m_presentpts = m_Queue[idx].pts - m_displayLatency;
     m_presentevent.notifyAll();
 
+    CPlaybackTrace& trace = CServiceBroker::GetDataCacheCore().GetPlaybackTrace();
+    if (skipped)
+      trace.AddSkipped(skipped);
+    trace.AddPresent();
+
     m_playerPort->UpdateRenderBuffers(m_queued.size(), m_discard.size(), m_free.size());
   }
   else if (!combined && renderPts > (nextFramePts - frametime))
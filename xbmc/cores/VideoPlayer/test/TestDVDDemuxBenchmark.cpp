@@ -0,0 +1,74 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "FileItem.h"
+#include "cores/VideoPlayer/DVDDemuxers/DVDDemux.h"
+#include "cores/VideoPlayer/DVDDemuxers/DVDDemuxPacketPool.h"
+#include "cores/VideoPlayer/DVDDemuxers/DVDDemuxUtils.h"
+#include "cores/VideoPlayer/DVDDemuxers/DVDFactoryDemuxer.h"
+#include "cores/VideoPlayer/DVDInputStreams/DVDFactoryInputStream.h"
+#include "cores/VideoPlayer/DVDInputStreams/DVDInputStream.h"
+#include "test/TestUtils.h"
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+
+#include <gtest/gtest.h>
+
+/*
+ * Reads all packets of the media files given with --add-demux-benchmark-file(s),
+ * once with and once without recycling the packets through the packet pool.
+ * Run with --gtest_also_run_disabled_tests.
+ */
+TEST(TestDVDDemuxBenchmark, DISABLED_ReadPackets)
+{
+  const std::vector<std::string>& files = CXBMCTestUtils::Instance().getDemuxBenchmarkFiles();
+  if (files.empty())
+  {
+    printf("[ BENCHMARK] no media files given, use --add-demux-benchmark-file\n");
+    return;
+  }
+
+  CDVDDemuxPacketPool& pool = CDVDDemuxPacketPool::GetInstance();
+  for (const auto& file : files)
+  {
+    for (size_t maxCachedBytes : { CDVDDemuxPacketPool::DEFAULT_MAX_CACHED_BYTES, static_cast<size_t>(0) })
+    {
+      pool.SetMaxCachedBytes(maxCachedBytes);
+      pool.ResetStats();
+
+      CFileItem item(file, false);
+      auto input = CDVDFactoryInputStream::CreateInputStream(nullptr, item);
+      ASSERT_TRUE(input);
+      ASSERT_TRUE(input->Open());
+      std::unique_ptr<CDVDDemux> demuxer(CDVDFactoryDemuxer::CreateDemuxer(input, true));
+      ASSERT_TRUE(demuxer);
+
+      unsigned int packets = 0;
+      uint64_t bytes = 0;
+      const auto start = std::chrono::steady_clock::now();
+      while (DemuxPacket* packet = demuxer->Read())
+      {
+        packets++;
+        bytes += packet->iSize;
+        CDVDDemuxUtils::FreeDemuxPacket(packet);
+      }
+      const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+      CDVDDemuxPacketPool::Stats stats = pool.GetStats();
+      EXPECT_EQ(0u, stats.outstanding);
+      printf("[ BENCHMARK] %s (%s): %u packets, %.0f packets/sec, %.1f MB/s, %.1f%% reused\n",
+             file.c_str(), maxCachedBytes ? "pooled" : "unpooled", packets,
+             packets / elapsed.count(), bytes / elapsed.count() / (1024 * 1024),
+             stats.allocations ? 100.0 * stats.reused / stats.allocations : 0.0);
+    }
+  }
+
+  pool.SetMaxCachedBytes(CDVDDemuxPacketPool::DEFAULT_MAX_CACHED_BYTES);
+}
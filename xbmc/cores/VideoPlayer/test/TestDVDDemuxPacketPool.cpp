@@ -0,0 +1,167 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/VideoPlayer/DVDDemuxers/DVDDemuxPacketPool.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <stdint.h>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+TEST(TestDVDDemuxPacketPool, ReusesPackets)
+{
+  CDVDDemuxPacketPool pool;
+  DemuxPacket* packet = pool.Allocate(1500);
+  ASSERT_TRUE(packet);
+  ASSERT_TRUE(packet->pData);
+  EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(packet->pData) % 64);
+
+  packet->iSize = 1500;
+  packet->iStreamId = 3;
+  packet->pts = 1000.0;
+  uint8_t* data = packet->pData;
+  pool.Release(packet);
+
+  // same size class, so the same packet is handed out again, with its members reset
+  DemuxPacket* reused = pool.Allocate(1800);
+  ASSERT_EQ(packet, reused);
+  EXPECT_EQ(data, reused->pData);
+  EXPECT_EQ(0, reused->iSize);
+  EXPECT_EQ(-1, reused->iStreamId);
+  EXPECT_EQ(DVD_NOPTS_VALUE, reused->pts);
+  pool.Release(reused);
+
+  CDVDDemuxPacketPool::Stats stats = pool.GetStats();
+  EXPECT_EQ(2u, stats.allocations);
+  EXPECT_EQ(1u, stats.reused);
+  EXPECT_EQ(2u, stats.releases);
+  EXPECT_EQ(0u, stats.outstanding);
+  EXPECT_EQ(1u, stats.cachedPackets);
+}
+
+TEST(TestDVDDemuxPacketPool, SizeClasses)
+{
+  CDVDDemuxPacketPool pool;
+  DemuxPacket* small = pool.Allocate(100);
+  DemuxPacket* empty = pool.Allocate(0);
+  ASSERT_TRUE(small && empty);
+  EXPECT_FALSE(empty->pData);
+  pool.Release(small);
+  pool.Release(empty);
+
+  // a bigger payload does not fit into the cached packet
+  DemuxPacket* big = pool.Allocate(100000);
+  ASSERT_TRUE(big);
+  EXPECT_NE(small, big);
+  memset(big->pData, 0, 100000);
+
+  DemuxPacket* noPayload = pool.Allocate(0);
+  EXPECT_EQ(empty, noPayload);
+
+  pool.Release(big);
+  pool.Release(noPayload);
+  EXPECT_EQ(3u, pool.GetStats().cachedPackets);
+}
+
+TEST(TestDVDDemuxPacketPool, HugePacketsAreNotCached)
+{
+  CDVDDemuxPacketPool pool;
+  DemuxPacket* packet = pool.Allocate(16 * 1024 * 1024);
+  ASSERT_TRUE(packet);
+  pool.Release(packet);
+
+  CDVDDemuxPacketPool::Stats stats = pool.GetStats();
+  EXPECT_EQ(1u, stats.discarded);
+  EXPECT_EQ(0u, stats.cachedPackets);
+  EXPECT_EQ(0u, stats.cachedBytes);
+}
+
+TEST(TestDVDDemuxPacketPool, MaxCachedBytes)
+{
+  CDVDDemuxPacketPool pool(64 * 1024);
+  std::vector<DemuxPacket*> packets;
+  for (int i = 0; i < 10; i++)
+    packets.push_back(pool.Allocate(16 * 1024));
+  for (DemuxPacket* packet : packets)
+    pool.Release(packet);
+
+  CDVDDemuxPacketPool::Stats stats = pool.GetStats();
+  EXPECT_LE(stats.cachedBytes, 64u * 1024);
+  EXPECT_GT(stats.cachedPackets, 0u);
+  EXPECT_EQ(10u, stats.cachedPackets + stats.discarded);
+
+  pool.SetMaxCachedBytes(0);
+  EXPECT_EQ(0u, pool.GetStats().cachedPackets);
+}
+
+TEST(TestDVDDemuxPacketPool, Threads)
+{
+  // one demuxer thread producing packets, two player threads releasing them
+  CDVDDemuxPacketPool pool;
+  const int count = 20000;
+  std::vector<DemuxPacket*> packets(count, nullptr);
+  std::vector<std::thread> consumers;
+
+  std::thread producer([&pool, &packets, count]() {
+    for (int i = 0; i < count; i++)
+      packets[i] = pool.Allocate(188 * (1 + i % 40));
+  });
+  producer.join();
+
+  for (int c = 0; c < 2; c++)
+  {
+    consumers.emplace_back([&pool, &packets, c, count]() {
+      for (int i = c; i < count; i += 2)
+        pool.Release(packets[i]);
+    });
+  }
+  std::thread allocator([&pool]() {
+    for (int i = 0; i < count; i++)
+      pool.Release(pool.Allocate(4096));
+  });
+
+  for (auto& consumer : consumers)
+    consumer.join();
+  allocator.join();
+
+  CDVDDemuxPacketPool::Stats stats = pool.GetStats();
+  EXPECT_EQ(0u, stats.outstanding);
+  EXPECT_EQ(stats.allocations, stats.releases);
+}
+
+TEST(TestDVDDemuxPacketPool, DISABLED_AllocationBenchmark)
+{
+  // typical queue depth of a high bitrate stream: packets are released a while after allocation
+  const int packets = 500000;
+  const int inFlight = 256;
+
+  for (size_t maxCachedBytes : { CDVDDemuxPacketPool::DEFAULT_MAX_CACHED_BYTES, static_cast<size_t>(0) })
+  {
+    CDVDDemuxPacketPool pool(maxCachedBytes);
+    std::vector<DemuxPacket*> queue(inFlight, nullptr);
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < packets; i++)
+    {
+      DemuxPacket*& slot = queue[i % inFlight];
+      pool.Release(slot);
+      slot = pool.Allocate(20000 + (i * 7919u) % 60000);
+      slot->pData[0] = 0;
+    }
+    for (DemuxPacket* packet : queue)
+      pool.Release(packet);
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    printf("[ BENCHMARK] %s: %.0f packets/sec\n", maxCachedBytes ? "pooled" : "unpooled",
+           packets / elapsed.count());
+  }
+}
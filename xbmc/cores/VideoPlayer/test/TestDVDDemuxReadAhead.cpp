@@ -0,0 +1,220 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "FileItem.h"
+#include "cores/VideoPlayer/DVDDemuxers/DVDDemuxReadAhead.h"
+#include "cores/VideoPlayer/DVDInputStreams/DVDInputStreamMemory.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <stdint.h>
+#include <stdio.h>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+/*!
+ * \brief Memory input returning short reads like a network file
+ */
+class CTestInputStream : public CDVDInputStreamMemory
+{
+public:
+  CTestInputStream(CFileItem& item, const std::vector<uint8_t>& data)
+    : CDVDInputStreamMemory(item)
+  {
+    m_pData = new uint8_t[data.size()];
+    memcpy(m_pData, data.data(), data.size());
+    m_iDataSize = static_cast<int>(data.size());
+  }
+
+  bool Pause(double dTime) override { return false; }
+
+  int Read(uint8_t* buf, int size) override
+  {
+    return CDVDInputStreamMemory::Read(buf, std::min(size, 50000));
+  }
+};
+
+/*!
+ * \brief Input hanging in a read like a stalled server, until it is released
+ */
+class CBlockingInputStream : public CDVDInputStreamMemory
+{
+public:
+  explicit CBlockingInputStream(CFileItem& item) : CDVDInputStreamMemory(item) {}
+
+  bool Pause(double dTime) override { return false; }
+
+  int Read(uint8_t* buf, int size) override
+  {
+    while (!m_released)
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    return 0;
+  }
+
+  void Release() { m_released = true; }
+
+private:
+  std::atomic<bool> m_released{false};
+};
+
+std::vector<uint8_t> CreateData(size_t size)
+{
+  std::mt19937 random(1);
+  std::vector<uint8_t> data(size);
+  for (uint8_t& byte : data)
+    byte = static_cast<uint8_t>(random());
+  return data;
+}
+
+/*!
+ * \brief Read until size bytes, the end of the stream or an error
+ */
+int ReadFully(CDVDDemuxReadAhead& readAhead, uint8_t* buf, int size)
+{
+  int total = 0;
+  while (total < size)
+  {
+    int bytes = readAhead.Read(buf + total, size - total);
+    if (bytes <= 0)
+      return total ? total : bytes;
+    total += bytes;
+  }
+  return total;
+}
+}
+
+TEST(TestDVDDemuxReadAhead, ReadsWholeStream)
+{
+  const std::vector<uint8_t> data = CreateData(3 * 1024 * 1024 + 17);
+  CFileItem item;
+  auto input = std::make_shared<CTestInputStream>(item, data);
+  CDVDDemuxReadAhead readAhead(input, 1024 * 1024, nullptr);
+
+  std::vector<uint8_t> read;
+  uint8_t buf[4096];
+  int bytes;
+  while ((bytes = readAhead.Read(buf, sizeof(buf))) > 0)
+    read.insert(read.end(), buf, buf + bytes);
+
+  EXPECT_EQ(0, bytes);
+  EXPECT_TRUE(readAhead.IsEOF());
+  EXPECT_TRUE(read == data);
+  EXPECT_EQ(data.size(), readAhead.GetStats().bytesRead);
+}
+
+TEST(TestDVDDemuxReadAhead, SeeksInsideBufferDontTouchInput)
+{
+  const std::vector<uint8_t> data = CreateData(1024 * 1024);
+  CFileItem item;
+  auto input = std::make_shared<CTestInputStream>(item, data);
+  CDVDDemuxReadAhead readAhead(input, 4 * 1024 * 1024, nullptr);
+
+  std::vector<uint8_t> buf(100000);
+  ASSERT_EQ(100000, ReadFully(readAhead, buf.data(), 100000));
+
+  // the demuxer probing back and forth at the start of the file
+  EXPECT_EQ(10, readAhead.Seek(10, SEEK_SET));
+  ASSERT_EQ(1000, ReadFully(readAhead, buf.data(), 1000));
+  EXPECT_EQ(0, memcmp(buf.data(), data.data() + 10, 1000));
+
+  EXPECT_EQ(1010 + 5000, readAhead.Seek(5000, SEEK_CUR));
+  ASSERT_EQ(1000, ReadFully(readAhead, buf.data(), 1000));
+  EXPECT_EQ(0, memcmp(buf.data(), data.data() + 6010, 1000));
+
+  CDVDDemuxReadAhead::Stats stats = readAhead.GetStats();
+  EXPECT_EQ(2u, stats.bufferedSeeks);
+  EXPECT_EQ(0u, stats.inputSeeks);
+
+  // the index at the end
+  EXPECT_EQ(static_cast<int64_t>(data.size()), readAhead.Seek(0, SEEK_END));
+  EXPECT_EQ(0, readAhead.Read(buf.data(), 1000));
+  EXPECT_TRUE(readAhead.IsEOF());
+}
+
+TEST(TestDVDDemuxReadAhead, MatchesInput)
+{
+  const std::vector<uint8_t> data = CreateData(8 * 1024 * 1024);
+  CFileItem item;
+  auto input = std::make_shared<CTestInputStream>(item, data);
+  CDVDDemuxReadAhead readAhead(input, 1024 * 1024, nullptr);
+
+  std::mt19937 random(2);
+  std::uniform_int_distribution<int> action(0, 9);
+  std::uniform_int_distribution<int64_t> position(0, data.size());
+  std::uniform_int_distribution<int> shortSeek(-300000, 300000);
+  std::uniform_int_distribution<int> length(1, 200000);
+
+  std::vector<uint8_t> buf(200000);
+  int64_t pos = 0;
+  unsigned int seeks = 0;
+  uint64_t read = 0;
+  for (int i = 0; i < 2000; i++)
+  {
+    const int what = action(random);
+    if (what == 0)
+    {
+      pos = position(random);
+      ASSERT_EQ(pos, readAhead.Seek(pos, SEEK_SET));
+      seeks++;
+    }
+    else if (what == 1)
+    {
+      int64_t offset = shortSeek(random);
+      offset = std::max(-pos, std::min(offset, static_cast<int64_t>(data.size()) - pos));
+      pos += offset;
+      ASSERT_EQ(pos, readAhead.Seek(offset, SEEK_CUR));
+      seeks++;
+    }
+    else
+    {
+      const int size = length(random);
+      const int expected = static_cast<int>(std::min<int64_t>(size, data.size() - pos));
+      const int bytes = ReadFully(readAhead, buf.data(), size);
+      ASSERT_EQ(expected, bytes);
+      ASSERT_EQ(0, memcmp(buf.data(), data.data() + pos, bytes));
+      pos += bytes;
+      read += bytes;
+    }
+  }
+
+  // which seeks stay in the buffer depends on how far the worker got, but
+  // each one is either and the random ones far ahead can't stay in it
+  CDVDDemuxReadAhead::Stats stats = readAhead.GetStats();
+  EXPECT_EQ(seeks, stats.bufferedSeeks + stats.inputSeeks);
+  EXPECT_GT(stats.bufferedSeeks, 0u);
+  EXPECT_GT(stats.inputSeeks, 0u);
+  EXPECT_EQ(read, stats.bytesRead);
+}
+
+TEST(TestDVDDemuxReadAhead, Interrupt)
+{
+  CFileItem item;
+  auto input = std::make_shared<CBlockingInputStream>(item);
+  std::atomic<bool> aborted(false);
+  CDVDDemuxReadAhead readAhead(input, 1024 * 1024, [&aborted]() { return aborted.load(); });
+
+  std::thread abort([&aborted]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    aborted = true;
+  });
+
+  // the input never returns data, the reader gives up once it was aborted
+  uint8_t buf[16];
+  EXPECT_EQ(-1, readAhead.Read(buf, sizeof(buf)));
+  abort.join();
+
+  input->Release();
+}
@@ -0,0 +1,154 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/VideoPlayer/DVDDemuxers/DVDDemuxSeekIndex.h"
+
+#include <memory>
+
+extern "C" {
+#include <libavformat/avformat.h>
+}
+
+#include <gtest/gtest.h>
+
+namespace
+{
+const int64_t LENGTH = 100 * 1000 * 1000;
+
+struct ContextDeleter
+{
+  void operator()(AVFormatContext* context) const { avformat_free_context(context); }
+};
+using ContextPtr = std::unique_ptr<AVFormatContext, ContextDeleter>;
+
+/*!
+ * \brief Context of a demuxer with an audio and a video stream, the video one is the default
+ */
+ContextPtr CreateContext(AVCodecID videoCodec = AV_CODEC_ID_H264)
+{
+  ContextPtr context(avformat_alloc_context());
+  AVStream* audio = avformat_new_stream(context.get(), nullptr);
+  audio->codecpar->codec_type = AVMEDIA_TYPE_AUDIO;
+  audio->codecpar->codec_id = AV_CODEC_ID_AC3;
+  AVStream* video = avformat_new_stream(context.get(), nullptr);
+  video->codecpar->codec_type = AVMEDIA_TYPE_VIDEO;
+  video->codecpar->codec_id = videoCodec;
+  return context;
+}
+
+const AVIndexEntry* GetIndexEntry(AVStream* stream, int idx)
+{
+#if LIBAVFORMAT_VERSION_INT >= AV_VERSION_INT(58, 78, 100)
+  return avformat_index_get_entry(stream, idx);
+#else
+  return &stream->index_entries[idx];
+#endif
+}
+
+/*!
+ * \brief Add a keyframe every second and a frame without the flag in between
+ */
+void AddEntries(AVFormatContext* context, int seconds)
+{
+  AVStream* video = context->streams[1];
+  for (int i = 0; i < seconds; i++)
+  {
+    av_add_index_entry(video, i * 1000000, i * 90000, 5000, 0, AVINDEX_KEYFRAME);
+    av_add_index_entry(video, i * 1000000 + 500000, i * 90000 + 45000, 1000, 0, 0);
+  }
+}
+}
+
+TEST(TestDVDDemuxSeekIndexCache, RoundTrip)
+{
+  CDVDDemuxSeekIndexCache cache(4);
+
+  ContextPtr played = CreateContext();
+  AddEntries(played.get(), 10);
+  cache.Store("file.ts", LENGTH, played.get());
+
+  // the demuxer opened again only knows the start of the file
+  ContextPtr opened = CreateContext();
+  AddEntries(opened.get(), 2);
+  EXPECT_EQ(8u, cache.Restore("file.ts", LENGTH, opened.get()));
+
+  // all keyframes are known again, with their positions
+  AVStream* video = opened->streams[1];
+  for (int i = 0; i < 10; i++)
+  {
+    const int idx = av_index_search_timestamp(video, i * 90000, AVSEEK_FLAG_BACKWARD);
+    ASSERT_GE(idx, 0);
+    const AVIndexEntry* entry = GetIndexEntry(video, idx);
+    EXPECT_EQ(i * 90000, entry->timestamp);
+    EXPECT_EQ(i * 1000000, entry->pos);
+    EXPECT_TRUE(entry->flags & AVINDEX_KEYFRAME);
+  }
+
+  // nothing to add a second time
+  EXPECT_EQ(0u, cache.Restore("file.ts", LENGTH, opened.get()));
+
+  const CDVDDemuxSeekIndexCache::Stats stats = cache.GetStats();
+  EXPECT_EQ(1u, stats.stored);
+  EXPECT_EQ(1u, stats.restored);
+  EXPECT_EQ(8u, stats.restoredEntries);
+}
+
+TEST(TestDVDDemuxSeekIndexCache, OtherFile)
+{
+  CDVDDemuxSeekIndexCache cache(4);
+
+  ContextPtr played = CreateContext();
+  AddEntries(played.get(), 10);
+  cache.Store("file.ts", LENGTH, played.get());
+
+  // a changed file, an other path or other streams don't get the index
+  ContextPtr opened = CreateContext();
+  EXPECT_EQ(0u, cache.Restore("file.ts", LENGTH + 1, opened.get()));
+  EXPECT_EQ(0u, cache.Restore("other.ts", LENGTH, opened.get()));
+  ContextPtr otherCodec = CreateContext(AV_CODEC_ID_MPEG2VIDEO);
+  EXPECT_EQ(0u, cache.Restore("file.ts", LENGTH, otherCodec.get()));
+
+  EXPECT_EQ(10u, cache.Restore("file.ts", LENGTH, opened.get()));
+}
+
+TEST(TestDVDDemuxSeekIndexCache, KeepsLargerIndex)
+{
+  CDVDDemuxSeekIndexCache cache(4);
+
+  ContextPtr full = CreateContext();
+  AddEntries(full.get(), 10);
+  cache.Store("file.ts", LENGTH, full.get());
+
+  // closed again after a seek to the start, before the end was read
+  ContextPtr partial = CreateContext();
+  AddEntries(partial.get(), 3);
+  cache.Store("file.ts", LENGTH, partial.get());
+
+  ContextPtr opened = CreateContext();
+  EXPECT_EQ(10u, cache.Restore("file.ts", LENGTH, opened.get()));
+}
+
+TEST(TestDVDDemuxSeekIndexCache, Eviction)
+{
+  CDVDDemuxSeekIndexCache cache(2);
+
+  for (const char* file : { "a.ts", "b.ts", "c.ts" })
+  {
+    ContextPtr played = CreateContext();
+    AddEntries(played.get(), 5);
+    cache.Store(file, LENGTH, played.get());
+  }
+
+  // the least recently stored file was dropped
+  ContextPtr opened = CreateContext();
+  EXPECT_EQ(0u, cache.Restore("a.ts", LENGTH, opened.get()));
+  EXPECT_EQ(5u, cache.Restore("b.ts", LENGTH, opened.get()));
+
+  ContextPtr openedAgain = CreateContext();
+  EXPECT_EQ(5u, cache.Restore("c.ts", LENGTH, openedAgain.get()));
+}
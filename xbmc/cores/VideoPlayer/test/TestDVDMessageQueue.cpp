@@ -0,0 +1,144 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/VideoPlayer/DVDMessageQueue.h"
+
+#include <gtest/gtest.h>
+
+namespace
+{
+int GetValue(CDVDMessageQueue &queue, int &priority)
+{
+  CDVDMsg* msg = nullptr;
+  if (queue.Get(&msg, 0, priority) != MSGQ_OK || !msg)
+    return -1;
+
+  int value = *static_cast<CDVDMsgInt*>(msg);
+  msg->Release();
+  return value;
+}
+
+int GetValue(CDVDMessageQueue &queue)
+{
+  int priority = 0;
+  return GetValue(queue, priority);
+}
+}
+
+TEST(TestDVDMessageQueue, Fifo)
+{
+  CDVDMessageQueue queue("test");
+  queue.Init();
+
+  for (int i = 0; i < 100; i++)
+    EXPECT_EQ(MSGQ_OK, queue.Put(new CDVDMsgInt(CDVDMsg::PLAYER_SETSPEED, i)));
+
+  // more than the initial size of the ring, so it has grown on the way
+  for (int i = 0; i < 100; i++)
+    EXPECT_EQ(i, GetValue(queue));
+
+  CDVDMsg* msg = nullptr;
+  EXPECT_EQ(MSGQ_TIMEOUT, queue.Get(&msg, 0));
+  EXPECT_EQ(nullptr, msg);
+}
+
+TEST(TestDVDMessageQueue, Priority)
+{
+  CDVDMessageQueue queue("test");
+  queue.Init();
+
+  queue.Put(new CDVDMsgInt(CDVDMsg::PLAYER_SETSPEED, 0));
+  queue.Put(new CDVDMsgInt(CDVDMsg::PLAYER_SETSPEED, 10), 1);
+  queue.Put(new CDVDMsgInt(CDVDMsg::PLAYER_SETSPEED, 1));
+  queue.Put(new CDVDMsgInt(CDVDMsg::PLAYER_SETSPEED, 20), 2);
+  queue.Put(new CDVDMsgInt(CDVDMsg::PLAYER_SETSPEED, 11), 1);
+  queue.Put(new CDVDMsgInt(CDVDMsg::PLAYER_SETSPEED, 21), 2);
+
+  int priority = 0;
+  EXPECT_EQ(20, GetValue(queue, priority));
+  EXPECT_EQ(2, priority);
+  priority = 0;
+  EXPECT_EQ(21, GetValue(queue, priority));
+  priority = 0;
+  EXPECT_EQ(10, GetValue(queue, priority));
+  EXPECT_EQ(1, priority);
+  priority = 0;
+  EXPECT_EQ(11, GetValue(queue, priority));
+  priority = 0;
+  EXPECT_EQ(0, GetValue(queue, priority));
+  EXPECT_EQ(0, priority);
+  EXPECT_EQ(1, GetValue(queue));
+}
+
+TEST(TestDVDMessageQueue, MinimumPriority)
+{
+  CDVDMessageQueue queue("test");
+  queue.Init();
+
+  queue.Put(new CDVDMsgInt(CDVDMsg::PLAYER_SETSPEED, 0));
+
+  // only asking for priority messages, the normal one stays queued
+  int priority = 1;
+  CDVDMsg* msg = nullptr;
+  EXPECT_EQ(MSGQ_TIMEOUT, queue.Get(&msg, 0, priority));
+  EXPECT_EQ(nullptr, msg);
+
+  queue.Put(new CDVDMsgInt(CDVDMsg::PLAYER_SETSPEED, 10), 1);
+  priority = 1;
+  EXPECT_EQ(10, GetValue(queue, priority));
+  EXPECT_EQ(0, GetValue(queue));
+}
+
+TEST(TestDVDMessageQueue, PutBack)
+{
+  CDVDMessageQueue queue("test");
+  queue.Init();
+
+  queue.Put(new CDVDMsgInt(CDVDMsg::PLAYER_SETSPEED, 0));
+  queue.Put(new CDVDMsgInt(CDVDMsg::PLAYER_SETSPEED, 1));
+  queue.Put(new CDVDMsgInt(CDVDMsg::PLAYER_SETSPEED, 10), 1);
+  queue.Put(new CDVDMsgInt(CDVDMsg::PLAYER_SETSPEED, 11), 1);
+
+  // a message put back is served before the others of its priority, but
+  // not before messages of a higher priority
+  queue.PutBack(new CDVDMsgInt(CDVDMsg::PLAYER_SETSPEED, -1));
+  queue.PutBack(new CDVDMsgInt(CDVDMsg::PLAYER_SETSPEED, 9), 1);
+
+  int priority = 0;
+  EXPECT_EQ(9, GetValue(queue, priority));
+  EXPECT_EQ(1, priority);
+  EXPECT_EQ(10, GetValue(queue));
+  EXPECT_EQ(11, GetValue(queue));
+  EXPECT_EQ(-1, GetValue(queue));
+  EXPECT_EQ(0, GetValue(queue));
+  EXPECT_EQ(1, GetValue(queue));
+}
+
+TEST(TestDVDMessageQueue, Flush)
+{
+  CDVDMessageQueue queue("test");
+  queue.Init();
+
+  queue.Put(new CDVDMsgInt(CDVDMsg::PLAYER_SETSPEED, 0));
+  queue.Put(new CDVDMsg(CDVDMsg::GENERAL_RESYNC));
+  queue.Put(new CDVDMsgInt(CDVDMsg::PLAYER_SETSPEED, 1));
+  queue.Put(new CDVDMsgInt(CDVDMsg::PLAYER_SETSPEED, 10), 1);
+  EXPECT_EQ(3u, queue.GetPacketCount(CDVDMsg::PLAYER_SETSPEED));
+
+  // the remaining messages keep their order
+  queue.Flush(CDVDMsg::GENERAL_RESYNC);
+  EXPECT_EQ(0u, queue.GetPacketCount(CDVDMsg::GENERAL_RESYNC));
+  EXPECT_EQ(10, GetValue(queue));
+  EXPECT_EQ(0, GetValue(queue));
+  EXPECT_EQ(1, GetValue(queue));
+
+  queue.Put(new CDVDMsgInt(CDVDMsg::PLAYER_SETSPEED, 2));
+  queue.Flush(CDVDMsg::NONE);
+  CDVDMsg* msg = nullptr;
+  EXPECT_EQ(MSGQ_TIMEOUT, queue.Get(&msg, 0));
+}
@@ -0,0 +1,220 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/VideoPlayer/DVDCodecs/Overlay/DVDOverlayText.h"
+#include "cores/VideoPlayer/DVDStreamInfo.h"
+#include "cores/VideoPlayer/DVDSubtitles/DVDSubtitleLineCollection.h"
+#include "cores/VideoPlayer/DVDSubtitles/DVDSubtitleParserSubrip.h"
+#include "cores/VideoPlayer/DVDSubtitles/DVDSubtitleStream.h"
+#include "cores/VideoPlayer/Interface/Addon/TimingConstants.h"
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+struct Event
+{
+  double start;
+  double stop;
+};
+
+/*!
+ * \brief Overlapping events like in SSA files, signs stay up while dialogue goes on
+ */
+std::vector<Event> CreateEvents(size_t count, unsigned int seed)
+{
+  std::mt19937 random(seed);
+  std::uniform_int_distribution<int> gap(0, 3000);
+  std::uniform_int_distribution<int> duration(500, 8000);
+  std::uniform_int_distribution<int> sign(0, 20);
+
+  std::vector<Event> events;
+  double start = 0;
+  for (size_t i = 0; i < count; i++)
+  {
+    start += gap(random) * (DVD_TIME_BASE / 1000);
+    double length = duration(random) * (DVD_TIME_BASE / 1000);
+    if (sign(random) == 0)
+      length *= 30;
+    events.push_back({ start, start + length });
+  }
+  return events;
+}
+
+void Fill(CDVDSubtitleLineCollection& collection, const std::vector<Event>& events)
+{
+  collection.Reserve(events.size());
+  for (const Event& event : events)
+  {
+    CDVDOverlayText* overlay = new CDVDOverlayText();
+    overlay->iPTSStartTime = event.start;
+    overlay->iPTSStopTime = event.stop;
+    collection.Add(overlay);
+  }
+  collection.Sort();
+}
+
+/*!
+ * \brief Index of the overlay Get() returns, by walking the events like a list
+ */
+size_t WalkTo(const std::vector<Event>& events, size_t& current, double pts)
+{
+  while (current < events.size() && events[current].stop < pts)
+    current++;
+  return current < events.size() ? current++ : events.size();
+}
+
+std::string CreateSubrip(const std::vector<Event>& events)
+{
+  std::string subrip;
+  char line[128];
+  for (size_t i = 0; i < events.size(); i++)
+  {
+    int start = static_cast<int>(events[i].start / (DVD_TIME_BASE / 1000));
+    int stop = static_cast<int>(events[i].stop / (DVD_TIME_BASE / 1000));
+    snprintf(line, sizeof(line), "%zu\n%02d:%02d:%02d,%03d --> %02d:%02d:%02d,%03d\nline %zu\n\n",
+             i + 1, start / 3600000, start / 60000 % 60, start / 1000 % 60, start % 1000,
+             stop / 3600000, stop / 60000 % 60, stop / 1000 % 60, stop % 1000, i);
+    subrip += line;
+  }
+  return subrip;
+}
+}
+
+TEST(TestDVDSubtitleLineCollection, Empty)
+{
+  CDVDSubtitleLineCollection collection;
+  EXPECT_EQ(nullptr, collection.Get(0));
+  EXPECT_EQ(0, collection.GetSize());
+}
+
+TEST(TestDVDSubtitleLineCollection, Sort)
+{
+  std::vector<Event> events = { { 3000, 4000 }, { 1000, 2000 }, { 2000, 9000 }, { 1000, 1500 } };
+  CDVDSubtitleLineCollection collection;
+  Fill(collection, events);
+
+  ASSERT_EQ(4, collection.GetSize());
+  CDVDOverlay* overlay;
+  overlay = collection.Get(0);
+  EXPECT_EQ(1000, overlay->iPTSStartTime);
+  EXPECT_EQ(2000, overlay->iPTSStopTime);
+  overlay = collection.Get(0);
+  EXPECT_EQ(1000, overlay->iPTSStartTime);
+  EXPECT_EQ(1500, overlay->iPTSStopTime);
+  EXPECT_EQ(2000, collection.Get(0)->iPTSStartTime);
+  EXPECT_EQ(3000, collection.Get(0)->iPTSStartTime);
+  EXPECT_EQ(nullptr, collection.Get(0));
+}
+
+TEST(TestDVDSubtitleLineCollection, SkipsOverlaysThatAreOver)
+{
+  std::vector<Event> events = { { 0, 1000 }, { 500, 10000 }, { 2000, 3000 }, { 4000, 5000 } };
+  CDVDSubtitleLineCollection collection;
+  Fill(collection, events);
+
+  // the long overlay is still shown, the short ones before it are over
+  EXPECT_EQ(500, collection.Get(4500)->iPTSStartTime);
+  EXPECT_EQ(4000, collection.Get(4500)->iPTSStartTime);
+  EXPECT_EQ(nullptr, collection.Get(4500));
+
+  collection.Reset();
+  EXPECT_EQ(500, collection.Get(10000)->iPTSStartTime);
+  EXPECT_EQ(nullptr, collection.Get(10000));
+}
+
+TEST(TestDVDSubtitleLineCollection, MatchesLinearWalk)
+{
+  const std::vector<Event> events = CreateEvents(5000, 1);
+  CDVDSubtitleLineCollection collection;
+  Fill(collection, events);
+
+  std::mt19937 random(2);
+  std::uniform_real_distribution<double> position(0, events.back().stop + DVD_TIME_BASE);
+  std::uniform_int_distribution<int> step(0, 4);
+
+  size_t current = 0;
+  for (int i = 0; i < 20000; i++)
+  {
+    // seek backwards now and then, otherwise play on
+    double pts = position(random);
+    if (step(random) == 0)
+    {
+      collection.Reset();
+      current = 0;
+    }
+
+    size_t expected = WalkTo(events, current, pts);
+    CDVDOverlay* overlay = collection.Get(pts);
+    if (expected == events.size())
+    {
+      EXPECT_EQ(nullptr, overlay);
+    }
+    else
+    {
+      ASSERT_NE(nullptr, overlay);
+      EXPECT_EQ(events[expected].start, overlay->iPTSStartTime);
+      EXPECT_EQ(events[expected].stop, overlay->iPTSStopTime);
+    }
+  }
+}
+
+/*
+ * Parses a generated Subrip file with many overlapping events and seeks
+ * through it, comparing lookups with walking the events like a list.
+ */
+TEST(TestDVDSubtitleLineCollection, DISABLED_Benchmark)
+{
+  const size_t count = 50000;
+  const int seeks = 2000;
+  const std::vector<Event> events = CreateEvents(count, 3);
+
+  std::unique_ptr<CDVDSubtitleStream> stream(new CDVDSubtitleStream());
+  stream->m_stringstream << CreateSubrip(events);
+
+  CDVDSubtitleParserSubrip parser(std::move(stream), "benchmark.srt");
+  CDVDStreamInfo hints;
+  auto start = std::chrono::steady_clock::now();
+  ASSERT_TRUE(parser.Open(hints));
+  const std::chrono::duration<double, std::milli> parse = std::chrono::steady_clock::now() - start;
+
+  std::mt19937 random(4);
+  std::uniform_real_distribution<double> position(0, events.back().stop);
+  std::vector<double> positions;
+  for (int i = 0; i < seeks; i++)
+    positions.push_back(position(random));
+
+  start = std::chrono::steady_clock::now();
+  for (double pts : positions)
+  {
+    parser.Reset();
+    CDVDOverlay* overlay = parser.Parse(pts);
+    ASSERT_NE(nullptr, overlay);
+    overlay->Release();
+  }
+  const std::chrono::duration<double, std::milli> indexed = std::chrono::steady_clock::now() - start;
+
+  size_t found = 0;
+  start = std::chrono::steady_clock::now();
+  for (double pts : positions)
+  {
+    size_t current = 0;
+    found += WalkTo(events, current, pts);
+  }
+  const std::chrono::duration<double, std::milli> walked = std::chrono::steady_clock::now() - start;
+
+  printf("[ BENCHMARK] %zu events: parsed in %.1f ms, %d seeks in %.2f ms indexed, %.2f ms walking to event %zu on average\n",
+         count, parse.count(), seeks, indexed.count(), walked.count(), found / seeks);
+  parser.Dispose();
+}
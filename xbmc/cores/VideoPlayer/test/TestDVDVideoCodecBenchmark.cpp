@@ -0,0 +1,138 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "FileItem.h"
+#include "cores/VideoPlayer/DVDCodecs/Video/DVDVideoCodecFFmpeg.h"
+#include "cores/VideoPlayer/DVDCodecs/Video/DVDVideoFramePoolFFmpeg.h"
+#include "cores/VideoPlayer/DVDDemuxers/DVDDemux.h"
+#include "cores/VideoPlayer/DVDDemuxers/DVDDemuxUtils.h"
+#include "cores/VideoPlayer/DVDDemuxers/DVDFactoryDemuxer.h"
+#include "cores/VideoPlayer/DVDInputStreams/DVDFactoryInputStream.h"
+#include "cores/VideoPlayer/DVDInputStreams/DVDInputStream.h"
+#include "cores/VideoPlayer/DVDStreamInfo.h"
+#include "cores/VideoPlayer/Process/ProcessInfo.h"
+#include "test/TestUtils.h"
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+extern "C" {
+#include <libavformat/avformat.h>
+}
+
+namespace
+{
+/*!
+ * \brief Take all pictures from the decoder and drop them like a renderer without output
+ * \return the number of pictures
+ */
+unsigned int TakePictures(CDVDVideoCodec& codec, VideoPicture& picture)
+{
+  unsigned int pictures = 0;
+  for (;;)
+  {
+    CDVDVideoCodec::VCReturn ret = codec.GetPicture(&picture);
+    if (ret == CDVDVideoCodec::VC_PICTURE)
+    {
+      if (!(picture.iFlags & DVP_FLAG_DROPPED))
+        pictures++;
+      if (picture.videoBuffer)
+      {
+        picture.videoBuffer->Release();
+        picture.videoBuffer = nullptr;
+      }
+    }
+    else if (ret != CDVDVideoCodec::VC_NONE)
+      return pictures;
+  }
+}
+}
+
+/*
+ * Decodes the first video stream of the media files given with
+ * --add-demux-benchmark-file(s) in software as fast as possible, once with
+ * frames from the pools of CDVDVideoFramePoolFFmpeg and once with the
+ * default buffers of ffmpeg. Run with --gtest_also_run_disabled_tests.
+ */
+TEST(TestDVDVideoCodecBenchmark, DISABLED_DecodeSoftware)
+{
+  const std::vector<std::string>& files = CXBMCTestUtils::Instance().getDemuxBenchmarkFiles();
+  if (files.empty())
+  {
+    printf("[ BENCHMARK] no media files given, use --add-demux-benchmark-file\n");
+    return;
+  }
+
+  for (const auto& file : files)
+  {
+    for (bool pooled : { true, false })
+    {
+      CDVDVideoFramePoolFFmpeg::SetEnabled(pooled);
+
+      CFileItem item(file, false);
+      auto input = CDVDFactoryInputStream::CreateInputStream(nullptr, item);
+      ASSERT_TRUE(input);
+      ASSERT_TRUE(input->Open());
+      std::unique_ptr<CDVDDemux> demuxer(CDVDFactoryDemuxer::CreateDemuxer(input, true));
+      ASSERT_TRUE(demuxer);
+
+      CDemuxStream* stream = nullptr;
+      for (CDemuxStream* s : demuxer->GetStreams())
+      {
+        if (s && s->type == STREAM_VIDEO && !(s->flags & AV_DISPOSITION_ATTACHED_PIC))
+        {
+          stream = s;
+          break;
+        }
+      }
+      if (!stream)
+      {
+        printf("[ BENCHMARK] %s: no video stream\n", file.c_str());
+        break;
+      }
+
+      std::unique_ptr<CProcessInfo> processInfo(CProcessInfo::CreateInstance());
+      std::vector<AVPixelFormat> pixFormats = { AV_PIX_FMT_YUV420P };
+      processInfo->SetPixFormats(pixFormats);
+
+      CDVDStreamInfo hints(*stream, true);
+      hints.codecOptions = CODEC_FORCE_SOFTWARE;
+      CDVDCodecOptions options;
+      CDVDVideoCodecFFmpeg codec(*processInfo);
+      ASSERT_TRUE(codec.Open(hints, options));
+
+      VideoPicture picture = {};
+      unsigned int pictures = 0;
+      const auto start = std::chrono::steady_clock::now();
+      while (DemuxPacket* packet = demuxer->Read())
+      {
+        if (packet->iStreamId == stream->uniqueId)
+        {
+          while (!codec.AddData(*packet))
+            pictures += TakePictures(codec, picture);
+          pictures += TakePictures(codec, picture);
+        }
+        CDVDDemuxUtils::FreeDemuxPacket(packet);
+      }
+
+      codec.SetCodecControl(DVD_CODEC_CTRL_DRAIN);
+      pictures += TakePictures(codec, picture);
+      const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+      printf("[ BENCHMARK] %s (%s): %u frames, %.1f fps\n", file.c_str(),
+             pooled ? "frame pool" : "ffmpeg buffers", pictures, pictures / elapsed.count());
+      EXPECT_GT(pictures, 0u);
+    }
+  }
+
+  CDVDVideoFramePoolFFmpeg::SetEnabled(true);
+}
@@ -0,0 +1,117 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/PlaybackTrace.h"
+#include "cores/VideoPlayer/Interface/Addon/TimingConstants.h"
+#include "utils/Variant.h"
+
+#include <gtest/gtest.h>
+
+namespace
+{
+CPlaybackTrace::Frame CreateFrame(double pts, float decode, CPlaybackTrace::DropCause drop)
+{
+  CPlaybackTrace::Frame frame;
+  frame.pts = pts;
+  frame.demux = 0.1f;
+  frame.queue = 2.0f;
+  frame.decode = decode;
+  frame.drop = drop;
+  return frame;
+}
+}
+
+TEST(TestPlaybackTrace, Buckets)
+{
+  EXPECT_EQ(0u, CPlaybackTrace::GetBucket(0.0));
+  EXPECT_EQ(0u, CPlaybackTrace::GetBucket(0.1));
+  EXPECT_EQ(1u, CPlaybackTrace::GetBucket(CPlaybackTrace::GetBucketLimit(0)));
+  EXPECT_EQ(5u, CPlaybackTrace::GetBucket(3.0));
+  EXPECT_EQ(CPlaybackTrace::BUCKETS - 1, CPlaybackTrace::GetBucket(1e6));
+
+  for (unsigned int bucket = 1; bucket + 1 < CPlaybackTrace::BUCKETS; bucket++)
+    EXPECT_DOUBLE_EQ(CPlaybackTrace::GetBucketLimit(bucket - 1) * 2, CPlaybackTrace::GetBucketLimit(bucket));
+}
+
+TEST(TestPlaybackTrace, KeepsLastFrames)
+{
+  CPlaybackTrace trace;
+  EXPECT_TRUE(trace.GetFrames().empty());
+
+  const unsigned int count = CPlaybackTrace::CAPACITY + 100;
+  for (unsigned int i = 0; i < count; i++)
+    trace.AddFrame(CreateFrame(i, 1.0f, CPlaybackTrace::DROP_NONE));
+
+  std::vector<CPlaybackTrace::Frame> frames = trace.GetFrames();
+  ASSERT_EQ(CPlaybackTrace::CAPACITY, frames.size());
+  EXPECT_EQ(100, frames.front().pts);
+  EXPECT_EQ(count - 1, frames.back().pts);
+
+  frames = trace.GetFrames(3);
+  ASSERT_EQ(3u, frames.size());
+  EXPECT_EQ(count - 3, frames[0].pts);
+  EXPECT_EQ(count - 1, frames[2].pts);
+
+  EXPECT_EQ(count, trace.GetSummary().frames);
+
+  trace.Reset();
+  EXPECT_TRUE(trace.GetFrames().empty());
+  EXPECT_EQ(0u, trace.GetSummary().frames);
+}
+
+TEST(TestPlaybackTrace, Summary)
+{
+  CPlaybackTrace trace;
+  trace.AddFrame(CreateFrame(0, 1.0f, CPlaybackTrace::DROP_NONE));
+  trace.AddFrame(CreateFrame(1, 3.0f, CPlaybackTrace::DROP_NONE));
+  trace.AddFrame(CreateFrame(2, 40.0f, CPlaybackTrace::DROP_LATE));
+  trace.AddSkipped(2);
+
+  const CPlaybackTrace::Summary summary = trace.GetSummary();
+  EXPECT_EQ(3u, summary.frames);
+  EXPECT_EQ(2u, summary.drops[CPlaybackTrace::DROP_NONE]);
+  EXPECT_EQ(1u, summary.drops[CPlaybackTrace::DROP_LATE]);
+  EXPECT_EQ(2u, summary.drops[CPlaybackTrace::DROP_SKIPPED]);
+  EXPECT_EQ(0u, summary.drops[CPlaybackTrace::DROP_RENDERER]);
+
+  EXPECT_EQ(1u, summary.histograms[CPlaybackTrace::STAGE_DECODE][CPlaybackTrace::GetBucket(1.0)]);
+  EXPECT_EQ(1u, summary.histograms[CPlaybackTrace::STAGE_DECODE][CPlaybackTrace::GetBucket(3.0)]);
+  EXPECT_EQ(1u, summary.histograms[CPlaybackTrace::STAGE_DECODE][CPlaybackTrace::GetBucket(40.0)]);
+  EXPECT_EQ(3u, summary.histograms[CPlaybackTrace::STAGE_QUEUE][CPlaybackTrace::GetBucket(2.0)]);
+  EXPECT_DOUBLE_EQ(44.0, summary.totalMs[CPlaybackTrace::STAGE_DECODE]);
+  EXPECT_DOUBLE_EQ(40.0, summary.maxMs[CPlaybackTrace::STAGE_DECODE]);
+}
+
+TEST(TestPlaybackTrace, Serialize)
+{
+  CPlaybackTrace trace;
+  trace.AddFrame(CreateFrame(DVD_TIME_BASE, 2.0f, CPlaybackTrace::DROP_NONE));
+  trace.AddFrame(CreateFrame(2 * DVD_TIME_BASE, 4.0f, CPlaybackTrace::DROP_DECODER));
+
+  CVariant value;
+  trace.Serialize(value, 1);
+
+  EXPECT_EQ(2u, value["frames"].asUnsignedInteger());
+  EXPECT_EQ(1u, value["shown"].asUnsignedInteger());
+  EXPECT_EQ(1u, value["dropped"]["decoder"].asUnsignedInteger());
+  EXPECT_EQ(0u, value["dropped"]["renderer"].asUnsignedInteger());
+  EXPECT_FALSE(value["dropped"].isMember("none"));
+  EXPECT_EQ(CPlaybackTrace::BUCKETS - 1, value["bucketlimits"].size());
+
+  for (unsigned int stage = 0; stage < CPlaybackTrace::STAGES; stage++)
+  {
+    const CVariant& entry = value["stages"][CPlaybackTrace::GetStageName(static_cast<CPlaybackTrace::Stage>(stage))];
+    EXPECT_EQ(CPlaybackTrace::BUCKETS, entry["histogram"].size());
+  }
+  EXPECT_DOUBLE_EQ(3.0, value["stages"]["decode"]["averagems"].asDouble());
+  EXPECT_DOUBLE_EQ(0.0, value["stages"]["presentinterval"]["averagems"].asDouble());
+
+  ASSERT_EQ(1u, value["trace"].size());
+  EXPECT_DOUBLE_EQ(2.0, value["trace"][0]["pts"].asDouble());
+  EXPECT_EQ("decoder", value["trace"][0]["drop"].asString());
+}
@@ -350,6 +350,77 @@ bool CDatabase::ExecuteQuery(const std::string &strQuery)
   return bReturn;
 }
 
+bool CDatabase::ExecutePreparedQuery(const std::string &strQuery, const std::vector<dbiplus::field_value> &params)
+{
+  bool bReturn = false;
+
+  try
+  {
+    if (NULL == m_pDB.get()) return bReturn;
+    if (NULL == m_pDS.get()) return bReturn;
+
+    if (m_multipleExecute)
+      m_multipleQueries.push_back(m_pDS->format_params(strQuery, params));
+    else
+      m_pDS->exec_prepared(strQuery, params);
+    bReturn = true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s - failed to execute query '%s'",
+        __FUNCTION__, strQuery.c_str());
+  }
+
+  return bReturn;
+}
+
+bool CDatabase::ResultPreparedQuery(const std::string &strQuery, const std::vector<dbiplus::field_value> &params)
+{
+  bool bReturn = false;
+
+  try
+  {
+    if (NULL == m_pDB.get()) return bReturn;
+    if (NULL == m_pDS.get()) return bReturn;
+
+    bReturn = m_pDS->query_prepared(strQuery, params);
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s - failed to execute query '%s'",
+        __FUNCTION__, strQuery.c_str());
+  }
+
+  return bReturn;
+}
+
+bool CDatabase::BulkInsert(const std::string &strQuery, const std::vector<std::vector<dbiplus::field_value>> &rows)
+{
+  bool bReturn = false;
+
+  try
+  {
+    if (NULL == m_pDB.get()) return bReturn;
+    if (NULL == m_pDS.get()) return bReturn;
+
+    if (m_multipleExecute)
+    {
+      for (const auto& params : rows)
+        m_multipleQueries.push_back(m_pDS->format_params(strQuery, params));
+    }
+    else
+      m_pDS->exec_batch(strQuery, rows);
+    bReturn = true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s - failed to insert %u rows with '%s'",
+        __FUNCTION__, static_cast<unsigned int>(rows.size()), strQuery.c_str());
+  }
+
+  return bReturn;
+}
+
 bool CDatabase::ResultQuery(const std::string &strQuery)
 {
   bool bReturn = false;
@@ -11,6 +11,7 @@
 namespace dbiplus {
   class Database;
   class Dataset;
+  class field_value;
 }
 
 #include <memory>
@@ -155,6 +156,36 @@ public:
    */
   bool ResultQuery(const std::string &strQuery);
 
+  /*!
+   * @brief Execute a query with bound parameters that does not return any result.
+   *        The statement is compiled once and reused for every call with the same
+   *        query, so use placeholders instead of formatting the values into it.
+   *        Queued like ExecuteQuery() after BeginMultipleExecute().
+   * @param strQuery The query to execute, with a ? for every parameter. It is used as is, not passed through PrepareSQL().
+   * @param params The values of the parameters, in order.
+   * @return True if the query was executed successfully, false otherwise.
+   */
+  bool ExecutePreparedQuery(const std::string &strQuery, const std::vector<dbiplus::field_value> &params);
+
+  /*!
+   * @brief Execute a query with bound parameters that returns a result.
+   * @remarks Call m_pDS->close(); to clean up the dataset when done.
+   * @sa ExecutePreparedQuery
+   */
+  bool ResultPreparedQuery(const std::string &strQuery, const std::vector<dbiplus::field_value> &params);
+
+  /*!
+   * @brief Execute an INSERT or REPLACE query with bound parameters for many rows at once.
+   *        The statement is compiled once and all rows are inserted in a single
+   *        transaction, unless a transaction is already active.
+   *        Queued like ExecuteQuery() after BeginMultipleExecute().
+   * @param strQuery The query to execute, with a ? for every column value.
+   * @param rows The values of the parameters for every row.
+   * @return True if all rows were inserted successfully, false otherwise.
+   * @sa ExecutePreparedQuery
+   */
+  bool BulkInsert(const std::string &strQuery, const std::vector<std::vector<dbiplus::field_value>> &rows);
+
   /*!
    * @brief Start a multiple execution queue. Any ExecuteQuery() function
    *        following this call will be queued rather than executed until
@@ -186,6 +186,85 @@ void Dataset::parse_sql(std::string &sql) {
 }
 
 
+int Dataset::exec_prepared(const std::string &sql, const sql_record &params) {
+  return exec(format_params(sql, params));
+}
+
+
+bool Dataset::query_prepared(const std::string &sql, const sql_record &params) {
+  return query(format_params(sql, params));
+}
+
+
+int Dataset::exec_batch(const std::string &sql, const std::vector<sql_record> &rows) {
+  if (db == NULL) throw DbErrors("No Database Connection");
+
+  const bool transaction = !db->in_transaction();
+  if (transaction)
+    db->start_transaction();
+
+  try {
+    for (const sql_record &params : rows)
+      exec_prepared(sql, params);
+  }
+  catch(...) {
+    if (transaction)
+      db->rollback_transaction();
+    throw;
+  }
+
+  if (transaction)
+    db->commit_transaction();
+  return DB_COMMAND_OK;
+}
+
+
+std::string Dataset::format_params(const std::string &sql, const sql_record &params) {
+  if (db == NULL) throw DbErrors("No Database Connection");
+
+  std::string result;
+  result.reserve(sql.size() + params.size() * 16);
+
+  size_t param = 0;
+  bool quoted = false;
+  for (const char c : sql) {
+    if (c == '\'')
+      quoted = !quoted;
+
+    if (c != '?' || quoted) {
+      result += c;
+      continue;
+    }
+
+    if (param >= params.size())
+      throw DbErrors("Missing parameter %u for query: %s", static_cast<unsigned int>(param + 1), sql.c_str());
+
+    const field_value &value = params[param++];
+    if (value.get_isNull())
+      result += "NULL";
+    else switch (value.get_fType()) {
+      case ft_String:
+      case ft_WideString:
+        result += db->prepare("'%s'", value.get_asString().c_str());
+        break;
+      case ft_Float:
+      case ft_Double:
+      case ft_LongDouble:
+        result += db->prepare("%.17g", value.get_asDouble());
+        break;
+      default:
+        result += std::to_string(value.get_asInt64());
+        break;
+    }
+  }
+
+  if (param != params.size())
+    throw DbErrors("Too many parameters for query: %s", sql.c_str());
+
+  return result;
+}
+
+
 void Dataset::close(void) {
   haveError  = false;
   frecno = 0;
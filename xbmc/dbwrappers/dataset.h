@@ -292,6 +292,34 @@ public:
   virtual const void* getExecRes()=0;
 /* as open, but with our query exec Sql */
   virtual bool query(const std::string &sql) = 0;
+
+/* ------------ for prepared statements ------------------- */
+
+  /*! \brief Execute a query with bound parameters that returns no results.
+   Backends that support it compile the statement once and reuse it for the same sql.
+   \param sql - the query, with a ? placeholder for every parameter.
+   \param params - the parameter values, in order of the placeholders.
+   */
+  virtual int exec_prepared(const std::string &sql, const sql_record &params);
+
+  /*! \brief As query(), with bound parameters.
+   \sa exec_prepared
+   */
+  virtual bool query_prepared(const std::string &sql, const sql_record &params);
+
+  /*! \brief Execute a query with bound parameters once for every row of parameters.
+   Runs in a single transaction unless one is already active.
+   \param sql - the query, usually an INSERT or REPLACE, with ? placeholders.
+   \param rows - one set of parameter values per execution.
+   \sa exec_prepared
+   */
+  virtual int exec_batch(const std::string &sql, const std::vector<sql_record> &rows);
+
+  /*! \brief Replace the ? placeholders of a query with the escaped parameter values.
+   \return the query as plain sql, for backends without prepared statements.
+   */
+  std::string format_params(const std::string &sql, const sql_record &params);
+
 /* Close SQL Query*/
   virtual void close();
 /* This function looks for field Field_name with value equal Field_value
@@ -23,6 +23,9 @@
 #include "platform/linux/XTimeUtils.h"
 #endif
 
+// Maximum number of prepared statements to keep per connection
+#define MAX_CACHED_STATEMENTS 64
+
 namespace {
 #define X(VAL) std::make_pair(VAL, #VAL)
 //!@todo Remove ifdefs when sqlite version requirement has been bumped to at least 3.26.0
@@ -209,6 +212,9 @@ SqliteDatabase::SqliteDatabase() {
 
   active = false;
   _in_transaction = false;    // for transaction
+  statement_uses = 0;
+  statement_hits = 0;
+  statement_misses = 0;
 
   error = "Unknown database error";//S_NO_CONNECTION;
   host = "localhost";
@@ -352,6 +358,7 @@ bool SqliteDatabase::exists(void)
 
 void SqliteDatabase::disconnect(void) {
   if (active == false) return;
+  clear_statements();
   sqlite3_close(conn);
   active = false;
 }
@@ -507,6 +514,48 @@ void SqliteDatabase::rollback_transaction() {
 }
 
 
+// methods for prepared statements
+// ---------------------------------------------
+sqlite3_stmt *SqliteDatabase::get_statement(const std::string &sql) {
+  if (!active) return NULL;
+
+  auto it = statements.find(sql);
+  if (it != statements.end()) {
+    statement_hits++;
+    it->second.last_use = ++statement_uses;
+    return it->second.stmt;
+  }
+
+  statement_misses++;
+  sqlite3_stmt *stmt = NULL;
+  int rc = sqlite3_prepare_v2(conn, sql.c_str(), sql.size(), &stmt, NULL);
+  if (rc != SQLITE_OK) {
+    setErr(rc, sql.c_str());
+    return NULL;
+  }
+
+  if (statements.size() >= MAX_CACHED_STATEMENTS) {
+    auto oldest = statements.begin();
+    for (auto i = statements.begin(); i != statements.end(); ++i)
+      if (i->second.last_use < oldest->second.last_use)
+        oldest = i;
+    sqlite3_finalize(oldest->second.stmt);
+    statements.erase(oldest);
+  }
+
+  CachedStatement &cached = statements[sql];
+  cached.stmt = stmt;
+  cached.last_use = ++statement_uses;
+  return stmt;
+}
+
+void SqliteDatabase::clear_statements() {
+  for (auto &i : statements)
+    sqlite3_finalize(i.second.stmt);
+  statements.clear();
+}
+
+
 // methods for formatting
 // ---------------------------------------------
 std::string SqliteDatabase::vprepare(const char *format, va_list args)
@@ -789,6 +838,22 @@ bool SqliteDataset::query(const std::string &query) {
   if (db->setErr(sqlite3_prepare_v2(handle(),query.c_str(),-1,&stmt, NULL),query.c_str()) != SQLITE_OK)
     throw DbErrors("%s", db->getErrorMsg());
 
+  fetch_rows(stmt);
+
+  if (db->setErr(sqlite3_finalize(stmt),query.c_str()) == SQLITE_OK)
+  {
+    active = true;
+    ds_state = dsSelect;
+    this->first();
+    return true;
+  }
+  else
+  {
+    throw DbErrors("%s", db->getErrorMsg());
+  }
+}
+
+void SqliteDataset::fetch_rows(sqlite3_stmt *stmt) {
   // column headers
   const unsigned int numColumns = sqlite3_column_count(stmt);
   result.record_header.resize(numColumns);
@@ -826,19 +891,129 @@ bool SqliteDataset::query(const std::string &query) {
     }
     result.records.push_back(res);
   }
-  if (db->setErr(sqlite3_finalize(stmt),query.c_str()) == SQLITE_OK)
+}
+
+sqlite3_stmt *SqliteDataset::get_statement(const std::string &sql) {
+  if (!handle()) throw DbErrors("No Database Connection");
+
+  sqlite3_stmt *stmt = static_cast<SqliteDatabase*>(db)->get_statement(sql);
+  if (!stmt)
+    throw DbErrors("%s", db->getErrorMsg());
+  return stmt;
+}
+
+void SqliteDataset::bind_params(sqlite3_stmt *stmt, const std::string &sql, const sql_record &params) {
+  if (static_cast<int>(params.size()) != sqlite3_bind_parameter_count(stmt))
+    throw DbErrors("Query expects %d parameters, got %u: %s", sqlite3_bind_parameter_count(stmt),
+                   static_cast<unsigned int>(params.size()), sql.c_str());
+
+  for (unsigned int i = 0; i < params.size(); i++)
   {
-    active = true;
-    ds_state = dsSelect;
-    this->first();
-    return true;
+    const field_value &value = params[i];
+    int rc;
+    if (value.get_isNull())
+      rc = sqlite3_bind_null(stmt, i + 1);
+    else switch (value.get_fType())
+    {
+    case ft_String:
+    case ft_WideString:
+    {
+      const std::string str = value.get_asString();
+      rc = sqlite3_bind_text(stmt, i + 1, str.c_str(), str.size(), SQLITE_TRANSIENT);
+      break;
+    }
+    case ft_Float:
+    case ft_Double:
+    case ft_LongDouble:
+      rc = sqlite3_bind_double(stmt, i + 1, value.get_asDouble());
+      break;
+    default:
+      rc = sqlite3_bind_int64(stmt, i + 1, value.get_asInt64());
+      break;
+    }
+
+    if (rc != SQLITE_OK)
+    {
+      db->setErr(rc, sql.c_str());
+      throw DbErrors("%s", db->getErrorMsg());
+    }
   }
-  else
+}
+
+void SqliteDataset::step_statement(sqlite3_stmt *stmt, const std::string &sql) {
+  int rc;
+  while ((rc = sqlite3_step(stmt)) == SQLITE_ROW)
+    ;
+  sqlite3_reset(stmt);
+
+  if (rc != SQLITE_DONE)
   {
+    db->setErr(rc, sql.c_str());
     throw DbErrors("%s", db->getErrorMsg());
   }
 }
 
+int SqliteDataset::exec_prepared(const std::string &sql, const sql_record &params) {
+  sqlite3_stmt *stmt = get_statement(sql);
+  exec_res.clear();
+
+  bind_params(stmt, sql, params);
+  step_statement(stmt, sql);
+  return SQLITE_OK;
+}
+
+bool SqliteDataset::query_prepared(const std::string &sql, const sql_record &params) {
+  sqlite3_stmt *stmt = get_statement(sql);
+  close();
+
+  bind_params(stmt, sql, params);
+  fetch_rows(stmt);
+
+  const int rc = sqlite3_reset(stmt);
+  if (rc != SQLITE_OK)
+  {
+    db->setErr(rc, sql.c_str());
+    throw DbErrors("%s", db->getErrorMsg());
+  }
+
+  active = true;
+  ds_state = dsSelect;
+  this->first();
+  return true;
+}
+
+int SqliteDataset::exec_batch(const std::string &sql, const std::vector<sql_record> &rows) {
+  if (rows.empty())
+    return SQLITE_OK;
+
+  sqlite3_stmt *stmt = get_statement(sql);
+  exec_res.clear();
+
+  const bool transaction = !db->in_transaction();
+  if (transaction)
+    db->start_transaction();
+
+  try
+  {
+    for (const sql_record &params : rows)
+    {
+      bind_params(stmt, sql, params);
+      step_statement(stmt, sql);
+    }
+  }
+  catch(...)
+  {
+    sqlite3_reset(stmt);
+    if (transaction)
+      db->rollback_transaction();
+    throw;
+  }
+
+  if (transaction)
+    db->commit_transaction();
+  return SQLITE_OK;
+}
+
 void SqliteDataset::open(const std::string &sql) {
   set_select_sql(sql);
   open();
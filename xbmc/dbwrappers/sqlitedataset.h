@@ -13,6 +13,8 @@
 #pragma once
 
 #include <stdio.h>
+#include <string>
+#include <unordered_map>
 #include "dataset.h"
 #include <sqlite3.h>
 
@@ -80,6 +82,30 @@ public:
 
   bool in_transaction() override {return _in_transaction;};
 
+/* prepared statements */
+
+  /*! \brief Get a compiled statement for the sql, ready to bind and step.
+   Statements are kept per connection and reused for the same sql, so it is only parsed once.
+   \return the statement, or NULL if it fails to compile (see getErrorMsg()).
+   */
+  sqlite3_stmt *get_statement(const std::string &sql);
+
+  /*! \brief Finalize all cached statements. */
+  void clear_statements();
+
+  unsigned int get_statement_hits() const { return statement_hits; }
+  unsigned int get_statement_misses() const { return statement_misses; }
+
+protected:
+  struct CachedStatement
+  {
+    sqlite3_stmt *stmt;
+    unsigned int last_use;
+  };
+  std::unordered_map<std::string, CachedStatement> statements;
+  unsigned int statement_uses;
+  unsigned int statement_hits;
+  unsigned int statement_misses;
 };
 
 
@@ -111,6 +137,12 @@ protected:
 /* Changing field values during dataset navigation */
   virtual void free_row();  // free the memory allocated for the current row
 
+/* prepared statements */
+  sqlite3_stmt *get_statement(const std::string &sql);
+  void bind_params(sqlite3_stmt *stmt, const std::string &sql, const sql_record &params);
+  void step_statement(sqlite3_stmt *stmt, const std::string &sql);
+  void fetch_rows(sqlite3_stmt *stmt);
+
 public:
 /* constructor */
   SqliteDataset();
@@ -132,6 +164,10 @@ or insert() operations default = false) */
   const void* getExecRes() override;
 /* as open, but with our query exec Sql */
   bool query(const std::string &query) override;
+/* prepared statements */
+  int exec_prepared(const std::string &sql, const sql_record &params) override;
+  bool query_prepared(const std::string &sql, const sql_record &params) override;
+  int exec_batch(const std::string &sql, const std::vector<sql_record> &rows) override;
 /* func. closes a query */
   void close(void) override;
 /* Cancel changes, made in insert or edit states of dataset */
@@ -0,0 +1,222 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "dbwrappers/sqlitedataset.h"
+#include "filesystem/SpecialProtocol.h"
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace dbiplus;
+
+namespace
+{
+const char* CREATE_SONG = "CREATE TABLE song (idSong integer primary key, idAlbum integer, idPath integer, "
+                          "strArtistDisp text, strTitle varchar(512), iTrack integer, iDuration integer, "
+                          "iYear integer, strFileName text, strMusicBrainzTrackID text, rating float, comment text)";
+const char* CREATE_SONG_INDEX = "CREATE INDEX idxSong3 ON song (idAlbum, strFileName)";
+
+const char* INSERT_SONG = "INSERT INTO song (idSong, idAlbum, idPath, strArtistDisp, strTitle, iTrack, iDuration, "
+                          "iYear, strFileName, strMusicBrainzTrackID, rating, comment) "
+                          "VALUES (NULL, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)";
+const char* SELECT_SONG = "SELECT idSong FROM song WHERE idAlbum = ? AND strFileName = ? AND iTrack = ?";
+
+struct Song
+{
+  int idAlbum;
+  int iTrack;
+  std::string strArtist;
+  std::string strTitle;
+  std::string strFileName;
+};
+
+Song MakeSong(int i)
+{
+  Song song;
+  song.idAlbum = i / 10 + 1;
+  song.iTrack = i % 10 + 1;
+  song.strArtist = "Artist " + std::to_string(i / 100);
+  song.strTitle = "Song's title " + std::to_string(i);
+  song.strFileName = std::to_string(song.iTrack) + " - Song " + std::to_string(i) + ".flac";
+  return song;
+}
+
+sql_record MakeParams(const Song& song)
+{
+  field_value mbid;
+  mbid.set_isNull();
+  return { field_value(song.idAlbum), field_value(song.idAlbum), field_value(song.strArtist),
+           field_value(song.strTitle), field_value(song.iTrack), field_value(240), field_value(2019),
+           field_value(song.strFileName), mbid, field_value(7.5), field_value("") };
+}
+
+class TestSqliteDataset : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_path = CSpecialProtocol::TranslatePath("special://temp/");
+    remove((m_path + "TestSqliteDataset.db").c_str());
+
+    m_db.setHostName(m_path.c_str());
+    m_db.setDatabase("TestSqliteDataset");
+    ASSERT_EQ(DB_CONNECTION_OK, m_db.connect(true));
+    m_ds.reset(m_db.CreateDataset());
+    m_ds->exec(CREATE_SONG);
+    m_ds->exec(CREATE_SONG_INDEX);
+  }
+
+  void TearDown() override
+  {
+    m_ds.reset();
+    m_db.disconnect();
+    remove((m_path + "TestSqliteDataset.db").c_str());
+  }
+
+  std::string m_path;
+  SqliteDatabase m_db;
+  std::unique_ptr<Dataset> m_ds;
+};
+}
+
+TEST_F(TestSqliteDataset, PreparedStatements)
+{
+  Song song = MakeSong(1);
+  song.strTitle = "It's a '?' title";
+  ASSERT_EQ(SQLITE_OK, m_ds->exec_prepared(INSERT_SONG, MakeParams(song)));
+  const int64_t idSong = m_ds->lastinsertid();
+
+  ASSERT_TRUE(m_ds->query_prepared(SELECT_SONG, { field_value(song.idAlbum), field_value(song.strFileName), field_value(song.iTrack) }));
+  ASSERT_EQ(1, m_ds->num_rows());
+  EXPECT_EQ(idSong, m_ds->fv("idSong").get_asInt64());
+  m_ds->close();
+
+  ASSERT_TRUE(m_ds->query_prepared("SELECT strTitle, strMusicBrainzTrackID, rating FROM song WHERE idSong = ?", { field_value(idSong) }));
+  ASSERT_EQ(1, m_ds->num_rows());
+  EXPECT_EQ(song.strTitle, m_ds->fv(0).get_asString());
+  EXPECT_TRUE(m_ds->fv(1).get_isNull());
+  EXPECT_EQ(7.5, m_ds->fv(2).get_asDouble());
+  m_ds->close();
+
+  // The statement is compiled once per connection
+  const unsigned int misses = m_db.get_statement_misses();
+  for (int i = 2; i < 10; i++)
+    m_ds->exec_prepared(INSERT_SONG, MakeParams(MakeSong(i)));
+  EXPECT_EQ(misses, m_db.get_statement_misses());
+  EXPECT_GE(m_db.get_statement_hits(), 8u);
+
+  // Parameters have to match the placeholders
+  EXPECT_THROW(m_ds->exec_prepared(INSERT_SONG, { field_value(1) }), DbErrors);
+  EXPECT_THROW(m_ds->exec_prepared("INSERT INTO nosuchtable VALUES (?)", { field_value(1) }), DbErrors);
+}
+
+TEST_F(TestSqliteDataset, FormatParams)
+{
+  field_value null;
+  null.set_isNull();
+
+  EXPECT_EQ("SELECT * FROM song WHERE strTitle = 'It''s' AND iTrack = 3 AND comment = '?' AND rating = 7.5 AND idPath IS NOT NULL AND strFileName = NULL",
+            m_ds->format_params("SELECT * FROM song WHERE strTitle = ? AND iTrack = ? AND comment = '?' AND rating = ? AND idPath IS NOT NULL AND strFileName = ?",
+                                { field_value("It's"), field_value(3), field_value(7.5), null }));
+  EXPECT_THROW(m_ds->format_params("SELECT ?, ?", { field_value(1) }), DbErrors);
+  EXPECT_THROW(m_ds->format_params("SELECT ?", { field_value(1), field_value(2) }), DbErrors);
+
+  // The generic implementation is what other backends use for exec_prepared()
+  ASSERT_EQ(SQLITE_OK, m_ds->exec(m_ds->format_params(INSERT_SONG, MakeParams(MakeSong(5)))));
+  ASSERT_TRUE(m_ds->query_prepared(SELECT_SONG, { field_value(1), field_value(MakeSong(5).strFileName), field_value(6) }));
+  EXPECT_EQ(1, m_ds->num_rows());
+  m_ds->close();
+}
+
+TEST_F(TestSqliteDataset, Batch)
+{
+  m_ds->exec("CREATE UNIQUE INDEX idxSongTitle ON song (strTitle)");
+
+  std::vector<sql_record> rows;
+  for (int i = 0; i < 100; i++)
+    rows.push_back(MakeParams(MakeSong(i)));
+  ASSERT_EQ(SQLITE_OK, m_ds->exec_batch(INSERT_SONG, rows));
+  EXPECT_FALSE(m_db.in_transaction());
+  EXPECT_EQ(100, m_ds->lastinsertid());
+
+  // A failing row rolls back the whole batch
+  rows.clear();
+  rows.push_back(MakeParams(MakeSong(1000)));
+  rows.push_back(MakeParams(MakeSong(0)));
+  EXPECT_THROW(m_ds->exec_batch(INSERT_SONG, rows), DbErrors);
+  EXPECT_FALSE(m_db.in_transaction());
+
+  ASSERT_TRUE(m_ds->query("SELECT COUNT(*) FROM song"));
+  EXPECT_EQ(100, m_ds->fv(0).get_asInt());
+  m_ds->close();
+}
+
+TEST_F(TestSqliteDataset, DISABLED_ImportBenchmark)
+{
+  // 100k songs on 10k albums, each album is added in its own transaction like
+  // CMusicDatabase::AddAlbum() does. Syncing is off so the statement overhead is measured, not the disk.
+  const int songCount = 100000;
+  const int songsPerAlbum = 10;
+  m_ds->exec("PRAGMA synchronous = OFF");
+
+  for (int method = 0; method < 3; method++)
+  {
+    m_ds->exec("DELETE FROM song");
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int album = 0; album < songCount / songsPerAlbum; album++)
+    {
+      m_db.start_transaction();
+      std::vector<sql_record> rows;
+      for (int i = album * songsPerAlbum; i < (album + 1) * songsPerAlbum; i++)
+      {
+        const Song song = MakeSong(i);
+        if (method == 0)
+        {
+          // Formatted SQL text, as the scanners did
+          m_ds->query(m_db.prepare("SELECT idSong FROM song WHERE idAlbum = %i AND strFileName = '%s' AND iTrack = %i",
+                                   song.idAlbum, song.strFileName.c_str(), song.iTrack));
+          ASSERT_EQ(0, m_ds->num_rows());
+          m_ds->close();
+          m_ds->exec(m_db.prepare("INSERT INTO song (idSong, idAlbum, idPath, strArtistDisp, strTitle, iTrack, iDuration, "
+                                  "iYear, strFileName, strMusicBrainzTrackID, rating, comment) "
+                                  "VALUES (NULL, %i, %i, '%s', '%s', %i, %i, %i, '%s', NULL, %.1f, '%s')",
+                                  song.idAlbum, song.idAlbum, song.strArtist.c_str(), song.strTitle.c_str(),
+                                  song.iTrack, 240, 2019, song.strFileName.c_str(), 7.5, ""));
+        }
+        else if (method == 1)
+        {
+          // Prepared statements
+          m_ds->query_prepared(SELECT_SONG, { field_value(song.idAlbum), field_value(song.strFileName), field_value(song.iTrack) });
+          ASSERT_EQ(0, m_ds->num_rows());
+          m_ds->close();
+          m_ds->exec_prepared(INSERT_SONG, MakeParams(song));
+        }
+        else
+          rows.push_back(MakeParams(song));
+      }
+      if (method == 2)
+        m_ds->exec_batch(INSERT_SONG, rows);
+      m_db.commit_transaction();
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    ASSERT_TRUE(m_ds->query("SELECT COUNT(*) FROM song"));
+    EXPECT_EQ(songCount, m_ds->fv(0).get_asInt());
+    m_ds->close();
+
+    const char* names[] = { "formatted select+insert", "prepared select+insert", "batched insert" };
+    printf("[ BENCHMARK] %s: %.2f s, %.0f songs/sec\n", names[method], elapsed.count(),
+           songCount / elapsed.count());
+  }
+}
@@ -6,6 +6,7 @@
  *  See LICENSES/README.md for more information.
  */
 
+#include "threads/SingleLock.h"
 #include "threads/SystemClock.h"
 #include "CacheStrategy.h"
 #include "IFile.h"
@@ -260,6 +261,313 @@ CCacheStrategy *CSimpleFileCache::CreateNew()
   return new CSimpleFileCache();
 }
 
+CSparseFileCache::CSparseFileCache()
+  : m_cacheFileRead(new CacheLocalFile())
+  , m_cacheFileWrite(new CacheLocalFile())
+{
+}
+
+CSparseFileCache::~CSparseFileCache()
+{
+  Close();
+  delete m_cacheFileRead;
+  delete m_cacheFileWrite;
+}
+
+int CSparseFileCache::Open()
+{
+  Close();
+
+  m_filename = CSpecialProtocol::TranslatePath(CUtil::GetNextFilename("special://temp/filecache%03d.cache", 999));
+  if (m_filename.empty())
+  {
+    CLog::Log(LOGERROR, "%s - Unable to generate a new filename", __FUNCTION__);
+    Close();
+    return CACHE_RC_ERROR;
+  }
+
+  CURL fileURL(m_filename);
+
+  if (!m_cacheFileWrite->OpenForWrite(fileURL, false))
+  {
+    CLog::LogF(LOGERROR, "failed to create file \"%s\" for writing", m_filename.c_str());
+    Close();
+    return CACHE_RC_ERROR;
+  }
+
+  if (!m_cacheFileRead->Open(fileURL))
+  {
+    CLog::LogF(LOGERROR, "failed to open file \"%s\" for reading", m_filename.c_str());
+    Close();
+    return CACHE_RC_ERROR;
+  }
+
+  return CACHE_RC_OK;
+}
+
+void CSparseFileCache::Close()
+{
+  m_cacheFileWrite->Close();
+  m_cacheFileRead->Close();
+
+  if (!m_filename.empty() && !m_cacheFileRead->Delete(CURL(m_filename)))
+    CLog::LogF(LOGWARNING, "failed to delete temporary file \"%s\"", m_filename.c_str());
+
+  m_filename.clear();
+
+  CSingleLock lock(m_sync);
+  m_ranges.clear();
+  m_nWritePosition = 0;
+  m_nWriteFilePosition = 0;
+  m_nReadPosition = 0;
+  m_nReadFilePosition = 0;
+}
+
+std::map<int64_t, int64_t>::iterator CSparseFileCache::FindRange(int64_t iFilePosition)
+{
+  auto it = m_ranges.upper_bound(iFilePosition);
+  if (it == m_ranges.begin())
+    return m_ranges.end();
+
+  --it;
+  if (iFilePosition <= it->second)
+    return it;
+  return m_ranges.end();
+}
+
+size_t CSparseFileCache::GetMaxWriteSize(const size_t& iRequestSize)
+{
+  return iRequestSize; // Can always write since it's on disk
+}
+
+int CSparseFileCache::WriteToCache(const char *pBuffer, size_t iSize)
+{
+  // the write position moves to the end of a cached range once it is reached
+  const int64_t iWritePosition = CachedDataEndPos();
+  if (m_nWriteFilePosition != iWritePosition)
+  {
+    m_nWriteFilePosition = m_cacheFileWrite->Seek(iWritePosition, SEEK_SET);
+    if (m_nWriteFilePosition != iWritePosition)
+    {
+      CLog::LogF(LOGERROR, "can't seek file");
+      return CACHE_RC_ERROR;
+    }
+  }
+
+  size_t written = 0;
+  while (iSize > 0)
+  {
+    const ssize_t lastWritten = m_cacheFileWrite->Write(pBuffer + written, (iSize > SSIZE_MAX) ? SSIZE_MAX : iSize);
+    if (lastWritten <= 0)
+    {
+      CLog::LogF(LOGERROR, "failed to write to file");
+      return CACHE_RC_ERROR;
+    }
+    m_nWriteFilePosition += lastWritten;
+    iSize -= lastWritten;
+    written += lastWritten;
+  }
+
+  {
+    CSingleLock lock(m_sync);
+
+    // add the written data to the range we are extending and merge it with all
+    // ranges it overlaps or touches
+    int64_t start = iWritePosition;
+    int64_t end = iWritePosition + written;
+    auto it = FindRange(start);
+    if (it != m_ranges.end())
+      start = it->first;
+
+    it = m_ranges.lower_bound(start);
+    while (it != m_ranges.end() && it->first <= end)
+    {
+      end = std::max(end, it->second);
+      it = m_ranges.erase(it);
+    }
+    m_ranges[start] = end;
+    m_nWritePosition = end;
+  }
+
+  // when reader waits for data it will wait on the event.
+  m_hDataAvailEvent.Set();
+
+  return written;
+}
+
+int64_t CSparseFileCache::GetAvailableRead()
+{
+  CSingleLock lock(m_sync);
+  return m_nWritePosition - m_nReadPosition;
+}
+
+int CSparseFileCache::ReadFromCache(char *pBuffer, size_t iMaxSize)
+{
+  int64_t iAvailable = GetAvailableRead();
+  if ( iAvailable <= 0 )
+    return m_bEndOfInput? 0 : CACHE_RC_WOULD_BLOCK;
+
+  size_t toRead = ((int64_t)iMaxSize > iAvailable) ? (size_t)iAvailable : iMaxSize;
+
+  int64_t iReadPosition;
+  {
+    CSingleLock lock(m_sync);
+    iReadPosition = m_nReadPosition;
+  }
+  if (m_nReadFilePosition != iReadPosition)
+  {
+    m_nReadFilePosition = m_cacheFileRead->Seek(iReadPosition, SEEK_SET);
+    if (m_nReadFilePosition != iReadPosition)
+    {
+      CLog::LogF(LOGERROR, "can't seek file");
+      return CACHE_RC_ERROR;
+    }
+  }
+
+  size_t readBytes = 0;
+  while (toRead > 0)
+  {
+    const ssize_t lastRead = m_cacheFileRead->Read(pBuffer + readBytes, (toRead > SSIZE_MAX) ? SSIZE_MAX : toRead);
+    if (lastRead == 0)
+      break;
+    if (lastRead < 0)
+    {
+      CLog::LogF(LOGERROR, "failed to read from file");
+      return CACHE_RC_ERROR;
+    }
+    m_nReadFilePosition += lastRead;
+    toRead -= lastRead;
+    readBytes += lastRead;
+  }
+
+  if (readBytes > 0)
+  {
+    {
+      CSingleLock lock(m_sync);
+      m_nReadPosition += readBytes;
+    }
+    m_space.Set();
+  }
+
+  return readBytes;
+}
+
+int64_t CSparseFileCache::WaitForData(unsigned int iMinAvail, unsigned int iMillis)
+{
+  if( iMillis == 0 || IsEndOfInput() )
+    return GetAvailableRead();
+
+  XbmcThreads::EndTime endTime(iMillis);
+  while (!IsEndOfInput())
+  {
+    int64_t iAvail = GetAvailableRead();
+    if (iAvail >= iMinAvail)
+      return iAvail;
+
+    if (!m_hDataAvailEvent.WaitMSec(endTime.MillisLeft()))
+      return CACHE_RC_TIMEOUT;
+  }
+  return GetAvailableRead();
+}
+
+int64_t CSparseFileCache::Seek(int64_t iFilePosition)
+{
+  int64_t nDiff;
+  int64_t nWait;
+  {
+    CSingleLock lock(m_sync);
+
+    // only the range being written is read from, any other cached range is picked up
+    // by a reset, so the source continues after it
+    auto it = FindRange(m_nWritePosition);
+    const int64_t iStartPosition = (it != m_ranges.end()) ? it->first : m_nWritePosition;
+    if (iFilePosition < iStartPosition)
+    {
+      CLog::Log(LOGDEBUG,"CSparseFileCache::Seek, request seek before start of cached range.");
+      return CACHE_RC_ERROR;
+    }
+
+    nDiff = iFilePosition - m_nWritePosition;
+    nWait = iFilePosition - m_nReadPosition;
+  }
+
+  if (nDiff > 500000 || (nDiff > 0 && WaitForData((unsigned int)nWait, 5000) == CACHE_RC_TIMEOUT))
+  {
+    CLog::Log(LOGDEBUG,"CSparseFileCache::Seek - Attempt to seek past read data");
+    return CACHE_RC_ERROR;
+  }
+
+  {
+    CSingleLock lock(m_sync);
+    m_nReadPosition = iFilePosition;
+  }
+
+  m_space.Set();
+
+  return iFilePosition;
+}
+
+bool CSparseFileCache::Reset(int64_t iSourcePosition, bool clearAnyway)
+{
+  CSingleLock lock(m_sync);
+
+  if (clearAnyway)
+    m_ranges.clear();
+
+  m_nReadPosition = iSourcePosition;
+
+  auto it = FindRange(iSourcePosition);
+  if (it != m_ranges.end())
+  {
+    m_nWritePosition = it->second;
+    return false;
+  }
+
+  m_nWritePosition = iSourcePosition;
+  return true;
+}
+
+void CSparseFileCache::EndOfInput()
+{
+  CCacheStrategy::EndOfInput();
+  m_hDataAvailEvent.Set();
+}
+
+int64_t CSparseFileCache::CachedDataEndPosIfSeekTo(int64_t iFilePosition)
+{
+  CSingleLock lock(m_sync);
+  auto it = FindRange(iFilePosition);
+  if (it != m_ranges.end())
+    return it->second;
+  return iFilePosition;
+}
+
+int64_t CSparseFileCache::CachedDataEndPos()
+{
+  CSingleLock lock(m_sync);
+  return m_nWritePosition;
+}
+
+bool CSparseFileCache::IsCachedPosition(int64_t iFilePosition)
+{
+  CSingleLock lock(m_sync);
+  return FindRange(iFilePosition) != m_ranges.end();
+}
+
+int64_t CSparseFileCache::GetCachedBytes()
+{
+  CSingleLock lock(m_sync);
+  int64_t bytes = 0;
+  for (const auto& range : m_ranges)
+    bytes += range.second - range.first;
+  return bytes;
+}
+
+CCacheStrategy *CSparseFileCache::CreateNew()
+{
+  return new CSparseFileCache();
+}
+
 
 CDoubleCache::CDoubleCache(CCacheStrategy *impl)
 {
@@ -8,8 +8,10 @@
 
 #pragma once
 
+#include <map>
 #include <stdint.h>
 #include <string>
+#include "threads/CriticalSection.h"
 #include "threads/Event.h"
 
 namespace XFILE {
@@ -96,6 +98,66 @@ protected:
   volatile int64_t m_nReadPosition = 0;
 };
 
+/*!
+ \brief Disk cache that keeps every range fetched from the source
+
+ Unlike CSimpleFileCache, which only holds the data written since the last reset, data is
+ stored at its original offset in a sparse temporary file and a map of the cached ranges is
+ kept. Seeking back to a range fetched earlier, e.g. when skipping chapters back and forth
+ or probing subtitles, is served from disk without reading the source again.
+
+ When the data written reaches a range that is already cached, the write position moves on
+ to the end of that range, see CachedDataEndPos(). The source has to be seekable.
+ */
+class CSparseFileCache : public CCacheStrategy {
+public:
+  CSparseFileCache();
+  ~CSparseFileCache() override;
+
+  int Open() override;
+  void Close() override;
+
+  size_t GetMaxWriteSize(const size_t& iRequestSize) override;
+  int WriteToCache(const char *pBuffer, size_t iSize) override;
+  int ReadFromCache(char *pBuffer, size_t iMaxSize) override;
+  int64_t WaitForData(unsigned int iMinAvail, unsigned int iMillis) override;
+
+  int64_t Seek(int64_t iFilePosition) override;
+  bool Reset(int64_t iSourcePosition, bool clearAnyway=true) override;
+  void EndOfInput() override;
+
+  int64_t CachedDataEndPosIfSeekTo(int64_t iFilePosition) override;
+  int64_t CachedDataEndPos() override;
+  bool IsCachedPosition(int64_t iFilePosition) override;
+
+  CCacheStrategy *CreateNew() override;
+
+  int64_t GetAvailableRead();
+
+  /*!
+   \brief Get the total number of bytes held by the cache
+   */
+  int64_t GetCachedBytes();
+
+protected:
+  /*!
+   \brief Get the cached range containing a position, a range end counts as part of the range
+   \return iterator to the range, or m_ranges.end() if the position isn't cached
+   */
+  std::map<int64_t, int64_t>::iterator FindRange(int64_t iFilePosition);
+
+  std::string m_filename;
+  IFile*   m_cacheFileRead;
+  IFile*   m_cacheFileWrite;
+  CEvent   m_hDataAvailEvent;
+  std::map<int64_t, int64_t> m_ranges; // start -> end of the cached ranges, never adjacent
+  int64_t  m_nWritePosition = 0;
+  int64_t  m_nWriteFilePosition = 0;
+  int64_t  m_nReadPosition = 0;
+  int64_t  m_nReadFilePosition = 0;
+  CCriticalSection m_sync;
+};
+
 class CDoubleCache : public CCacheStrategy{
 public:
   explicit CDoubleCache(CCacheStrategy *impl);
@@ -390,6 +390,264 @@ void CCurlFile::CReadState::Disconnect()
   m_curlAliasList = NULL;
 }
 
+const unsigned int CCurlFile::CPrefetchState::SEGMENT_SIZE;
+
+CCurlFile::CPrefetchState::CPrefetchState(CCurlFile& file, int64_t fileSize, unsigned int maxConnections)
+  : m_file(file)
+  , m_fileSize(fileSize)
+  , m_maxConnections(maxConnections)
+  , m_connections(std::min(2u, maxConnections))
+{
+}
+
+CCurlFile::CPrefetchState::~CPrefetchState()
+{
+  Clear();
+}
+
+void CCurlFile::CPrefetchState::Clear()
+{
+  for (auto& segment : m_segments)
+    delete segment.state;
+  m_segments.clear();
+}
+
+void CCurlFile::CPrefetchState::Start(int64_t pos)
+{
+  Clear();
+  m_filePos = pos;
+  m_nextStart = pos;
+  m_measureStart = XbmcThreads::SystemClockMillis();
+  m_measureSegments = 0;
+  m_measureBytes = 0;
+}
+
+bool CCurlFile::CPrefetchState::Seek(int64_t pos)
+{
+  if (pos == m_filePos)
+    return true;
+  if (m_segments.empty() || pos < m_filePos || pos >= m_segments.front().end)
+    return false;
+
+  // the segment buffers can only be skipped forward
+  Segment& head = m_segments.front();
+  if (!FITS_INT(pos - m_filePos) || !head.state->m_buffer.SkipBytes((int)(pos - m_filePos)))
+    return false;
+
+  m_filePos = pos;
+  return true;
+}
+
+bool CCurlFile::CPrefetchState::StartSegment()
+{
+  if (m_nextStart >= m_fileSize)
+    return false;
+
+  Segment segment;
+  segment.state = new CReadState();
+  segment.start = m_nextStart;
+  segment.end = std::min<int64_t>(m_nextStart + SEGMENT_SIZE, m_fileSize);
+  segment.checked = false;
+  segment.done = false;
+  segment.failed = false;
+
+  CReadState* state = segment.state;
+  CURL url(m_file.m_url);
+  g_curlInterface.easy_acquire(url.GetProtocol().c_str(),
+                              url.GetHostName().c_str(),
+                              &state->m_easyHandle,
+                              &state->m_multiHandle);
+
+  m_file.SetCommonOptions(state);
+  m_file.SetRequestHeaders(state);
+
+  std::string range = StringUtils::Format("%" PRId64 "-%" PRId64, segment.start, segment.end - 1);
+  g_curlInterface.easy_setopt(state->m_easyHandle, CURLOPT_RANGE, range.c_str());
+
+  state->m_filePos = segment.start;
+  state->m_fileSize = segment.end;
+  state->m_bufferSize = segment.end - segment.start;
+  state->m_buffer.Create(state->m_bufferSize);
+  state->m_stillRunning = 1;
+  g_curlInterface.multi_add_handle(state->m_multiHandle, state->m_easyHandle);
+
+  m_segments.push_back(segment);
+  m_nextStart = segment.end;
+  return true;
+}
+
+void CCurlFile::CPrefetchState::FillWindow()
+{
+  while (m_segments.size() < m_connections && StartSegment())
+    ;
+}
+
+void CCurlFile::CPrefetchState::SegmentDone(int64_t size)
+{
+  m_measureBytes += size;
+  if (++m_measureSegments < m_connections)
+    return;
+
+  // compare the throughput of the last window with the one before: keep changing the number
+  // of connections in the same direction while it helps, turn around when it got slower
+  unsigned int now = XbmcThreads::SystemClockMillis();
+  double rate = m_measureBytes * 1000.0 / std::max(1u, now - m_measureStart);
+  unsigned int connections = m_connections;
+  if (rate < m_lastRate * 0.9)
+    m_direction = -m_direction;
+  if (rate < m_lastRate * 0.9 || rate > m_lastRate * 1.1)
+  {
+    if (m_direction > 0)
+      connections = std::min(m_maxConnections, m_connections + 1);
+    else
+      connections = std::max(1u, m_connections - 1);
+  }
+
+  if (connections != m_connections)
+  {
+    CLog::Log(LOGDEBUG, "CCurlFile::CPrefetchState - %.0f kB/s with %u connections, using %u now",
+              rate / 1024, m_connections, connections);
+    m_connections = connections;
+  }
+
+  m_lastRate = rate;
+  m_measureStart = now;
+  m_measureSegments = 0;
+  m_measureBytes = 0;
+}
+
+void CCurlFile::CPrefetchState::Perform(unsigned int timeout)
+{
+  fd_set fdread;
+  fd_set fdwrite;
+  fd_set fdexcep;
+  FD_ZERO(&fdread);
+  FD_ZERO(&fdwrite);
+  FD_ZERO(&fdexcep);
+  int maxfd = -1;
+  bool running = false;
+
+  for (auto& segment : m_segments)
+  {
+    if (segment.done)
+      continue;
+
+    CReadState* state = segment.state;
+    CURLMcode result;
+    while ((result = g_curlInterface.multi_perform(state->m_multiHandle, &state->m_stillRunning)) == CURLM_CALL_MULTI_PERFORM)
+      ;
+
+    if (result != CURLM_OK)
+    {
+      CLog::Log(LOGERROR, "CCurlFile::CPrefetchState - Multi perform failed with code %d", result);
+      segment.done = segment.failed = true;
+      continue;
+    }
+
+    // a server ignoring the range would send the whole file for every segment
+    if (!segment.checked)
+    {
+      long response = 0;
+      if (g_curlInterface.easy_getinfo(state->m_easyHandle, CURLINFO_RESPONSE_CODE, &response) == CURLE_OK && response > 0)
+      {
+        segment.checked = true;
+        if (response != 206)
+        {
+          CLog::Log(LOGWARNING, "CCurlFile::CPrefetchState - Range request answered with %ld", response);
+          segment.done = segment.failed = true;
+          continue;
+        }
+      }
+    }
+
+    if (!state->m_stillRunning)
+    {
+      segment.done = true;
+      int msgs;
+      CURLMsg* msg;
+      while ((msg = g_curlInterface.multi_info_read(state->m_multiHandle, &msgs)))
+      {
+        if (msg->msg == CURLMSG_DONE && msg->data.result != CURLE_OK)
+        {
+          CLog::Log(LOGERROR, "CCurlFile::CPrefetchState - Failed: %s(%d)", g_curlInterface.easy_strerror(msg->data.result), msg->data.result);
+          segment.failed = true;
+        }
+      }
+      // only the head segment may have been read from already
+      int64_t received = std::max<int64_t>(0, m_filePos - segment.start) +
+                         state->m_buffer.getMaxReadSize() + state->m_overflowSize;
+      if (!segment.checked || received < segment.end - segment.start)
+        segment.failed = true;
+      if (!segment.failed)
+        SegmentDone(segment.end - segment.start);
+      continue;
+    }
+
+    int fd = -1;
+    g_curlInterface.multi_fdset(state->m_multiHandle, &fdread, &fdwrite, &fdexcep, &fd);
+    maxfd = std::max(maxfd, fd);
+    running = true;
+  }
+
+  if (!running)
+    return;
+
+  long wait = maxfd == -1 ? 100 : timeout;
+#ifdef TARGET_WINDOWS
+  if (maxfd == -1)
+  {
+    Sleep(wait);
+    return;
+  }
+#endif
+  // errors show up in the next multi_perform, interrupted waits just loop
+  struct timeval tv = { (int)wait / 1000, ((int)wait % 1000) * 1000 };
+  select(maxfd + 1, &fdread, &fdwrite, &fdexcep, &tv);
+}
+
+ssize_t CCurlFile::CPrefetchState::Read(void* lpBuf, size_t uiBufSize)
+{
+  while (m_filePos < m_fileSize)
+  {
+    if (m_file.m_state->m_cancelled)
+      return 0;
+
+    FillWindow();
+    if (m_segments.empty())
+      return -1;
+
+    Segment& head = m_segments.front();
+    if (head.failed)
+      return -1;
+
+    CReadState* state = head.state;
+    unsigned int want = std::min<unsigned int>(state->m_buffer.getMaxReadSize(), uiBufSize);
+    if (want > 0 && state->m_buffer.ReadData((char *)lpBuf, want))
+    {
+      m_filePos += want;
+      if (m_filePos >= head.end)
+      {
+        delete state;
+        m_segments.pop_front();
+      }
+      return want;
+    }
+
+    if (head.done)
+      return -1;
+
+    if (state->m_overflowSize)
+    {
+      // only happens if the server sent more than requested, the buffer holds the whole segment
+      CLog::Log(LOGERROR, "CCurlFile::CPrefetchState - Segment exceeds its range");
+      return -1;
+    }
+
+    Perform(200);
+  }
+  return 0;
+}
+
 
 CCurlFile::~CCurlFile()
 {
@@ -439,6 +697,10 @@ void CCurlFile::Close()
   if (m_opened && m_forWrite && !m_inError)
       Write(NULL, 0);
 
+  delete m_prefetch;
+  m_prefetch = nullptr;
+  m_prefetchConnections = 0;
+
   m_state->Disconnect();
   delete m_oldState;
   m_oldState = NULL;
@@ -521,8 +783,8 @@ void CCurlFile::SetCommonOptions(CReadState* state, bool failOnError /* = true *
   if (!m_verifyPeer)
     g_curlInterface.easy_setopt(h, CURLOPT_SSL_VERIFYPEER, 0);
 
-  g_curlInterface.easy_setopt(m_state->m_easyHandle, CURLOPT_URL, m_url.c_str());
-  g_curlInterface.easy_setopt(m_state->m_easyHandle, CURLOPT_TRANSFERTEXT, CURL_OFF);
+  g_curlInterface.easy_setopt(h, CURLOPT_URL, m_url.c_str());
+  g_curlInterface.easy_setopt(h, CURLOPT_TRANSFERTEXT, CURL_OFF);
 
   // setup POST data if it is set (and it may be empty)
   if (m_postdataset)
@@ -1312,6 +1574,14 @@ int64_t CCurlFile::Seek(int64_t iFilePosition, int iWhence)
   // We can't seek beyond EOF
   if (m_state->m_fileSize && nextPos > m_state->m_fileSize) return -1;
 
+  if (m_prefetch)
+  {
+    if (!m_prefetch->Seek(nextPos))
+      m_prefetch->Start(nextPos);
+    m_state->m_filePos = nextPos;
+    return nextPos;
+  }
+
   if(m_state->Seek(nextPos))
     return nextPos;
 
@@ -1381,6 +1651,71 @@ int64_t CCurlFile::Seek(int64_t iFilePosition, int iWhence)
   return m_state->m_filePos;
 }
 
+void CCurlFile::StartPrefetch()
+{
+  if (m_prefetch || m_prefetchConnections < 2 || !m_opened || m_forWrite ||
+      !m_seekable || !m_multisession || m_state->m_fileSize <= 0)
+    return;
+
+  // the segments take over reading, the single connection is only needed again as fallback
+  int64_t pos = m_state->m_filePos;
+  int64_t size = m_state->m_fileSize;
+  m_state->Disconnect();
+  m_state->m_filePos = pos;
+  m_state->m_fileSize = size;
+  delete m_oldState;
+  m_oldState = NULL;
+
+  CLog::Log(LOGDEBUG, "CCurlFile::StartPrefetch - Reading ahead with up to %u connections", m_prefetchConnections);
+  m_prefetch = new CPrefetchState(*this, size, m_prefetchConnections);
+  m_prefetch->Start(pos);
+}
+
+bool CCurlFile::StopPrefetch()
+{
+  if (!m_prefetch)
+    return true;
+
+  delete m_prefetch;
+  m_prefetch = nullptr;
+  m_prefetchConnections = 0;
+
+  SetCommonOptions(m_state);
+  SetRequestHeaders(m_state);
+  m_state->m_sendRange = true;
+
+  int64_t size = m_state->m_fileSize;
+  long response = m_state->Connect(m_bufferSize);
+  if (response < 0 && size != m_state->m_filePos)
+    return false;
+
+  m_state->m_fileSize = size;
+  return true;
+}
+
+ssize_t CCurlFile::Read(void* lpBuf, size_t uiBufSize)
+{
+  if (m_prefetch)
+  {
+    ssize_t read = m_prefetch->Read(lpBuf, uiBufSize);
+    m_state->m_filePos = m_prefetch->GetPosition();
+    if (read >= 0)
+      return read;
+
+    CLog::Log(LOGWARNING, "CCurlFile::Read - Prefetch failed at %" PRId64 ", continuing with a single connection", m_state->m_filePos);
+    if (!StopPrefetch())
+      return -1;
+  }
+  return m_state->Read(lpBuf, uiBufSize);
+}
+
+bool CCurlFile::ReadString(char *szLine, int iLineLength)
+{
+  if (m_prefetch && !StopPrefetch())
+    return false;
+  return m_state->ReadString(szLine, iLineLength);
+}
+
 int64_t CCurlFile::GetLength()
 {
   if (!m_opened) return 0;
@@ -1964,6 +2299,16 @@ int CCurlFile::IoControl(EIoControl request, void* param)
     return 0;
   }
 
+  if (request == IOCTRL_SET_PREFETCH)
+  {
+    m_prefetchConnections = *(unsigned int*) param;
+    if (m_prefetchConnections < 2)
+      return StopPrefetch() ? 0 : -1;
+
+    StartPrefetch();
+    return m_prefetch ? 0 : -1;
+  }
+
   return -1;
 }
 
@@ -2009,6 +2354,9 @@ const std::vector<std::string> CCurlFile::GetPropertyValues(XFILE::FileProperty
 
 double CCurlFile::GetDownloadSpeed()
 {
+  if (m_prefetch)
+    return m_prefetch->GetDownloadSpeed();
+
 #if LIBCURL_VERSION_NUM >= 0x073a00 // 0.7.58.0
   double speed = 0.0;
   if (g_curlInterface.easy_getinfo(m_state->m_easyHandle, CURLINFO_SPEED_DOWNLOAD, &speed) == CURLE_OK)
@@ -10,6 +10,7 @@
 
 #include "IFile.h"
 #include "utils/RingBuffer.h"
+#include <deque>
 #include <map>
 #include <string>
 #include "utils/HttpHeader.h"
@@ -44,8 +45,8 @@ namespace XFILE
       int64_t GetLength() override;
       int Stat(const CURL& url, struct __stat64* buffer) override;
       void Close() override;
-      bool ReadString(char *szLine, int iLineLength) override { return m_state->ReadString(szLine, iLineLength); }
-      ssize_t Read(void* lpBuf, size_t uiBufSize) override { return m_state->Read(lpBuf, uiBufSize); }
+      bool ReadString(char *szLine, int iLineLength) override;
+      ssize_t Read(void* lpBuf, size_t uiBufSize) override;
       ssize_t Write(const void* lpBuf, size_t uiBufSize) override;
       const std::string GetProperty(XFILE::FileProperty type, const std::string &name = "") const override;
       const std::vector<std::string> GetPropertyValues(XFILE::FileProperty type, const std::string &name = "") const override;
@@ -136,6 +137,76 @@ namespace XFILE
           void Disconnect();
       };
 
+      /*!
+       \brief Reads ahead of the read position with several ranged requests in parallel
+
+       The file is split into segments that are each fetched with their own connection, so
+       the throughput isn't limited by a single TCP window on high latency links. Segments are
+       handed out in file order, the reader sees a plain sequential stream. The number of
+       connections adapts to the measured throughput, up to the configured maximum.
+       */
+      class CPrefetchState
+      {
+      public:
+          CPrefetchState(CCurlFile& file, int64_t fileSize, unsigned int maxConnections);
+          ~CPrefetchState();
+
+          /*!
+           \brief Drop all segments and start fetching at the given position
+           */
+          void Start(int64_t pos);
+
+          /*!
+           \brief Seek within the data already fetched
+           \return false if the position isn't buffered, use Start() then
+           */
+          bool Seek(int64_t pos);
+
+          /*!
+           \return number of bytes read, 0 on end of file or when cancelled, -1 if the
+                   ranged requests failed
+           */
+          ssize_t Read(void* lpBuf, size_t uiBufSize);
+
+          int64_t GetPosition() const { return m_filePos; }
+          unsigned int GetConnections() const { return m_connections; }
+          double GetDownloadSpeed() const { return m_lastRate; }
+
+          static const unsigned int SEGMENT_SIZE = 1024 * 1024;
+
+      private:
+          struct Segment
+          {
+            CReadState* state;
+            int64_t start;
+            int64_t end;
+            bool checked;
+            bool done;
+            bool failed;
+          };
+
+          void Clear();
+          bool StartSegment();
+          void FillWindow();
+          void Perform(unsigned int timeout);
+          void SegmentDone(int64_t size);
+
+          CCurlFile& m_file;
+          std::deque<Segment> m_segments;
+          int64_t m_fileSize;
+          int64_t m_filePos = 0;
+          int64_t m_nextStart = 0;
+          unsigned int m_maxConnections;
+          unsigned int m_connections;
+
+          // throughput measurement for adapting the number of connections
+          unsigned int m_measureStart = 0;
+          unsigned int m_measureSegments = 0;
+          int64_t m_measureBytes = 0;
+          double m_lastRate = 0.0; // bytes per second
+          int m_direction = 1;
+      };
+
     protected:
       void ParseAndCorrectUrl(CURL &url);
       void SetCommonOptions(CReadState* state, bool failOnError = true);
@@ -143,10 +214,14 @@ namespace XFILE
       void SetCorrectHeaders(CReadState* state);
       bool Service(const std::string& strURL, std::string& strHTML);
       std::string GetInfoString(int infoType);
+      void StartPrefetch();
+      bool StopPrefetch();
 
     protected:
       CReadState* m_state;
       CReadState* m_oldState;
+      CPrefetchState* m_prefetch = nullptr;
+      unsigned int m_prefetchConnections = 0;
       unsigned int m_bufferSize;
       int64_t m_writeOffset = 0;
 
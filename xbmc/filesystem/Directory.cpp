@@ -164,7 +164,24 @@ bool CDirectory::GetDirectory(const CURL& url, std::shared_ptr<IDirectory> pDire
       return false;
 
     // check our cache for this path
-    if (g_directoryCache.GetDirectory(realURL.Get(), items, (hints.flags & DIR_FLAG_READ_CACHE) == DIR_FLAG_READ_CACHE))
+    bool cached = g_directoryCache.GetDirectory(realURL.Get(), items, (hints.flags & DIR_FLAG_READ_CACHE) == DIR_FLAG_READ_CACHE);
+
+    // a listing of a remote source stored by an earlier session is still good if the
+    // directory didn't change since. Getting the validator costs a round trip to
+    // the source, so only do it for directories that are cached at all
+    const DIR_CACHE_TYPE cacheType = pDirectory->GetCacheType(url);
+    std::string validator;
+    if (!cached && cacheType != DIR_CACHE_NEVER && !(hints.flags & DIR_FLAG_BYPASS_CACHE) &&
+        g_directoryCache.CanPersist(realURL))
+    {
+      CURL statURL = realURL;
+      if (CPasswordManager::GetInstance().IsURLSupported(statURL) && statURL.GetUserName().empty())
+        CPasswordManager::GetInstance().AuthenticateURL(statURL);
+      validator = CDirectoryCache::GetValidator(statURL);
+      cached = g_directoryCache.LoadDirectory(realURL.Get(), validator, items, cacheType);
+    }
+
+    if (cached)
       items.SetURL(url);
     else
     {
@@ -247,7 +264,7 @@ bool CDirectory::GetDirectory(const CURL& url, std::shared_ptr<IDirectory> pDire
 
       // cache the directory, if necessary
       if (!(hints.flags & DIR_FLAG_BYPASS_CACHE))
-        g_directoryCache.SetDirectory(realURL.Get(), items, pDirectory->GetCacheType(url));
+        g_directoryCache.SetDirectory(realURL.Get(), items, cacheType, validator);
     }
 
     // now filter for allowed files
@@ -8,8 +8,12 @@
 
 #include "Directory.h"
 #include "DirectoryCache.h"
+#include "CurlFile.h"
+#include "File.h"
 #include "FileItem.h"
+#include "PersistentDirectoryCache.h"
 #include "threads/SingleLock.h"
+#include "utils/HttpHeader.h"
 #include "utils/log.h"
 #include "utils/URIUtils.h"
 #include "utils/StringUtils.h"
@@ -17,15 +21,16 @@
 #include "climits"
 
 #include <algorithm>
-
-// Maximum number of directories to keep in our cache
-#define MAX_CACHED_DIRS 50
+#include <inttypes.h>
 
 using namespace XFILE;
 
+const size_t CDirectoryCache::DEFAULT_MAX_MEMORY_SIZE;
+
 CDirectoryCache::CDir::CDir(DIR_CACHE_TYPE cacheType)
 {
   m_cacheType = cacheType;
+  m_memorySize = 0;
   m_lastAccess = 0;
   m_Items = new CFileItemList;
   m_Items->SetIgnoreURLOptions(true);
@@ -45,13 +50,14 @@ void CDirectoryCache::CDir::SetLastAccess(unsigned int &accessCounter)
 CDirectoryCache::CDirectoryCache(void)
 {
   m_accessCounter = 0;
-#ifdef _DEBUG
-  m_cacheHits = 0;
-  m_cacheMisses = 0;
-#endif
+  m_cachedBytes = 0;
+  m_maxCachedBytes = DEFAULT_MAX_MEMORY_SIZE;
 }
 
-CDirectoryCache::~CDirectoryCache(void) = default;
+CDirectoryCache::~CDirectoryCache(void)
+{
+  Clear();
+}
 
 bool CDirectoryCache::GetDirectory(const std::string& strPath, CFileItemList &items, bool retrieveAll)
 {
@@ -70,16 +76,15 @@ bool CDirectoryCache::GetDirectory(const std::string& strPath, CFileItemList &it
     {
       items.Copy(*dir->m_Items);
       dir->SetLastAccess(m_accessCounter);
-#ifdef _DEBUG
-      m_cacheHits+=items.Size();
-#endif
+      m_stats.hits++;
       return true;
     }
   }
+  m_stats.misses++;
   return false;
 }
 
-void CDirectoryCache::SetDirectory(const std::string& strPath, const CFileItemList &items, DIR_CACHE_TYPE cacheType)
+void CDirectoryCache::SetDirectory(const std::string& strPath, const CFileItemList &items, DIR_CACHE_TYPE cacheType, const std::string& validator)
 {
   if (cacheType == DIR_CACHE_NEVER)
     return; // nothing to do
@@ -103,12 +108,66 @@ void CDirectoryCache::SetDirectory(const std::string& strPath, const CFileItemLi
 
   ClearDirectory(storedPath);
 
-  CheckIfFull();
-
   CDir* dir = new CDir(cacheType);
   dir->m_Items->Copy(items);
+  dir->m_memorySize = GetMemorySize(*dir->m_Items);
+
+  CheckIfFull(dir->m_memorySize);
+
   dir->SetLastAccess(m_accessCounter);
   m_cache.insert(std::pair<std::string, CDir*>(storedPath, dir));
+  m_cachedBytes += dir->m_memorySize;
+
+  std::shared_ptr<CPersistentDirectoryCache> persistent = m_persistent;
+  if (validator.empty() || !persistent)
+    return;
+
+  // the items are shared with the caller, who waits for us to return
+  CFileItemList store;
+  store.Copy(items, false);
+  lock.Leave();
+
+  if (persistent->Save(storedPath, validator, store))
+  {
+    CSingleLock statsLock(m_cs);
+    m_stats.persistentWrites++;
+  }
+}
+
+bool CDirectoryCache::LoadDirectory(const std::string& strPath, const std::string& validator, CFileItemList &items, DIR_CACHE_TYPE cacheType)
+{
+  if (cacheType == DIR_CACHE_NEVER || validator.empty())
+    return false;
+
+  std::shared_ptr<CPersistentDirectoryCache> persistent;
+  {
+    CSingleLock lock(m_cs);
+    persistent = m_persistent;
+  }
+  if (!persistent)
+    return false;
+
+  std::string storedPath = CURL(strPath).GetWithoutOptions();
+  URIUtils::RemoveSlashAtEnd(storedPath);
+
+  CFileItemList stored;
+  CPersistentDirectoryCache::LoadResult result = persistent->Load(storedPath, validator, stored);
+
+  {
+    CSingleLock lock(m_cs);
+    if (result == CPersistentDirectoryCache::LOAD_OK)
+      m_stats.persistentHits++;
+    else if (result == CPersistentDirectoryCache::LOAD_STALE)
+      m_stats.persistentStale++;
+    else
+      m_stats.persistentMisses++;
+  }
+  if (result != CPersistentDirectoryCache::LOAD_OK)
+    return false;
+
+  SetDirectory(storedPath, stored, cacheType);
+  items.Copy(stored);
+  return true;
 }
 
 void CDirectoryCache::ClearFile(const std::string& strFile)
@@ -117,6 +176,19 @@ void CDirectoryCache::ClearFile(const std::string& strFile)
   std::string strFile2 = CURL(strFile).GetWithoutOptions();
 
   ClearDirectory(URIUtils::GetDirectory(strFile2));
+
+  // a file was changed through us, don't wait for the validator to notice
+  std::shared_ptr<CPersistentDirectoryCache> persistent;
+  {
+    CSingleLock lock(m_cs);
+    persistent = m_persistent;
+  }
+  if (persistent)
+  {
+    std::string storedPath = URIUtils::GetDirectory(strFile2);
+    URIUtils::RemoveSlashAtEnd(storedPath);
+    persistent->Remove(storedPath);
+  }
 }
 
 void CDirectoryCache::ClearDirectory(const std::string& strPath)
@@ -164,6 +236,8 @@ void CDirectoryCache::AddFile(const std::string& strFile)
     CFileItemPtr item(new CFileItem(strFile, false));
     dir->m_Items->Add(item);
     dir->SetLastAccess(m_accessCounter);
+    dir->m_memorySize += GetMemorySize(*item);
+    m_cachedBytes += GetMemorySize(*item);
   }
 }
 
@@ -184,14 +258,8 @@ bool CDirectoryCache::FileExists(const std::string& strFile, bool& bInCache)
     bInCache = true;
     CDir *dir = i->second;
     dir->SetLastAccess(m_accessCounter);
-#ifdef _DEBUG
-    m_cacheHits++;
-#endif
     return (URIUtils::PathEquals(strPath, storedPath) || dir->m_Items->Contains(strFile));
   }
-#ifdef _DEBUG
-  m_cacheMisses++;
-#endif
   return false;
 }
 
@@ -229,39 +297,134 @@ void CDirectoryCache::ClearCache(std::set<std::string>& dirs)
   }
 }
 
-void CDirectoryCache::CheckIfFull()
+void CDirectoryCache::CheckIfFull(size_t size)
 {
   CSingleLock lock (m_cs);
 
-  // find the last accessed folder, and remove if the number of cached folders is too many
-  iCache lastAccessed = m_cache.end();
-  unsigned int numCached = 0;
-  for (iCache i = m_cache.begin(); i != m_cache.end(); i++)
+  // remove the last accessed folders until the new one fits. The new one is added
+  // in any case, so a single huge folder can exceed the limit.
+  while (m_cachedBytes + size > m_maxCachedBytes)
   {
-    // ensure dirs that are always cached aren't cleared
-    if (i->second->m_cacheType != DIR_CACHE_ALWAYS)
+    iCache lastAccessed = m_cache.end();
+    for (iCache i = m_cache.begin(); i != m_cache.end(); i++)
     {
-      if (lastAccessed == m_cache.end() || i->second->GetLastAccess() < lastAccessed->second->GetLastAccess())
-        lastAccessed = i;
-      numCached++;
+      // ensure dirs that are always cached aren't cleared
+      if (i->second->m_cacheType != DIR_CACHE_ALWAYS)
+      {
+        if (lastAccessed == m_cache.end() || i->second->GetLastAccess() < lastAccessed->second->GetLastAccess())
+          lastAccessed = i;
+      }
     }
-  }
-  if (lastAccessed != m_cache.end() && numCached >= MAX_CACHED_DIRS)
+    if (lastAccessed == m_cache.end())
+      break;
+
     Delete(lastAccessed);
+    m_stats.evictions++;
+  }
 }
 
 void CDirectoryCache::Delete(iCache it)
 {
   CDir* dir = it->second;
+  m_cachedBytes -= dir->m_memorySize;
   delete dir;
   m_cache.erase(it);
 }
 
+void CDirectoryCache::SetMaxMemorySize(size_t maxSize)
+{
+  CSingleLock lock (m_cs);
+  m_maxCachedBytes = maxSize;
+  CheckIfFull(0);
+}
+
+void CDirectoryCache::SetPersistentCache(const std::string& path, int64_t maxSize)
+{
+  std::shared_ptr<CPersistentDirectoryCache> persistent;
+  if (!path.empty())
+    persistent = std::make_shared<CPersistentDirectoryCache>(path, maxSize);
+
+  CSingleLock lock (m_cs);
+  m_persistent = persistent;
+}
+
+bool CDirectoryCache::CanPersist(const CURL& url) const
+{
+  {
+    CSingleLock lock (m_cs);
+    if (!m_persistent)
+      return false;
+  }
+
+  // only worth it where listing is slow, and where the directory tells when it changed
+  const std::string path = url.Get();
+  return URIUtils::IsSmb(path) || URIUtils::IsNfs(path) || URIUtils::IsFTP(path) ||
+         URIUtils::IsDAV(path) || URIUtils::IsHTTP(path) || url.IsProtocol("sftp");
+}
+
+std::string CDirectoryCache::GetValidator(const CURL& url)
+{
+  if (URIUtils::IsHTTP(url.Get()) || URIUtils::IsDAV(url.Get()))
+  {
+    CHttpHeader header;
+    if (CCurlFile::GetHttpHeader(url, header))
+    {
+      std::string validator = header.GetValue("etag");
+      if (validator.empty())
+        validator = header.GetValue("last-modified");
+      return validator;
+    }
+    return "";
+  }
+
+  struct __stat64 buffer;
+  if (CFile::Stat(url, &buffer) == 0 && buffer.st_mtime != 0)
+    return StringUtils::Format("%" PRId64, static_cast<int64_t>(buffer.st_mtime));
+  return "";
+}
+
+size_t CDirectoryCache::GetMemorySize(const CFileItem& item)
+{
+  // rough estimate: the item, its strings, the shared pointer and the fast lookup entry
+  return sizeof(CFileItem) + 2 * item.GetPath().size() + item.GetLabel().size() +
+         item.GetLabel2().size() + 128;
+}
+
+size_t CDirectoryCache::GetMemorySize(const CFileItemList& items)
+{
+  size_t size = sizeof(CFileItemList) + items.GetPath().size();
+  for (int i = 0; i < items.Size(); i++)
+    size += GetMemorySize(*items[i]);
+  return size;
+}
+
+CDirectoryCache::Stats CDirectoryCache::GetStats() const
+{
+  std::shared_ptr<CPersistentDirectoryCache> persistent;
+  Stats stats;
+  {
+    CSingleLock lock (m_cs);
+    stats = m_stats;
+    stats.cachedDirs = m_cache.size();
+    stats.cachedBytes = m_cachedBytes;
+    persistent = m_persistent;
+  }
+  if (persistent)
+  {
+    stats.persistentDirs = persistent->GetCount();
+    stats.persistentBytes = persistent->GetSize();
+  }
+  return stats;
+}
+
 #ifdef _DEBUG
 void CDirectoryCache::PrintStats() const
 {
+  Stats stats = GetStats();
   CSingleLock lock (m_cs);
-  CLog::Log(LOGDEBUG, "%s - total of %u cache hits, and %u cache misses", __FUNCTION__, m_cacheHits, m_cacheMisses);
+  CLog::Log(LOGDEBUG, "%s - total of %u cache hits, and %u cache misses", __FUNCTION__, stats.hits, stats.misses);
+  CLog::Log(LOGDEBUG, "%s - %u listings loaded from disk, %u missing, %u outdated, %u stored", __FUNCTION__,
+            stats.persistentHits, stats.persistentMisses, stats.persistentStale, stats.persistentWrites);
   // run through and find the oldest and the number of items cached
   unsigned int oldest = UINT_MAX;
   unsigned int numItems = 0;
@@ -273,6 +436,6 @@ void CDirectoryCache::PrintStats() const
     numItems += dir->m_Items->Size();
     numDirs++;
   }
-  CLog::Log(LOGDEBUG, "%s - %u folders cached, with %u items total.  Oldest is %u, current is %u", __FUNCTION__, numDirs, numItems, oldest, m_accessCounter);
+  CLog::Log(LOGDEBUG, "%s - %u folders cached, with %u items total (about %zu bytes).  Oldest is %u, current is %u", __FUNCTION__, numDirs, numItems, m_cachedBytes, oldest, m_accessCounter);
 }
 #endif
@@ -12,12 +12,17 @@
 #include "threads/CriticalSection.h"
 
 #include <map>
+#include <memory>
 #include <set>
+#include <stdint.h>
 
 class CFileItem;
+class CURL;
 
 namespace XFILE
 {
+  class CPersistentDirectoryCache;
+
   class CDirectoryCache
   {
     class CDir
@@ -31,29 +36,92 @@ namespace XFILE
 
       CFileItemList* m_Items;
       DIR_CACHE_TYPE m_cacheType;
+      size_t m_memorySize; ///< estimated memory used by the listing
     private:
       CDir(const CDir&) = delete;
       CDir& operator=(const CDir&) = delete;
       unsigned int m_lastAccess;
     };
   public:
+    struct Stats
+    {
+      unsigned int hits = 0;              ///< GetDirectory() answered from memory
+      unsigned int misses = 0;            ///< GetDirectory() not answered from memory
+      unsigned int persistentHits = 0;    ///< LoadDirectory() answered from disk
+      unsigned int persistentMisses = 0;  ///< LoadDirectory() found nothing stored
+      unsigned int persistentStale = 0;   ///< LoadDirectory() found a listing of an older version
+      unsigned int persistentWrites = 0;  ///< listings stored on disk
+      unsigned int evictions = 0;         ///< listings dropped from memory to stay within the budget
+      unsigned int cachedDirs = 0;
+      size_t cachedBytes = 0;
+      unsigned int persistentDirs = 0;
+      int64_t persistentBytes = 0;
+    };
+
+    static const size_t DEFAULT_MAX_MEMORY_SIZE = 32 * 1024 * 1024;
+
     CDirectoryCache(void);
     virtual ~CDirectoryCache(void);
     bool GetDirectory(const std::string& strPath, CFileItemList &items, bool retrieveAll = false);
-    void SetDirectory(const std::string& strPath, const CFileItemList &items, DIR_CACHE_TYPE cacheType);
+
+    /*!
+     \brief Cache a directory listing
+     \param validator identifies the version of the directory (see GetValidator()). If it's not empty
+                      and persistent caching is enabled, the listing is stored on disk as well.
+     */
+    void SetDirectory(const std::string& strPath, const CFileItemList &items, DIR_CACHE_TYPE cacheType, const std::string& validator = "");
+
+    /*!
+     \brief Get a listing stored on disk by this or an earlier session
+     \param validator has to match the one the listing was stored with
+     \return true if the listing was found, it's cached in memory as well then
+     */
+    bool LoadDirectory(const std::string& strPath, const std::string& validator, CFileItemList &items, DIR_CACHE_TYPE cacheType);
+
     void ClearDirectory(const std::string& strPath);
     void ClearFile(const std::string& strFile);
     void ClearSubPaths(const std::string& strPath);
+
+    /*!
+     \brief Clear the listings in memory, the ones stored on disk are kept as they are validated on use
+     */
     void Clear();
     void AddFile(const std::string& strFile);
     bool FileExists(const std::string& strPath, bool& bInCache);
+
+    /*!
+     \brief Limit the memory used by cached listings, the least recently used ones are dropped first
+     */
+    void SetMaxMemorySize(size_t maxSize);
+
+    /*!
+     \brief Store listings of remote sources on disk so they survive a restart
+     \param path directory to store the listings in, empty to disable
+     \param maxSize maximum number of bytes to use on disk
+     */
+    void SetPersistentCache(const std::string& path, int64_t maxSize);
+
+    /*!
+     \brief Whether listings of this path may be stored on disk
+     */
+    bool CanPersist(const CURL& url) const;
+
+    /*!
+     \brief Get a value that changes whenever the directory changes, e.g. its modification time or ETag
+     \return empty if the source doesn't provide one
+     */
+    static std::string GetValidator(const CURL& url);
+
+    Stats GetStats() const;
 #ifdef _DEBUG
     void PrintStats() const;
 #endif
   protected:
     void InitCache(std::set<std::string>& dirs);
     void ClearCache(std::set<std::string>& dirs);
-    void CheckIfFull();
+    void CheckIfFull(size_t size);
+    static size_t GetMemorySize(const CFileItem& item);
+    static size_t GetMemorySize(const CFileItemList& items);
 
     std::map<std::string, CDir*> m_cache;
     typedef std::map<std::string, CDir*>::iterator iCache;
@@ -63,11 +131,10 @@ namespace XFILE
     mutable CCriticalSection m_cs;
 
     unsigned int m_accessCounter;
-
-#ifdef _DEBUG
-    unsigned int m_cacheHits;
-    unsigned int m_cacheMisses;
-#endif
+    size_t m_cachedBytes;
+    size_t m_maxCachedBytes;
+    std::shared_ptr<CPersistentDirectoryCache> m_persistent;
+    Stats m_stats;
   };
 }
 extern XFILE::CDirectoryCache g_directoryCache;
@@ -168,6 +168,11 @@ bool CFileCache::Open(const CURL& url)
   bool retry = false;
   m_source.IoControl(IOCTRL_SET_RETRY, &retry); // We already handle retrying ourselves
 
+  // read ahead with parallel requests if the source supports it
+  unsigned int prefetchConnections = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_curlPrefetchConnections;
+  if (prefetchConnections > 1)
+    m_source.IoControl(IOCTRL_SET_PREFETCH, &prefetchConnections);
+
   // check if source can seek
   m_seekPossible = m_source.IoControl(IOCTRL_SEEK_POSSIBLE, NULL);
   m_chunkSize = CFile::GetChunkSize(m_source.GetChunkSize(), READ_CACHE_CHUNK_SIZE);
@@ -175,10 +180,15 @@ bool CFileCache::Open(const CURL& url)
 
   if (!m_pCache)
   {
+    bool sparseCache = false;
     if (CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_cacheMemSize == 0)
     {
-      // Use cache on disk
-      m_pCache = new CSimpleFileCache();
+      // Use cache on disk, keeping everything fetched if we can seek back and forth on the source
+      sparseCache = m_seekPossible > 0;
+      if (sparseCache)
+        m_pCache = new CSparseFileCache();
+      else
+        m_pCache = new CSimpleFileCache();
       m_forwardCacheSize = 0;
     }
     else
@@ -207,9 +217,10 @@ bool CFileCache::Open(const CURL& url)
       m_forwardCacheSize = front;
     }
 
-    if (m_flags & READ_MULTI_STREAM)
+    if ((m_flags & READ_MULTI_STREAM) && !sparseCache)
     {
-      // If READ_MULTI_STREAM flag is set: Double buffering is required
+      // If READ_MULTI_STREAM flag is set: Double buffering is required, unless the
+      // cache keeps all ranges anyway
       m_pCache = new CDoubleCache(m_pCache);
     }
   }
@@ -413,6 +424,23 @@ void CFileCache::Process()
 
     m_writePos += iTotalWrite;
 
+    // the cache may already hold the data following what we've just written
+    // (see CSparseFileCache), continue reading the source after it
+    const int64_t cacheEndPos = m_pCache->CachedDataEndPos();
+    if (cacheEndPos > m_writePos)
+    {
+      if (m_fileSize > 0 && cacheEndPos >= m_fileSize)
+        cacheReachEOF = true;
+      else if (m_source.Seek(cacheEndPos, SEEK_SET) != cacheEndPos)
+      {
+        CLog::Log(LOGERROR, "CFileCache::Process - Error %d seeking past cached data to %" PRId64, (int)GetLastError(), cacheEndPos);
+        break; // while (!m_bStop)
+      }
+      m_writePos = cacheEndPos;
+      average.Reset(m_writePos, false);
+      limiter.Reset(m_writePos);
+    }
+
     // under estimate write rate by a second, to
     // avoid uncertainty at start of caching
     m_writeRateActual = average.Rate(m_writePos, 1000);
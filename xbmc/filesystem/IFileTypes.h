@@ -61,6 +61,7 @@ typedef enum {
   IOCTRL_CACHE_SETRATE = 4,  /**< unsigned int with speed limit for caching in bytes per second */
   IOCTRL_SET_CACHE     = 8,  /**< CFileCache */
   IOCTRL_SET_RETRY     = 16, /**< Enable/disable retry within the protocol handler (if supported) */
+  IOCTRL_SET_PREFETCH  = 32, /**< unsigned int with the maximum number of parallel requests to read ahead with, 0 to disable (if supported) */
 } EIoControl;
 
 enum CURLOPTIONTYPE
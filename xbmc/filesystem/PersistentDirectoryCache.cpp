@@ -0,0 +1,220 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "PersistentDirectoryCache.h"
+#include "Directory.h"
+#include "File.h"
+#include "FileItem.h"
+#include "URL.h"
+#include "threads/SingleLock.h"
+#include "utils/Archive.h"
+#include "utils/Crc32.h"
+#include "utils/log.h"
+#include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
+
+#include <algorithm>
+#include <inttypes.h>
+#include <stdexcept>
+#include <stdlib.h>
+#include <vector>
+
+// bump whenever the stored format (including CFileItem::Archive) changes
+#define CACHE_VERSION 1
+
+using namespace XFILE;
+
+CPersistentDirectoryCache::CPersistentDirectoryCache(const std::string& path, int64_t maxSize)
+  : m_path(path)
+  , m_maxSize(maxSize)
+{
+  URIUtils::AddSlashAtEnd(m_path);
+}
+
+void CPersistentDirectoryCache::Init()
+{
+  if (m_initialized)
+    return;
+  m_initialized = true;
+
+  if (!CDirectory::Exists(m_path) && !CDirectory::Create(m_path))
+  {
+    CLog::Log(LOGERROR, "CPersistentDirectoryCache - unable to create %s", CURL::GetRedacted(m_path).c_str());
+    return;
+  }
+
+  // pick up the listings of previous sessions, the oldest ones are removed first
+  CFileItemList items;
+  CDirectory::GetDirectory(m_path, items, ".dc", DIR_FLAG_BYPASS_CACHE | DIR_FLAG_NO_FILE_DIRS);
+
+  std::vector<CFileItemPtr> files(items.cbegin(), items.cend());
+  std::sort(files.begin(), files.end(), [](const CFileItemPtr& a, const CFileItemPtr& b) {
+    return a->m_dateTime < b->m_dateTime;
+  });
+
+  for (const auto& item : files)
+  {
+    const std::string name = URIUtils::GetFileName(item->GetPath());
+    Entry entry;
+    entry.size = item->m_dwSize;
+    entry.lastAccess = m_accessCounter++;
+    m_entries[strtoul(name.c_str(), nullptr, 16)] = entry;
+    m_size += entry.size;
+  }
+
+  CheckIfFull();
+  CLog::Log(LOGDEBUG, "CPersistentDirectoryCache - %u listings with %" PRId64 " bytes in %s",
+            static_cast<unsigned int>(m_entries.size()), m_size, CURL::GetRedacted(m_path).c_str());
+}
+
+std::string CPersistentDirectoryCache::GetCacheFile(uint32_t crc) const
+{
+  return StringUtils::Format("%s%08x.dc", m_path.c_str(), crc);
+}
+
+CPersistentDirectoryCache::LoadResult CPersistentDirectoryCache::Load(const std::string& strPath, const std::string& validator, CFileItemList& items)
+{
+  CSingleLock lock(m_cs);
+  Init();
+
+  const uint32_t crc = Crc32::ComputeFromLowerCase(strPath);
+  auto it = m_entries.find(crc);
+  if (it == m_entries.end())
+    return LOAD_MISSING;
+
+  const std::string cacheFile = GetCacheFile(crc);
+  CFile file;
+  if (!file.Open(cacheFile))
+  {
+    RemoveEntry(it);
+    return LOAD_MISSING;
+  }
+
+  try
+  {
+    CArchive ar(&file, CArchive::load);
+    int version;
+    std::string path;
+    std::string storedValidator;
+    ar >> version;
+    if (version != CACHE_VERSION)
+    {
+      ar.Close();
+      file.Close();
+      RemoveEntry(it);
+      return LOAD_MISSING;
+    }
+
+    ar >> path;
+    ar >> storedValidator;
+    // different paths may end up with the same crc
+    if (path != strPath)
+      return LOAD_MISSING;
+    if (storedValidator != validator)
+      return LOAD_STALE;
+
+    ar >> items;
+    ar.Close();
+  }
+  catch (const std::out_of_range&)
+  {
+    CLog::Log(LOGERROR, "CPersistentDirectoryCache - corrupt listing %s", CURL::GetRedacted(cacheFile).c_str());
+    file.Close();
+    RemoveEntry(it);
+    return LOAD_MISSING;
+  }
+
+  it->second.lastAccess = m_accessCounter++;
+  return LOAD_OK;
+}
+
+bool CPersistentDirectoryCache::Save(const std::string& strPath, const std::string& validator, CFileItemList& items)
+{
+  CSingleLock lock(m_cs);
+  Init();
+
+  const uint32_t crc = Crc32::ComputeFromLowerCase(strPath);
+  const std::string cacheFile = GetCacheFile(crc);
+
+  CFile file;
+  if (!file.OpenForWrite(cacheFile, true))
+    return false;
+
+  CArchive ar(&file, CArchive::store);
+  ar << CACHE_VERSION;
+  ar << strPath;
+  ar << validator;
+  ar << items;
+  ar.Close();
+
+  Entry entry;
+  entry.size = file.GetLength();
+  entry.lastAccess = m_accessCounter++;
+  file.Close();
+
+  auto it = m_entries.find(crc);
+  if (it != m_entries.end())
+    m_size -= it->second.size;
+  m_entries[crc] = entry;
+  m_size += entry.size;
+
+  CheckIfFull();
+  return true;
+}
+
+void CPersistentDirectoryCache::Remove(const std::string& strPath)
+{
+  CSingleLock lock(m_cs);
+  Init();
+
+  auto it = m_entries.find(Crc32::ComputeFromLowerCase(strPath));
+  if (it != m_entries.end())
+    RemoveEntry(it);
+}
+
+void CPersistentDirectoryCache::Clear()
+{
+  CSingleLock lock(m_cs);
+  Init();
+
+  while (!m_entries.empty())
+    RemoveEntry(m_entries.begin());
+}
+
+unsigned int CPersistentDirectoryCache::GetCount() const
+{
+  CSingleLock lock(m_cs);
+  return m_entries.size();
+}
+
+int64_t CPersistentDirectoryCache::GetSize() const
+{
+  CSingleLock lock(m_cs);
+  return m_size;
+}
+
+void CPersistentDirectoryCache::RemoveEntry(std::map<uint32_t, Entry>::iterator it)
+{
+  CFile::Delete(GetCacheFile(it->first));
+  m_size -= it->second.size;
+  m_entries.erase(it);
+}
+
+void CPersistentDirectoryCache::CheckIfFull()
+{
+  while (m_size > m_maxSize && !m_entries.empty())
+  {
+    auto lastAccessed = m_entries.begin();
+    for (auto it = m_entries.begin(); it != m_entries.end(); ++it)
+    {
+      if (it->second.lastAccess < lastAccessed->second.lastAccess)
+        lastAccessed = it;
+    }
+    RemoveEntry(lastAccessed);
+  }
+}
@@ -0,0 +1,72 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "threads/CriticalSection.h"
+
+#include <map>
+#include <stdint.h>
+#include <string>
+
+class CFileItemList;
+
+namespace XFILE
+{
+  /*!
+   \brief Directory listings stored on disk, so they survive a restart
+
+   Every listing is stored together with a validator, e.g. the modification time of the
+   directory. A stored listing is only handed out again for the same validator. The total
+   size of the stored listings is limited, the least recently used ones are removed first.
+   */
+  class CPersistentDirectoryCache
+  {
+  public:
+    enum LoadResult
+    {
+      LOAD_MISSING = 0, ///< Nothing stored for this path
+      LOAD_STALE,       ///< Stored with a different validator, the directory changed since
+      LOAD_OK
+    };
+
+    /*!
+     \param path directory the listings are stored in, created if needed
+     \param maxSize maximum number of bytes used on disk
+     */
+    CPersistentDirectoryCache(const std::string& path, int64_t maxSize);
+
+    LoadResult Load(const std::string& strPath, const std::string& validator, CFileItemList& items);
+    bool Save(const std::string& strPath, const std::string& validator, CFileItemList& items);
+    void Remove(const std::string& strPath);
+    void Clear();
+
+    unsigned int GetCount() const;
+    int64_t GetSize() const;
+
+  private:
+    struct Entry
+    {
+      int64_t size;
+      unsigned int lastAccess;
+    };
+
+    void Init();
+    std::string GetCacheFile(uint32_t crc) const;
+    void RemoveEntry(std::map<uint32_t, Entry>::iterator it);
+    void CheckIfFull();
+
+    std::string m_path;
+    int64_t m_maxSize;
+    int64_t m_size = 0;
+    bool m_initialized = false;
+    unsigned int m_accessCounter = 0;
+    std::map<uint32_t, Entry> m_entries;
+    mutable CCriticalSection m_cs;
+  };
+}
@@ -0,0 +1,122 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "filesystem/CacheStrategy.h"
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace XFILE;
+
+namespace
+{
+std::vector<char> MakeData(int64_t position, size_t size)
+{
+  std::vector<char> data(size);
+  for (size_t i = 0; i < size; i++)
+    data[i] = static_cast<char>((position + i) * 7 % 251);
+  return data;
+}
+
+// simulate CFileCache: reset to the source position and write what the source returns
+void Fill(CSparseFileCache& cache, int64_t position, size_t size)
+{
+  cache.Reset(position, false);
+  ASSERT_EQ(position, cache.CachedDataEndPos());
+  std::vector<char> data = MakeData(position, size);
+  ASSERT_EQ(static_cast<int>(size), cache.WriteToCache(data.data(), size));
+}
+
+void ExpectData(CSparseFileCache& cache, int64_t position, size_t size)
+{
+  std::vector<char> buffer(size);
+  ASSERT_EQ(static_cast<int>(size), cache.ReadFromCache(buffer.data(), size));
+  EXPECT_EQ(MakeData(position, size), buffer);
+}
+}
+
+TEST(TestSparseFileCache, WriteAndRead)
+{
+  CSparseFileCache cache;
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+
+  Fill(cache, 0, 1000);
+  EXPECT_EQ(1000, cache.CachedDataEndPos());
+  EXPECT_EQ(1000, cache.WaitForData(0, 0));
+  ExpectData(cache, 0, 1000);
+
+  char c;
+  EXPECT_EQ(CACHE_RC_WOULD_BLOCK, cache.ReadFromCache(&c, 1));
+  cache.EndOfInput();
+  EXPECT_EQ(0, cache.ReadFromCache(&c, 1));
+  cache.Close();
+}
+
+TEST(TestSparseFileCache, KeepsRangesAcrossReset)
+{
+  CSparseFileCache cache;
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+
+  Fill(cache, 0, 4096);
+  Fill(cache, 1000000, 4096);
+  Fill(cache, 50000, 4096);
+  EXPECT_EQ(3 * 4096, cache.GetCachedBytes());
+
+  // the first range is still there after seeking elsewhere
+  EXPECT_TRUE(cache.IsCachedPosition(100));
+  EXPECT_EQ(4096, cache.CachedDataEndPosIfSeekTo(100));
+  EXPECT_FALSE(cache.Reset(100, false));
+  EXPECT_EQ(4096, cache.CachedDataEndPos());
+  ExpectData(cache, 100, 3996);
+
+  EXPECT_FALSE(cache.IsCachedPosition(20000));
+  EXPECT_EQ(20000, cache.CachedDataEndPosIfSeekTo(20000));
+  EXPECT_TRUE(cache.Reset(20000, false));
+  cache.Close();
+}
+
+TEST(TestSparseFileCache, Seek)
+{
+  CSparseFileCache cache;
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+
+  Fill(cache, 1000000, 4096);
+  Fill(cache, 10000, 4096);
+
+  // within the range being written
+  EXPECT_EQ(12000, cache.Seek(12000));
+  ExpectData(cache, 12000, 1000);
+  EXPECT_EQ(10000, cache.Seek(10000));
+  ExpectData(cache, 10000, 10);
+
+  // other ranges need a reset so the source continues after them
+  EXPECT_EQ(CACHE_RC_ERROR, cache.Seek(1000100));
+  EXPECT_EQ(CACHE_RC_ERROR, cache.Seek(5000));
+  cache.Close();
+}
+
+TEST(TestSparseFileCache, MergesRanges)
+{
+  CSparseFileCache cache;
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+
+  Fill(cache, 8192, 4096);
+  Fill(cache, 0, 4096);
+  EXPECT_EQ(4096, cache.CachedDataEndPos());
+
+  // reaching the following range moves the write position to its end
+  std::vector<char> data = MakeData(4096, 5000);
+  ASSERT_EQ(5000, cache.WriteToCache(data.data(), data.size()));
+  EXPECT_EQ(12288, cache.CachedDataEndPos());
+  EXPECT_EQ(12288, cache.GetCachedBytes());
+  EXPECT_EQ(12288, cache.WaitForData(0, 0));
+  ExpectData(cache, 0, 12288);
+  cache.Close();
+}
@@ -0,0 +1,117 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "FileItem.h"
+#include "URL.h"
+#include "filesystem/Directory.h"
+#include "filesystem/DirectoryCache.h"
+#include "utils/StringUtils.h"
+
+#include "gtest/gtest.h"
+
+using namespace XFILE;
+
+namespace
+{
+void MakeListing(const std::string& path, int count, CFileItemList& items)
+{
+  items.Clear();
+  items.SetPath(path);
+  for (int i = 0; i < count; i++)
+  {
+    CFileItemPtr item(new CFileItem(StringUtils::Format("%s/file%d.mkv", path.c_str(), i), false));
+    item->SetLabel(StringUtils::Format("file%d.mkv", i));
+    item->m_dwSize = 1000 + i;
+    items.Add(item);
+  }
+}
+}
+
+TEST(TestDirectoryCache, MemoryLimit)
+{
+  CDirectoryCache cache;
+  CFileItemList a, b, c, items;
+  MakeListing("smb://server/share/a", 100, a);
+  MakeListing("smb://server/share/b", 100, b);
+  MakeListing("smb://server/share/c", 100, c);
+
+  cache.SetDirectory(a.GetPath(), a, DIR_CACHE_ONCE);
+  const size_t listingSize = cache.GetStats().cachedBytes;
+  EXPECT_GT(listingSize, 100 * sizeof(CFileItem));
+
+  // room for two listings
+  cache.SetMaxMemorySize(listingSize * 5 / 2);
+  cache.SetDirectory(b.GetPath(), b, DIR_CACHE_ONCE);
+  EXPECT_TRUE(cache.GetDirectory(a.GetPath(), items, true));
+  cache.SetDirectory(c.GetPath(), c, DIR_CACHE_ONCE);
+
+  // b was used least recently
+  EXPECT_TRUE(cache.GetDirectory(a.GetPath(), items, true));
+  EXPECT_FALSE(cache.GetDirectory(b.GetPath(), items, true));
+  EXPECT_TRUE(cache.GetDirectory(c.GetPath(), items, true));
+  EXPECT_EQ(100, items.Size());
+
+  CDirectoryCache::Stats stats = cache.GetStats();
+  EXPECT_EQ(1u, stats.evictions);
+  EXPECT_EQ(2u, stats.cachedDirs);
+  EXPECT_LE(stats.cachedBytes, listingSize * 5 / 2);
+  EXPECT_EQ(3u, stats.hits);
+  EXPECT_EQ(1u, stats.misses);
+
+  cache.Clear();
+  EXPECT_EQ(0u, cache.GetStats().cachedBytes);
+}
+
+TEST(TestDirectoryCache, Persistent)
+{
+  const std::string cachePath = "special://temp/TestDirectoryCache/";
+  CFileItemList listing, items;
+  MakeListing("smb://server/share/movies", 50, listing);
+
+  {
+    CDirectoryCache cache;
+    EXPECT_FALSE(cache.CanPersist(CURL(listing.GetPath())));
+    cache.SetPersistentCache(cachePath, 1024 * 1024);
+    EXPECT_TRUE(cache.CanPersist(CURL(listing.GetPath())));
+    EXPECT_FALSE(cache.CanPersist(CURL("special://temp/")));
+
+    cache.SetDirectory(listing.GetPath(), listing, DIR_CACHE_ONCE, "1000");
+    EXPECT_EQ(1u, cache.GetStats().persistentWrites);
+    EXPECT_EQ(1u, cache.GetStats().persistentDirs);
+  }
+
+  // next session
+  CDirectoryCache cache;
+  cache.SetPersistentCache(cachePath, 1024 * 1024);
+
+  EXPECT_FALSE(cache.LoadDirectory(listing.GetPath(), "1001", items, DIR_CACHE_ONCE));
+  ASSERT_TRUE(cache.LoadDirectory(listing.GetPath(), "1000", items, DIR_CACHE_ONCE));
+  ASSERT_EQ(listing.Size(), items.Size());
+  for (int i = 0; i < items.Size(); i++)
+  {
+    EXPECT_EQ(listing[i]->GetPath(), items[i]->GetPath());
+    EXPECT_EQ(listing[i]->GetLabel(), items[i]->GetLabel());
+    EXPECT_EQ(listing[i]->m_dwSize, items[i]->m_dwSize);
+  }
+
+  // it's in memory as well now
+  EXPECT_TRUE(cache.GetDirectory(listing.GetPath(), items, true));
+  EXPECT_FALSE(cache.LoadDirectory("smb://server/share/other", "1000", items, DIR_CACHE_ONCE));
+
+  // changing a file drops the stored listing
+  cache.ClearFile(listing[0]->GetPath());
+  EXPECT_FALSE(cache.LoadDirectory(listing.GetPath(), "1000", items, DIR_CACHE_ONCE));
+
+  CDirectoryCache::Stats stats = cache.GetStats();
+  EXPECT_EQ(1u, stats.persistentHits);
+  EXPECT_EQ(1u, stats.persistentStale);
+  EXPECT_EQ(2u, stats.persistentMisses);
+  EXPECT_EQ(0u, stats.persistentDirs);
+
+  EXPECT_TRUE(CDirectory::RemoveRecursive(cachePath));
+}
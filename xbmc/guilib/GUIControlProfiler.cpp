@@ -14,7 +14,7 @@
 bool CGUIControlProfiler::m_bIsRunning = false;
 
 CGUIControlProfilerItem::CGUIControlProfilerItem(CGUIControlProfiler *pProfiler, CGUIControlProfilerItem *pParent, CGUIControl *pControl)
-: m_pProfiler(pProfiler), m_pParent(pParent), m_pControl(pControl), m_visTime(0), m_renderTime(0), m_i64VisStart(0), m_i64RenderStart(0)
+: m_pProfiler(pProfiler), m_pParent(pParent), m_pControl(pControl), m_visTime(0), m_renderTime(0), m_drawCalls(0), m_i64VisStart(0), m_i64RenderStart(0), m_drawCallsStart(0)
 {
   if (m_pControl)
   {
@@ -42,6 +42,7 @@ void CGUIControlProfilerItem::Reset(CGUIControlProfiler *pProfiler)
 
   m_visTime = 0;
   m_renderTime = 0;
+  m_drawCalls = 0;
   const unsigned int dwSize = m_vecChildren.size();
   for (unsigned int i=0; i<dwSize; ++i)
     delete m_vecChildren[i];
@@ -63,11 +64,13 @@ void CGUIControlProfilerItem::EndVisibility(void)
 void CGUIControlProfilerItem::BeginRender(void)
 {
   m_i64RenderStart = CurrentHostCounter();
+  m_drawCallsStart = m_pProfiler->GetDrawCalls();
 }
 
 void CGUIControlProfilerItem::EndRender(void)
 {
   m_renderTime += (unsigned int)(m_pProfiler->m_fPerfScale * (CurrentHostCounter() - m_i64RenderStart));
+  m_drawCalls += m_pProfiler->GetDrawCalls() - m_drawCallsStart;
 }
 
 void CGUIControlProfilerItem::SaveToXML(TiXmlElement *parent)
@@ -182,6 +185,15 @@ void CGUIControlProfilerItem::SaveToXML(TiXmlElement *parent)
     elem->LinkEndChild(text);
   }
 
+  if (m_drawCalls)
+  {
+    TiXmlElement *elem = new TiXmlElement("drawcalls");
+    xmlControl->LinkEndChild(elem);
+    std::string val = StringUtils::Format("%u", m_drawCalls);
+    TiXmlText *text = new TiXmlText(val.c_str());
+    elem->LinkEndChild(text);
+  }
+
   if (m_vecChildren.size())
   {
     TiXmlElement *xmlChilds = new TiXmlElement("children");
@@ -237,6 +249,7 @@ bool CGUIControlProfiler::IsRunning(void)
 void CGUIControlProfiler::Start(void)
 {
   m_iFrameCount = 0;
+  m_drawCalls = 0;
   m_bIsRunning = true;
   m_pLastItem = NULL;
   m_ItemHead.Reset(this);
@@ -305,6 +318,7 @@ void CGUIControlProfiler::EndFrame(void)
       CGUIControlProfilerItem *p = m_ItemHead.m_vecChildren[i];
       m_ItemHead.m_visTime += p->m_visTime;
       m_ItemHead.m_renderTime += p->m_renderTime;
+      m_ItemHead.m_drawCalls += p->m_drawCalls;
     }
 
     m_bIsRunning = false;
@@ -326,6 +340,11 @@ bool CGUIControlProfiler::SaveResults(void)
   std::string str = StringUtils::Format("%d", m_iFrameCount);
   root->SetAttribute("framecount", str.c_str());
   root->SetAttribute("timeunit", "ms");
+  if (m_iFrameCount > 0)
+  {
+    str = StringUtils::Format("%.1f", (float)m_drawCalls / m_iFrameCount);
+    root->SetAttribute("drawcallsperframe", str.c_str());
+  }
   doc.LinkEndChild(root);
 
   m_ItemHead.SaveToXML(root);
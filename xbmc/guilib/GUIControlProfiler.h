@@ -27,8 +27,10 @@ public:
   CGUIControl::GUICONTROLTYPES m_ControlType;
   unsigned int m_visTime;
   unsigned int m_renderTime;
+  unsigned int m_drawCalls; // issued while the control rendered, batched ones go to the control that flushed them
   int64_t m_i64VisStart;
   int64_t m_i64RenderStart;
+  unsigned int m_drawCallsStart;
 
   CGUIControlProfilerItem(CGUIControlProfiler *pProfiler, CGUIControlProfilerItem *pParent, CGUIControl *pControl);
   ~CGUIControlProfilerItem(void);
@@ -63,6 +65,8 @@ public:
   const std::string &GetOutputFile(void) const { return m_strOutputFile; };
   bool SaveResults(void);
   unsigned int GetTotalTime(void) const { return m_ItemHead.GetTotalTime(); };
+  void AddDrawCall(void) { m_drawCalls++; };
+  unsigned int GetDrawCalls(void) const { return m_drawCalls; };
 
   float m_fPerfScale;
 private:
@@ -79,10 +83,12 @@ private:
   std::string m_strOutputFile;
   int m_iMaxFrameCount = 200;
   int m_iFrameCount = 0;
+  unsigned int m_drawCalls = 0;
 };
 
 #define GUIPROFILER_VISIBILITY_BEGIN(x) { if (CGUIControlProfiler::IsRunning()) CGUIControlProfiler::Instance().BeginVisibility(x); }
 #define GUIPROFILER_VISIBILITY_END(x) { if (CGUIControlProfiler::IsRunning()) CGUIControlProfiler::Instance().EndVisibility(x); }
 #define GUIPROFILER_RENDER_BEGIN(x) { if (CGUIControlProfiler::IsRunning()) CGUIControlProfiler::Instance().BeginRender(x); }
 #define GUIPROFILER_RENDER_END(x) { if (CGUIControlProfiler::IsRunning()) CGUIControlProfiler::Instance().EndRender(x); }
+#define GUIPROFILER_DRAWCALL() { if (CGUIControlProfiler::IsRunning()) CGUIControlProfiler::Instance().AddDrawCall(); }
 
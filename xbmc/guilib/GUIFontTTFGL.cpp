@@ -22,6 +22,8 @@
 #include "rendering/gles/RenderSystemGLES.h"
 #endif
 #include "rendering/MatrixGL.h"
+#include "settings/AdvancedSettings.h"
+#include "settings/SettingsComponent.h"
 
 #include <cassert>
 
@@ -31,15 +33,17 @@
 #include FT_GLYPH_H
 #include FT_OUTLINE_H
 
-#define ELEMENT_ARRAY_MAX_CHAR_INDEX (1000)
-#define BUFFER_OFFSET(i) ((char *)NULL + (i))
-
 CGUIFontTTFGL::CGUIFontTTFGL(const std::string& strFileName)
 : CGUIFontTTFBase(strFileName)
 {
   m_updateY1 = 0;
   m_updateY2 = 0;
   m_textureStatus = TEXTURE_VOID;
+#if defined(HAS_GL)
+  m_batching = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_guiTextureBatching;
+#else
+  m_batching = false;
+#endif
 }
 
 CGUIFontTTFGL::~CGUIFontTTFGL(void)
@@ -70,6 +74,9 @@ bool CGUIFontTTFGL::FirstBegin()
 
   if (m_textureStatus == TEXTURE_REALLOCATED)
   {
+    // text held back was laid out for the old texture
+    if (m_batchTexture == m_nTexture)
+      FlushBatch();
     if (glIsTexture(m_nTexture))
       CServiceBroker::GetGUI()->GetTextureManager().ReleaseHwTexture(m_nTexture);
     m_textureStatus = TEXTURE_VOID;
@@ -97,6 +104,7 @@ bool CGUIFontTTFGL::FirstBegin()
 
   if (m_textureStatus == TEXTURE_UPDATED)
   {
+    // Only adds glyphs, the text held back doesn't use the updated rows
     glBindTexture(GL_TEXTURE_2D, m_nTexture);
     glTexSubImage2D(GL_TEXTURE_2D, 0, 0, m_updateY1, m_texture->GetWidth(), m_updateY2 - m_updateY1, pixformat, GL_UNSIGNED_BYTE,
         m_texture->GetPixels() + m_updateY1 * m_texture->GetPitch());
@@ -105,117 +113,53 @@ bool CGUIFontTTFGL::FirstBegin()
     m_textureStatus = TEXTURE_READY;
   }
 
-  // Turn Blending On
-  glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE_MINUS_DST_ALPHA, GL_ONE);
-  glEnable(GL_BLEND);
-  glActiveTexture(GL_TEXTURE0);
-  glBindTexture(GL_TEXTURE_2D, m_nTexture);
   return true;
 }
 
 void CGUIFontTTFGL::LastEnd()
 {
-#ifdef HAS_GL
-  CRenderSystemGL* renderSystem = dynamic_cast<CRenderSystemGL*>(CServiceBroker::GetRenderSystem());
-  renderSystem->EnableShader(SM_FONTS);
-
-  GLint posLoc = renderSystem->ShaderGetPos();
-  GLint colLoc = renderSystem->ShaderGetCol();
-  GLint tex0Loc = renderSystem->ShaderGetCoord0();
-  GLint modelLoc = renderSystem->ShaderGetModel();
-
-  CreateStaticVertexBuffers();
-
-  // Enable the attributes used by this shader
-  glEnableVertexAttribArray(posLoc);
-  glEnableVertexAttribArray(colLoc);
-  glEnableVertexAttribArray(tex0Loc);
-
-  if (!m_vertex.empty())
+  bool drawVertices = !m_vertex.empty();
+  if (drawVertices && m_batching)
   {
-
-    // Deal with vertices that had to use software clipping
-    std::vector<SVertex> vecVertices(6 * (m_vertex.size() / 4));
-    SVertex *vertices = &vecVertices[0];
-    for (size_t i=0; i<m_vertex.size(); i+=4)
+    // Hold back the vertices that had to use software clipping, the text of
+    // the labels that follow in the same font texture is drawn with them.
+    // They are drawn before anything else is, and before the scissors, the
+    // transform or the shader change.
+    if (m_batchVertices.empty() || m_batchTexture != m_nTexture)
     {
-      *vertices++ = m_vertex[i];
-      *vertices++ = m_vertex[i+1];
-      *vertices++ = m_vertex[i+2];
-
-      *vertices++ = m_vertex[i+1];
-      *vertices++ = m_vertex[i+3];
-      *vertices++ = m_vertex[i+2];
+      CServiceBroker::GetRenderSystem()->FlushBatch();
+      m_batchTexture = m_nTexture;
     }
-    vertices = &vecVertices[0];
-
-    GLuint VertexVBO;
-
-    glGenBuffers(1, &VertexVBO);
-    glBindBuffer(GL_ARRAY_BUFFER, VertexVBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(SVertex)*vecVertices.size(), &vecVertices[0], GL_STATIC_DRAW);
-
-    glVertexAttribPointer(posLoc, 3, GL_FLOAT, GL_FALSE, sizeof(SVertex), BUFFER_OFFSET(offsetof(SVertex, x)));
-    glVertexAttribPointer(colLoc, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(SVertex), BUFFER_OFFSET(offsetof(SVertex, r)));
-    glVertexAttribPointer(tex0Loc, 2, GL_FLOAT, GL_FALSE, sizeof(SVertex), BUFFER_OFFSET(offsetof(SVertex, u)));
-
-    glDrawArrays(GL_TRIANGLES, 0, vecVertices.size());
-
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glDeleteBuffers(1, &VertexVBO);
+    m_batchVertices.insert(m_batchVertices.end(), m_vertex.begin(), m_vertex.end());
+    drawVertices = false;
   }
 
-#else
-  // GLES 2.0 version.
-  CRenderSystemGLES* renderSystem = dynamic_cast<CRenderSystemGLES*>(CServiceBroker::GetRenderSystem());
-  renderSystem->EnableGUIShader(SM_FONTS);
-
-  GLint posLoc  = renderSystem->GUIShaderGetPos();
-  GLint colLoc  = renderSystem->GUIShaderGetCol();
-  GLint tex0Loc = renderSystem->GUIShaderGetCoord0();
-  GLint modelLoc = renderSystem->GUIShaderGetModel();
-
+  if (!drawVertices && m_vertexTrans.empty())
+    return;
 
-  CreateStaticVertexBuffers();
+  // Draw what is held back before setting up the state for this
+  CServiceBroker::GetRenderSystem()->FlushBatch();
 
-  // Enable the attributes used by this shader
-  glEnableVertexAttribArray(posLoc);
-  glEnableVertexAttribArray(colLoc);
-  glEnableVertexAttribArray(tex0Loc);
+  GLint posLoc, colLoc, tex0Loc, modelLoc;
+  CQuadStreamGL& quadStream = BeginDraw(m_nTexture, posLoc, colLoc, tex0Loc, modelLoc);
 
-  if (!m_vertex.empty())
+  if (drawVertices)
   {
-    // Deal with vertices that had to use software clipping
-    std::vector<SVertex> vecVertices( 6 * (m_vertex.size() / 4) );
-    SVertex *vertices = &vecVertices[0];
-
-    for (size_t i=0; i<m_vertex.size(); i+=4)
-    {
-      *vertices++ = m_vertex[i];
-      *vertices++ = m_vertex[i+1];
-      *vertices++ = m_vertex[i+2];
-
-      *vertices++ = m_vertex[i+1];
-      *vertices++ = m_vertex[i+3];
-      *vertices++ = m_vertex[i+2];
-    }
-
-    vertices = &vecVertices[0];
-
-    glVertexAttribPointer(posLoc,  3, GL_FLOAT, GL_FALSE, sizeof(SVertex), (char*)vertices + offsetof(SVertex, x));
-    glVertexAttribPointer(colLoc,  4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(SVertex), (char*)vertices + offsetof(SVertex, r));
-    glVertexAttribPointer(tex0Loc, 2, GL_FLOAT,  GL_FALSE, sizeof(SVertex), (char*)vertices + offsetof(SVertex, u));
-
-    glDrawArrays(GL_TRIANGLES, 0, vecVertices.size());
+    // Deal with vertices that had to use software clipping, all text drawn
+    // since the first Begin() call goes into the stream buffer in one piece
+    GLintptr offset = quadStream.Stream(m_vertex.data(), m_vertex.size() * sizeof(SVertex));
+    DrawQuads(quadStream, posLoc, colLoc, tex0Loc, offset, m_vertex.size() / 4);
   }
-#endif
 
   if (!m_vertexTrans.empty())
   {
     // Deal with the vertices that can be hardware clipped and therefore translated
+#ifdef HAS_GL
+    CRenderSystemGL* renderSystem = dynamic_cast<CRenderSystemGL*>(CServiceBroker::GetRenderSystem());
+#else
+    CRenderSystemGLES* renderSystem = dynamic_cast<CRenderSystemGLES*>(CServiceBroker::GetRenderSystem());
+#endif
 
-    // Bind our pre-calculated array to GL_ELEMENT_ARRAY_BUFFER
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_elementArrayHandle);
     // Store current scissor
     CRect scissor = CServiceBroker::GetWinSystem()->GetGfxContext().StereoCorrection(CServiceBroker::GetWinSystem()->GetGfxContext().GetScissors());
 
@@ -246,21 +190,7 @@ void CGUIFontTTFGL::LastEnd()
       // Bind the buffer to the OpenGL context's GL_ARRAY_BUFFER binding point
       glBindBuffer(GL_ARRAY_BUFFER, m_vertexTrans[i].vertexBuffer->bufferHandle);
 
-      // Do the actual drawing operation, split into groups of characters no
-      // larger than the pre-determined size of the element array
-      for (size_t character = 0; m_vertexTrans[i].vertexBuffer->size > character; character += ELEMENT_ARRAY_MAX_CHAR_INDEX)
-      {
-        size_t count = m_vertexTrans[i].vertexBuffer->size - character;
-        count = std::min<size_t>(count, ELEMENT_ARRAY_MAX_CHAR_INDEX);
-
-        // Set up the offsets of the various vertex attributes within the buffer
-        // object bound to GL_ARRAY_BUFFER
-        glVertexAttribPointer(posLoc,  3, GL_FLOAT,         GL_FALSE, sizeof(SVertex), (GLvoid *) (character*sizeof(SVertex)*4 + offsetof(SVertex, x)));
-        glVertexAttribPointer(colLoc,  4, GL_UNSIGNED_BYTE, GL_TRUE,  sizeof(SVertex), (GLvoid *) (character*sizeof(SVertex)*4 + offsetof(SVertex, r)));
-        glVertexAttribPointer(tex0Loc, 2, GL_FLOAT,         GL_FALSE, sizeof(SVertex), (GLvoid *) (character*sizeof(SVertex)*4 + offsetof(SVertex, u)));
-
-        glDrawElements(GL_TRIANGLES, 6 * count, GL_UNSIGNED_SHORT, 0);
-      }
+      DrawQuads(quadStream, posLoc, colLoc, tex0Loc, 0, m_vertexTrans[i].vertexBuffer->size);
 
       glMatrixModview.Pop();
     }
@@ -268,23 +198,99 @@ void CGUIFontTTFGL::LastEnd()
     renderSystem->SetScissors(scissor);
     // Restore the original model view matrix
     glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glMatrixModview.Get());
-    // Unbind GL_ARRAY_BUFFER and GL_ELEMENT_ARRAY_BUFFER
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
   }
 
+  EndDraw(posLoc, colLoc, tex0Loc);
+}
+
+void CGUIFontTTFGL::FlushBatch()
+{
+  if (m_batchVertices.empty())
+    return;
+
+  // Enabling the shader flushes again, take the text out first
+  std::vector<SVertex> vertices;
+  vertices.swap(m_batchVertices);
+
+  GLint posLoc, colLoc, tex0Loc, modelLoc;
+  CQuadStreamGL& quadStream = BeginDraw(m_batchTexture, posLoc, colLoc, tex0Loc, modelLoc);
+  GLintptr offset = quadStream.Stream(vertices.data(), vertices.size() * sizeof(SVertex));
+  DrawQuads(quadStream, posLoc, colLoc, tex0Loc, offset, vertices.size() / 4);
+  EndDraw(posLoc, colLoc, tex0Loc);
+
+  // keep the memory for the next batch
+  vertices.clear();
+  m_batchVertices.swap(vertices);
+}
+
+CQuadStreamGL& CGUIFontTTFGL::BeginDraw(GLuint texture, GLint& posLoc, GLint& colLoc, GLint& tex0Loc, GLint& modelLoc)
+{
+#ifdef HAS_GL
+  CRenderSystemGL* renderSystem = dynamic_cast<CRenderSystemGL*>(CServiceBroker::GetRenderSystem());
+  renderSystem->EnableShader(SM_FONTS);
+
+  posLoc = renderSystem->ShaderGetPos();
+  colLoc = renderSystem->ShaderGetCol();
+  tex0Loc = renderSystem->ShaderGetCoord0();
+  modelLoc = renderSystem->ShaderGetModel();
+#else
+  // GLES 2.0 version.
+  CRenderSystemGLES* renderSystem = dynamic_cast<CRenderSystemGLES*>(CServiceBroker::GetRenderSystem());
+  renderSystem->EnableGUIShader(SM_FONTS);
+
+  posLoc  = renderSystem->GUIShaderGetPos();
+  colLoc  = renderSystem->GUIShaderGetCol();
+  tex0Loc = renderSystem->GUIShaderGetCoord0();
+  modelLoc = renderSystem->GUIShaderGetModel();
+#endif
+
+  // Turn Blending On
+  glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE_MINUS_DST_ALPHA, GL_ONE);
+  glEnable(GL_BLEND);
+  glActiveTexture(GL_TEXTURE0);
+  glBindTexture(GL_TEXTURE_2D, texture);
+
+  // Enable the attributes used by this shader
+  glEnableVertexAttribArray(posLoc);
+  glEnableVertexAttribArray(colLoc);
+  glEnableVertexAttribArray(tex0Loc);
+
+  // Bind our pre-calculated array to GL_ELEMENT_ARRAY_BUFFER, both paths draw quads with it
+  CQuadStreamGL& quadStream = renderSystem->GetQuadStream();
+  quadStream.BindElements();
+  return quadStream;
+}
+
+void CGUIFontTTFGL::EndDraw(GLint posLoc, GLint colLoc, GLint tex0Loc)
+{
+  // Unbind GL_ARRAY_BUFFER and GL_ELEMENT_ARRAY_BUFFER
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
   // Disable the attributes used by this shader
   glDisableVertexAttribArray(posLoc);
   glDisableVertexAttribArray(colLoc);
   glDisableVertexAttribArray(tex0Loc);
 
 #ifdef HAS_GL
-  renderSystem->DisableShader();
+  dynamic_cast<CRenderSystemGL*>(CServiceBroker::GetRenderSystem())->DisableShader();
 #else
-  renderSystem->DisableGUIShader();
+  dynamic_cast<CRenderSystemGLES*>(CServiceBroker::GetRenderSystem())->DisableGUIShader();
 #endif
 }
 
+void CGUIFontTTFGL::DrawQuads(CQuadStreamGL& quadStream, GLint posLoc, GLint colLoc, GLint tex0Loc, GLintptr offset, size_t characters)
+{
+  quadStream.Draw(offset, characters, sizeof(SVertex), [=](GLintptr first)
+  {
+    // Set up the offsets of the various vertex attributes within the buffer
+    // object bound to GL_ARRAY_BUFFER
+    glVertexAttribPointer(posLoc,  3, GL_FLOAT,         GL_FALSE, sizeof(SVertex), reinterpret_cast<const GLvoid*>(first + offsetof(SVertex, x)));
+    glVertexAttribPointer(colLoc,  4, GL_UNSIGNED_BYTE, GL_TRUE,  sizeof(SVertex), reinterpret_cast<const GLvoid*>(first + offsetof(SVertex, r)));
+    glVertexAttribPointer(tex0Loc, 2, GL_FLOAT,         GL_FALSE, sizeof(SVertex), reinterpret_cast<const GLvoid*>(first + offsetof(SVertex, u)));
+  });
+}
+
 CVertexBuffer CGUIFontTTFGL::CreateVertexBuffer(const std::vector<SVertex> &vertices) const
 {
   assert(vertices.size() % 4 == 0);
@@ -410,6 +416,9 @@ void CGUIFontTTFGL::DeleteHardwareTexture()
 {
   if (m_textureStatus != TEXTURE_VOID)
   {
+    if (m_batchTexture == m_nTexture)
+      FlushBatch();
+
     if (glIsTexture(m_nTexture))
       CServiceBroker::GetGUI()->GetTextureManager().ReleaseHwTexture(m_nTexture);
 
@@ -418,38 +427,5 @@ void CGUIFontTTFGL::DeleteHardwareTexture()
   }
 }
 
-void CGUIFontTTFGL::CreateStaticVertexBuffers(void)
-{
-  if (m_staticVertexBufferCreated)
-    return;
-
-  // Bind a new buffer to the OpenGL context's GL_ELEMENT_ARRAY_BUFFER binding point
-  glGenBuffers(1, &m_elementArrayHandle);
-  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_elementArrayHandle);
-  // Create an array holding the mesh indices to convert quads to triangles
-  GLushort index[ELEMENT_ARRAY_MAX_CHAR_INDEX][6];
-  for (size_t i = 0; i < ELEMENT_ARRAY_MAX_CHAR_INDEX; i++)
-  {
-    index[i][0] = 4*i;
-    index[i][1] = 4*i+1;
-    index[i][2] = 4*i+2;
-    index[i][3] = 4*i+1;
-    index[i][4] = 4*i+3;
-    index[i][5] = 4*i+2;
-  }
-  glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof index, index, GL_STATIC_DRAW);
-  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-  m_staticVertexBufferCreated = true;
-}
-
-void CGUIFontTTFGL::DestroyStaticVertexBuffers(void)
-{
-  if (!m_staticVertexBufferCreated)
-    return;
-  glDeleteBuffers(1, &m_elementArrayHandle);
-  m_staticVertexBufferCreated = false;
-}
-
-GLuint CGUIFontTTFGL::m_elementArrayHandle;
-bool CGUIFontTTFGL::m_staticVertexBufferCreated;
-
+GLuint CGUIFontTTFGL::m_batchTexture;
+std::vector<SVertex> CGUIFontTTFGL::m_batchVertices;
@@ -14,6 +14,8 @@
 #include "GUIFontTTF.h"
 #include "system_gl.h"
 
+class CQuadStreamGL;
+
 class CGUIFontTTFGL : public CGUIFontTTFBase
 {
 public:
@@ -25,17 +27,37 @@ public:
 
   CVertexBuffer CreateVertexBuffer(const std::vector<SVertex> &vertices) const override;
   void DestroyVertexBuffer(CVertexBuffer &bufferHandle) const override;
-  static void CreateStaticVertexBuffers(void);
-  static void DestroyStaticVertexBuffers(void);
+
+  /*!
+   * \brief Draw the text held back to be drawn together with the next labels
+   *
+   * With texture batching enabled (gui/texturebatching in advancedsettings)
+   * the software clipped text of consecutive labels using the same font
+   * texture is drawn with one call. CRenderSystemGL calls this with the
+   * flush of the GUI textures.
+   */
+  static void FlushBatch();
 
 protected:
   CBaseTexture* ReallocTexture(unsigned int& newHeight) override;
   bool CopyCharToTexture(FT_BitmapGlyph bitGlyph, unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2) override;
   void DeleteHardwareTexture() override;
 
-  static GLuint m_elementArrayHandle;
-
 private:
+  /*!
+   \brief Draw quads of the buffer bound to GL_ARRAY_BUFFER with the element array
+   \param offset byte offset of the first quad in the buffer
+   \param characters the number of quads
+   */
+  static void DrawQuads(CQuadStreamGL& quadStream, GLint posLoc, GLint colLoc, GLint tex0Loc, GLintptr offset, size_t characters);
+
+  /*!
+   \brief Enable the font shader and its attributes, set up blending and bind the texture and the element array
+   \return the quad stream to draw with
+   */
+  static CQuadStreamGL& BeginDraw(GLuint texture, GLint& posLoc, GLint& colLoc, GLint& tex0Loc, GLint& modelLoc);
+  static void EndDraw(GLint posLoc, GLint colLoc, GLint tex0Loc);
+
   unsigned int m_updateY1;
   unsigned int m_updateY2;
 
@@ -48,7 +70,9 @@ private:
   };
 
   TextureStatus m_textureStatus;
+  bool m_batching;
 
-  static bool m_staticVertexBufferCreated;
+  static GLuint m_batchTexture;
+  static std::vector<SVertex> m_batchVertices;
 };
 
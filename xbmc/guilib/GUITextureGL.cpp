@@ -9,19 +9,24 @@
 #include "GUITextureGL.h"
 #include "ServiceBroker.h"
 #include "Texture.h"
+#include "settings/AdvancedSettings.h"
+#include "settings/SettingsComponent.h"
 #include "utils/log.h"
 #include "utils/GLUtils.h"
 #include "utils/Geometry.h"
 #include "rendering/gl/RenderSystemGL.h"
 #include "windowing/WinSystem.h"
 
-#define BUFFER_OFFSET(i) ((char *)NULL + (i))
-
 CGUITextureGL::CGUITextureGL(float posX, float posY, float width, float height, const CTextureInfo &texture)
 : CGUITextureBase(posX, posY, width, height, texture)
 {
-  memset(m_col, 0, sizeof(m_col));
-  m_renderSystem = dynamic_cast<CRenderSystemGL*>(CServiceBroker::GetRenderSystem());
+  m_batching = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_guiTextureBatching;
+}
+
+bool CGUITextureGL::BatchState::operator==(const BatchState& right) const
+{
+  return texture == right.texture && diffuse == right.diffuse && shader == right.shader &&
+         blend == right.blend && memcmp(col, right.col, sizeof(col)) == 0;
 }
 
 void CGUITextureGL::Begin(UTILS::Color color)
@@ -31,111 +36,139 @@ void CGUITextureGL::Begin(UTILS::Color color)
   if (m_diffuse.size())
     m_diffuse.m_textures[0]->LoadToGPU();
 
-  texture->BindToUnit(0);
+  m_state.texture = static_cast<CGLTexture*>(texture)->GetTextureObject();
 
   // Setup Colors
-  m_col[0] = (GLubyte)GET_R(color);
-  m_col[1] = (GLubyte)GET_G(color);
-  m_col[2] = (GLubyte)GET_B(color);
-  m_col[3] = (GLubyte)GET_A(color);
+  m_state.col[0] = (GLubyte)GET_R(color);
+  m_state.col[1] = (GLubyte)GET_G(color);
+  m_state.col[2] = (GLubyte)GET_B(color);
+  m_state.col[3] = (GLubyte)GET_A(color);
 
-  bool hasAlpha = m_texture.m_textures[m_currentFrame]->HasAlpha() || m_col[3] < 255;
+  bool hasAlpha = m_texture.m_textures[m_currentFrame]->HasAlpha() || m_state.col[3] < 255;
+  bool white = m_state.col[0] == 255 && m_state.col[1] == 255 && m_state.col[2] == 255 && m_state.col[3] == 255;
 
   if (m_diffuse.size())
   {
-    if (m_col[0] == 255 && m_col[1] == 255 && m_col[2] == 255 && m_col[3] == 255 )
-    {
-      m_renderSystem->EnableShader(SM_MULTI);
-    }
-    else
-    {
-      m_renderSystem->EnableShader(SM_MULTI_BLENDCOLOR);
-    }
-
+    m_state.shader = white ? SM_MULTI : SM_MULTI_BLENDCOLOR;
+    m_state.diffuse = static_cast<CGLTexture*>(m_diffuse.m_textures[0])->GetTextureObject();
     hasAlpha |= m_diffuse.m_textures[0]->HasAlpha();
-
-    m_diffuse.m_textures[0]->BindToUnit(1);
   }
   else
   {
-    if (m_col[0] == 255 && m_col[1] == 255 && m_col[2] == 255 && m_col[3] == 255)
-    {
-      m_renderSystem->EnableShader(SM_TEXTURE_NOBLEND);
-    }
-    else
-    {
-      m_renderSystem->EnableShader(SM_TEXTURE);
-    }
+    m_state.shader = white ? SM_TEXTURE_NOBLEND : SM_TEXTURE;
+    m_state.diffuse = 0;
   }
 
-  if (hasAlpha)
-  {
-    glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE_MINUS_DST_ALPHA, GL_ONE);
-    glEnable(GL_BLEND);
-  }
-  else
-  {
-    glDisable(GL_BLEND);
-  }
+  m_state.blend = hasAlpha;
   m_packedVertices.clear();
-  m_idx.clear();
 }
 
 void CGUITextureGL::End()
 {
-  if (m_packedVertices.size())
+  if (m_packedVertices.empty())
+    return;
+
+  if (!m_batching)
   {
-    GLint posLoc  = m_renderSystem->ShaderGetPos();
-    GLint tex0Loc = m_renderSystem->ShaderGetCoord0();
-    GLint tex1Loc = m_renderSystem->ShaderGetCoord1();
-    GLint uniColLoc = m_renderSystem->ShaderGetUniCol();
+    DrawQuads(m_state, m_packedVertices);
+    return;
+  }
 
-    GLuint VertexVBO;
-    GLuint IndexVBO;
+  if (m_batchVertices.empty() || !(m_batchState == m_state))
+  {
+    // draw what is held back, also text, before starting a new batch
+    CServiceBroker::GetRenderSystem()->FlushBatch();
+    m_batchState = m_state;
+  }
+  m_batchVertices.insert(m_batchVertices.end(), m_packedVertices.begin(), m_packedVertices.end());
+}
 
-    glGenBuffers(1, &VertexVBO);
-    glBindBuffer(GL_ARRAY_BUFFER, VertexVBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(PackedVertex)*m_packedVertices.size(), &m_packedVertices[0], GL_STATIC_DRAW);
+void CGUITextureGL::FlushBatch()
+{
+  if (m_batchVertices.empty())
+    return;
 
-    if (uniColLoc >= 0)
-    {
-      glUniform4f(uniColLoc,(m_col[0] / 255.0f), (m_col[1] / 255.0f), (m_col[2] / 255.0f), (m_col[3] / 255.0f));
-    }
+  DrawBatch();
+}
 
-    if (m_diffuse.size())
-    {
-      glVertexAttribPointer(tex1Loc, 2, GL_FLOAT, 0, sizeof(PackedVertex), BUFFER_OFFSET(offsetof(PackedVertex, u2)));
-      glEnableVertexAttribArray(tex1Loc);
-    }
+void CGUITextureGL::DrawBatch()
+{
+  // drawing enables a shader, which flushes again, so take the quads out first
+  std::vector<PackedVertex> vertices;
+  vertices.swap(m_batchVertices);
+  DrawQuads(m_batchState, vertices);
+
+  // keep the memory for the next batch
+  vertices.clear();
+  m_batchVertices.swap(vertices);
+}
 
-    glVertexAttribPointer(posLoc, 3, GL_FLOAT, 0, sizeof(PackedVertex), BUFFER_OFFSET(offsetof(PackedVertex, x)));
-    glEnableVertexAttribArray(posLoc);
-    glVertexAttribPointer(tex0Loc, 2, GL_FLOAT, 0, sizeof(PackedVertex), BUFFER_OFFSET(offsetof(PackedVertex, u1)));
-    glEnableVertexAttribArray(tex0Loc);
+void CGUITextureGL::DrawQuads(const BatchState& state, const std::vector<PackedVertex>& vertices)
+{
+  CRenderSystemGL* renderSystem = dynamic_cast<CRenderSystemGL*>(CServiceBroker::GetRenderSystem());
 
-    glGenBuffers(1, &IndexVBO);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, IndexVBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(ushort)*m_idx.size(), m_idx.data(), GL_STATIC_DRAW);
+  // Enabling the shader draws what is held back, set up the textures after it
+  renderSystem->EnableShader(static_cast<ESHADERMETHOD>(state.shader));
 
-    glDrawElements(GL_TRIANGLES, m_packedVertices.size()*6 / 4, GL_UNSIGNED_SHORT, 0);
+  glActiveTexture(GL_TEXTURE0);
+  glBindTexture(GL_TEXTURE_2D, state.texture);
+  if (state.diffuse)
+  {
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, state.diffuse);
+  }
 
-    if (m_diffuse.size())
-      glDisableVertexAttribArray(tex1Loc);
+  if (state.blend)
+  {
+    glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE_MINUS_DST_ALPHA, GL_ONE);
+    glEnable(GL_BLEND);
+  }
+  else
+  {
+    glDisable(GL_BLEND);
+  }
 
-    glDisableVertexAttribArray(posLoc);
-    glDisableVertexAttribArray(tex0Loc);
+  GLint posLoc  = renderSystem->ShaderGetPos();
+  GLint tex0Loc = renderSystem->ShaderGetCoord0();
+  GLint tex1Loc = renderSystem->ShaderGetCoord1();
+  GLint uniColLoc = renderSystem->ShaderGetUniCol();
 
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-    glDeleteBuffers(1, &VertexVBO);
-    glDeleteBuffers(1, &IndexVBO);
+  if (uniColLoc >= 0)
+  {
+    glUniform4f(uniColLoc, (state.col[0] / 255.0f), (state.col[1] / 255.0f), (state.col[2] / 255.0f), (state.col[3] / 255.0f));
   }
 
-  if (m_diffuse.size())
+  CQuadStreamGL& quadStream = renderSystem->GetQuadStream();
+  GLintptr offset = quadStream.Stream(vertices.data(), vertices.size() * sizeof(PackedVertex));
+  quadStream.BindElements();
+
+  glEnableVertexAttribArray(posLoc);
+  glEnableVertexAttribArray(tex0Loc);
+  if (state.diffuse)
+    glEnableVertexAttribArray(tex1Loc);
+
+  quadStream.Draw(offset, vertices.size() / 4, sizeof(PackedVertex), [&](GLintptr first)
+  {
+    glVertexAttribPointer(posLoc, 3, GL_FLOAT, 0, sizeof(PackedVertex), reinterpret_cast<const GLvoid*>(first + offsetof(PackedVertex, x)));
+    glVertexAttribPointer(tex0Loc, 2, GL_FLOAT, 0, sizeof(PackedVertex), reinterpret_cast<const GLvoid*>(first + offsetof(PackedVertex, u1)));
+    if (state.diffuse)
+      glVertexAttribPointer(tex1Loc, 2, GL_FLOAT, 0, sizeof(PackedVertex), reinterpret_cast<const GLvoid*>(first + offsetof(PackedVertex, u2)));
+  });
+
+  if (state.diffuse)
+    glDisableVertexAttribArray(tex1Loc);
+
+  glDisableVertexAttribArray(posLoc);
+  glDisableVertexAttribArray(tex0Loc);
+
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+  if (state.diffuse)
     glActiveTexture(GL_TEXTURE0);
   glEnable(GL_BLEND);
 
-  m_renderSystem->DisableShader();
+  renderSystem->DisableShader();
 }
 
 void CGUITextureGL::Draw(float *x, float *y, float *z, const CRect &texture, const CRect &diffuse, int orientation)
@@ -215,24 +248,21 @@ void CGUITextureGL::Draw(float *x, float *y, float *z, const CRect &texture, con
     vertices[i].x = x[i];
     vertices[i].y = y[i];
     vertices[i].z = z[i];
-    m_packedVertices.push_back(vertices[i]);
   }
 
-  if ((m_packedVertices.size() / 4) > (m_idx.size() / 6))
-  {
-    size_t i = m_packedVertices.size() - 4;
-    m_idx.push_back(i+0);
-    m_idx.push_back(i+1);
-    m_idx.push_back(i+2);
-    m_idx.push_back(i+2);
-    m_idx.push_back(i+3);
-    m_idx.push_back(i+0);
-  }
+  // The quad stream takes the bottom right corner before the bottom left one
+  m_packedVertices.push_back(vertices[0]);
+  m_packedVertices.push_back(vertices[1]);
+  m_packedVertices.push_back(vertices[3]);
+  m_packedVertices.push_back(vertices[2]);
 }
 
 void CGUITextureGL::DrawQuad(const CRect &rect, UTILS::Color color, CBaseTexture *texture, const CRect *texCoords)
 {
   CRenderSystemGL *renderSystem = dynamic_cast<CRenderSystemGL*>(CServiceBroker::GetRenderSystem());
+  // draw what is held back before setting up the texture and blending
+  renderSystem->FlushBatch();
+
   if (texture)
   {
     texture->LoadToGPU();
@@ -245,9 +275,6 @@ void CGUITextureGL::DrawQuad(const CRect &rect, UTILS::Color color, CBaseTexture
   VerifyGLState();
 
   GLubyte col[4];
-  GLubyte idx[4] = {0, 1, 3, 2};  //determines order of the vertices
-  GLuint vertexVBO;
-  GLuint indexVBO;
 
   struct PackedVertex
   {
@@ -282,53 +309,50 @@ void CGUITextureGL::DrawQuad(const CRect &rect, UTILS::Color color, CBaseTexture
   vertex[1].y = rect.y1;
   vertex[1].z = 0;
 
-  // top right
-  vertex[2].x = rect.x2;
+  // top left
+  vertex[2].x = rect.x1;
   vertex[2].y = rect.y2;
   vertex[2].z = 0;
 
-  // top left
-  vertex[3].x = rect.x1;
+  // top right
+  vertex[3].x = rect.x2;
   vertex[3].y = rect.y2;
   vertex[3].z = 0;
 
   if (texture)
   {
     CRect coords = texCoords ? *texCoords : CRect(0.0f, 0.0f, 1.0f, 1.0f);
-    vertex[0].u1 = vertex[3].u1 = coords.x1;
+    vertex[0].u1 = vertex[2].u1 = coords.x1;
     vertex[0].v1 = vertex[1].v1 = coords.y1;
-    vertex[1].u1 = vertex[2].u1 = coords.x2;
+    vertex[1].u1 = vertex[3].u1 = coords.x2;
     vertex[2].v1 = vertex[3].v1 = coords.y2;
   }
 
-  glGenBuffers(1, &vertexVBO);
-  glBindBuffer(GL_ARRAY_BUFFER, vertexVBO);
-  glBufferData(GL_ARRAY_BUFFER, sizeof(PackedVertex)*4, &vertex[0], GL_STATIC_DRAW);
+  CQuadStreamGL& quadStream = renderSystem->GetQuadStream();
+  GLintptr offset = quadStream.Stream(vertex, sizeof(vertex));
+  quadStream.BindElements();
 
-  glVertexAttribPointer(posLoc,  3, GL_FLOAT, 0, sizeof(PackedVertex), BUFFER_OFFSET(offsetof(PackedVertex, x)));
   glEnableVertexAttribArray(posLoc);
-
   if (texture)
-  {
-    glVertexAttribPointer(tex0Loc, 2, GL_FLOAT, 0, sizeof(PackedVertex), BUFFER_OFFSET(offsetof(PackedVertex, u1)));
     glEnableVertexAttribArray(tex0Loc);
-  }
-
-  glGenBuffers(1, &indexVBO);
-  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexVBO);
-  glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(GLubyte)*4, idx, GL_STATIC_DRAW);
 
-  glDrawElements(GL_TRIANGLE_STRIP, 4, GL_UNSIGNED_BYTE, 0);
+  quadStream.Draw(offset, 1, sizeof(PackedVertex), [&](GLintptr first)
+  {
+    glVertexAttribPointer(posLoc, 3, GL_FLOAT, 0, sizeof(PackedVertex), reinterpret_cast<const GLvoid*>(first + offsetof(PackedVertex, x)));
+    if (texture)
+      glVertexAttribPointer(tex0Loc, 2, GL_FLOAT, 0, sizeof(PackedVertex), reinterpret_cast<const GLvoid*>(first + offsetof(PackedVertex, u1)));
+  });
 
   glDisableVertexAttribArray(posLoc);
   if (texture)
     glDisableVertexAttribArray(tex0Loc);
 
   glBindBuffer(GL_ARRAY_BUFFER, 0);
-  glDeleteBuffers(1, &vertexVBO);
   glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-  glDeleteBuffers(1, &indexVBO);
 
   renderSystem->DisableShader();
 }
 
+
+CGUITextureGL::BatchState CGUITextureGL::m_batchState;
+std::vector<CGUITextureGL::PackedVertex> CGUITextureGL::m_batchVertices;
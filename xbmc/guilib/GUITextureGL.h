@@ -13,22 +13,31 @@
 #include "GUITexture.h"
 #include "utils/Color.h"
 
-class CRenderSystemGL;
-
 class CGUITextureGL : public CGUITextureBase
 {
 public:
   CGUITextureGL(float posX, float posY, float width, float height, const CTextureInfo& texture);
   static void DrawQuad(const CRect &coords, UTILS::Color color, CBaseTexture *texture = NULL, const CRect *texCoords = NULL);
 
+  /*!
+   * \brief Draw the quads held back to be drawn together with the next textures
+   *
+   * With texture batching enabled (gui/texturebatching in advancedsettings)
+   * the quads of consecutive textures with the same texture, diffuse texture,
+   * shader, blending and color are drawn with one call, also when they belong
+   * to different controls. CRenderSystemGL calls this before it changes any
+   * state they are drawn with, which includes anything else being drawn.
+   * Drawing them changes the bound textures, buffers and blending, so code
+   * setting up those for its own drawing has to flush before it does.
+   */
+  static void FlushBatch();
+
 protected:
   void Begin(UTILS::Color color) override;
   void Draw(float *x, float *y, float *z, const CRect &texture, const CRect &diffuse, int orientation) override;
   void End() override;
 
 private:
-  GLubyte m_col[4];
-
   struct PackedVertex
   {
     float x, y, z;
@@ -36,8 +45,24 @@ private:
     float u2, v2;
   };
 
+  struct BatchState
+  {
+    GLuint texture = 0;
+    GLuint diffuse = 0; //!< 0 without diffuse texture
+    int shader = 0; //!< ESHADERMETHOD
+    bool blend = false;
+    GLubyte col[4] = {};
+
+    bool operator==(const BatchState& right) const;
+  };
+
+  static void DrawBatch();
+  static void DrawQuads(const BatchState& state, const std::vector<PackedVertex>& vertices);
+
+  BatchState m_state;
   std::vector<PackedVertex> m_packedVertices;
-  std::vector<GLushort> m_idx;
-  CRenderSystemGL *m_renderSystem;
-};
+  bool m_batching;
 
+  static BatchState m_batchState;
+  static std::vector<PackedVertex> m_batchVertices;
+};
@@ -25,6 +25,7 @@ public:
   void DestroyTextureObject() override;
   void LoadToGPU() override;
   void BindToUnit(unsigned int unit) override;
+  GLuint GetTextureObject() const { return m_texture; }
 
 protected:
   GLuint m_texture = 0;
@@ -210,6 +210,7 @@ void CTextureMap::Add(CBaseTexture* texture, int delay)
 /*                                                                      */
 /************************************************************************/
 CGUITextureManager::CGUITextureManager(void)
+  : m_memoryBudget(0)
 {
   // we set the theme bundle to be the first bundle (thus prioritizing it)
   m_TexBundle[0].SetThemeBundle(true);
@@ -252,14 +253,10 @@ bool CGUITextureManager::HasTexture(const std::string &textureName, std::string
 
   // Check our loaded and bundled textures - we store in bundles using \\.
   std::string bundledName = CTextureBundle::Normalize(textureName);
-  for (int i = 0; i < (int)m_vecTextures.size(); ++i)
+  if (m_textures.find(textureName) != m_textures.end())
   {
-    CTextureMap *pMap = m_vecTextures[i];
-    if (pMap->GetName() == textureName)
-    {
-      if (size) *size = 1;
-      return true;
-    }
+    if (size) *size = 1;
+    return true;
   }
 
   for (int i = 0; i < 2; i++)
@@ -293,28 +290,27 @@ const CTextureArray& CGUITextureManager::Load(const std::string& strTextureName,
 
   if (size) // we found the texture
   {
-    for (int i = 0; i < (int)m_vecTextures.size(); ++i)
+    iTextures i = m_textures.find(strTextureName);
+    if (i != m_textures.end())
     {
-      CTextureMap *pMap = m_vecTextures[i];
-      if (pMap->GetName() == strTextureName)
-      {
-        //CLog::Log(LOGDEBUG, "Total memusage %u", GetMemoryUsage());
-        return pMap->GetTexture();
-      }
+      m_stats.hits++;
+      return i->second->GetTexture();
     }
     // Whoops, not there.
     return emptyTexture;
   }
 
-  for (ilistUnused i = m_unusedTextures.begin(); i != m_unusedTextures.end(); ++i)
+  // textures released without "immediately" are kept in the index until they are freed
+  auto unused = m_unusedIndex.find(strTextureName);
+  if (unused != m_unusedIndex.end())
   {
-    CTextureMap* pMap = i->first;
-    if (pMap->GetName() == strTextureName && i->second > 0)
-    {
-      m_vecTextures.push_back(pMap);
-      m_unusedTextures.erase(i);
-      return pMap->GetTexture();
-    }
+    CTextureMap* pMap = unused->second->first;
+    m_unusedTextures.erase(unused->second);
+    m_unusedIndex.erase(unused);
+    m_stats.bytesUnused -= pMap->GetMemoryUsage();
+    m_textures[strTextureName] = pMap;
+    m_stats.hits++;
+    return pMap->GetTexture();
   }
 
   if (checkBundleOnly && bundle == -1)
@@ -359,7 +355,7 @@ const CTextureArray& CGUITextureManager::Load(const std::string& strTextureName,
     delete[] pTextures;
     delete[] Delay;
 
-    m_vecTextures.push_back(pMap);
+    AddLoaded(pMap);
     return pMap->GetTexture();
   }
   else if (StringUtils::EndsWithNoCase(strPath, ".gif") ||
@@ -416,7 +412,7 @@ const CTextureArray& CGUITextureManager::Load(const std::string& strTextureName,
 
     file.Close();
 
-    m_vecTextures.push_back(pMap);
+    AddLoaded(pMap);
     return pMap->GetTexture();
   }
 
@@ -443,7 +439,7 @@ const CTextureArray& CGUITextureManager::Load(const std::string& strTextureName,
 
   CTextureMap* pMap = new CTextureMap(strTextureName, width, height, 0);
   pMap->Add(pTexture, 100);
-  m_vecTextures.push_back(pMap);
+  AddLoaded(pMap);
 
 #ifdef _DEBUG_TEXTURES
   int64_t end, freq;
@@ -458,27 +454,51 @@ const CTextureArray& CGUITextureManager::Load(const std::string& strTextureName,
 }
 
 
+void CGUITextureManager::AddLoaded(CTextureMap* pMap)
+{
+  m_textures[pMap->GetName()] = pMap;
+  m_stats.misses++;
+  m_stats.bytesResident += pMap->GetMemoryUsage();
+}
+
+void CGUITextureManager::AddUnused(CTextureMap* pMap, unsigned int releaseTime)
+{
+  UnusedList::iterator it = m_unusedTextures.insert(m_unusedTextures.end(), std::make_pair(pMap, releaseTime));
+  m_stats.bytesUnused += pMap->GetMemoryUsage();
+  if (releaseTime > 0)
+    m_unusedIndex[pMap->GetName()] = it;
+}
+
+CGUITextureManager::UnusedList::iterator CGUITextureManager::FreeUnused(UnusedList::iterator it)
+{
+  CTextureMap* pMap = it->first;
+  auto unused = m_unusedIndex.find(pMap->GetName());
+  if (unused != m_unusedIndex.end() && unused->second == it)
+    m_unusedIndex.erase(unused);
+
+  m_stats.bytesResident -= pMap->GetMemoryUsage();
+  m_stats.bytesUnused -= pMap->GetMemoryUsage();
+  m_stats.evictions++;
+  delete pMap;
+  return m_unusedTextures.erase(it);
+}
+
 void CGUITextureManager::ReleaseTexture(const std::string& strTextureName, bool immediately /*= false */)
 {
   CSingleLock lock(CServiceBroker::GetWinSystem()->GetGfxContext());
 
-  ivecTextures i;
-  i = m_vecTextures.begin();
-  while (i != m_vecTextures.end())
+  iTextures i = m_textures.find(strTextureName);
+  if (i != m_textures.end())
   {
-    CTextureMap* pMap = *i;
-    if (pMap->GetName() == strTextureName)
+    CTextureMap* pMap = i->second;
+    if (pMap->Release())
     {
-      if (pMap->Release())
-      {
-        //CLog::Log(LOGINFO, "  cleanup:%s", strTextureName.c_str());
-        // add to our textures to free
-        m_unusedTextures.push_back(std::make_pair(pMap, immediately ? 0 : XbmcThreads::SystemClockMillis()));
-        i = m_vecTextures.erase(i);
-      }
-      return;
+      //CLog::Log(LOGINFO, "  cleanup:%s", strTextureName.c_str());
+      // add to our textures to free
+      m_textures.erase(i);
+      AddUnused(pMap, immediately ? 0 : XbmcThreads::SystemClockMillis());
     }
-    ++i;
+    return;
   }
   CLog::Log(LOGWARNING, "%s: Unable to release texture %s", __FUNCTION__, strTextureName.c_str());
 }
@@ -487,17 +507,18 @@ void CGUITextureManager::FreeUnusedTextures(unsigned int timeDelay)
 {
   unsigned int currFrameTime = XbmcThreads::SystemClockMillis();
   CSingleLock lock(CServiceBroker::GetWinSystem()->GetGfxContext());
-  for (ilistUnused i = m_unusedTextures.begin(); i != m_unusedTextures.end();)
+  for (UnusedList::iterator i = m_unusedTextures.begin(); i != m_unusedTextures.end();)
   {
     if (currFrameTime - i->second >= timeDelay)
-    {
-      delete i->first;
-      i = m_unusedTextures.erase(i);
-    }
+      i = FreeUnused(i);
     else
       ++i;
   }
 
+  // over the budget the least recently released textures go before their time
+  while (m_memoryBudget > 0 && m_stats.bytesResident > m_memoryBudget && !m_unusedTextures.empty())
+    FreeUnused(m_unusedTextures.begin());
+
 #if defined(HAS_GL) || defined(HAS_GLES)
   for (unsigned int i = 0; i < m_unusedHwTextures.size(); ++i)
   {
@@ -514,6 +535,18 @@ void CGUITextureManager::FreeUnusedTextures(unsigned int timeDelay)
   m_unusedHwTextures.clear();
 }
 
+void CGUITextureManager::SetMemoryBudget(uint64_t bytes)
+{
+  CSingleLock lock(CServiceBroker::GetWinSystem()->GetGfxContext());
+  m_memoryBudget = bytes;
+}
+
+CGUITextureManager::Stats CGUITextureManager::GetStats() const
+{
+  CSingleLock lock(CServiceBroker::GetWinSystem()->GetGfxContext());
+  return m_stats;
+}
+
 void CGUITextureManager::ReleaseHwTexture(unsigned int texture)
 {
   CSingleLock lock(CServiceBroker::GetWinSystem()->GetGfxContext());
@@ -524,15 +557,14 @@ void CGUITextureManager::Cleanup()
 {
   CSingleLock lock(CServiceBroker::GetWinSystem()->GetGfxContext());
 
-  ivecTextures i;
-  i = m_vecTextures.begin();
-  while (i != m_vecTextures.end())
+  for (iTextures i = m_textures.begin(); i != m_textures.end(); ++i)
   {
-    CTextureMap* pMap = *i;
+    CTextureMap* pMap = i->second;
     CLog::Log(LOGWARNING, "%s: Having to cleanup texture %s", __FUNCTION__, pMap->GetName().c_str());
+    m_stats.bytesResident -= pMap->GetMemoryUsage();
     delete pMap;
-    i = m_vecTextures.erase(i);
   }
+  m_textures.clear();
   m_TexBundle[0].Close();
   m_TexBundle[1].Close();
   m_TexBundle[0] = CTextureBundle(true);
@@ -542,11 +574,13 @@ void CGUITextureManager::Cleanup()
 
 void CGUITextureManager::Dump() const
 {
-  CLog::Log(LOGDEBUG, "{0}: total texturemaps size: {1}", __FUNCTION__, m_vecTextures.size());
+  CLog::Log(LOGDEBUG, "{0}: total texturemaps size: {1}", __FUNCTION__, m_textures.size());
+  CLog::Log(LOGDEBUG, "{0}: {1} hits, {2} misses, {3} evictions, {4} bytes resident, {5} of them unused", __FUNCTION__,
+    m_stats.hits, m_stats.misses, m_stats.evictions, m_stats.bytesResident, m_stats.bytesUnused);
 
-  for (int i = 0; i < (int)m_vecTextures.size(); ++i)
+  for (const auto& texture : m_textures)
   {
-    const CTextureMap* pMap = m_vecTextures[i];
+    const CTextureMap* pMap = texture.second;
     if (!pMap->IsEmpty())
       pMap->Dump();
   }
@@ -556,16 +590,17 @@ void CGUITextureManager::Flush()
 {
   CSingleLock lock(CServiceBroker::GetWinSystem()->GetGfxContext());
 
-  ivecTextures i;
-  i = m_vecTextures.begin();
-  while (i != m_vecTextures.end())
+  iTextures i;
+  i = m_textures.begin();
+  while (i != m_textures.end())
   {
-    CTextureMap* pMap = *i;
+    CTextureMap* pMap = i->second;
     pMap->Flush();
     if (pMap->IsEmpty() )
     {
+      m_stats.bytesResident -= pMap->GetMemoryUsage();
       delete pMap;
-      i = m_vecTextures.erase(i);
+      i = m_textures.erase(i);
     }
     else
     {
@@ -576,12 +611,7 @@ void CGUITextureManager::Flush()
 
 unsigned int CGUITextureManager::GetMemoryUsage() const
 {
-  unsigned int memUsage = 0;
-  for (int i = 0; i < (int)m_vecTextures.size(); ++i)
-  {
-    memUsage += m_vecTextures[i]->GetMemoryUsage();
-  }
-  return memUsage;
+  return static_cast<unsigned int>(m_stats.bytesResident - m_stats.bytesUnused);
 }
 
 void CGUITextureManager::SetTexturePath(const std::string &texturePath)
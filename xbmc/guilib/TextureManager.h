@@ -9,6 +9,8 @@
 #pragma once
 
 #include <list>
+#include <string>
+#include <unordered_map>
 #include <vector>
 #include <utility>
 
@@ -90,6 +92,15 @@ protected:
 class CGUITextureManager
 {
 public:
+  struct Stats
+  {
+    uint64_t hits = 0; //!< loads served by a texture in use or not yet freed
+    uint64_t misses = 0; //!< loads that read the texture from a bundle or file
+    uint64_t evictions = 0; //!< unused textures freed
+    uint64_t bytesResident = 0; //!< memory of all textures in use or not yet freed
+    uint64_t bytesUnused = 0; //!< part of bytesResident that may be freed
+  };
+
   CGUITextureManager(void);
   virtual ~CGUITextureManager(void);
 
@@ -110,16 +121,32 @@ public:
 
   void FreeUnusedTextures(unsigned int timeDelay = 0); ///< Free textures (called from app thread only)
   void ReleaseHwTexture(unsigned int texture);
+
+  /*!
+   \brief Set the memory textures may use before unused ones are freed early
+   \param bytes the budget, 0 to free unused textures by their age only
+   \sa FreeUnusedTextures
+   */
+  void SetMemoryBudget(uint64_t bytes);
+  Stats GetStats() const;
 protected:
-  std::vector<CTextureMap*> m_vecTextures;
-  std::list<std::pair<CTextureMap*, unsigned int> > m_unusedTextures;
+  typedef std::list<std::pair<CTextureMap*, unsigned int> > UnusedList;
+
+  void AddLoaded(CTextureMap* pMap);
+  void AddUnused(CTextureMap* pMap, unsigned int releaseTime);
+  UnusedList::iterator FreeUnused(UnusedList::iterator it);
+
+  std::unordered_map<std::string, CTextureMap*> m_textures; ///< textures in use by name
+  UnusedList m_unusedTextures; ///< released textures with their release time, least recently used first
+  std::unordered_map<std::string, UnusedList::iterator> m_unusedIndex; ///< unused textures that may be used again
   std::vector<unsigned int> m_unusedHwTextures;
-  typedef std::vector<CTextureMap*>::iterator ivecTextures;
-  typedef std::list<std::pair<CTextureMap*, unsigned int> >::iterator ilistUnused;
+  typedef std::unordered_map<std::string, CTextureMap*>::iterator iTextures;
   // we have 2 texture bundles (one for the base textures, one for the theme)
   CTextureBundle m_TexBundle[2];
 
   std::vector<std::string> m_texturePaths;
   CCriticalSection m_section;
-};
 
+  uint64_t m_memoryBudget;
+  Stats m_stats;
+};
@@ -0,0 +1,318 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "ServiceBroker.h"
+#include "guilib/GUIComponent.h"
+#include "guilib/GUIControlGroup.h"
+#include "guilib/GUIControlProfiler.h"
+#include "guilib/GUIFont.h"
+#include "guilib/GUIFontTTFGL.h"
+#include "guilib/GUIImage.h"
+#include "guilib/GUILabelControl.h"
+#include "rendering/gl/RenderSystemGL.h"
+#include "settings/AdvancedSettings.h"
+#include "settings/SettingsComponent.h"
+#include "test/TestUtils.h"
+#include "utils/StringUtils.h"
+#include "windowing/GraphicContext.h"
+#include "windowing/WinSystem.h"
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+
+#include <EGL/egl.h>
+#include <gtest/gtest.h>
+
+namespace
+{
+// the size the graphics context starts with
+const int WIDTH = 720;
+const int HEIGHT = 576;
+
+const unsigned int FRAMES = 500;
+
+/*!
+ * \brief Window system rendering with GL into a pbuffer of the default EGL display
+ */
+class CTestWinSystemGL : public CWinSystemBase, public CRenderSystemGL
+{
+public:
+  bool Create()
+  {
+    m_display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    if (m_display == EGL_NO_DISPLAY || !eglInitialize(m_display, nullptr, nullptr))
+      return false;
+
+    const EGLint configAttribs[] = { EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+                                     EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+                                     EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8, EGL_ALPHA_SIZE, 8,
+                                     EGL_NONE };
+    EGLConfig config;
+    EGLint configs = 0;
+    if (!eglChooseConfig(m_display, configAttribs, &config, 1, &configs) || configs < 1 ||
+        !eglBindAPI(EGL_OPENGL_API))
+      return false;
+
+    const EGLint surfaceAttribs[] = { EGL_WIDTH, WIDTH, EGL_HEIGHT, HEIGHT, EGL_NONE };
+    m_surface = eglCreatePbufferSurface(m_display, config, surfaceAttribs);
+    m_context = eglCreateContext(m_display, config, EGL_NO_CONTEXT, nullptr);
+    if (m_surface == EGL_NO_SURFACE || m_context == EGL_NO_CONTEXT ||
+        !eglMakeCurrent(m_display, m_surface, m_surface, m_context))
+      return false;
+
+    if (!InitRenderSystem() || !ResetRenderSystem(WIDTH, HEIGHT))
+      return false;
+
+    m_gfxContext->SetRenderingResolution(RESOLUTION_INFO(WIDTH, HEIGHT), false);
+    return true;
+  }
+
+  void Destroy()
+  {
+    if (m_display == EGL_NO_DISPLAY)
+      return;
+
+    if (m_bRenderCreated)
+      DestroyRenderSystem();
+    eglMakeCurrent(m_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    if (m_context != EGL_NO_CONTEXT)
+      eglDestroyContext(m_display, m_context);
+    if (m_surface != EGL_NO_SURFACE)
+      eglDestroySurface(m_display, m_surface);
+    eglTerminate(m_display);
+    m_display = EGL_NO_DISPLAY;
+  }
+
+  bool CreateNewWindow(const std::string& name, bool fullScreen, RESOLUTION_INFO& res) override { return false; }
+  bool ResizeWindow(int newWidth, int newHeight, int newLeft, int newTop) override { return false; }
+  bool SetFullScreen(bool fullScreen, RESOLUTION_INFO& res, bool blankOtherDisplays) override { return false; }
+  void Register(IDispResource *resource) override {}
+  void Unregister(IDispResource *resource) override {}
+  CRenderSystemBase *GetRenderSystem() override { return this; }
+
+protected:
+  void SetVSyncImpl(bool enable) override {}
+  void PresentRenderImpl(bool rendered) override {}
+
+private:
+  EGLDisplay m_display = EGL_NO_DISPLAY;
+  EGLSurface m_surface = EGL_NO_SURFACE;
+  EGLContext m_context = EGL_NO_CONTEXT;
+};
+
+/*!
+ * \brief Font of the skin, loaded without the font manager so it goes away with the test
+ */
+class CTestFont
+{
+public:
+  CTestFont(const std::string& file, float size)
+    : m_ttf(new CGUIFontTTFGL(file))
+  {
+    m_ttf->Load(XBMC_REF_FILE_PATH("addons/skin.estuary/fonts/" + file), size);
+    m_font.reset(new CGUIFont(file, FONT_STYLE_NORMAL, 0xFFFFFFFF, 0, 1.0f, size, m_ttf.get()));
+  }
+
+  CGUIFont* Get() { return m_font.get(); }
+
+private:
+  // the font drops its reference to the file when it goes, the file must outlive it
+  std::unique_ptr<CGUIFontTTFGL> m_ttf;
+  std::unique_ptr<CGUIFont> m_font;
+};
+
+std::string Media(const std::string& name)
+{
+  return XBMC_REF_FILE_PATH("addons/skin.estuary/media/" + name);
+}
+
+CGUILabelControl* CreateLabel(float posX, float posY, float width, float height,
+                              CGUIFont* font, uint32_t align, const std::string& text)
+{
+  CLabelInfo info;
+  info.font = font;
+  info.align = align | XBFONT_CENTER_Y;
+  info.textColor = KODI::GUILIB::GUIINFO::CGUIInfoColor(0xFFFFFFFF);
+  CGUILabelControl* label = new CGUILabelControl(0, 0, posX, posY, width, height, info, false, false);
+  label->SetLabel(text);
+  return label;
+}
+
+/*!
+ \brief Window like a list view of the skin, a row has an icon, two labels and a separator
+ */
+CGUIControlGroup* CreateListWindow(CGUIFont* font, CGUIFont* smallFont)
+{
+  const unsigned int rows = 12;
+  CGUIControlGroup* window = new CGUIControlGroup(0, 0, 0, 0, WIDTH, HEIGHT);
+  window->AddControl(new CGUIImage(0, 0, 0, 0, WIDTH, HEIGHT, CTextureInfo(Media("colors/black.png"))));
+  window->AddControl(new CGUIImage(0, 0, 20, 20, WIDTH - 40, HEIGHT - 40, CTextureInfo(Media("lists/panel.png"))));
+
+  const float rowHeight = (HEIGHT - 60.0f) / rows;
+  for (unsigned int row = 0; row < rows; row++)
+  {
+    const float posY = 30 + row * rowHeight;
+    window->AddControl(new CGUIImage(0, 0, 30, posY, rowHeight, rowHeight, CTextureInfo(Media("DefaultAddon.png"))));
+    window->AddControl(CreateLabel(40 + rowHeight, posY, 400, rowHeight, font, XBFONT_LEFT,
+                                   StringUtils::Format("List item %u", row + 1)));
+    window->AddControl(CreateLabel(WIDTH - 230, posY, 200, rowHeight, smallFont, XBFONT_RIGHT,
+                                   StringUtils::Format("%u:%02u", row + 1, (row * 7) % 60)));
+    window->AddControl(new CGUIImage(0, 0, 30, posY + rowHeight - 1, WIDTH - 60, 1, CTextureInfo(Media("colors/grey.png"))));
+  }
+  return window;
+}
+
+/*!
+ \brief Window with little else than text, a heading and a table in another font
+ */
+CGUIControlGroup* CreateTextWindow(CGUIFont* font, CGUIFont* smallFont)
+{
+  const unsigned int rows = 16;
+  CGUIControlGroup* window = new CGUIControlGroup(0, 0, 0, 0, WIDTH, HEIGHT);
+  window->AddControl(new CGUIImage(0, 0, 0, 0, WIDTH, HEIGHT, CTextureInfo(Media("colors/black.png"))));
+  window->AddControl(CreateLabel(30, 20, WIDTH - 60, 40, font, XBFONT_LEFT, "Media information"));
+
+  const float rowHeight = (HEIGHT - 80.0f) / rows;
+  const char* columns[] = { "Title", "Year", "Genre", "Duration" };
+  for (unsigned int row = 0; row < rows; row++)
+  {
+    const float posY = 70 + row * rowHeight;
+    for (unsigned int column = 0; column < 4; column++)
+      window->AddControl(CreateLabel(30 + column * 165, posY, 160, rowHeight, smallFont, XBFONT_LEFT,
+                                     StringUtils::Format("%s %u", columns[column], row + 1)));
+  }
+  return window;
+}
+
+typedef CGUIControlGroup* (*WindowCreator)(CGUIFont* font, CGUIFont* smallFont);
+
+struct FrameStats
+{
+  double msPerFrame;
+  double drawCallsPerFrame;
+};
+}
+
+/*
+ * Renders GUI controls like the window manager does, into a pbuffer. They
+ * need an EGL display that works without a window, e.g. llvmpipe with
+ * EGL_PLATFORM=surfaceless LIBGL_ALWAYS_SOFTWARE=1. Run with
+ * --gtest_also_run_disabled_tests.
+ */
+class TestGUIRenderingGL : public testing::Test
+{
+protected:
+  TestGUIRenderingGL()
+  {
+    m_batching = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_guiTextureBatching;
+    CServiceBroker::RegisterWinSystem(&m_winSystem);
+    m_created = m_winSystem.Create();
+    if (m_created)
+    {
+      m_gui.reset(new CGUIComponent());
+      CServiceBroker::RegisterGUI(m_gui.get());
+    }
+  }
+
+  ~TestGUIRenderingGL() override
+  {
+    // the textures left in the texture manager are deleted with the context current
+    m_gui.reset();
+    m_winSystem.Destroy();
+    CServiceBroker::UnregisterWinSystem();
+    CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_guiTextureBatching = m_batching;
+  }
+
+  /*!
+   \brief Render a window built with gui/texturebatching set as given
+   */
+  FrameStats Render(WindowCreator createWindow, bool batching)
+  {
+    // textures and fonts read the setting when they are created
+    CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_guiTextureBatching = batching;
+    CTestFont font("NotoSans-Bold.ttf", 30);
+    CTestFont smallFont("NotoSans-Regular.ttf", 20);
+    std::unique_ptr<CGUIControlGroup> window(createWindow(font.Get(), smallFont.Get()));
+    window->AllocResources();
+
+    // the first frame uploads the textures and caches the glyphs
+    unsigned int time = 0;
+    RenderFrame(*window, time);
+
+    CGUIControlProfiler& profiler = CGUIControlProfiler::Instance();
+    profiler.SetMaxFrameCount(FRAMES);
+    profiler.Start();
+    const auto start = std::chrono::steady_clock::now();
+    for (unsigned int frame = 0; frame < FRAMES; frame++)
+    {
+      time += 16;
+      RenderFrame(*window, time);
+      profiler.EndFrame();
+    }
+    const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+    window->FreeResources(true);
+
+    FrameStats stats;
+    stats.msPerFrame = elapsed.count() / FRAMES;
+    stats.drawCallsPerFrame = static_cast<double>(profiler.GetDrawCalls()) / FRAMES;
+    return stats;
+  }
+
+  void RenderFrame(CGUIControlGroup& window, unsigned int time)
+  {
+    CDirtyRegionList dirtyRegions;
+    window.DoProcess(time, dirtyRegions);
+    m_winSystem.BeginRender();
+    m_winSystem.ClearBuffers(0);
+    window.DoRender();
+    m_winSystem.EndRender();
+    // wait for the frame like a swap with vsync off would
+    glFinish();
+  }
+
+  CTestWinSystemGL m_winSystem;
+  std::unique_ptr<CGUIComponent> m_gui;
+  bool m_created;
+  bool m_batching;
+};
+
+TEST_F(TestGUIRenderingGL, DISABLED_TextFrameTime)
+{
+  if (!m_created)
+  {
+    printf("[ BENCHMARK] no EGL display with desktop GL\n");
+    return;
+  }
+
+  for (bool batching : { false, true })
+  {
+    FrameStats stats = Render(CreateTextWindow, batching);
+    printf("[ BENCHMARK] text window (texturebatching %s): %.3f ms per frame, %.1f draw calls per frame\n",
+           batching ? "on" : "off", stats.msPerFrame, stats.drawCallsPerFrame);
+    EXPECT_GT(stats.drawCallsPerFrame, 0.0);
+  }
+}
+
+TEST_F(TestGUIRenderingGL, DISABLED_DrawCallsPerFrame)
+{
+  if (!m_created)
+  {
+    printf("[ BENCHMARK] no EGL display with desktop GL\n");
+    return;
+  }
+
+  FrameStats off = Render(CreateListWindow, false);
+  FrameStats on = Render(CreateListWindow, true);
+  printf("[ BENCHMARK] list window: drawcallsperframe %.1f with texturebatching off, %.1f with it on\n",
+         off.drawCallsPerFrame, on.drawCallsPerFrame);
+  printf("[ BENCHMARK] list window: %.3f ms per frame with texturebatching off, %.3f ms with it on\n",
+         off.msPerFrame, on.msPerFrame);
+  EXPECT_LT(on.drawCallsPerFrame, off.drawCallsPerFrame);
+}
@@ -0,0 +1,190 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "ServiceBroker.h"
+#include "filesystem/SpecialProtocol.h"
+#include "guilib/Texture.h"
+#include "guilib/TextureManager.h"
+#include "windowing/WinSystem.h"
+
+#include <memory>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+/*!
+ * \brief Window system without a window, the texture manager only needs its graphics context lock
+ */
+class CTestWinSystem : public CWinSystemBase
+{
+public:
+  bool CreateNewWindow(const std::string& name, bool fullScreen, RESOLUTION_INFO& res) override { return false; }
+  bool ResizeWindow(int newWidth, int newHeight, int newLeft, int newTop) override { return false; }
+  bool SetFullScreen(bool fullScreen, RESOLUTION_INFO& res, bool blankOtherDisplays) override { return false; }
+  void Register(IDispResource *resource) override {}
+  void Unregister(IDispResource *resource) override {}
+};
+
+/*!
+ * \brief Texture manager taking textures from memory instead of files
+ */
+class CTestTextureManager : public CGUITextureManager
+{
+public:
+  /*!
+   \brief Add a texture in use like Load() does after reading it, the texture isn't uploaded
+   */
+  void AddTexture(const std::string& name, unsigned int width, unsigned int height)
+  {
+    CTextureMap* map = new CTextureMap(name, width, height, 0);
+    map->Add(new CTexture(width, height, XB_FMT_A8R8G8B8), 100);
+    AddLoaded(map);
+    map->GetTexture();
+  }
+
+  bool IsInUse(const std::string& name) const { return m_textures.find(name) != m_textures.end(); }
+  bool IsUnused(const std::string& name) const { return m_unusedIndex.find(name) != m_unusedIndex.end(); }
+};
+
+/*!
+ \brief Full path of a texture, Load() only takes back a released one if it can find its file
+ */
+std::string Texture(const std::string& name)
+{
+  return CSpecialProtocol::TranslatePath("special://temp/" + name);
+}
+
+// longer than any test runs, textures are only freed by the budget
+const unsigned int KEEP = 60 * 60 * 1000;
+}
+
+class TestTextureManager : public testing::Test
+{
+protected:
+  TestTextureManager()
+  {
+    CServiceBroker::RegisterWinSystem(&m_winSystem);
+    m_manager.reset(new CTestTextureManager());
+  }
+
+  ~TestTextureManager() override
+  {
+    m_manager.reset();
+    CServiceBroker::UnregisterWinSystem();
+  }
+
+  CTestWinSystem m_winSystem;
+  std::unique_ptr<CTestTextureManager> m_manager;
+};
+
+TEST_F(TestTextureManager, Stats)
+{
+  m_manager->AddTexture(Texture("a.png"), 64, 64);
+  const uint64_t size = m_manager->GetStats().bytesResident;
+  EXPECT_GE(size, 64u * 64 * 4);
+
+  m_manager->AddTexture(Texture("b.png"), 64, 64);
+  CGUITextureManager::Stats stats = m_manager->GetStats();
+  EXPECT_EQ(2u, stats.misses);
+  EXPECT_EQ(0u, stats.hits);
+  EXPECT_EQ(2 * size, stats.bytesResident);
+  EXPECT_EQ(0u, stats.bytesUnused);
+
+  // a second user of a texture in use
+  EXPECT_EQ(1u, m_manager->Load(Texture("a.png")).size());
+  EXPECT_EQ(1u, m_manager->GetStats().hits);
+
+  // released by both users, kept until it is freed
+  m_manager->ReleaseTexture(Texture("a.png"));
+  EXPECT_TRUE(m_manager->IsInUse(Texture("a.png")));
+  m_manager->ReleaseTexture(Texture("a.png"));
+  EXPECT_TRUE(m_manager->IsUnused(Texture("a.png")));
+  stats = m_manager->GetStats();
+  EXPECT_EQ(2 * size, stats.bytesResident);
+  EXPECT_EQ(size, stats.bytesUnused);
+  EXPECT_EQ(size, m_manager->GetMemoryUsage());
+
+  // loaded again before it was freed
+  EXPECT_EQ(1u, m_manager->Load(Texture("a.png")).size());
+  stats = m_manager->GetStats();
+  EXPECT_EQ(2u, stats.hits);
+  EXPECT_EQ(2u, stats.misses);
+  EXPECT_EQ(0u, stats.bytesUnused);
+  EXPECT_TRUE(m_manager->IsInUse(Texture("a.png")));
+
+  // freed after its delay
+  m_manager->ReleaseTexture(Texture("b.png"));
+  m_manager->FreeUnusedTextures(0);
+  stats = m_manager->GetStats();
+  EXPECT_EQ(1u, stats.evictions);
+  EXPECT_EQ(size, stats.bytesResident);
+  EXPECT_EQ(0u, stats.bytesUnused);
+  EXPECT_FALSE(m_manager->IsUnused(Texture("b.png")));
+
+  m_manager->ReleaseTexture(Texture("a.png"));
+}
+
+TEST_F(TestTextureManager, BudgetFreesLeastRecentlyReleased)
+{
+  m_manager->AddTexture(Texture("a.png"), 64, 64);
+  const uint64_t size = m_manager->GetStats().bytesResident;
+  m_manager->AddTexture(Texture("b.png"), 64, 64);
+  m_manager->AddTexture(Texture("c.png"), 64, 64);
+  m_manager->AddTexture(Texture("d.png"), 64, 64);
+
+  // without a budget only the age counts
+  m_manager->ReleaseTexture(Texture("c.png"));
+  m_manager->ReleaseTexture(Texture("a.png"));
+  m_manager->ReleaseTexture(Texture("b.png"));
+  m_manager->FreeUnusedTextures(KEEP);
+  EXPECT_EQ(0u, m_manager->GetStats().evictions);
+
+  // room for two and a half textures, the ones released first go
+  m_manager->SetMemoryBudget(2 * size + size / 2);
+  m_manager->FreeUnusedTextures(KEEP);
+  CGUITextureManager::Stats stats = m_manager->GetStats();
+  EXPECT_EQ(2u, stats.evictions);
+  EXPECT_EQ(2 * size, stats.bytesResident);
+  EXPECT_EQ(size, stats.bytesUnused);
+  EXPECT_FALSE(m_manager->IsUnused(Texture("c.png")));
+  EXPECT_FALSE(m_manager->IsUnused(Texture("a.png")));
+  EXPECT_TRUE(m_manager->IsUnused(Texture("b.png")));
+  EXPECT_TRUE(m_manager->IsInUse(Texture("d.png")));
+
+  m_manager->ReleaseTexture(Texture("d.png"));
+}
+
+TEST_F(TestTextureManager, BudgetKeepsTexturesInUse)
+{
+  m_manager->AddTexture(Texture("a.png"), 64, 64);
+  const uint64_t size = m_manager->GetStats().bytesResident;
+  m_manager->AddTexture(Texture("b.png"), 64, 64);
+  m_manager->AddTexture(Texture("c.png"), 64, 64);
+
+  // far over the budget, but nothing may be freed
+  m_manager->SetMemoryBudget(size);
+  m_manager->FreeUnusedTextures(KEEP);
+  CGUITextureManager::Stats stats = m_manager->GetStats();
+  EXPECT_EQ(0u, stats.evictions);
+  EXPECT_EQ(3 * size, stats.bytesResident);
+
+  // only the released texture goes, the budget stays exceeded
+  m_manager->ReleaseTexture(Texture("b.png"));
+  m_manager->FreeUnusedTextures(KEEP);
+  stats = m_manager->GetStats();
+  EXPECT_EQ(1u, stats.evictions);
+  EXPECT_EQ(2 * size, stats.bytesResident);
+  EXPECT_TRUE(m_manager->IsInUse(Texture("a.png")));
+  EXPECT_TRUE(m_manager->IsInUse(Texture("c.png")));
+  EXPECT_EQ(1u, m_manager->Load(Texture("c.png")).size());
+
+  m_manager->ReleaseTexture(Texture("a.png"));
+  m_manager->ReleaseTexture(Texture("c.png"));
+  m_manager->ReleaseTexture(Texture("c.png"));
+}
@@ -18,6 +18,7 @@
 #include "PartyModeManager.h"
 #include "PlayListPlayer.h"
 #include "SeekHandler.h"
+#include "cores/DataCacheCore.h"
 #include "settings/MediaSettings.h"
 #include "settings/Settings.h"
 #include "settings/SettingsComponent.h"
@@ -231,6 +232,10 @@ static int PlayerControl(const std::vector<std::string>& params)
     if( g_application.GetAppPlayer().IsPlaying() )
       g_application.GetAppPlayer().OnAction(CAction(ACTION_SHOW_VIDEOMENU));
   }
+  else if (paramlow == "dumptrace")
+  {
+    CServiceBroker::GetDataCacheCore().GetPlaybackTrace().Dump("special://temp/playbacktrace.json");
+  }
   else if (StringUtils::StartsWithNoCase(params[0], "partymode"))
   {
     std::string strXspPath;
@@ -552,6 +557,7 @@ static int Seek(const std::vector<std::string>& params)
 ///     | Partymode(path to .xsp) | Partymode for *.xsp-file               | Partymode for *.xsp-file    |             |
 ///     | ShowVideoMenu           | Shows the DVD/BR menu if available     | none                        |             |
 ///     | FrameAdvance(n) ***     | Advance video by _n_ frames            | none                        | Kodi v18    |
+///     | DumpTrace               | Writes the frame timing of the last playback to special://temp/playbacktrace.json | none | Kodi v19 |
 ///     <br>
 ///     '*' = For these controls\, the PlayerControl built-in function can make use of the 'notify'-parameter. For example: PlayerControl(random\, notify)
 ///     <br>
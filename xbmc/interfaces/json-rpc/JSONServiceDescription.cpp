@@ -60,6 +60,7 @@ JsonRpcMethodMap CJSONServiceDescription::m_methodMaps[] = {
   { "Player.Zoom",                                  CPlayerOperations::Zoom },
   { "Player.SetViewMode",                           CPlayerOperations::SetViewMode },
   { "Player.GetViewMode",                           CPlayerOperations::GetViewMode },
+  { "Player.GetPlaybackTrace",                      CPlayerOperations::GetPlaybackTrace },
   { "Player.Rotate",                                CPlayerOperations::Rotate },
 
   { "Player.Open",                                  CPlayerOperations::Open },
@@ -59,6 +59,7 @@
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
 #include "utils/XMLUtils.h"
+#include <cmath>
 #include <inttypes.h>
 
 using namespace XFILE;
@@ -67,6 +68,7 @@ using namespace KODI::MESSAGING;
 using namespace MUSIC_INFO;
 
 using ADDON::AddonPtr;
+using dbiplus::field_value;
 using KODI::MESSAGING::HELPERS::DialogResponse;
 
 #define RECENTLY_PLAYED_LIMIT 25
@@ -575,55 +577,52 @@ int CMusicDatabase::AddSong(const int idAlbum,
     SplitPath(strPathAndFileName, strPath, strFileName);
     int idPath = AddPath(strPath);
 
+    // The scanner adds every song this way, so use prepared statements
+    bool found;
     if (!strMusicBrainzTrackID.empty())
-      strSQL = PrepareSQL("SELECT idSong FROM song WHERE idAlbum = %i AND iTrack=%i AND strMusicBrainzTrackID = '%s'",
-                          idAlbum,
-                          iTrack,
-                          strMusicBrainzTrackID.c_str());
+    {
+      strSQL = "SELECT idSong FROM song WHERE idAlbum = ? AND iTrack = ? AND strMusicBrainzTrackID = ?";
+      found = ResultPreparedQuery(strSQL, { field_value(idAlbum), field_value(iTrack), field_value(strMusicBrainzTrackID) });
+    }
     else
-      strSQL = PrepareSQL("SELECT idSong FROM song WHERE idAlbum=%i AND strFileName='%s' AND strTitle='%s' AND iTrack=%i AND strMusicBrainzTrackID IS NULL",
-                          idAlbum,
-                          strFileName.c_str(),
-                          strTitle.c_str(),
-                          iTrack);
-
-    if (!m_pDS->query(strSQL))
+    {
+      strSQL = "SELECT idSong FROM song WHERE idAlbum = ? AND strFileName = ? AND strTitle = ? AND iTrack = ? AND strMusicBrainzTrackID IS NULL";
+      found = ResultPreparedQuery(strSQL, { field_value(idAlbum), field_value(strFileName), field_value(strTitle), field_value(iTrack) });
+    }
+    if (!found)
       return -1;
 
     if (m_pDS->num_rows() == 0)
     {
       m_pDS->close();
-      strSQL=PrepareSQL("INSERT INTO song ("
-                                          "idSong,idAlbum,idPath,strArtistDisp,"
-                                          "strTitle,iTrack,iDuration,iYear,strFileName,"
-                                          "strMusicBrainzTrackID, strArtistSort, "
-                                          "iTimesPlayed,iStartOffset, "
-                                          "iEndOffset,lastplayed,rating,userrating,votes,comment,mood,strReplayGain"
-                        ") values (NULL, %i, %i, '%s', '%s', %i, %i, %i, '%s'",
-                    idAlbum,
-                    idPath,
-                    artistDisp.c_str(),
-                    strTitle.c_str(),
-                    iTrack, iDuration, iYear,
-                    strFileName.c_str());
-
-      if (strMusicBrainzTrackID.empty())
-        strSQL += PrepareSQL(",NULL");
-      else
-        strSQL += PrepareSQL(",'%s'", strMusicBrainzTrackID.c_str());
-      if (artistSort.empty())
-        strSQL += PrepareSQL(",NULL");
-      else
-        strSQL += PrepareSQL(",'%s'", artistSort.c_str());
 
-      if (dtLastPlayed.IsValid())
-        strSQL += PrepareSQL(",%i,%i,%i,'%s', %.1f, %i, %i, '%s','%s', '%s')",
-                      iTimesPlayed, iStartOffset, iEndOffset, dtLastPlayed.GetAsDBDateTime().c_str(), rating, userrating, votes,
-                      strComment.c_str(), strMood.c_str(), replayGain.Get().c_str());
-      else
-        strSQL += PrepareSQL(",%i,%i,%i,NULL, %.1f, %i, %i,'%s', '%s', '%s')",
-                      iTimesPlayed, iStartOffset, iEndOffset, rating, userrating, votes, strComment.c_str(), strMood.c_str(), replayGain.Get().c_str());
-      m_pDS->exec(strSQL);
+      field_value nullValue;
+      nullValue.set_isNull();
+
+      strSQL = "INSERT INTO song ("
+                 "idSong,idAlbum,idPath,strArtistDisp,"
+                 "strTitle,iTrack,iDuration,iYear,strFileName,"
+                 "strMusicBrainzTrackID, strArtistSort, "
+                 "iTimesPlayed,iStartOffset, "
+                 "iEndOffset,lastplayed,rating,userrating,votes,comment,mood,strReplayGain"
+               ") values (NULL, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)";
+      const std::vector<field_value> params = {
+        field_value(idAlbum),
+        field_value(idPath),
+        field_value(artistDisp),
+        field_value(strTitle),
+        field_value(iTrack), field_value(iDuration), field_value(iYear),
+        field_value(strFileName),
+        strMusicBrainzTrackID.empty() ? nullValue : field_value(strMusicBrainzTrackID),
+        artistSort.empty() ? nullValue : field_value(artistSort),
+        field_value(iTimesPlayed), field_value(iStartOffset), field_value(iEndOffset),
+        dtLastPlayed.IsValid() ? field_value(dtLastPlayed.GetAsDBDateTime()) : nullValue,
+        field_value(std::round(rating * 10.0) / 10.0), // was stored with one decimal
+        field_value(userrating), field_value(votes),
+        field_value(strComment), field_value(strMood), field_value(replayGain.Get())
+      };
+      if (!ExecutePreparedQuery(strSQL, params))
+        return -1;
       idSong = (int)m_pDS->lastinsertid();
     }
     else
@@ -1598,10 +1597,8 @@ bool CMusicDatabase::AddSongArtist(int idArtist, int idSong, const std::string&
 
 bool CMusicDatabase::AddSongArtist(int idArtist, int idSong, int idRole, const std::string& strArtist, int iOrder)
 {
-  std::string strSQL;
-  strSQL = PrepareSQL("replace into song_artist (idArtist, idSong, idRole, strArtist, iOrder) values(%i,%i,%i,'%s',%i)",
-    idArtist, idSong, idRole, strArtist.c_str(), iOrder);
-  return ExecuteQuery(strSQL);
+  return ExecutePreparedQuery("replace into song_artist (idArtist, idSong, idRole, strArtist, iOrder) values(?,?,?,?,?)",
+    { field_value(idArtist), field_value(idSong), field_value(idRole), field_value(strArtist), field_value(iOrder) });
 }
 
 int CMusicDatabase::AddSongContributor(int idSong, const std::string& strRole, const std::string& strArtist, const std::string &strSort)
@@ -1760,14 +1757,15 @@ bool CMusicDatabase::AddSongGenres(int idSong, const std::vector<std::string>& g
       return false;
     unsigned int index = 0;
     std::vector<std::string> modgenres = genres;
+    std::vector<std::vector<field_value>> rows;
     for (auto &strGenre : modgenres)
     {
       int idGenre = AddGenre(strGenre); // Genre string trimed and matched case insensitively
-      strSQL = PrepareSQL("INSERT INTO song_genre (idGenre, idSong, iOrder) VALUES(%i,%i,%i)",
-        idGenre, idSong, index++);
-      if (!ExecuteQuery(strSQL))
-        return false;
+      rows.push_back({ field_value(idGenre), field_value(idSong), field_value(index++) });
     }
+    strSQL = "INSERT INTO song_genre (idGenre, idSong, iOrder) VALUES(?,?,?)";
+    if (!BulkInsert(strSQL, rows))
+      return false;
     // Update concatenated genre string from the standardised genre values
     std::string strGenres = StringUtils::Join(modgenres, CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_musicItemSeparator);
     strSQL = PrepareSQL("UPDATE song SET strGenres = '%s' WHERE idSong = %i", strGenres.c_str(), idSong);
@@ -21,6 +21,7 @@
 #include "network/WebServer.h"
 #include "network/httprequesthandler/HTTPVfsHandler.h"
 #include "network/httprequesthandler/HTTPJsonRpcHandler.h"
+#include "network/httprequesthandler/HTTPRequestHandlerUtils.h"
 #include "settings/MediaSourceSettings.h"
 #include "test/TestUtils.h"
 #include "utils/JSONVariantParser.h"
@@ -28,7 +29,11 @@
 #include "utils/URIUtils.h"
 #include "utils/Variant.h"
 
+#include <chrono>
+#include <cstdio>
 #include <random>
+#include <thread>
+#include <vector>
 
 using namespace XFILE;
 
@@ -41,6 +46,51 @@ using namespace XFILE;
 #define TEST_FILES_HTML         TEST_FILES_DATA ".html"
 #define TEST_FILES_RANGES       TEST_FILES_DATA "-ranges.txt"
 
+/*!
+ \brief Serves the vfs like CHTTPVfsHandler but emulates a slow link
+
+ Every request is answered after a fixed latency plus the time its data takes at the given
+ throughput per connection, like a link where a single TCP connection can't use the whole
+ bandwidth. The server runs a thread per connection, so parallel requests overlap.
+ */
+class CSlowVfsHandler : public CHTTPVfsHandler
+{
+public:
+  CSlowVfsHandler() = default;
+
+  IHTTPRequestHandler* Create(const HTTPRequest &request) const override { return new CSlowVfsHandler(request); }
+  int GetPriority() const override { return CHTTPVfsHandler::GetPriority() + 1; }
+
+  int HandleRequest() override
+  {
+    const std::string header = HTTPRequestHandlerUtils::GetRequestHeaderValue(m_request.connection, MHD_HEADER_KIND, MHD_HTTP_HEADER_RANGE);
+    CHttpRanges ranges;
+    const uint64_t length = ranges.Parse(header, fileSize) ? ranges.GetLength() : fileSize;
+
+    // an open ended range is what Open() requests, when prefetching that connection is
+    // dropped right after the response started
+    double delay = latency;
+    if (chargeOpenEnded || (!header.empty() && header.back() != '-'))
+      delay += length / bytesPerSecond;
+    std::this_thread::sleep_for(std::chrono::duration<double>(delay));
+
+    return CHTTPVfsHandler::HandleRequest();
+  }
+
+  static double latency;
+  static double bytesPerSecond;
+  static uint64_t fileSize;
+  static bool chargeOpenEnded;
+
+protected:
+  explicit CSlowVfsHandler(const HTTPRequest &request) : CHTTPVfsHandler(request) { }
+};
+
+double CSlowVfsHandler::latency = 0.0;
+double CSlowVfsHandler::bytesPerSecond = 1.0;
+uint64_t CSlowVfsHandler::fileSize = 0;
+bool CSlowVfsHandler::chargeOpenEnded = true;
+
 class TestWebServer : public testing::Test
 {
 protected:
@@ -83,11 +133,16 @@ protected:
   }
 
   void SetupMediaSources()
+  {
+    AddMediaSource(sourcePath);
+  }
+
+  void AddMediaSource(const std::string& path)
   {
     CMediaSource source;
     source.strName = "WebServer Share";
-    source.strPath = sourcePath;
-    source.vecPaths.push_back(sourcePath);
+    source.strPath = path;
+    source.vecPaths.push_back(path);
     source.m_allowSharing = true;
     source.m_iDriveType = CMediaSource::SOURCE_TYPE_LOCAL;
     source.m_iLockMode = LOCK_MODE_EVERYONE;
@@ -334,6 +389,20 @@ protected:
     }
   }
 
+  // writes data to a temporary file in a new media source, returns the file and its url
+  CFile* CreateTestFile(const std::string& data, std::string& url)
+  {
+    CFile* file = XBMC_CREATETEMPFILE(".bin");
+    if (file == nullptr)
+      return nullptr;
+
+    file->Write(data.c_str(), data.size());
+    file->Flush();
+    AddMediaSource(CXBMCTestUtils::Instance().TempFileDirectory(file));
+    url = GetUrl(URIUtils::AddFileToFolder("vfs", CURL::Encode(XBMC_TEMPFILEPATH(file))));
+    return file;
+  }
+
   std::string GenerateRangeHeaderValue(unsigned int start, unsigned int end)
   {
     return StringUtils::Format("bytes=%u-%u", start, end);
@@ -897,3 +966,96 @@ TEST_F(TestWebServer, CanGetCachedRangedFileWithNewerIfRange)
   ASSERT_TRUE(curl.Get(GetUrlOfTestFile(TEST_FILES_RANGES), result));
   CheckRangesTestFileResponse(curl, result, ranges);
 }
+
+TEST_F(TestWebServer, CanReadFileWithParallelPrefetch)
+{
+  // a few prefetch segments worth of data
+  const size_t size = 16 * 1024 * 1024;
+  std::string data(size, '\0');
+  for (size_t i = 0; i < size; i++)
+    data[i] = static_cast<char>(i * 7 % 251);
+
+  std::string url;
+  CFile* file = CreateTestFile(data, url);
+  ASSERT_NE(nullptr, file);
+
+  for (unsigned int connections : { 0u, 2u, 4u })
+  {
+    CCurlFile curl;
+    ASSERT_TRUE(curl.Open(CURL(url)));
+    if (connections)
+      EXPECT_EQ(0, curl.IoControl(IOCTRL_SET_PREFETCH, &connections));
+
+    std::string result;
+    result.reserve(size);
+    char buffer[65536];
+    ssize_t read;
+    while ((read = curl.Read(buffer, sizeof(buffer))) > 0)
+      result.append(buffer, read);
+
+    EXPECT_EQ(size, result.size());
+    EXPECT_TRUE(data == result);
+    EXPECT_EQ(static_cast<int64_t>(size), curl.GetPosition());
+    curl.Close();
+  }
+
+  XBMC_DELETETEMPFILE(file);
+}
+
+TEST_F(TestWebServer, DISABLED_ParallelPrefetchBenchmark)
+{
+  const size_t size = 32 * 1024 * 1024;
+  std::string data(size, '\0');
+  for (size_t i = 0; i < size; i++)
+    data[i] = static_cast<char>(i * 7 % 251);
+
+  std::string url;
+  CFile* file = CreateTestFile(data, url);
+  ASSERT_NE(nullptr, file);
+
+  // 20ms round trip and 16 MB/s per connection
+  CSlowVfsHandler slowHandler;
+  CSlowVfsHandler::latency = 0.02;
+  CSlowVfsHandler::bytesPerSecond = 16.0 * 1024 * 1024;
+  CSlowVfsHandler::fileSize = size;
+  webserver.RegisterRequestHandler(&slowHandler);
+
+  // the number of connections always adapts to the throughput, up to the given maximum.
+  // 8 is the most the advanced settings allow
+  const struct
+  {
+    unsigned int connections;
+    const char* name;
+  } modes[] = {
+    { 0, "single connection" },
+    { 2, "up to 2 connections" },
+    { 4, "up to 4 connections" },
+    { 8, "adaptive, up to 8 connections" },
+  };
+
+  for (const auto& mode : modes)
+  {
+    CSlowVfsHandler::chargeOpenEnded = mode.connections == 0;
+
+    const auto start = std::chrono::steady_clock::now();
+    CCurlFile curl;
+    ASSERT_TRUE(curl.Open(CURL(url)));
+    unsigned int connections = mode.connections;
+    if (connections)
+      EXPECT_EQ(0, curl.IoControl(IOCTRL_SET_PREFETCH, &connections));
+
+    std::vector<char> buffer(65536);
+    size_t total = 0;
+    ssize_t read;
+    while ((read = curl.Read(buffer.data(), buffer.size())) > 0)
+      total += read;
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    curl.Close();
+
+    EXPECT_EQ(size, total);
+    printf("[ BENCHMARK] %s: %.1f MB/s\n", mode.name, total / elapsed.count() / (1024 * 1024));
+  }
+
+  webserver.UnregisterRequestHandler(&slowHandler);
+  XBMC_DELETETEMPFILE(file);
+}
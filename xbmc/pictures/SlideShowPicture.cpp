@@ -835,6 +835,8 @@ void CSlideShowPic::Render(float *x, float *y, CBaseTexture* pTexture, UTILS::Co
 
 #elif defined(HAS_GL)
   CRenderSystemGL *renderSystem = dynamic_cast<CRenderSystemGL*>(CServiceBroker::GetRenderSystem());
+  // draw what the GUI holds back before setting up the texture and blending
+  renderSystem->FlushBatch();
   if (pTexture)
   {
     pTexture->LoadToGPU();
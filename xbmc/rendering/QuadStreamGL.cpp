@@ -0,0 +1,98 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "QuadStreamGL.h"
+#include "guilib/GUIControlProfiler.h"
+
+#include <vector>
+
+// room for a few thousand quads, the buffer grows if a draw needs more
+#define STREAM_INITIAL_SIZE (512 * 1024)
+
+GLintptr CQuadStreamGL::Stream(const void* vertices, size_t bytes)
+{
+  Create();
+
+  glBindBuffer(GL_ARRAY_BUFFER, m_streamArray);
+  if (m_streamOffset + bytes > m_streamSize)
+  {
+    // Orphan the data store instead of waiting for the draws still using it,
+    // the driver hands out a fresh one of the same size
+    while (m_streamSize < bytes)
+      m_streamSize *= 2;
+    glBufferData(GL_ARRAY_BUFFER, m_streamSize, NULL, GL_STREAM_DRAW);
+    m_streamOffset = 0;
+  }
+
+  GLintptr offset = m_streamOffset;
+  glBufferSubData(GL_ARRAY_BUFFER, offset, bytes, vertices);
+  m_streamOffset += bytes;
+  return offset;
+}
+
+void CQuadStreamGL::BindElements()
+{
+  Create();
+
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_elementArray);
+}
+
+void CQuadStreamGL::Draw(GLintptr offset, size_t quads, size_t stride, const std::function<void(GLintptr)>& setPointers)
+{
+  // Split into groups no larger than the element array
+  for (size_t quad = 0; quad < quads; quad += MAX_QUADS)
+  {
+    size_t count = quads - quad;
+    if (count > MAX_QUADS)
+      count = MAX_QUADS;
+
+    setPointers(offset + quad * 4 * stride);
+    glDrawElements(GL_TRIANGLES, 6 * count, GL_UNSIGNED_SHORT, 0);
+    GUIPROFILER_DRAWCALL();
+  }
+}
+
+void CQuadStreamGL::Create()
+{
+  if (m_created)
+    return;
+
+  // Create an array holding the mesh indices to convert quads to triangles
+  std::vector<GLushort> index(MAX_QUADS * 6);
+  for (size_t i = 0; i < MAX_QUADS; i++)
+  {
+    index[6*i]   = 4*i;
+    index[6*i+1] = 4*i+1;
+    index[6*i+2] = 4*i+2;
+    index[6*i+3] = 4*i+1;
+    index[6*i+4] = 4*i+3;
+    index[6*i+5] = 4*i+2;
+  }
+  glGenBuffers(1, &m_elementArray);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_elementArray);
+  glBufferData(GL_ELEMENT_ARRAY_BUFFER, index.size() * sizeof(GLushort), index.data(), GL_STATIC_DRAW);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+  m_streamSize = STREAM_INITIAL_SIZE;
+  m_streamOffset = 0;
+  glGenBuffers(1, &m_streamArray);
+  glBindBuffer(GL_ARRAY_BUFFER, m_streamArray);
+  glBufferData(GL_ARRAY_BUFFER, m_streamSize, NULL, GL_STREAM_DRAW);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  m_created = true;
+}
+
+void CQuadStreamGL::Destroy()
+{
+  if (!m_created)
+    return;
+
+  glDeleteBuffers(1, &m_elementArray);
+  glDeleteBuffers(1, &m_streamArray);
+  m_created = false;
+}
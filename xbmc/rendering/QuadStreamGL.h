@@ -0,0 +1,65 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "system_gl.h"
+
+#include <functional>
+#include <stddef.h>
+
+/*!
+ * \brief Stream buffer and element array the GUI draws its quads with
+ *
+ * Vertices are appended to one buffer that lives as long as the GL context.
+ * When it is full its data store is orphaned instead of waiting for the draws
+ * still reading it, and it grows if the vertices don't fit. Quads are drawn as
+ * two triangles each with a static element array, their vertices go top left,
+ * top right, bottom left, bottom right. The render system owns one.
+ */
+class CQuadStreamGL
+{
+public:
+  //! the most quads 16 bit indexes can address
+  static const size_t MAX_QUADS = 16383;
+
+  /*!
+   \brief Append vertices to the stream buffer and leave it bound to GL_ARRAY_BUFFER
+   \return byte offset of the vertices in the buffer
+   */
+  GLintptr Stream(const void* vertices, size_t bytes);
+
+  /*!
+   \brief Bind the element array to GL_ELEMENT_ARRAY_BUFFER
+   */
+  void BindElements();
+
+  /*!
+   \brief Draw quads of the buffer bound to GL_ARRAY_BUFFER with the element array
+   \param offset byte offset of the first quad in the buffer
+   \param quads the number of quads
+   \param stride bytes per vertex
+   \param setPointers points the vertex attributes at the byte offset it is
+          given, called before each group of up to MAX_QUADS quads
+   */
+  void Draw(GLintptr offset, size_t quads, size_t stride, const std::function<void(GLintptr)>& setPointers);
+
+  /*!
+   \brief Delete the buffers, called with the context still current
+   */
+  void Destroy();
+
+private:
+  void Create();
+
+  GLuint m_elementArray = 0;
+  GLuint m_streamArray = 0;
+  size_t m_streamSize = 0;
+  size_t m_streamOffset = 0;
+  bool m_created = false;
+};
@@ -51,6 +51,13 @@ public:
   virtual void CaptureStateBlock() = 0;
   virtual void ApplyStateBlock() = 0;
 
+  /**
+   * Draw what the GUI holds back to draw it together with what follows,
+   * needed before anything renders without the render system, like video,
+   * and before code binds textures or sets up blending for its own drawing
+   */
+  virtual void FlushBatch() { }
+
   virtual void SetCameraPosition(const CPoint &camera, int screenWidth, int screenHeight, float stereoFactor = 0.f) = 0;
   virtual void SetStereoMode(RENDER_STEREO_MODE mode, RENDER_STEREO_VIEW view)
   {
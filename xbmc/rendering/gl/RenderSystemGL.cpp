@@ -8,6 +8,8 @@
 
 #include "RenderSystemGL.h"
 #include "filesystem/File.h"
+#include "guilib/GUIFontTTFGL.h"
+#include "guilib/GUITextureGL.h"
 #include "rendering/MatrixGL.h"
 #include "windowing/GraphicContext.h"
 #include "settings/AdvancedSettings.h"
@@ -194,6 +196,8 @@ bool CRenderSystemGL::ResetRenderSystem(int width, int height)
 
 bool CRenderSystemGL::DestroyRenderSystem()
 {
+  m_quadStream.Destroy();
+
   if (m_vertexArray != GL_NONE)
   {
     glDeleteVertexArrays(1, &m_vertexArray);
@@ -227,6 +231,8 @@ bool CRenderSystemGL::EndRender()
   if (!m_bRenderCreated)
     return false;
 
+  FlushBatch();
+
   return true;
 }
 
@@ -239,6 +245,8 @@ bool CRenderSystemGL::ClearBuffers(UTILS::Color color)
   if(m_stereoMode == RENDER_STEREO_MODE_INTERLACED && m_stereoView == RENDER_STEREO_VIEW_RIGHT)
     return true;
 
+  FlushBatch();
+
   float r = GET_R(color) / 255.0f;
   float g = GET_G(color) / 255.0f;
   float b = GET_B(color) / 255.0f;
@@ -287,6 +295,8 @@ void CRenderSystemGL::PresentRender(bool rendered, bool videoLayer)
   if (!m_bRenderCreated)
     return;
 
+  FlushBatch();
+
   PresentRenderImpl(rendered);
 
   if (!rendered)
@@ -317,6 +327,8 @@ void CRenderSystemGL::CaptureStateBlock()
   if (!m_bRenderCreated)
     return;
 
+  FlushBatch();
+
   glMatrixProject.Push();
   glMatrixModview.Push();
   glMatrixTexture.Push();
@@ -330,6 +342,8 @@ void CRenderSystemGL::ApplyStateBlock()
   if (!m_bRenderCreated)
     return;
 
+  FlushBatch();
+
   glBindVertexArray(m_vertexArray);
 
   glViewport(m_viewPort[0], m_viewPort[1], m_viewPort[2], m_viewPort[3]);
@@ -348,6 +362,8 @@ void CRenderSystemGL::SetCameraPosition(const CPoint &camera, int screenWidth, i
   if (!m_bRenderCreated)
     return;
 
+  FlushBatch();
+
   CPoint offset = camera - CPoint(screenWidth*0.5f, screenHeight*0.5f);
 
 
@@ -437,6 +453,8 @@ void CRenderSystemGL::SetViewPort(const CRect& viewPort)
   if (!m_bRenderCreated)
     return;
 
+  FlushBatch();
+
   glScissor((GLint) viewPort.x1, (GLint) (m_height - viewPort.y1 - viewPort.Height()), (GLsizei) viewPort.Width(), (GLsizei) viewPort.Height());
   glViewport((GLint) viewPort.x1, (GLint) (m_height - viewPort.y1 - viewPort.Height()), (GLsizei) viewPort.Width(), (GLsizei) viewPort.Height());
   m_viewPort[0] = viewPort.x1;
@@ -471,6 +489,8 @@ void CRenderSystemGL::SetScissors(const CRect &rect)
 {
   if (!m_bRenderCreated)
     return;
+
+  FlushBatch();
   GLint x1 = MathUtils::round_int(rect.x1);
   GLint y1 = MathUtils::round_int(rect.y1);
   GLint x2 = MathUtils::round_int(rect.x2);
@@ -540,6 +560,8 @@ static const GLubyte stipple_3d[] = {
 
 void CRenderSystemGL::SetStereoMode(RENDER_STEREO_MODE mode, RENDER_STEREO_VIEW view)
 {
+  FlushBatch();
+
   CRenderSystemBase::SetStereoMode(mode, view);
 
   glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
@@ -709,8 +731,18 @@ void CRenderSystemGL::ReleaseShaders()
   m_pShader[SM_MULTI_BLENDCOLOR].reset();
 }
 
+void CRenderSystemGL::FlushBatch()
+{
+  // only one of them holds anything back, each flushes the other before it starts
+  CGUITextureGL::FlushBatch();
+  CGUIFontTTFGL::FlushBatch();
+}
+
 void CRenderSystemGL::EnableShader(ESHADERMETHOD method)
 {
+  // anything drawn with a shader goes after the textures held back
+  FlushBatch();
+
   m_method = method;
   if (m_pShader[m_method])
   {
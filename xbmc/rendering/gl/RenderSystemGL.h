@@ -10,6 +10,7 @@
 
 #include "system_gl.h"
 #include "GLShader.h"
+#include "rendering/QuadStreamGL.h"
 #include "rendering/RenderSystem.h"
 #include "utils/Color.h"
 
@@ -57,6 +58,14 @@ public:
   void CaptureStateBlock() override;
   void ApplyStateBlock() override;
 
+  /*!
+   * \brief Draw the textures and text CGUITextureGL and CGUIFontTTFGL hold back for batching
+   *
+   * Called before the shader, the viewport, the scissors, the projection or
+   * the stereo view change and before the frame is done.
+   */
+  void FlushBatch() override;
+
   void SetCameraPosition(const CPoint &camera, int screenWidth, int screenHeight, float stereoFactor = 0.0f) override;
 
   void SetStereoMode(RENDER_STEREO_MODE mode, RENDER_STEREO_VIEW view) override;
@@ -82,6 +91,11 @@ public:
   GLint ShaderGetUniCol();
   GLint ShaderGetModel();
 
+  /*!
+   * \brief Stream buffer and element array the GUI textures and fonts draw their quads with
+   */
+  CQuadStreamGL& GetQuadStream() { return m_quadStream; }
+
 protected:
   virtual void SetVSyncImpl(bool enable) = 0;
   virtual void PresentRenderImpl(bool rendered) = 0;
@@ -104,4 +118,5 @@ protected:
   std::array<std::unique_ptr<CGLShader>, SM_MAX> m_pShader;
   ESHADERMETHOD m_method = SM_DEFAULT;
   GLuint m_vertexArray = GL_NONE;
+  CQuadStreamGL m_quadStream;
 };
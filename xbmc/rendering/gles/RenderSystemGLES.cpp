@@ -153,6 +153,7 @@ bool CRenderSystemGLES::DestroyRenderSystem()
   glFinish();
   PresentRenderImpl(true);
 
+  m_quadStream.Destroy();
   ReleaseShaders();
   m_bRenderCreated = false;
 
@@ -9,6 +9,7 @@
 #pragma once
 
 #include "system_gl.h"
+#include "rendering/QuadStreamGL.h"
 #include "rendering/RenderSystem.h"
 #include "utils/Color.h"
 #include "GLESShader.h"
@@ -86,6 +87,11 @@ public:
   GLint GUIShaderGetBrightness();
   GLint GUIShaderGetModel();
 
+  /*!
+   * \brief Stream buffer and element array the GUI fonts draw their quads with
+   */
+  CQuadStreamGL& GetQuadStream() { return m_quadStream; }
+
 protected:
   virtual void SetVSyncImpl(bool enable) = 0;
   virtual void PresentRenderImpl(bool rendered) = 0;
@@ -101,5 +107,7 @@ protected:
   ESHADERMETHOD m_method = SM_DEFAULT;
 
   GLint      m_viewPort[4];
+
+  CQuadStreamGL m_quadStream;
 };
 
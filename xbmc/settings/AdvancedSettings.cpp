@@ -366,6 +366,7 @@ void CAdvancedSettings::Initialize()
   m_curlconnecttimeout = 30;
   m_curllowspeedtime = 20;
   m_curlretries = 2;
+  m_curlPrefetchConnections = 0;
   m_curlDisableIPV6 = false;      //Certain hardware/OS combinations have trouble
                                   //with ipv6.
 
@@ -411,6 +412,12 @@ void CAdvancedSettings::Initialize()
   // as multiply of the default data read rate
   m_cacheReadFactor = 4.0f;
 
+  m_dirCacheMemSize = 1024 * 1024 * 32;
+  m_dirCachePersistent = false;
+  m_dirCacheDiskSize = 1024 * 1024 * 64;
+
+  m_jobManagerWorkStealing = false;
+
   m_addonPackageFolderSize = 200;
 
   m_jsonOutputCompact = true;
@@ -422,6 +429,8 @@ void CAdvancedSettings::Initialize()
   m_guiVisualizeDirtyRegions = false;
   m_guiAlgorithmDirtyRegions = 3;
   m_guiSmartRedraw = false;
+  m_guiTextureBatching = false;
+  m_guiTextureMemoryBudget = 1024 * 1024 * 256;
   m_airTunesPort = 36666;
   m_airPlayPort = 36667;
 
@@ -856,6 +865,7 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetInt(pElement, "curlclienttimeout", m_curlconnecttimeout, 1, 1000);
     XMLUtils::GetInt(pElement, "curllowspeedtime", m_curllowspeedtime, 1, 1000);
     XMLUtils::GetInt(pElement, "curlretries", m_curlretries, 0, 10);
+    XMLUtils::GetUInt(pElement, "curlprefetchconnections", m_curlPrefetchConnections, 0, 8);
     XMLUtils::GetBoolean(pElement,"disableipv6", m_curlDisableIPV6);
   }
 
@@ -867,6 +877,18 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetFloat(pElement, "readfactor", m_cacheReadFactor);
   }
 
+  pElement = pRootElement->FirstChildElement("directorycache");
+  if (pElement)
+  {
+    XMLUtils::GetUInt(pElement, "memorysize", m_dirCacheMemSize);
+    XMLUtils::GetBoolean(pElement, "persistent", m_dirCachePersistent);
+    XMLUtils::GetUInt(pElement, "disksize", m_dirCacheDiskSize);
+  }
+
+  pElement = pRootElement->FirstChildElement("jobmanager");
+  if (pElement)
+    XMLUtils::GetBoolean(pElement, "workstealing", m_jobManagerWorkStealing);
+
   pElement = pRootElement->FirstChildElement("jsonrpc");
   if (pElement)
   {
@@ -1243,6 +1265,8 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetBoolean(pElement, "visualizedirtyregions", m_guiVisualizeDirtyRegions);
     XMLUtils::GetInt(pElement, "algorithmdirtyregions",     m_guiAlgorithmDirtyRegions);
     XMLUtils::GetBoolean(pElement, "smartredraw", m_guiSmartRedraw);
+    XMLUtils::GetBoolean(pElement, "texturebatching", m_guiTextureBatching);
+    XMLUtils::GetUInt(pElement, "texturememorybudget", m_guiTextureMemoryBudget);
   }
 
   std::string seekSteps;
@@ -299,6 +299,7 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     int m_curlconnecttimeout;
     int m_curllowspeedtime;
     int m_curlretries;
+    unsigned int m_curlPrefetchConnections;
     bool m_curlDisableIPV6;
 
     bool m_fullScreen;
@@ -344,15 +345,23 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     bool m_guiVisualizeDirtyRegions;
     int  m_guiAlgorithmDirtyRegions;
     bool m_guiSmartRedraw;
+    bool m_guiTextureBatching; //!< draw consecutive textures, and text, with the same state with one call
+    unsigned int m_guiTextureMemoryBudget; //!< bytes of textures before unused ones are freed early, 0 for no limit
     unsigned int m_addonPackageFolderSize;
 
     unsigned int m_cacheMemSize;
     unsigned int m_cacheBufferMode;
     float m_cacheReadFactor;
 
+    unsigned int m_dirCacheMemSize;
+    bool m_dirCachePersistent;
+    unsigned int m_dirCacheDiskSize;
+
     bool m_jsonOutputCompact;
     unsigned int m_jsonTcpPort;
 
+    bool m_jobManagerWorkStealing;
+
     bool m_enableMultimediaKeys;
     std::vector<std::string> m_settingsFiles;
     void ParseSettingsFile(const std::string &file);
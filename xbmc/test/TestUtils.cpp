@@ -199,6 +199,11 @@ std::vector<std::string> &CXBMCTestUtils::getGUISettingsFiles()
   return GUISettingsFiles;
 }
 
+std::vector<std::string> &CXBMCTestUtils::getDemuxBenchmarkFiles()
+{
+  return DemuxBenchmarkFiles;
+}
+
 static const char usage[] =
 "Kodi Test Suite\n"
 "Usage: kodi-test [options]\n"
@@ -236,6 +241,15 @@ static const char usage[] =
 "    Add multiple GUI settings files from a ',' delimited string of\n"
 "    files to be loaded in test cases that use them.\n"
 "\n"
+"  --add-demux-benchmark-file [FILE]\n"
+"    Add a local media file to be read in the demuxer and decoder\n"
+"    benchmarks. The benchmarks are disabled tests, run them with\n"
+"    --gtest_also_run_disabled_tests.\n"
+"\n"
+"  --add-demux-benchmark-files [FILES]\n"
+"    Add multiple media files from a ',' delimited string of files to be\n"
+"    read in the demuxer and decoder benchmarks.\n"
+"\n"
 "  --set-probability [PROBABILITY]\n"
 "    Set the probability variable used by the file corrupting functions.\n"
 "    The variable should be a double type from 0.0 to 1.0. Values given\n"
@@ -298,6 +312,17 @@ void CXBMCTestUtils::ParseArgs(int argc, char **argv)
       for (const auto& it : urls)
         GUISettingsFiles.push_back(it);
     }
+    else if (arg == "--add-demux-benchmark-file")
+    {
+      DemuxBenchmarkFiles.push_back(argv[++i]);
+    }
+    else if (arg == "--add-demux-benchmark-files")
+    {
+      arg = argv[++i];
+      std::vector<std::string> files = StringUtils::Split(arg, ",");
+      for (const auto& it : files)
+        DemuxBenchmarkFiles.push_back(it);
+    }
     else if (arg == "--set-probability")
     {
       probability = atof(argv[++i]);
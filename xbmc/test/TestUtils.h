@@ -65,6 +65,9 @@ public:
   /* Function to get GUI settings files. */
   std::vector<std::string> &getGUISettingsFiles();
 
+  /* Function to get the media files read in the demuxer and decoder benchmarks. */
+  std::vector<std::string> &getDemuxBenchmarkFiles();
+
   /* Function used in creating a corrupted file. The parameters are a URL
    * to the original file to be corrupted and a suffix to append to the
    * path of the newly created file. This will return a XFILE::CFile
@@ -90,6 +93,7 @@ private:
 
   std::vector<std::string> AdvancedSettingsFiles;
   std::vector<std::string> GUISettingsFiles;
+  std::vector<std::string> DemuxBenchmarkFiles;
 
   double probability;
 };
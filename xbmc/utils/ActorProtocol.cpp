@@ -8,21 +8,30 @@
 
 #include "ActorProtocol.h"
 #include "threads/Event.h"
+#include "threads/SingleLock.h"
 
+#include <algorithm>
 #include <cstring>
 
 using namespace Actor;
 
+Message::~Message() = default;
+
 void Message::Release()
 {
-  bool skip;
-  origin.Lock();
-  skip = isSync ? !isSyncFini : false;
-  isSyncFini = true;
-  origin.Unlock();
-
-  if (skip)
-    return;
+  // async messages only have a single owner, sync messages are released
+  // by both the sender and the receiver and the last one returns it
+  if (isSync)
+  {
+    bool skip;
+    origin.Lock();
+    skip = !isSyncFini;
+    isSyncFini = true;
+    origin.Unlock();
+
+    if (skip)
+      return;
+  }
 
   // free data buffer
   if (data != buffer)
@@ -30,9 +39,6 @@ void Message::Release()
 
   payloadObj.release();
 
-  // delete event in case of sync message
-  delete event;
-
   origin.ReturnMessage(this);
 }
 
@@ -72,30 +78,184 @@ bool Message::Reply(int sig, void *data /* = NULL*/, size_t size /* = 0 */)
   return true;
 }
 
-Protocol::~Protocol()
+CMailbox::CMailbox()
+  : m_head(&m_stub),
+    m_tail(&m_stub)
 {
-  Message *msg;
-  Purge();
-  while (!freeMessageQueue.empty())
+}
+
+void CMailbox::Post(Message *msg)
+{
+  msg->next.store(nullptr, std::memory_order_relaxed);
+  CMailboxNode *prev = m_head.exchange(msg, std::memory_order_acq_rel);
+  prev->next.store(msg, std::memory_order_release);
+}
+
+Message *CMailbox::Pop()
+{
+  CMailboxNode *tail = m_tail;
+  CMailboxNode *next = tail->next.load(std::memory_order_acquire);
+
+  if (tail == &m_stub)
   {
-    msg = freeMessageQueue.front();
-    freeMessageQueue.pop();
-    delete msg;
+    if (!next)
+      return nullptr;
+    m_tail = next;
+    tail = next;
+    next = next->next.load(std::memory_order_acquire);
+  }
+
+  if (next)
+  {
+    m_tail = next;
+    return static_cast<Message*>(tail);
+  }
+
+  // a producer is in the middle of posting, its event will wake us up again
+  if (tail != m_head.load(std::memory_order_acquire))
+    return nullptr;
+
+  // tail is the last message, put the stub behind it so it can be unlinked
+  m_stub.next.store(nullptr, std::memory_order_relaxed);
+  CMailboxNode *prev = m_head.exchange(&m_stub, std::memory_order_acq_rel);
+  prev->next.store(&m_stub, std::memory_order_release);
+
+  next = tail->next.load(std::memory_order_acquire);
+  if (next)
+  {
+    m_tail = next;
+    return static_cast<Message*>(tail);
   }
+  return nullptr;
 }
 
-Message *Protocol::GetMessage()
+Message *CMailbox::Receive()
 {
-  Message *msg;
+  CSingleLock lock(m_consumerSection);
 
-  CSingleLock lock(criticalSection);
+  if (!m_purged.empty())
+  {
+    Message *msg = m_purged.front();
+    m_purged.pop_front();
+    return msg;
+  }
+  return Pop();
+}
 
-  if (!freeMessageQueue.empty())
+void CMailbox::Purge(int signal)
+{
+  std::vector<Message*> removed;
   {
-    msg = freeMessageQueue.front();
-    freeMessageQueue.pop();
+    CSingleLock lock(m_consumerSection);
+
+    Message *msg;
+    while ((msg = Pop()))
+      m_purged.push_back(msg);
+
+    auto it = std::stable_partition(m_purged.begin(), m_purged.end(),
+                                    [signal](const Message *msg) { return msg->signal != signal; });
+    removed.assign(it, m_purged.end());
+    m_purged.erase(it, m_purged.end());
   }
-  else
+
+  for (Message *msg : removed)
+    msg->Release();
+}
+
+CMessagePool::CMessagePool(size_t size)
+{
+  // round up to a power of two so positions can be masked
+  size_t cells = 2;
+  while (cells < size)
+    cells <<= 1;
+
+  m_cells = std::vector<Cell>(cells);
+  m_mask = cells - 1;
+  for (size_t i = 0; i < cells; i++)
+  {
+    m_cells[i].sequence.store(i, std::memory_order_relaxed);
+    m_cells[i].msg = nullptr;
+  }
+}
+
+bool CMessagePool::Push(Message *msg)
+{
+  size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+  while (true)
+  {
+    Cell &cell = m_cells[pos & m_mask];
+    size_t sequence = cell.sequence.load(std::memory_order_acquire);
+    intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+    if (diff == 0)
+    {
+      if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+      {
+        cell.msg = msg;
+        cell.sequence.store(pos + 1, std::memory_order_release);
+        return true;
+      }
+    }
+    else if (diff < 0)
+      return false; // full
+    else
+      pos = m_enqueuePos.load(std::memory_order_relaxed);
+  }
+}
+
+Message *CMessagePool::Pop()
+{
+  size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+  while (true)
+  {
+    Cell &cell = m_cells[pos & m_mask];
+    size_t sequence = cell.sequence.load(std::memory_order_acquire);
+    intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+    if (diff == 0)
+    {
+      if (m_dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+      {
+        Message *msg = cell.msg;
+        cell.sequence.store(pos + m_mask + 1, std::memory_order_release);
+        return msg;
+      }
+    }
+    else if (diff < 0)
+      return nullptr; // empty
+    else
+      pos = m_dequeuePos.load(std::memory_order_relaxed);
+  }
+}
+
+Protocol::Protocol(std::string name, CEvent* inEvent, CEvent *outEvent, size_t poolSize)
+  : portName(name),
+    containerInEvent(inEvent),
+    containerOutEvent(outEvent),
+    freeMessages(poolSize)
+{
+  // preallocate messages so steady state traffic does not hit the heap
+  for (size_t i = 0; i < poolSize; i++)
+  {
+    Message *msg = new Message(*this);
+    if (!freeMessages.Push(msg))
+    {
+      delete msg;
+      break;
+    }
+  }
+}
+
+Protocol::~Protocol()
+{
+  Message *msg;
+  Purge();
+  while ((msg = freeMessages.Pop()))
+    delete msg;
+}
+
+Message *Protocol::GetMessage()
+{
+  Message *msg = freeMessages.Pop();
+  if (!msg)
     msg = new Message(*this);
 
   msg->isSync = false;
@@ -111,9 +271,8 @@ Message *Protocol::GetMessage()
 
 void Protocol::ReturnMessage(Message *msg)
 {
-  CSingleLock lock(criticalSection);
-
-  freeMessageQueue.push(msg);
+  if (!freeMessages.Push(msg))
+    delete msg;
 }
 
 bool Protocol::SendOutMessage(int signal, void *data /* = NULL */, size_t size /* = 0 */, Message *outMsg /* = NULL */)
@@ -136,9 +295,7 @@ bool Protocol::SendOutMessage(int signal, void *data /* = NULL */, size_t size /
     memcpy(msg->data, data, size);
   }
 
-  { CSingleLock lock(criticalSection);
-    outMessages.push(msg);
-  }
+  outMessages.Post(msg);
   if (containerOutEvent)
     containerOutEvent->Set();
 
@@ -158,9 +315,7 @@ bool Protocol::SendOutMessage(int signal, CPayloadWrapBase *payload, Message *ou
 
   msg->payloadObj.reset(payload);
 
-  { CSingleLock lock(criticalSection);
-    outMessages.push(msg);
-  }
+  outMessages.Post(msg);
   if (containerOutEvent)
     containerOutEvent->Set();
 
@@ -180,16 +335,14 @@ bool Protocol::SendInMessage(int signal, void *data /* = NULL */, size_t size /*
 
   if (data)
   {
-    if (size > sizeof(msg->data))
+    if (size > sizeof(msg->buffer))
       msg->data = new uint8_t[size];
     else
       msg->data = msg->buffer;
     memcpy(msg->data, data, size);
   }
 
-  { CSingleLock lock(criticalSection);
-    inMessages.push(msg);
-  }
+  inMessages.Post(msg);
   if (containerInEvent)
     containerInEvent->Set();
 
@@ -209,9 +362,7 @@ bool Protocol::SendInMessage(int signal, CPayloadWrapBase *payload, Message *out
 
   msg->payloadObj.reset(payload);
 
-  { CSingleLock lock(criticalSection);
-    inMessages.push(msg);
-  }
+  inMessages.Post(msg);
   if (containerInEvent)
     containerInEvent->Set();
 
@@ -223,7 +374,9 @@ bool Protocol::SendOutMessageSync(int signal, Message **retMsg, int timeout, voi
   Message *msg = GetMessage();
   msg->isOut = true;
   msg->isSync = true;
-  msg->event = new CEvent;
+  if (!msg->syncEvent)
+    msg->syncEvent.reset(new CEvent);
+  msg->event = msg->syncEvent.get();
   msg->event->Reset();
   SendOutMessage(signal, data, size, msg);
 
@@ -254,7 +407,9 @@ bool Protocol::SendOutMessageSync(int signal, Message **retMsg, int timeout, CPa
   Message *msg = GetMessage();
   msg->isOut = true;
   msg->isSync = true;
-  msg->event = new CEvent;
+  if (!msg->syncEvent)
+    msg->syncEvent.reset(new CEvent);
+  msg->event = msg->syncEvent.get();
   msg->event->Reset();
   SendOutMessage(signal, payload, msg);
 
@@ -282,27 +437,27 @@ bool Protocol::SendOutMessageSync(int signal, Message **retMsg, int timeout, CPa
 
 bool Protocol::ReceiveOutMessage(Message **msg)
 {
-  CSingleLock lock(criticalSection);
-
-  if (outMessages.empty() || outDefered)
+  if (outDefered)
     return false;
 
-  *msg = outMessages.front();
-  outMessages.pop();
+  Message *next = outMessages.Receive();
+  if (!next)
+    return false;
 
+  *msg = next;
   return true;
 }
 
 bool Protocol::ReceiveInMessage(Message **msg)
 {
-  CSingleLock lock(criticalSection);
-
-  if (inMessages.empty() || inDefered)
+  if (inDefered)
     return false;
 
-  *msg = inMessages.front();
-  inMessages.pop();
+  Message *next = inMessages.Receive();
+  if (!next)
+    return false;
 
+  *msg = next;
   return true;
 }
 
@@ -320,44 +475,10 @@ void Protocol::Purge()
 
 void Protocol::PurgeIn(int signal)
 {
-  Message *msg;
-  std::queue<Message*> msgs;
-
-  CSingleLock lock(criticalSection);
-
-  while (!inMessages.empty())
-  {
-    msg = inMessages.front();
-    inMessages.pop();
-    if (msg->signal != signal)
-      msgs.push(msg);
-  }
-  while (!msgs.empty())
-  {
-    msg = msgs.front();
-    msgs.pop();
-    inMessages.push(msg);
-  }
+  inMessages.Purge(signal);
 }
 
 void Protocol::PurgeOut(int signal)
 {
-  Message *msg;
-  std::queue<Message*> msgs;
-
-  CSingleLock lock(criticalSection);
-
-  while (!outMessages.empty())
-  {
-    msg = outMessages.front();
-    outMessages.pop();
-    if (msg->signal != signal)
-      msgs.push(msg);
-  }
-  while (!msgs.empty())
-  {
-    msg = msgs.front();
-    msgs.pop();
-    outMessages.push(msg);
-  }
+  outMessages.Purge(signal);
 }
@@ -9,11 +9,15 @@
 #pragma once
 
 #include "threads/CriticalSection.h"
+#include "utils/CacheLine.h"
 
+#include <atomic>
 #include <cstddef>
+#include <deque>
 #include <queue>
 #include <memory>
 #include <string>
+#include <vector>
 
 class CEvent;
 
@@ -40,7 +44,15 @@ protected:
 
 class Protocol;
 
-class Message
+/*!
+ * \brief Link of an intrusive, lock-free message queue
+ */
+struct CMailboxNode
+{
+  std::atomic<CMailboxNode*> next{nullptr};
+};
+
+class Message : public CMailboxNode
 {
   friend class Protocol;
 
@@ -63,16 +75,87 @@ public:
   void Release();
   bool Reply(int sig, void *data = nullptr, size_t size = 0);
 
+  ~Message();
+
 private:
   explicit Message(Protocol &_origin) noexcept
     :origin(_origin) {}
+
+  std::unique_ptr<CEvent> syncEvent; // reused by sync messages
+};
+
+/*!
+ * \brief Multi-producer, single-consumer mailbox
+ *
+ * Any number of threads may post messages without taking a lock. Messages are
+ * received in the order they were posted. Receiving is meant to be done by the
+ * one thread that owns the port; it is serialized by a consumer lock which is
+ * uncontended in that case.
+ */
+class CMailbox
+{
+public:
+  CMailbox();
+  CMailbox(const CMailbox&) = delete;
+  CMailbox& operator=(const CMailbox&) = delete;
+
+  void Post(Message *msg);
+  Message *Receive();
+  void Purge(int signal);
+
+private:
+  Message *Pop();
+
+  // the producers write m_head and the consumer m_tail, the padding keeps them
+  // on different cache lines
+  std::atomic<CMailboxNode*> m_head;
+  CACHE_LINE_PADDING char m_headPadding[CACHE_LINE_SIZE];
+  CMailboxNode *m_tail;
+  CACHE_LINE_PADDING char m_tailPadding[CACHE_LINE_SIZE];
+  CMailboxNode m_stub;
+  std::deque<Message*> m_purged; // survivors of Purge(), received before anything else
+  CCriticalSection m_consumerSection;
+};
+
+/*!
+ * \brief Bounded, preallocated pool of free messages
+ *
+ * A lock-free ring of free messages. Getting a message when the pool is empty
+ * allocates a new one; returning a message to a full pool deletes it.
+ */
+class CMessagePool
+{
+public:
+  explicit CMessagePool(size_t size);
+  CMessagePool(const CMessagePool&) = delete;
+  CMessagePool& operator=(const CMessagePool&) = delete;
+
+  bool Push(Message *msg);
+  Message *Pop();
+
+private:
+  struct Cell
+  {
+    std::atomic<size_t> sequence;
+    Message *msg;
+  };
+
+  // padding keeps the positions on cache lines of their own
+  std::vector<Cell> m_cells;
+  size_t m_mask;
+  CACHE_LINE_PADDING char m_maskPadding[CACHE_LINE_SIZE];
+  std::atomic<size_t> m_enqueuePos{0};
+  CACHE_LINE_PADDING char m_enqueuePadding[CACHE_LINE_SIZE];
+  std::atomic<size_t> m_dequeuePos{0};
+  CACHE_LINE_PADDING char m_dequeuePadding[CACHE_LINE_SIZE];
 };
 
 class Protocol
 {
 public:
-  Protocol(std::string name, CEvent* inEvent, CEvent *outEvent)
-    :portName(name), containerInEvent(inEvent), containerOutEvent(outEvent) {}
+  static constexpr size_t DEFAULT_POOL_SIZE = 64;
+
+  Protocol(std::string name, CEvent* inEvent, CEvent *outEvent, size_t poolSize = DEFAULT_POOL_SIZE);
   Protocol(std::string name)
     : Protocol(name, nullptr, nullptr) {}
   ~Protocol();
@@ -98,9 +181,9 @@ public:
 protected:
   CEvent *containerInEvent, *containerOutEvent;
   CCriticalSection criticalSection;
-  std::queue<Message*> outMessages;
-  std::queue<Message*> inMessages;
-  std::queue<Message*> freeMessageQueue;
+  CMailbox outMessages;
+  CMailbox inMessages;
+  CMessagePool freeMessages;
   bool inDefered = false, outDefered = false;
 };
 
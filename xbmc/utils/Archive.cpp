@@ -49,6 +49,22 @@ CArchive::CArchive(CFile* pFile, int mode)
   }
 }
 
+CArchive::CArchive(std::vector<uint8_t>& data)
+  : CArchive(nullptr, store)
+{
+  m_memory = &data;
+}
+
+CArchive::CArchive(const uint8_t* data, size_t size)
+{
+  m_pFile = nullptr;
+  m_iMode = load;
+
+  // nothing is written to the data while loading
+  m_BufferPos = const_cast<uint8_t*>(data);
+  m_BufferRemain = size;
+}
+
 CArchive::~CArchive()
 {
   FlushBuffer();
@@ -243,6 +259,14 @@ CArchive& CArchive::operator>>(std::string& str)
   if (iLength > MAX_STRING_SIZE)
     throw std::out_of_range("String too large, over 100MB");
 
+  if (m_BufferRemain >= iLength)
+  {
+    str.assign(reinterpret_cast<const char*>(m_BufferPos), iLength);
+    m_BufferPos += iLength;
+    m_BufferRemain -= iLength;
+    return *this;
+  }
+
   auto s = std::unique_ptr<char[]>(new char[iLength]);
   streamin(s.get(), iLength * sizeof(char));
   str.assign(s.get(), iLength);
@@ -396,7 +420,13 @@ void CArchive::FlushBuffer()
 {
   if (m_iMode == store && m_BufferPos != m_pBuffer.get())
   {
-    if (m_pFile->Write(m_pBuffer.get(), m_BufferPos - m_pBuffer.get()) != m_BufferPos - m_pBuffer.get())
+    if (m_memory)
+    {
+      m_memory->insert(m_memory->end(), m_pBuffer.get(), m_BufferPos);
+      m_BufferPos = m_pBuffer.get();
+      m_BufferRemain = CARCHIVE_BUFFER_MAX;
+    }
+    else if (m_pFile->Write(m_pBuffer.get(), m_BufferPos - m_pBuffer.get()) != m_BufferPos - m_pBuffer.get())
       CLog::Log(LOGERROR, "%s: Error flushing buffer", __FUNCTION__);
     else
     {
@@ -423,7 +453,7 @@ CArchive &CArchive::streamout_bufferwrap(const uint8_t *ptr, size_t size)
 
 void CArchive::FillBuffer()
 {
-  if (m_iMode == load && m_BufferRemain == 0)
+  if (m_iMode == load && m_BufferRemain == 0 && m_pFile)
   {
     auto read = m_pFile->Read(m_pBuffer.get(), CARCHIVE_BUFFER_MAX);
     if (read > 0)
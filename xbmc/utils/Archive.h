@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <stdint.h>
 #include <string>
 #include <memory>
 #include <vector>
@@ -26,6 +27,20 @@ class CArchive
 {
 public:
   CArchive(XFILE::CFile* pFile, int mode);
+
+  /*!
+   * \brief Store into memory
+   * \param data the archive is appended to, complete after Close()
+   */
+  explicit CArchive(std::vector<uint8_t>& data);
+
+  /*!
+   * \brief Load from memory, without copying it into the buffer first
+   * \param data has to stay valid as long as the archive is used
+   * \param size of the data in bytes
+   */
+  CArchive(const uint8_t* data, size_t size);
+
   ~CArchive();
 
   /* CArchive support storing and loading of all C basic integer types
@@ -168,6 +183,7 @@ protected:
   }
 
   XFILE::CFile* m_pFile; //non-owning
+  std::vector<uint8_t>* m_memory = nullptr; //non-owning
   int m_iMode;
   std::unique_ptr<uint8_t[]> m_pBuffer;
   uint8_t *m_BufferPos;
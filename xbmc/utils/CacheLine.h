@@ -0,0 +1,31 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+/*!
+ * \brief Size of a cache line on the supported CPUs
+ *
+ * Data written by different threads is kept this far apart so the threads
+ * don't invalidate each other's cache lines. This is done with padding
+ * members, alignas is not honoured by operator new in C++11.
+ */
+constexpr size_t CACHE_LINE_SIZE = 64;
+
+/*!
+ * \brief Marks a padding member, which is never read
+ */
+#if __cplusplus >= 201703L
+#define CACHE_LINE_PADDING [[maybe_unused]]
+#elif defined(__GNUC__) || defined(__clang__)
+#define CACHE_LINE_PADDING __attribute__((unused))
+#else
+#define CACHE_LINE_PADDING
+#endif
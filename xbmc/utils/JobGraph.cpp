@@ -0,0 +1,232 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "JobGraph.h"
+
+#include "threads/SingleLock.h"
+#include "utils/log.h"
+
+CJobGraph::CJobGraph(CJob::PRIORITY priority)
+  : m_priority(priority),
+    m_finished(true, true)
+{
+}
+
+CJobGraph::~CJobGraph()
+{
+  CancelAll();
+}
+
+unsigned int CJobGraph::AddJob(CJob *job, const std::vector<unsigned int> &dependsOn, IJobCallback *callback)
+{
+  CSingleLock lock(m_section);
+
+  for (unsigned int dependency : dependsOn)
+  {
+    if (dependency == 0 || dependency > m_nodes.size())
+    {
+      CLog::Log(LOGERROR, "CJobGraph::%s - unknown dependency %u", __FUNCTION__, dependency);
+      delete job;
+      return 0;
+    }
+  }
+
+  m_nodes.emplace_back();
+  const unsigned int node = m_nodes.size();
+  m_nodes.back().job = job;
+  m_nodes.back().callback = callback;
+  m_unfinished++;
+  m_finished.Reset();
+
+  bool cancelled = false;
+  for (unsigned int dependency : dependsOn)
+  {
+    Node &parent = m_nodes[dependency - 1];
+    switch (parent.state)
+    {
+      case NodeState::WAITING:
+      case NodeState::QUEUED:
+        parent.dependants.push_back(node);
+        m_nodes[node - 1].pending++;
+        break;
+      case NodeState::SUCCEEDED:
+        break;
+      case NodeState::FAILED:
+      case NodeState::CANCELLED:
+        cancelled = true;
+        break;
+    }
+  }
+
+  if (cancelled)
+    CancelNode(node);
+  else if (m_started && m_nodes[node - 1].pending == 0)
+    QueueNode(node);
+
+  return node;
+}
+
+void CJobGraph::Start()
+{
+  CSingleLock lock(m_section);
+  if (m_started)
+    return;
+  m_started = true;
+
+  for (unsigned int node = 1; node <= m_nodes.size(); node++)
+  {
+    if (m_nodes[node - 1].state == NodeState::WAITING && m_nodes[node - 1].pending == 0)
+      QueueNode(node);
+  }
+}
+
+void CJobGraph::Cancel(unsigned int node)
+{
+  CSingleLock lock(m_section);
+  if (node == 0 || node > m_nodes.size())
+    return;
+  CancelNode(node);
+}
+
+void CJobGraph::CancelAll()
+{
+  CSingleLock lock(m_section);
+  for (unsigned int node = 1; node <= m_nodes.size(); node++)
+    CancelNode(node);
+}
+
+void CJobGraph::Wait()
+{
+  m_finished.Wait();
+}
+
+bool CJobGraph::Wait(unsigned int milliseconds)
+{
+  return m_finished.WaitMSec(milliseconds);
+}
+
+bool CJobGraph::IsFinished() const
+{
+  CSingleLock lock(m_section);
+  return m_unfinished == 0;
+}
+
+CJobGraph::NodeState CJobGraph::GetState(unsigned int node) const
+{
+  CSingleLock lock(m_section);
+  if (node == 0 || node > m_nodes.size())
+    return NodeState::CANCELLED;
+  return m_nodes[node - 1].state;
+}
+
+void CJobGraph::OnJobComplete(unsigned int jobID, bool success, CJob *job)
+{
+  CSingleLock lock(m_section);
+  unsigned int node = FindNode(jobID);
+  if (!node)
+    return;
+  m_queued.erase(jobID);
+
+  // tell the listener of this node first, so dependants see whatever it did with the result
+  IJobCallback *callback = m_nodes[node - 1].callback;
+  if (callback)
+  {
+    lock.Leave();
+    callback->OnJobComplete(jobID, success, job);
+    lock.Enter();
+
+    // the node may have been cancelled while we were out of the lock
+    if (m_nodes[node - 1].state != NodeState::QUEUED)
+      return;
+  }
+
+  Finish(node, success ? NodeState::SUCCEEDED : NodeState::FAILED);
+}
+
+void CJobGraph::OnJobProgress(unsigned int jobID, unsigned int progress, unsigned int total, const CJob *job)
+{
+  CSingleLock lock(m_section);
+  unsigned int node = FindNode(jobID);
+  if (!node)
+    return;
+
+  IJobCallback *callback = m_nodes[node - 1].callback;
+  lock.Leave();
+  if (callback)
+    callback->OnJobProgress(jobID, progress, total, job);
+}
+
+unsigned int CJobGraph::FindNode(unsigned int jobID) const
+{
+  auto it = m_queued.find(jobID);
+  if (it == m_queued.end())
+    return 0;
+  return it->second;
+}
+
+void CJobGraph::QueueNode(unsigned int node)
+{
+  Node &item = m_nodes[node - 1];
+  CJob *job = item.job;
+  item.job = nullptr;
+  item.state = NodeState::QUEUED;
+
+  // the job manager owns the job from here on
+  item.jobID = CJobManager::GetInstance().AddJob(job, this, m_priority);
+  if (item.jobID == 0)
+  {
+    // job manager isn't accepting jobs (shutting down)
+    delete job;
+    Finish(node, NodeState::CANCELLED);
+    return;
+  }
+  m_queued[item.jobID] = node;
+}
+
+void CJobGraph::CancelNode(unsigned int node)
+{
+  Node &item = m_nodes[node - 1];
+  if (item.state == NodeState::WAITING)
+  {
+    delete item.job;
+    item.job = nullptr;
+  }
+  else if (item.state == NodeState::QUEUED)
+  {
+    CJobManager::GetInstance().CancelJob(item.jobID);
+    m_queued.erase(item.jobID);
+  }
+  else
+    return;
+
+  Finish(node, NodeState::CANCELLED);
+}
+
+void CJobGraph::Finish(unsigned int node, NodeState state)
+{
+  m_nodes[node - 1].state = state;
+
+  // copy, as queueing or cancelling dependants may add nodes and invalidate references
+  const std::vector<unsigned int> dependants = m_nodes[node - 1].dependants;
+  for (unsigned int dependant : dependants)
+  {
+    if (m_nodes[dependant - 1].state != NodeState::WAITING)
+      continue;
+
+    if (state == NodeState::SUCCEEDED)
+    {
+      if (--m_nodes[dependant - 1].pending == 0 && m_started)
+        QueueNode(dependant);
+    }
+    else
+      CancelNode(dependant);
+  }
+
+  if (--m_unfinished == 0)
+    m_finished.Set();
+}
@@ -0,0 +1,174 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "Job.h"
+#include "JobManager.h"
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+
+#include <map>
+#include <utility>
+#include <vector>
+
+/*!
+ \ingroup jobs
+ \brief Runs a set of jobs that depend on each other (a directed acyclic graph).
+
+ Jobs are added as nodes of the graph and may depend on any number of previously added
+ nodes. A node is handed to the CJobManager as soon as all the nodes it depends on have
+ completed successfully, so independent nodes (fan-out) run concurrently and a node that
+ depends on several others (fan-in) only runs once all of them are done.
+
+ If a node fails or is cancelled, all nodes that depend on it (directly or indirectly)
+ are cancelled as well and never run.
+
+ \code
+ CJobGraph graph;
+ unsigned int fetch = graph.Submit([]() { ... });
+ unsigned int decode = graph.Submit([]() { ... }, { fetch });
+ unsigned int scale = graph.Submit([]() { ... }, { decode });
+ unsigned int store = graph.Submit([]() { ... }, { scale });
+ graph.Start();
+ graph.Wait();
+ \endcode
+
+ \sa CJob, CJobManager and IJobCallback
+ */
+class CJobGraph : public IJobCallback
+{
+public:
+  /*!
+   \brief State of a node in the graph.
+   */
+  enum class NodeState
+  {
+    WAITING, //!< waiting for the nodes it depends on
+    QUEUED, //!< handed to the job manager
+    SUCCEEDED, //!< DoWork() returned true
+    FAILED, //!< DoWork() returned false
+    CANCELLED, //!< cancelled, either directly or because a dependency did not succeed
+  };
+
+  /*!
+   \brief CJobGraph constructor
+   \param priority priority the jobs of this graph are added to the job manager with.
+   */
+  explicit CJobGraph(CJob::PRIORITY priority = CJob::PRIORITY_LOW);
+
+  /*!
+   \brief CJobGraph destructor
+   Cancels all nodes that have not run yet as well as any in-process jobs.
+   */
+  ~CJobGraph() override;
+
+  CJobGraph(const CJobGraph&) = delete;
+  CJobGraph& operator=(const CJobGraph&) = delete;
+
+  /*!
+   \brief Add a job to the graph
+   The job is owned by the graph and destroyed once it has run or has been cancelled.
+   \param job a pointer to the job to add. The job should be subclassed from CJob.
+   \param dependsOn nodes that must complete successfully before this job is run.
+   \param callback optional callback receiving progress and completion notices of this job.
+   \return the node identifier of the job, or 0 if dependsOn references an unknown node.
+   */
+  unsigned int AddJob(CJob *job,
+                      const std::vector<unsigned int> &dependsOn = {},
+                      IJobCallback *callback = nullptr);
+
+  /*!
+   \brief Add a function f to the graph
+   \sa AddJob()
+   */
+  template<typename F>
+  unsigned int Submit(F&& f, const std::vector<unsigned int> &dependsOn = {})
+  {
+    return AddJob(new CLambdaJob<F>(std::forward<F>(f)), dependsOn);
+  }
+
+  /*!
+   \brief Add a job to be run once the given node has completed successfully
+   \sa AddJob()
+   */
+  unsigned int Then(unsigned int node, CJob *job, IJobCallback *callback = nullptr)
+  {
+    return AddJob(job, { node }, callback);
+  }
+
+  /*!
+   \brief Start processing the graph
+   Nodes added before Start() are held back until it is called, nodes added afterwards are
+   queued as soon as their dependencies allow.
+   */
+  void Start();
+
+  /*!
+   \brief Cancel a node and every node that depends on it
+   Any job currently being processed may complete after this call has completed, but
+   OnJobComplete will not be performed.
+   \param node the node to cancel, as returned by AddJob()
+   */
+  void Cancel(unsigned int node);
+
+  /*!
+   \brief Cancel all nodes of the graph that have not completed
+   */
+  void CancelAll();
+
+  /*!
+   \brief Wait until all nodes of the graph have either completed or been cancelled
+   */
+  void Wait();
+
+  /*!
+   \brief Wait until all nodes of the graph have either completed or been cancelled
+   \param milliseconds maximum time to wait.
+   \return true if the graph has finished, false on timeout.
+   */
+  bool Wait(unsigned int milliseconds);
+
+  /*!
+   \brief Check whether all nodes of the graph have either completed or been cancelled
+   */
+  bool IsFinished() const;
+
+  /*!
+   \brief Get the state of a node
+   \param node the node to query, as returned by AddJob()
+   */
+  NodeState GetState(unsigned int node) const;
+
+  void OnJobComplete(unsigned int jobID, bool success, CJob *job) override;
+  void OnJobProgress(unsigned int jobID, unsigned int progress, unsigned int total, const CJob *job) override;
+
+private:
+  struct Node
+  {
+    CJob *job = nullptr;
+    IJobCallback *callback = nullptr;
+    unsigned int jobID = 0;
+    unsigned int pending = 0;
+    NodeState state = NodeState::WAITING;
+    std::vector<unsigned int> dependants;
+  };
+
+  unsigned int FindNode(unsigned int jobID) const;
+  void QueueNode(unsigned int node);
+  void Finish(unsigned int node, NodeState state);
+  void CancelNode(unsigned int node);
+
+  std::vector<Node> m_nodes;
+  std::map<unsigned int, unsigned int> m_queued; // job manager id -> node
+  unsigned int m_unfinished = 0;
+  bool m_started = false;
+  CJob::PRIORITY m_priority;
+  mutable CCriticalSection m_section;
+  CEvent m_finished;
+};
@@ -9,6 +9,7 @@
 #include "JobManager.h"
 #include <algorithm>
 #include <functional>
+#include <random>
 #include <stdexcept>
 #include "threads/SingleLock.h"
 #include "utils/log.h"
@@ -16,6 +17,12 @@
 #include "platform/linux/XTimeUtils.h"
 #endif
 
+namespace
+{
+// work queue preferred by the job worker running on this thread, if any
+thread_local int tlsWorkQueue = -1;
+}
+
 bool CJob::ShouldCancel(unsigned int progress, unsigned int total) const
 {
   if (m_callback)
@@ -23,9 +30,10 @@ bool CJob::ShouldCancel(unsigned int progress, unsigned int total) const
   return false;
 }
 
-CJobWorker::CJobWorker(CJobManager *manager) : CThread("JobWorker")
+CJobWorker::CJobWorker(CJobManager *manager, unsigned int workQueue) : CThread("JobWorker")
 {
   m_jobManager = manager;
+  m_workQueue = workQueue;
   Create(true); // start work immediately, and kill ourselves when we're done
 }
 
@@ -42,6 +50,7 @@ CJobWorker::~CJobWorker()
 void CJobWorker::Process()
 {
   SetPriority( GetMinPriority() );
+  tlsWorkQueue = m_workQueue;
   while (true)
   {
     // request an item from our manager (this call is blocking)
@@ -165,11 +174,119 @@ CJobManager &CJobManager::GetInstance()
   return sJobManager;
 }
 
+void CJobManager::CWorkQueue::Push(const CWorkItem &item)
+{
+  CSingleLock lock(m_section);
+  m_jobs[item.m_priority].push_back(item);
+  ++m_queued[item.m_priority];
+}
+
+bool CJobManager::CWorkQueue::Pop(int priority, bool steal, CWorkItem &item)
+{
+  // avoid taking the lock just to find out the queue is empty
+  if (Empty(priority))
+    return false;
+
+  CSingleLock lock(m_section);
+  std::deque<CWorkItem> &jobs = m_jobs[priority];
+  if (jobs.empty())
+    return false;
+
+  // the owner takes the oldest job, thieves take the newest one
+  if (steal)
+  {
+    item = jobs.back();
+    jobs.pop_back();
+  }
+  else
+  {
+    item = jobs.front();
+    jobs.pop_front();
+  }
+  --m_queued[priority];
+  m_inTransit.emplace_back(item.m_id, false);
+  return true;
+}
+
+void CJobManager::CWorkQueue::PutBack(const CWorkItem &item, bool stolen)
+{
+  CSingleLock lock(m_section);
+  if (stolen)
+    m_jobs[item.m_priority].push_back(item);
+  else
+    m_jobs[item.m_priority].push_front(item);
+  ++m_queued[item.m_priority];
+}
+
+bool CJobManager::CWorkQueue::EndTransit(unsigned int jobID)
+{
+  CSingleLock lock(m_section);
+  auto it = std::find_if(m_inTransit.begin(), m_inTransit.end(),
+                         [jobID](const std::pair<unsigned int, bool>& transit) { return transit.first == jobID; });
+  if (it == m_inTransit.end())
+    return false;
+  bool cancelled = it->second;
+  m_inTransit.erase(it);
+  return cancelled;
+}
+
+bool CJobManager::CWorkQueue::Cancel(unsigned int jobID)
+{
+  CSingleLock lock(m_section);
+  for (unsigned int priority = CJob::PRIORITY_LOW_PAUSABLE; priority <= CJob::PRIORITY_DEDICATED; ++priority)
+  {
+    JobQueue::iterator i = find(m_jobs[priority].begin(), m_jobs[priority].end(), jobID);
+    if (i != m_jobs[priority].end())
+    {
+      delete i->m_job;
+      m_jobs[priority].erase(i);
+      --m_queued[priority];
+      return true;
+    }
+  }
+  // the job may have just been popped by a worker, which will drop it instead of running it
+  for (auto& transit : m_inTransit)
+  {
+    if (transit.first == jobID)
+    {
+      transit.second = true;
+      return true;
+    }
+  }
+  return false;
+}
+
+void CJobManager::CWorkQueue::Clear()
+{
+  CSingleLock lock(m_section);
+  for (unsigned int priority = CJob::PRIORITY_LOW_PAUSABLE; priority <= CJob::PRIORITY_DEDICATED; ++priority)
+  {
+    for_each(m_jobs[priority].begin(), m_jobs[priority].end(), [](CWorkItem& wi) { wi.FreeJob(); });
+    m_jobs[priority].clear();
+    m_queued[priority] = 0;
+  }
+  for (auto& transit : m_inTransit)
+    transit.second = true;
+}
+
+void CJobManager::CWorkQueue::MoveTo(std::deque<CWorkItem> *queues)
+{
+  CSingleLock lock(m_section);
+  for (unsigned int priority = CJob::PRIORITY_LOW_PAUSABLE; priority <= CJob::PRIORITY_DEDICATED; ++priority)
+  {
+    queues[priority].insert(queues[priority].end(), m_jobs[priority].begin(), m_jobs[priority].end());
+    m_jobs[priority].clear();
+    m_queued[priority] = 0;
+  }
+}
+
 CJobManager::CJobManager()
 {
   m_jobCounter = 0;
+  m_nextWorkQueue = 0;
   m_running = true;
   m_pauseJobs = false;
+  m_workStealing = false;
 }
 
 void CJobManager::Restart()
@@ -192,6 +309,8 @@ void CJobManager::CancelJobs()
     for_each(m_jobQueue[priority].begin(), m_jobQueue[priority].end(), [](CWorkItem& wi) { wi.FreeJob(); });
     m_jobQueue[priority].clear();
   }
+  for (auto& queue : m_workQueues)
+    queue.Clear();
 
   // cancel any callbacks on jobs still processing
   for_each(m_processing.begin(), m_processing.end(), [](CWorkItem& wi) { wi.Cancel(); });
@@ -220,7 +339,14 @@ unsigned int CJobManager::AddJob(CJob *job, IJobCallback *callback, CJob::PRIORI
 
   // create a work item for this job
   CWorkItem work(job, m_jobCounter, priority, callback);
-  m_jobQueue[priority].push_back(work);
+  if (m_workStealing)
+  {
+    // jobs added from a worker stay local to that worker, others are spread round robin
+    unsigned int queue = tlsWorkQueue >= 0 ? tlsWorkQueue : m_nextWorkQueue++;
+    m_workQueues[queue % WORK_QUEUES].Push(work);
+  }
+  else
+    m_jobQueue[priority].push_back(work);
 
   StartWorkers(priority);
   return work.m_id;
@@ -241,6 +367,11 @@ void CJobManager::CancelJob(unsigned int jobID)
       return;
     }
   }
+  for (auto& queue : m_workQueues)
+  {
+    if (queue.Cancel(jobID))
+      return;
+  }
   // or if we're processing it
   Processing::iterator it = find(m_processing.begin(), m_processing.end(), jobID);
   if (it != m_processing.end())
@@ -263,7 +394,7 @@ void CJobManager::StartWorkers(CJob::PRIORITY priority)
   }
 
   // everyone is busy - we need more workers
-  m_workers.push_back(new CJobWorker(this));
+  m_workers.push_back(new CJobWorker(this, m_workers.size() % WORK_QUEUES));
 }
 
 CJob *CJobManager::PopJob()
@@ -290,6 +421,97 @@ CJob *CJobManager::PopJob()
   return NULL;
 }
 
+CJob *CJobManager::PopQueuedJob(const CJobWorker *worker)
+{
+  static thread_local std::minstd_rand random(std::random_device{}());
+  const unsigned int own = worker->GetWorkQueue() % WORK_QUEUES;
+
+  for (int priority = CJob::PRIORITY_DEDICATED; priority >= CJob::PRIORITY_LOW_PAUSABLE; --priority)
+  {
+    // Check whether we're pausing pausable jobs
+    if (priority == CJob::PRIORITY_LOW_PAUSABLE && m_pauseJobs)
+      continue;
+
+    // our own queue first, then the other queues starting from a random victim
+    const unsigned int victim = random() % WORK_QUEUES;
+    for (unsigned int i = 0; i < WORK_QUEUES; ++i)
+    {
+      unsigned int index = own;
+      if (i > 0)
+      {
+        index = (victim + i) % WORK_QUEUES;
+        if (index == own)
+          index = victim;
+      }
+
+      CWorkQueue &queue = m_workQueues[index];
+      const bool steal = index != own;
+      CWorkItem item(nullptr, 0, CJob::PRIORITY(priority), nullptr);
+      while (queue.Pop(priority, steal, item))
+      {
+        CJob *job = nullptr;
+        if (!CommitQueuedJob(queue, item, steal, job))
+          return nullptr; // no spare workers for this or any lower priority
+        if (job)
+          return job;
+      }
+    }
+  }
+  return nullptr;
+}
+
+bool CJobManager::CommitQueuedJob(CWorkQueue &queue, CWorkItem &item, bool stolen, CJob *&job)
+{
+  CSingleLock lock(m_section);
+
+  // the job was cancelled while we were popping it
+  if (queue.EndTransit(item.m_id))
+  {
+    item.FreeJob();
+    return true;
+  }
+
+  if (m_processing.size() >= GetMaxWorkers(item.m_priority) ||
+      (item.m_priority == CJob::PRIORITY_LOW_PAUSABLE && m_pauseJobs))
+  {
+    queue.PutBack(item, stolen);
+    return false;
+  }
+
+  // add to the processing vector
+  m_processing.push_back(item);
+  item.m_job->m_callback = this;
+  job = item.m_job;
+  return true;
+}
+
+void CJobManager::SetWorkStealing(bool enable)
+{
+  CSingleLock lock(m_section);
+  if (m_workStealing == enable)
+    return;
+
+  // move anything that is already queued over to the new queues
+  if (enable)
+  {
+    for (unsigned int priority = CJob::PRIORITY_LOW_PAUSABLE; priority <= CJob::PRIORITY_DEDICATED; ++priority)
+    {
+      for (const auto& work : m_jobQueue[priority])
+        m_workQueues[m_nextWorkQueue++ % WORK_QUEUES].Push(work);
+      m_jobQueue[priority].clear();
+    }
+  }
+  else
+  {
+    for (auto& queue : m_workQueues)
+      queue.MoveTo(m_jobQueue);
+  }
+  m_workStealing = enable;
+
+  CLog::Log(LOGDEBUG, "CJobManager: work stealing %s", enable ? "enabled" : "disabled");
+  m_jobEvent.Set();
+}
+
 void CJobManager::PauseJobs()
 {
   CSingleLock lock(m_section);
@@ -335,23 +557,21 @@ int CJobManager::IsProcessing(const std::string &type) const
 
 CJob *CJobManager::GetNextJob(const CJobWorker *worker)
 {
-  CSingleLock lock(m_section);
   while (m_running)
   {
-    // grab a job off the queue if we have one
-    CJob *job = PopJob();
+    // grab a job off the queue if we have one. With work stealing enabled
+    // this does not need the manager lock until a job has been found.
+    CJob *job = m_workStealing ? PopQueuedJob(worker) : PopJob();
     if (job)
       return job;
     // no jobs are left - sleep for 30 seconds to allow new jobs to come in
-    lock.Leave();
-    bool newJob = m_jobEvent.WaitMSec(30000);
-    lock.Enter();
-    if (!newJob)
+    if (!m_jobEvent.WaitMSec(30000))
       break;
   }
   // ensure no jobs have come in during the period after
   // timeout and before we held the lock
-  CJob *job = PopJob();
+  CSingleLock lock(m_section);
+  CJob *job = m_workStealing ? PopQueuedJob(worker) : PopJob();
   if (job)
     return job;
   // have no jobs
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <queue>
 #include <vector>
 #include <string>
@@ -20,12 +21,19 @@ class CJobManager;
 class CJobWorker : public CThread
 {
 public:
-  explicit CJobWorker(CJobManager *manager);
+  CJobWorker(CJobManager *manager, unsigned int workQueue);
   ~CJobWorker() override;
 
   void Process() override;
+
+  /*!
+   \brief The work queue this worker prefers when work stealing is enabled.
+   \sa CJobManager::SetWorkStealing()
+   */
+  unsigned int GetWorkQueue() const { return m_workQueue; }
 private:
   CJobManager  *m_jobManager;
+  unsigned int  m_workQueue;
 };
 
 template<typename F>
@@ -186,6 +194,14 @@ private:
  priority levels.  Lower priority jobs are executed only if there are sufficient
  spare worker threads free to allow for higher priority jobs that may arise.
 
+ By default all pending jobs are kept in a single set of per-priority queues guarded
+ by the manager lock.  When work stealing is enabled, pending jobs are instead spread
+ over a fixed number of per-worker queues, each with its own lock.  A worker takes
+ jobs from the front of its own queue and, once that runs dry, steals from the back
+ of a randomly chosen victim, so idle workers no longer serialize on the manager lock
+ while looking for work.  Priorities, pausing and cancellation behave the same in
+ both modes.
+
  \sa CJob and IJobCallback
  */
 class CJobManager final
@@ -223,6 +239,31 @@ class CJobManager final
     CJob::PRIORITY m_priority;
   };
 
+  /*!
+   \brief Per-worker queue of pending jobs used when work stealing is enabled.
+
+   Jobs that have been popped but not yet moved to the processing list are tracked as
+   "in transit" so that a CancelJob() racing with the pop is not lost.
+   */
+  class CWorkQueue
+  {
+  public:
+    void Push(const CWorkItem &item);
+    bool Pop(int priority, bool steal, CWorkItem &item);
+    void PutBack(const CWorkItem &item, bool stolen);
+    bool EndTransit(unsigned int jobID);
+    bool Cancel(unsigned int jobID);
+    void Clear();
+    void MoveTo(std::deque<CWorkItem> *queues);
+    bool Empty(int priority) const { return m_queued[priority] == 0; }
+
+  private:
+    CCriticalSection m_section;
+    std::deque<CWorkItem> m_jobs[CJob::PRIORITY_DEDICATED + 1];
+    std::atomic<unsigned int> m_queued[CJob::PRIORITY_DEDICATED + 1] = {};
+    std::vector<std::pair<unsigned int, bool>> m_inTransit;
+  };
+
 public:
   /*!
    \brief The only way through which the global instance of the CJobManager should be accessed.
@@ -301,6 +342,12 @@ public:
    */
   void UnPauseJobs();
 
+  /*!
+   \brief Checks whether jobs with priority PRIORITY_LOW_PAUSABLE are paused
+   \sa PauseJobs()
+   */
+  bool IsPaused() const { return m_pauseJobs; }
+
   /*!
    \brief Checks to see if any jobs with specific priority are currently processing.
    \param priority to search for
@@ -308,6 +355,20 @@ public:
    */
   bool IsProcessing(const CJob::PRIORITY &priority) const;
 
+  /*!
+   \brief Switches between the shared job queue and the work stealing scheduler.
+   Jobs that are already queued are moved over to the newly selected queues.
+   \param enable true to use per-worker queues with work stealing, false to use the shared queue.
+   \sa IsWorkStealing()
+   */
+  void SetWorkStealing(bool enable);
+
+  /*!
+   \brief Checks whether the work stealing scheduler is in use.
+   \sa SetWorkStealing()
+   */
+  bool IsWorkStealing() const { return m_workStealing; }
+
 protected:
   friend class CJobWorker;
   friend class CJob;
@@ -351,22 +412,40 @@ private:
    */
   CJob *PopJob();
 
+  /*! \brief Pop a job off the worker's own queue, or steal one from another worker's queue,
+   and add it to the processing queue ready to process. Used when work stealing is enabled.
+   \param worker the worker requesting the job.
+   \return the job to process, NULL if no jobs are available
+   */
+  CJob *PopQueuedJob(const CJobWorker *worker);
+
+  /*! \brief Move a job popped from a work queue to the processing queue.
+   \return true if the item was either committed or dropped, false if it had to be put back
+   because there is no capacity for its priority.
+   */
+  bool CommitQueuedJob(CWorkQueue &queue, CWorkItem &item, bool stolen, CJob *&job);
+
   void StartWorkers(CJob::PRIORITY priority);
   void RemoveWorker(const CJobWorker *worker);
   static unsigned int GetMaxWorkers(CJob::PRIORITY priority);
 
+  static const unsigned int WORK_QUEUES = 5;
+
   unsigned int m_jobCounter;
+  unsigned int m_nextWorkQueue;
 
   typedef std::deque<CWorkItem>    JobQueue;
   typedef std::vector<CWorkItem>   Processing;
   typedef std::vector<CJobWorker*> Workers;
 
   JobQueue   m_jobQueue[CJob::PRIORITY_DEDICATED + 1];
-  bool       m_pauseJobs;
+  CWorkQueue m_workQueues[WORK_QUEUES];
+  std::atomic<bool> m_pauseJobs;
+  std::atomic<bool> m_workStealing;
   Processing m_processing;
   Workers    m_workers;
 
   mutable CCriticalSection m_section;
   CEvent           m_jobEvent;
-  bool             m_running;
+  std::atomic<bool> m_running;
 };
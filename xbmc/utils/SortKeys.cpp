@@ -0,0 +1,284 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "SortKeys.h"
+#include "JobManager.h"
+#include "LangInfo.h"
+#include "SortUtils.h"
+#include "threads/Event.h"
+
+#include <algorithm>
+#include <atomic>
+#include <locale>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <thread>
+
+namespace
+{
+// a key is the collation rank of the character shifted by this, the bits
+// below hold the value of a digit plus one, so numbers need no lookup
+const unsigned int RANK_SHIFT = 4;
+const uint32_t DIGIT_MASK = (1 << RANK_SHIFT) - 1;
+
+// StringUtils::AlphaNumericCompare() compares at most this many digits as one number
+const size_t MAX_NUMBER_DIGITS = 15;
+
+// characters below this are ranked through a table instead of a map, which
+// only pays off for the labels of larger lists
+const wchar_t FAST_RANKS = 0x10000;
+const size_t FAST_RANKS_MIN_TEXT = 8192;
+
+bool IsDigit(wchar_t c)
+{
+  return c >= L'0' && c <= L'9';
+}
+
+wchar_t ToLower(wchar_t c)
+{
+  if (c >= L'A' && c <= L'Z')
+    c += L'a' - L'A';
+  return c;
+}
+
+struct SortParts
+{
+  explicit SortParts(size_t parts) : claimed(parts), remaining(parts) {}
+
+  std::vector<std::atomic<bool>> claimed;
+  std::atomic<size_t> remaining;
+  CEvent done;
+};
+}
+
+const size_t CSortKeys::PARALLEL_THRESHOLD;
+
+void CSortKeys::Reserve(size_t items, size_t labelLength /* = 32 */)
+{
+  m_text.reserve(items * (labelLength + 1));
+  m_offsets.reserve(items);
+  m_special.reserve(items);
+  m_folder.reserve(items);
+}
+
+void CSortKeys::Add(const std::wstring& label, int special /* = 0 */, int folder /* = -1 */)
+{
+  m_offsets.push_back(m_text.size());
+  // like the C string the label used to be compared as
+  m_text.insert(m_text.end(), label.c_str(), label.c_str() + wcslen(label.c_str()) + 1);
+  m_special.push_back(special);
+  m_folder.push_back(static_cast<int8_t>(folder));
+}
+
+void CSortKeys::Prepare()
+{
+  const size_t items = Size();
+
+  m_numeric = true;
+  for (size_t i = 0; i < items && m_numeric; i++)
+  {
+    const wchar_t* label = &m_text[m_offsets[i]];
+    size_t length = 0;
+    while (IsDigit(label[length]))
+      length++;
+    m_numeric = length > 0 && length <= MAX_NUMBER_DIGITS && label[length] == 0;
+  }
+
+  if (m_numeric)
+  {
+    m_numbers.resize(items);
+    for (size_t i = 0; i < items; i++)
+    {
+      int64_t number = 0;
+      for (const wchar_t* c = &m_text[m_offsets[i]]; *c; c++)
+        number = number * 10 + (*c - L'0');
+      m_numbers[i] = number;
+    }
+  }
+  else
+  {
+    // rank every character in the labels by the collation of the locale once
+    const bool useFastRanks = m_text.size() >= FAST_RANKS_MIN_TEXT;
+    std::vector<uint32_t> fastRanks(useFastRanks ? FAST_RANKS : 0);
+    auto isFast = [useFastRanks](wchar_t c)
+    {
+      return useFastRanks && c >= 0 && c < FAST_RANKS;
+    };
+
+    std::map<wchar_t, uint32_t> ranks;
+    std::vector<wchar_t> chars;
+    for (wchar_t c : m_text)
+    {
+      c = ToLower(c);
+      if (c == 0)
+        continue;
+      if (isFast(c))
+      {
+        if (!fastRanks[c])
+        {
+          fastRanks[c] = 1;
+          chars.push_back(c);
+        }
+      }
+      else if (ranks.insert(std::make_pair(c, 0)).second)
+        chars.push_back(c);
+    }
+
+    const std::collate<wchar_t>& coll = std::use_facet<std::collate<wchar_t> >(g_langInfo.GetSystemLocale());
+    auto compare = [&coll](wchar_t left, wchar_t right)
+    {
+      return coll.compare(&left, &left + 1, &right, &right + 1);
+    };
+    std::sort(chars.begin(), chars.end(), [&compare](wchar_t left, wchar_t right)
+    {
+      return compare(left, right) < 0;
+    });
+
+    uint32_t rank = 0;
+    for (size_t i = 0; i < chars.size(); i++)
+    {
+      if (i == 0 || compare(chars[i - 1], chars[i]) != 0)
+        rank++;
+      if (isFast(chars[i]))
+        fastRanks[chars[i]] = rank;
+      else
+        ranks[chars[i]] = rank;
+    }
+
+    m_keys.resize(m_text.size());
+    for (size_t i = 0; i < m_text.size(); i++)
+    {
+      const wchar_t c = ToLower(m_text[i]);
+      if (c == 0)
+        m_keys[i] = 0;
+      else
+      {
+        const uint32_t key = (isFast(c) ? fastRanks[c] : ranks[c]) << RANK_SHIFT;
+        m_keys[i] = IsDigit(c) ? key | (c - L'0' + 1) : key;
+      }
+    }
+  }
+
+  std::vector<wchar_t>().swap(m_text);
+}
+
+int64_t CSortKeys::Compare(size_t left, size_t right) const
+{
+  if (m_numeric)
+    return m_numbers[left] - m_numbers[right];
+
+  const uint32_t* l = &m_keys[m_offsets[left]];
+  const uint32_t* r = &m_keys[m_offsets[right]];
+  while (*l != 0 && *r != 0)
+  {
+    if ((*l & DIGIT_MASK) && (*r & DIGIT_MASK))
+    {
+      const uint32_t* ld = l;
+      int64_t lnum = 0;
+      while ((*ld & DIGIT_MASK) && ld < l + MAX_NUMBER_DIGITS)
+        lnum = lnum * 10 + (*ld++ & DIGIT_MASK) - 1;
+      const uint32_t* rd = r;
+      int64_t rnum = 0;
+      while ((*rd & DIGIT_MASK) && rd < r + MAX_NUMBER_DIGITS)
+        rnum = rnum * 10 + (*rd++ & DIGIT_MASK) - 1;
+      if (lnum != rnum)
+        return lnum - rnum;
+      l = ld;
+      r = rd;
+      continue;
+    }
+
+    if ((*l >> RANK_SHIFT) != (*r >> RANK_SHIFT))
+      return static_cast<int64_t>(*l >> RANK_SHIFT) - static_cast<int64_t>(*r >> RANK_SHIFT);
+    l++;
+    r++;
+  }
+  if (*r)
+    return -1;
+  else if (*l)
+    return 1;
+  return 0;
+}
+
+bool CSortKeys::Less(size_t left, size_t right, bool descending, bool handleFolders) const
+{
+  // items sorted on top or bottom go there, among themselves they keep their order
+  if (m_special[left] != m_special[right])
+    return m_special[left] == SortSpecialOnTop || m_special[right] == SortSpecialOnBottom;
+  if (m_special[left] != SortSpecialNone)
+    return false;
+
+  if (handleFolders && m_folder[left] >= 0 && m_folder[right] >= 0 && m_folder[left] != m_folder[right])
+    return m_folder[left] != 0;
+
+  const int64_t result = Compare(left, right);
+  return descending ? result > 0 : result < 0;
+}
+
+void CSortKeys::SortRange(size_t* begin, size_t* end, bool descending, bool handleFolders) const
+{
+  std::stable_sort(begin, end, [this, descending, handleFolders](size_t left, size_t right)
+  {
+    return Less(left, right, descending, handleFolders);
+  });
+}
+
+std::vector<size_t> CSortKeys::Sort(bool descending, bool handleFolders, unsigned int threads /* = 0 */) const
+{
+  std::vector<size_t> order(Size());
+  std::iota(order.begin(), order.end(), 0);
+  if (order.empty())
+    return order;
+
+  if (threads == 0)
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  const size_t parts = std::min<size_t>(threads, order.size() / (PARALLEL_THRESHOLD / 2));
+
+  if (order.size() < PARALLEL_THRESHOLD || parts < 2)
+  {
+    SortRange(order.data(), order.data() + order.size(), descending, handleFolders);
+    return order;
+  }
+
+  std::vector<size_t*> bounds;
+  for (size_t part = 0; part <= parts; part++)
+    bounds.push_back(order.data() + order.size() * part / parts);
+
+  // parts no worker of the job manager has picked up by the time this thread
+  // is done with its own are sorted here as well, so sorting from a job can't
+  // end up waiting for jobs that don't get a worker
+  auto state = std::make_shared<SortParts>(parts);
+  auto sortPart = [this, state, bounds, descending, handleFolders](size_t part)
+  {
+    if (state->claimed[part].exchange(true))
+      return;
+    SortRange(bounds[part], bounds[part + 1], descending, handleFolders);
+    if (--state->remaining == 0)
+      state->done.Set();
+  };
+
+  for (size_t part = 1; part < parts; part++)
+    CJobManager::GetInstance().Submit([sortPart, part]() { sortPart(part); }, CJob::PRIORITY_HIGH);
+  for (size_t part = 0; part < parts; part++)
+    sortPart(part);
+  state->done.Wait();
+
+  // merging neighbours keeps equal items in their order
+  auto less = [this, descending, handleFolders](size_t left, size_t right)
+  {
+    return Less(left, right, descending, handleFolders);
+  };
+  for (size_t width = 1; width < parts; width *= 2)
+  {
+    for (size_t part = 0; part + width < parts; part += 2 * width)
+      std::inplace_merge(bounds[part], bounds[part + width], bounds[std::min(part + 2 * width, parts)], less);
+  }
+
+  return order;
+}
@@ -0,0 +1,75 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/*!
+ * \brief Columns of everything SortUtils compares when sorting items
+ *
+ * The sort labels of all items are turned into collation keys once, before
+ * sorting, so comparing two items compares integers instead of looking up
+ * their fields and running the locale per character. If every label is a
+ * number, like for sorting by size or track, only the numbers are compared.
+ * The order is the one StringUtils::AlphaNumericCompare() gives.
+ *
+ * Lists of PARALLEL_THRESHOLD items or more are sorted in parts by jobs of
+ * the job manager, which are then merged.
+ */
+class CSortKeys
+{
+public:
+  static const size_t PARALLEL_THRESHOLD = 16384;
+
+  void Reserve(size_t items, size_t labelLength = 32);
+
+  /*!
+   * \brief Add the next item, call Prepare() once all are added
+   * \param label the sort label
+   * \param special SortSpecial of the item
+   * \param folder 1 for folders, 0 for files and -1 if unknown
+   */
+  void Add(const std::wstring& label, int special = 0, int folder = -1);
+
+  /*!
+   * \brief Build the collation keys or the number column of the labels
+   */
+  void Prepare();
+
+  size_t Size() const { return m_special.size(); }
+  bool IsNumeric() const { return m_numeric; }
+
+  /*!
+   * \brief Compare the labels of two items like StringUtils::AlphaNumericCompare()
+   */
+  int64_t Compare(size_t left, size_t right) const;
+
+  /*!
+   * \brief Get the stable order of the items
+   * \param descending sort the labels in descending order
+   * \param handleFolders sort folders above files
+   * \param threads parts to sort large lists in concurrently, 0 for one per core
+   * \return indexes of the items in sorted order
+   */
+  std::vector<size_t> Sort(bool descending, bool handleFolders, unsigned int threads = 0) const;
+
+private:
+  bool Less(size_t left, size_t right, bool descending, bool handleFolders) const;
+  void SortRange(size_t* begin, size_t* end, bool descending, bool handleFolders) const;
+
+  std::vector<wchar_t> m_text; //!< labels until Prepare(), each one ends with 0
+  std::vector<uint32_t> m_keys; //!< collation keys after Prepare(), each one ends with 0
+  std::vector<size_t> m_offsets; //!< start of the label and the key of every item
+  std::vector<int64_t> m_numbers;
+  std::vector<int> m_special;
+  std::vector<int8_t> m_folder;
+  bool m_numeric = false;
+};
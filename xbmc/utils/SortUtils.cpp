@@ -7,6 +7,7 @@
  */
 
 #include "SortUtils.h"
+#include "SortKeys.h"
 #include "LangInfo.h"
 #include "URL.h"
 #include "Util.h"
@@ -422,130 +423,29 @@ std::string ByLastUsed(SortAttribute attributes, const SortItem &values)
   return values.at(FieldLastUsed).asString();
 }
 
-bool preliminarySort(const SortItem &left, const SortItem &right, bool handleFolder, bool &result, std::wstring &labelLeft, std::wstring &labelRight)
+void AddSortKey(CSortKeys &keys, const SortItem &item)
 {
-  // make sure both items have the necessary data to do the sorting
-  SortItem::const_iterator itLeftSort, itRightSort;
-  if ((itLeftSort = left.find(FieldSort)) == left.end())
-  {
-    result = false;
-    return true;
-  }
-  if ((itRightSort = right.find(FieldSort)) == right.end())
-  {
-    result = true;
-    return true;
-  }
-
-  // look at special sorting behaviour
-  SortItem::const_iterator itLeft, itRight;
-  SortSpecial leftSortSpecial = SortSpecialNone;
-  SortSpecial rightSortSpecial = SortSpecialNone;
-  if ((itLeft = left.find(FieldSortSpecial)) != left.end() && itLeft->second.asInteger() <= (int64_t)SortSpecialOnBottom)
-    leftSortSpecial = (SortSpecial)itLeft->second.asInteger();
-  if ((itRight = right.find(FieldSortSpecial)) != right.end() && itRight->second.asInteger() <= (int64_t)SortSpecialOnBottom)
-    rightSortSpecial = (SortSpecial)itRight->second.asInteger();
-
-  // one has a special sort
-  if (leftSortSpecial != rightSortSpecial)
-  {
-    // left should be sorted on top
-    // or right should be sorted on bottom
-    // => left is sorted above right
-    if (leftSortSpecial == SortSpecialOnTop ||
-        rightSortSpecial == SortSpecialOnBottom)
-    {
-      result = true;
-      return true;
-    }
-
-    // otherwise right is sorted above left
-    result = false;
-    return true;
-  }
-  // both have either sort on top or sort on bottom -> leave as-is
-  else if (leftSortSpecial != SortSpecialNone && leftSortSpecial == rightSortSpecial)
-  {
-    result = false;
-    return true;
-  }
-
-  if (handleFolder)
-  {
-    itLeft = left.find(FieldFolder);
-    itRight = right.find(FieldFolder);
-    if (itLeft != left.end() && itRight != right.end() &&
-        itLeft->second.asBoolean() != itRight->second.asBoolean())
-    {
-      result = itLeft->second.asBoolean();
-      return true;
-    }
-  }
+  // items with values beyond SortSpecialOnBottom are sorted like any other
+  SortItem::const_iterator it;
+  int special = SortSpecialNone;
+  if ((it = item.find(FieldSortSpecial)) != item.end() && it->second.asInteger() <= (int64_t)SortSpecialOnBottom)
+    special = (int)it->second.asInteger();
 
-  labelLeft = itLeftSort->second.asWideString();
-  labelRight = itRightSort->second.asWideString();
+  int folder = -1;
+  if ((it = item.find(FieldFolder)) != item.end())
+    folder = it->second.asBoolean() ? 1 : 0;
 
-  return false;
+  keys.Add(item.at(FieldSort).asWideString(), special, folder);
 }
 
-bool SorterAscending(const SortItem &left, const SortItem &right)
-{
-  bool result;
-  std::wstring labelLeft, labelRight;
-  if (preliminarySort(left, right, true, result, labelLeft, labelRight))
-    return result;
-
-  return StringUtils::AlphaNumericCompare(labelLeft.c_str(), labelRight.c_str()) < 0;
-}
-
-bool SorterDescending(const SortItem &left, const SortItem &right)
-{
-  bool result;
-  std::wstring labelLeft, labelRight;
-  if (preliminarySort(left, right, true, result, labelLeft, labelRight))
-    return result;
-
-  return StringUtils::AlphaNumericCompare(labelLeft.c_str(), labelRight.c_str()) > 0;
-}
-
-bool SorterIgnoreFoldersAscending(const SortItem &left, const SortItem &right)
-{
-  bool result;
-  std::wstring labelLeft, labelRight;
-  if (preliminarySort(left, right, false, result, labelLeft, labelRight))
-    return result;
-
-  return StringUtils::AlphaNumericCompare(labelLeft.c_str(), labelRight.c_str()) < 0;
-}
-
-bool SorterIgnoreFoldersDescending(const SortItem &left, const SortItem &right)
-{
-  bool result;
-  std::wstring labelLeft, labelRight;
-  if (preliminarySort(left, right, false, result, labelLeft, labelRight))
-    return result;
-
-  return StringUtils::AlphaNumericCompare(labelLeft.c_str(), labelRight.c_str()) > 0;
-}
-
-bool SorterIndirectAscending(const SortItemPtr &left, const SortItemPtr &right)
-{
-  return SorterAscending(*left, *right);
-}
-
-bool SorterIndirectDescending(const SortItemPtr &left, const SortItemPtr &right)
-{
-  return SorterDescending(*left, *right);
-}
-
-bool SorterIndirectIgnoreFoldersAscending(const SortItemPtr &left, const SortItemPtr &right)
-{
-  return SorterIgnoreFoldersAscending(*left, *right);
-}
-
-bool SorterIndirectIgnoreFoldersDescending(const SortItemPtr &left, const SortItemPtr &right)
+template<typename T>
+void ApplyOrder(std::vector<T> &items, const std::vector<size_t> &order)
 {
-  return SorterIgnoreFoldersDescending(*left, *right);
+  std::vector<T> sorted;
+  sorted.reserve(items.size());
+  for (size_t index : order)
+    sorted.push_back(std::move(items[index]));
+  items.swap(sorted);
 }
 
 std::map<SortBy, SortUtils::SortPreparator> fillPreparators()
@@ -707,6 +607,8 @@ void SortUtils::Sort(SortBy sortBy, SortOrder sortOrder, SortAttribute attribute
     if (preparator != NULL)
     {
       Fields sortingFields = GetFieldsForSorting(sortBy);
+      CSortKeys keys;
+      keys.Reserve(items.size());
 
       // Prepare the string used for sorting and store it under FieldSort
       for (DatabaseResults::iterator item = items.begin(); item != items.end(); ++item)
@@ -721,10 +623,12 @@ void SortUtils::Sort(SortBy sortBy, SortOrder sortOrder, SortAttribute attribute
         std::wstring sortLabel;
         g_charsetConverter.utf8ToW(preparator(attributes, *item), sortLabel, false);
         item->insert(std::pair<Field, CVariant>(FieldSort, CVariant(sortLabel)));
+        AddSortKey(keys, *item);
       }
 
       // Do the sorting
-      std::stable_sort(items.begin(), items.end(), getSorter(sortOrder, attributes));
+      keys.Prepare();
+      ApplyOrder(items, keys.Sort(sortOrder == SortOrderDescending, !(attributes & SortAttributeIgnoreFolders)));
     }
   }
 
@@ -746,6 +650,8 @@ void SortUtils::Sort(SortBy sortBy, SortOrder sortOrder, SortAttribute attribute
     if (preparator != NULL)
     {
       Fields sortingFields = GetFieldsForSorting(sortBy);
+      CSortKeys keys;
+      keys.Reserve(items.size());
 
       // Prepare the string used for sorting and store it under FieldSort
       for (SortItems::iterator item = items.begin(); item != items.end(); ++item)
@@ -760,10 +666,12 @@ void SortUtils::Sort(SortBy sortBy, SortOrder sortOrder, SortAttribute attribute
         std::wstring sortLabel;
         g_charsetConverter.utf8ToW(preparator(attributes, **item), sortLabel, false);
         (*item)->insert(std::pair<Field, CVariant>(FieldSort, CVariant(sortLabel)));
+        AddSortKey(keys, **item);
       }
 
       // Do the sorting
-      std::stable_sort(items.begin(), items.end(), getSorterIndirect(sortOrder, attributes));
+      keys.Prepare();
+      ApplyOrder(items, keys.Sort(sortOrder == SortOrderDescending, !(attributes & SortAttributeIgnoreFolders)));
     }
   }
 
@@ -816,22 +724,6 @@ const SortUtils::SortPreparator& SortUtils::getPreparator(SortBy sortBy)
   return m_preparators[SortByNone];
 }
 
-SortUtils::Sorter SortUtils::getSorter(SortOrder sortOrder, SortAttribute attributes)
-{
-  if (attributes & SortAttributeIgnoreFolders)
-    return sortOrder == SortOrderDescending ? SorterIgnoreFoldersDescending : SorterIgnoreFoldersAscending;
-
-  return sortOrder == SortOrderDescending ? SorterDescending : SorterAscending;
-}
-
-SortUtils::SorterIndirect SortUtils::getSorterIndirect(SortOrder sortOrder, SortAttribute attributes)
-{
-  if (attributes & SortAttributeIgnoreFolders)
-    return sortOrder == SortOrderDescending ? SorterIndirectIgnoreFoldersDescending : SorterIndirectIgnoreFoldersAscending;
-
-  return sortOrder == SortOrderDescending ? SorterIndirectDescending : SorterIndirectAscending;
-}
-
 const Fields& SortUtils::GetFieldsForSorting(SortBy sortBy)
 {
   std::map<SortBy, Fields>::const_iterator it = m_sortingFields.find(sortBy);
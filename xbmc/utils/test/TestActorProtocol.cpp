@@ -0,0 +1,262 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "threads/Event.h"
+#include "utils/ActorProtocol.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace Actor;
+
+namespace
+{
+enum Signals
+{
+  PING = 1,
+  PONG,
+  DEVICECHANGE,
+  QUIT,
+};
+}
+
+TEST(TestActorProtocol, KeepsOrder)
+{
+  Protocol port("test");
+  for (int i = 0; i < 200; i++)
+    port.SendOutMessage(PING, &i, sizeof(i));
+
+  Message *msg;
+  for (int i = 0; i < 200; i++)
+  {
+    ASSERT_TRUE(port.ReceiveOutMessage(&msg));
+    EXPECT_EQ(PING, msg->signal);
+    EXPECT_EQ(i, *reinterpret_cast<int*>(msg->data));
+    msg->Release();
+  }
+  EXPECT_FALSE(port.ReceiveOutMessage(&msg));
+}
+
+TEST(TestActorProtocol, LargePayload)
+{
+  Protocol port("test");
+  char data[100] = "some data that does not fit the internal buffer";
+  port.SendInMessage(PING, data, sizeof(data));
+
+  Message *msg;
+  ASSERT_TRUE(port.ReceiveInMessage(&msg));
+  EXPECT_STREQ(data, reinterpret_cast<char*>(msg->data));
+  msg->Release();
+}
+
+TEST(TestActorProtocol, Defer)
+{
+  Protocol port("test");
+  port.SendOutMessage(PING);
+
+  Message *msg;
+  port.DeferOut(true);
+  EXPECT_FALSE(port.ReceiveOutMessage(&msg));
+  port.DeferOut(false);
+  ASSERT_TRUE(port.ReceiveOutMessage(&msg));
+  msg->Release();
+}
+
+TEST(TestActorProtocol, PurgeOut)
+{
+  Protocol port("test");
+  port.SendOutMessage(PING);
+  port.SendOutMessage(DEVICECHANGE);
+  port.SendOutMessage(PONG);
+  port.SendOutMessage(DEVICECHANGE);
+
+  port.PurgeOut(DEVICECHANGE);
+  port.SendOutMessage(QUIT);
+
+  Message *msg;
+  for (int signal : { PING, PONG, QUIT })
+  {
+    ASSERT_TRUE(port.ReceiveOutMessage(&msg));
+    EXPECT_EQ(signal, msg->signal);
+    msg->Release();
+  }
+  EXPECT_FALSE(port.ReceiveOutMessage(&msg));
+}
+
+TEST(TestActorProtocol, ManyProducers)
+{
+  CEvent outEvent;
+  Protocol port("test", nullptr, &outEvent, 16);
+  const int producers = 4;
+  const int messages = 10000;
+
+  std::vector<std::thread> threads;
+  for (int p = 0; p < producers; p++)
+  {
+    threads.emplace_back([&port, p, messages]() {
+      for (int i = 0; i < messages; i++)
+      {
+        int value = p * messages + i;
+        port.SendOutMessage(PING, &value, sizeof(value));
+      }
+    });
+  }
+
+  std::vector<int> last(producers, -1);
+  int received = 0;
+  Message *msg;
+  while (received < producers * messages)
+  {
+    if (!port.ReceiveOutMessage(&msg))
+    {
+      outEvent.WaitMSec(10);
+      continue;
+    }
+    int value = *reinterpret_cast<int*>(msg->data);
+    int producer = value / messages;
+    // messages of one producer arrive in order
+    EXPECT_LT(last[producer], value % messages);
+    last[producer] = value % messages;
+    msg->Release();
+    received++;
+  }
+
+  for (auto& thread : threads)
+    thread.join();
+}
+
+TEST(TestActorProtocol, SyncReply)
+{
+  CEvent outEvent;
+  Protocol port("test", nullptr, &outEvent);
+
+  std::thread actor([&port, &outEvent]() {
+    bool quit = false;
+    Message *msg;
+    while (!quit)
+    {
+      if (port.ReceiveOutMessage(&msg))
+      {
+        quit = msg->signal == QUIT;
+        msg->Reply(PONG);
+        msg->Release();
+      }
+      else
+        outEvent.WaitMSec(10);
+    }
+  });
+
+  for (int i = 0; i < 10; i++)
+  {
+    Message *reply;
+    ASSERT_TRUE(port.SendOutMessageSync(PING, &reply, 1000));
+    EXPECT_EQ(PONG, reply->signal);
+    reply->Release();
+  }
+
+  Message *reply;
+  EXPECT_TRUE(port.SendOutMessageSync(QUIT, &reply, 1000));
+  if (reply)
+    reply->Release();
+  actor.join();
+}
+
+TEST(TestActorProtocol, DISABLED_SyncRoundTripBenchmark)
+{
+  CEvent outEvent;
+  Protocol port("test", nullptr, &outEvent);
+  std::atomic<bool> quit(false);
+
+  std::thread actor([&port, &outEvent, &quit]() {
+    Message *msg;
+    while (!quit)
+    {
+      if (port.ReceiveOutMessage(&msg))
+      {
+        if (msg->signal == QUIT)
+          quit = true;
+        msg->Reply(PONG);
+        msg->Release();
+      }
+      else
+        outEvent.WaitMSec(10);
+    }
+  });
+
+  const int roundTrips = 5000;
+  std::vector<double> latencies;
+  latencies.reserve(roundTrips);
+
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < roundTrips; i++)
+  {
+    Message *reply;
+    const auto sent = std::chrono::steady_clock::now();
+    ASSERT_TRUE(port.SendOutMessageSync(PING, &reply, 1000));
+    const std::chrono::duration<double, std::micro> latency = std::chrono::steady_clock::now() - sent;
+    latencies.push_back(latency.count());
+    EXPECT_EQ(PONG, reply->signal);
+    reply->Release();
+  }
+  const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+  Message *reply;
+  port.SendOutMessageSync(QUIT, &reply, 1000);
+  if (reply)
+    reply->Release();
+  actor.join();
+
+  std::sort(latencies.begin(), latencies.end());
+  const double p50 = latencies[latencies.size() / 2];
+  const double p99 = latencies[latencies.size() * 99 / 100];
+  printf("[ BENCHMARK] SendOutMessageSync: %.0f round trips/sec, p50 %.1f us, p99 %.1f us\n",
+         roundTrips / elapsed.count(), p50, p99);
+}
+
+TEST(TestActorProtocol, DISABLED_ThroughputBenchmark)
+{
+  CEvent outEvent;
+  Protocol port("test", nullptr, &outEvent);
+  const int producers = 2;
+  const int messages = 100000;
+
+  const auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+  for (int p = 0; p < producers; p++)
+  {
+    threads.emplace_back([&port, messages]() {
+      for (int i = 0; i < messages; i++)
+        port.SendOutMessage(PING, &i, sizeof(i));
+    });
+  }
+
+  int received = 0;
+  Message *msg;
+  while (received < producers * messages)
+  {
+    if (!port.ReceiveOutMessage(&msg))
+    {
+      outEvent.WaitMSec(10);
+      continue;
+    }
+    msg->Release();
+    received++;
+  }
+  const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+  for (auto& thread : threads)
+    thread.join();
+
+  printf("[ BENCHMARK] %d producers: %.0f messages/sec\n", producers, received / elapsed.count());
+}
@@ -11,8 +11,12 @@
 #endif
 
 #include "utils/Archive.h"
+#include "utils/Crc32.h"
+#include "utils/StringUtils.h"
 #include "utils/Variant.h"
+#include "filesystem/Directory.h"
 #include "filesystem/File.h"
+#include "utils/test/TestArchiveHelpers.h"
 
 #include "test/TestUtils.h"
 
@@ -409,3 +413,106 @@ TEST_F(TestArchive, MultiTypeArchive)
   EXPECT_EQ(2, iArray_var.at(2));
   EXPECT_EQ(3, iArray_var.at(3));
 }
+
+TEST(TestArchiveMemory, StoreAndLoad)
+{
+  std::vector<uint8_t> data;
+  std::string long_string_ref(3 * CARCHIVE_BUFFER_MAX, 'x');
+  CArchive arstore(data);
+  EXPECT_TRUE(arstore.IsStoring());
+  arstore << 42;
+  arstore << std::string("test string");
+  arstore << long_string_ref;
+  arstore << CVariant("test variant");
+  arstore.Close();
+
+  int int_var = 0;
+  std::string string_var, long_string_var;
+  CVariant CVariant_var;
+  CArchive arload(data.data(), data.size());
+  EXPECT_TRUE(arload.IsLoading());
+  arload >> int_var;
+  arload >> string_var;
+  arload >> long_string_var;
+  arload >> CVariant_var;
+  arload.Close();
+
+  EXPECT_EQ(42, int_var);
+  EXPECT_EQ("test string", string_var);
+  EXPECT_EQ(long_string_ref, long_string_var);
+  EXPECT_EQ("test variant", CVariant_var.asString());
+}
+
+TEST(TestArchiveMemory, LoadPastEnd)
+{
+  std::vector<uint8_t> data;
+  CArchive arstore(data);
+  arstore << 1;
+  arstore.Close();
+
+  int first = 0, second = 5;
+  std::string string_var = "not empty";
+  CArchive arload(data.data(), data.size());
+  arload >> first;
+  arload >> second;
+  arload >> string_var;
+
+  EXPECT_EQ(1, first);
+  EXPECT_EQ(0, second);
+  EXPECT_TRUE(string_var.empty());
+}
+
+TEST(TestArchiveFileItemList, RoundTrip)
+{
+  CFileItemList list("videodb://movies/titles/");
+  FillList(list, 100);
+  ASSERT_TRUE(XFILE::CDirectory::Create("special://temp/archive_cache"));
+
+  const std::string path = "special://temp/archive_cache/roundtrip.ar";
+  {
+    XFILE::CFile file;
+    ASSERT_TRUE(file.OpenForWrite(path, true));
+    CArchive ar(&file, CArchive::store);
+    ar << list;
+    ar.Close();
+  }
+
+  CFileItemList streamed;
+  {
+    XFILE::CFile file;
+    ASSERT_TRUE(file.Open(path));
+    CArchive ar(&file, CArchive::load);
+    ar >> streamed;
+    ar.Close();
+  }
+  XFILE::CFile::Delete(path);
+  ExpectEqual(list, streamed);
+
+  ASSERT_TRUE(list.Save());
+  CFileItemList cached(list.GetPath());
+  ASSERT_TRUE(cached.Load());
+  list.RemoveDiscCache();
+  ExpectEqual(list, cached);
+}
+
+TEST(TestArchiveFileItemList, IgnoresTruncatedCache)
+{
+  CFileItemList list("videodb://movies/titles/");
+  FillList(list, 10);
+  ASSERT_TRUE(XFILE::CDirectory::Create("special://temp/archive_cache"));
+  ASSERT_TRUE(list.Save());
+
+  // where CFileItemList keeps the cache of video library nodes
+  const std::string path = StringUtils::Format("special://temp/archive_cache/vdb-%08x.fi",
+                                               Crc32::ComputeFromLowerCase("videodb://movies/titles"));
+  XUTILS::auto_buffer buffer;
+  XFILE::CFile file;
+  ASSERT_GT(file.LoadFile(path, buffer), 0);
+  ASSERT_TRUE(file.OpenForWrite(path, true));
+  EXPECT_EQ(10, file.Write(buffer.get(), 10));
+  file.Close();
+
+  CFileItemList cached(list.GetPath());
+  EXPECT_FALSE(cached.Load());
+  list.RemoveDiscCache();
+}
@@ -0,0 +1,68 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "FileItem.h"
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "utils/Archive.h"
+#include "utils/test/TestArchiveHelpers.h"
+
+#include <chrono>
+#include <cstdio>
+
+#include <gtest/gtest.h>
+
+/*
+ * Stores a list of 20000 items and loads it again, streaming it through
+ * a file like caches used to and with CFileItemList::Save() and Load().
+ */
+TEST(TestArchiveBenchmark, DISABLED_FileItemList)
+{
+  const int count = 20000;
+  CFileItemList list("videodb://movies/titles/");
+  FillList(list, count);
+  ASSERT_TRUE(XFILE::CDirectory::Create("special://temp/archive_cache"));
+
+  const std::string path = "special://temp/archive_cache/benchmark.ar";
+  auto start = std::chrono::steady_clock::now();
+  {
+    XFILE::CFile file;
+    ASSERT_TRUE(file.OpenForWrite(path, true));
+    CArchive ar(&file, CArchive::store);
+    ar << list;
+    ar.Close();
+  }
+  const std::chrono::duration<double, std::milli> streamedStore = std::chrono::steady_clock::now() - start;
+
+  CFileItemList streamed;
+  start = std::chrono::steady_clock::now();
+  {
+    XFILE::CFile file;
+    ASSERT_TRUE(file.Open(path));
+    CArchive ar(&file, CArchive::load);
+    ar >> streamed;
+    ar.Close();
+  }
+  const std::chrono::duration<double, std::milli> streamedLoad = std::chrono::steady_clock::now() - start;
+  XFILE::CFile::Delete(path);
+  ExpectEqual(list, streamed);
+
+  start = std::chrono::steady_clock::now();
+  ASSERT_TRUE(list.Save());
+  const std::chrono::duration<double, std::milli> cacheStore = std::chrono::steady_clock::now() - start;
+
+  CFileItemList cached(list.GetPath());
+  start = std::chrono::steady_clock::now();
+  ASSERT_TRUE(cached.Load());
+  const std::chrono::duration<double, std::milli> cacheLoad = std::chrono::steady_clock::now() - start;
+  list.RemoveDiscCache();
+  ExpectEqual(list, cached);
+
+  printf("[ BENCHMARK] %d items: streamed through the file %.1f ms store, %.1f ms load; cache %.1f ms save, %.1f ms load\n",
+         count, streamedStore.count(), streamedLoad.count(), cacheStore.count(), cacheLoad.count());
+}
@@ -0,0 +1,66 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "FileItem.h"
+#include "music/tags/MusicInfoTag.h"
+#include "utils/StringUtils.h"
+#include "video/VideoInfoTag.h"
+
+#include "gtest/gtest.h"
+
+/*!
+ * \brief A library node of movies and songs with their tags, like the views cache them
+ */
+inline void FillList(CFileItemList& list, int count)
+{
+  for (int i = 0; i < count; i++)
+  {
+    CFileItemPtr item(new CFileItem(StringUtils::Format("Item %d", i)));
+    item->SetPath(StringUtils::Format("videodb://movies/titles/%d", i));
+    if (i % 2)
+    {
+      CVideoInfoTag* tag = item->GetVideoInfoTag();
+      tag->SetTitle(StringUtils::Format("Movie %d", i));
+      tag->SetPlot(std::string(400, 'p'));
+      tag->SetGenre({ "Drama", "Comedy" });
+      tag->SetYear(1950 + i % 70);
+      tag->SetDuration(5400);
+    }
+    else
+    {
+      MUSIC_INFO::CMusicInfoTag* tag = item->GetMusicInfoTag();
+      tag->SetTitle(StringUtils::Format("Song %d", i));
+      tag->SetArtist(StringUtils::Format("Artist %d", i / 100));
+      tag->SetAlbum(StringUtils::Format("Album %d", i / 10));
+      tag->SetTrackNumber(i % 10 + 1);
+      tag->SetDuration(240);
+    }
+    list.Add(item);
+  }
+}
+
+inline void ExpectEqual(CFileItemList& expected, CFileItemList& list)
+{
+  ASSERT_EQ(expected.Size(), list.Size());
+  for (int i = 0; i < list.Size(); i++)
+  {
+    EXPECT_EQ(expected[i]->GetLabel(), list[i]->GetLabel());
+    EXPECT_EQ(expected[i]->GetPath(), list[i]->GetPath());
+    EXPECT_EQ(expected[i]->HasVideoInfoTag(), list[i]->HasVideoInfoTag());
+    if (list[i]->HasVideoInfoTag())
+    {
+      EXPECT_EQ(expected[i]->GetVideoInfoTag()->m_strTitle, list[i]->GetVideoInfoTag()->m_strTitle);
+    }
+    if (list[i]->HasMusicInfoTag())
+    {
+      EXPECT_EQ(expected[i]->GetMusicInfoTag()->GetTitle(), list[i]->GetMusicInfoTag()->GetTitle());
+    }
+  }
+}
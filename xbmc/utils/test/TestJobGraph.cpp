@@ -0,0 +1,137 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "threads/Event.h"
+#include "threads/SingleLock.h"
+#include "utils/JobGraph.h"
+#include "utils/JobManager.h"
+
+#include <atomic>
+#include <string>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+class FailingJob : public CJob
+{
+public:
+  bool DoWork() override { return false; }
+};
+
+class BlockingJob : public CJob
+{
+public:
+  explicit BlockingJob(CEvent &release) : m_release(release) {}
+  bool DoWork() override
+  {
+    m_release.Wait();
+    return true;
+  }
+
+private:
+  CEvent &m_release;
+};
+}
+
+class TestJobGraph : public testing::Test
+{
+protected:
+  ~TestJobGraph() override
+  {
+    CJobManager::GetInstance().CancelJobs();
+    CJobManager::GetInstance().Restart();
+  }
+};
+
+TEST_F(TestJobGraph, RunsInDependencyOrder)
+{
+  CCriticalSection section;
+  std::string order;
+  auto append = [&section, &order](char c) {
+    CSingleLock lock(section);
+    order += c;
+  };
+
+  CJobGraph graph;
+  unsigned int a = graph.Submit([&append]() { append('a'); });
+  unsigned int b = graph.Submit([&append]() { append('b'); }, { a });
+  unsigned int c = graph.Submit([&append]() { append('c'); }, { b });
+  graph.Start();
+
+  EXPECT_TRUE(graph.Wait(10000));
+  EXPECT_EQ("abc", order);
+  EXPECT_EQ(CJobGraph::NodeState::SUCCEEDED, graph.GetState(c));
+}
+
+TEST_F(TestJobGraph, FanOutFanIn)
+{
+  std::atomic<int> fanned(0);
+  std::atomic<int> seenByJoin(-1);
+
+  CJobGraph graph(CJob::PRIORITY_HIGH);
+  unsigned int root = graph.Submit([]() {});
+  std::vector<unsigned int> branches;
+  for (int i = 0; i < 8; i++)
+    branches.push_back(graph.Submit([&fanned]() { fanned++; }, { root }));
+  graph.Submit([&fanned, &seenByJoin]() { seenByJoin = fanned.load(); }, branches);
+  graph.Start();
+
+  EXPECT_TRUE(graph.Wait(10000));
+  EXPECT_EQ(8, seenByJoin);
+}
+
+TEST_F(TestJobGraph, FailurePropagates)
+{
+  std::atomic<bool> ran(false);
+
+  CJobGraph graph;
+  unsigned int a = graph.AddJob(new FailingJob());
+  unsigned int b = graph.Submit([&ran]() { ran = true; }, { a });
+  unsigned int c = graph.Submit([&ran]() { ran = true; }, { b });
+  graph.Start();
+
+  EXPECT_TRUE(graph.Wait(10000));
+  EXPECT_FALSE(ran);
+  EXPECT_EQ(CJobGraph::NodeState::FAILED, graph.GetState(a));
+  EXPECT_EQ(CJobGraph::NodeState::CANCELLED, graph.GetState(b));
+  EXPECT_EQ(CJobGraph::NodeState::CANCELLED, graph.GetState(c));
+
+  // adding to a failed node cancels straight away
+  unsigned int d = graph.Submit([&ran]() { ran = true; }, { c });
+  EXPECT_EQ(CJobGraph::NodeState::CANCELLED, graph.GetState(d));
+  EXPECT_TRUE(graph.IsFinished());
+}
+
+TEST_F(TestJobGraph, CancelPropagates)
+{
+  // the cancelled job keeps running until released, so it must outlive the test body
+  static CEvent release(true);
+  std::atomic<bool> ran(false);
+
+  CJobGraph graph;
+  unsigned int a = graph.AddJob(new BlockingJob(release));
+  unsigned int b = graph.Submit([&ran]() { ran = true; }, { a });
+  unsigned int independent = graph.Submit([]() {});
+  graph.Start();
+
+  graph.Cancel(a);
+  release.Set();
+
+  EXPECT_TRUE(graph.Wait(10000));
+  EXPECT_FALSE(ran);
+  EXPECT_EQ(CJobGraph::NodeState::CANCELLED, graph.GetState(a));
+  EXPECT_EQ(CJobGraph::NodeState::CANCELLED, graph.GetState(b));
+  EXPECT_NE(CJobGraph::NodeState::CANCELLED, graph.GetState(independent));
+}
+
+TEST_F(TestJobGraph, UnknownDependency)
+{
+  CJobGraph graph;
+  EXPECT_EQ(0u, graph.Submit([]() {}, { 42 }));
+}
@@ -42,6 +42,7 @@ protected:
   {
     /* Always cancel jobs test completion */
     CJobManager::GetInstance().CancelJobs();
+    CJobManager::GetInstance().SetWorkStealing(false);
     CJobManager::GetInstance().Restart();
   }
 };
@@ -170,3 +171,51 @@ TEST_F(TestJobManager, IsProcessing)
 
   job->FinishAndStopBlocking();
 }
+
+TEST_F(TestJobManager, WorkStealingCancelJob)
+{
+  CJobManager::GetInstance().SetWorkStealing(true);
+  cancelled = false;
+
+  unsigned int id;
+  CJob* job = new DummyJob();
+  id = CJobManager::GetInstance().AddJob(job, NULL);
+  Sleep(50);
+  CJobManager::GetInstance().CancelJob(id);
+  Sleep(100);
+  EXPECT_TRUE(cancelled);
+}
+
+TEST_F(TestJobManager, WorkStealingPauseLowPriorityJob)
+{
+  CJobManager::GetInstance().SetWorkStealing(true);
+
+  JobControlPackage package;
+  BroadcastingJob *job (WaitForJobToStartProcessing(CJob::PRIORITY_LOW_PAUSABLE, package));
+
+  EXPECT_TRUE(CJobManager::GetInstance().IsProcessing(CJob::PRIORITY_LOW_PAUSABLE));
+  CJobManager::GetInstance().PauseJobs();
+  EXPECT_FALSE(CJobManager::GetInstance().IsProcessing(CJob::PRIORITY_LOW_PAUSABLE));
+  CJobManager::GetInstance().UnPauseJobs();
+  EXPECT_TRUE(CJobManager::GetInstance().IsProcessing(CJob::PRIORITY_LOW_PAUSABLE));
+
+  job->FinishAndStopBlocking();
+}
+
+TEST_F(TestJobManager, WorkStealingRunsAllJobs)
+{
+  CJobManager::GetInstance().SetWorkStealing(true);
+
+  static const unsigned int jobs = 1000;
+  static std::atomic<unsigned int> done(0);
+  static CEvent finished;
+  for (unsigned int i = 0; i < jobs; i++)
+  {
+    CJobManager::GetInstance().Submit([]() {
+      if (++done == jobs)
+        finished.Set();
+    }, CJob::PRIORITY_HIGH);
+  }
+  EXPECT_TRUE(finished.WaitMSec(10000));
+  EXPECT_EQ(jobs, done);
+}
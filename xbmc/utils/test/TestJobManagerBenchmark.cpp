@@ -0,0 +1,101 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "threads/Event.h"
+#include "utils/JobManager.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+/*
+ * The number of workers the job manager is allowed to use depends on the
+ * priority of the queued jobs, so each priority level gives us a different
+ * worker count: LOW_PAUSABLE=2, LOW=3, NORMAL=4, HIGH=5.
+ */
+struct BenchmarkParam
+{
+  CJob::PRIORITY priority;
+  unsigned int workers;
+  bool workStealing;
+};
+
+const unsigned int BENCHMARK_JOBS = 20000;
+
+class TestJobManagerBenchmark : public testing::TestWithParam<BenchmarkParam>
+{
+protected:
+  ~TestJobManagerBenchmark() override
+  {
+    CJobManager::GetInstance().CancelJobs();
+    CJobManager::GetInstance().SetWorkStealing(false);
+    CJobManager::GetInstance().Restart();
+  }
+};
+
+struct BenchmarkState
+{
+  std::atomic<unsigned int> done{0};
+  std::atomic<unsigned int> sink{0};
+  CEvent finished;
+};
+
+double RunJobs(const BenchmarkParam& param)
+{
+  // jobs may still be touching the state after we've been woken up
+  auto state = std::make_shared<BenchmarkState>();
+
+  const auto start = std::chrono::steady_clock::now();
+  for (unsigned int i = 0; i < BENCHMARK_JOBS; i++)
+  {
+    CJobManager::GetInstance().Submit([state, i]() {
+      // a little bit of work so the job isn't free
+      unsigned int value = i;
+      for (int n = 0; n < 200; n++)
+        value = value * 1664525u + 1013904223u;
+      state->sink += value & 1;
+
+      if (++state->done == BENCHMARK_JOBS)
+        state->finished.Set();
+    }, param.priority);
+  }
+  if (!state->finished.WaitMSec(60000))
+    return 0.0;
+  const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+  return BENCHMARK_JOBS / elapsed.count();
+}
+}
+
+TEST_P(TestJobManagerBenchmark, DISABLED_JobsPerSecond)
+{
+  const BenchmarkParam& param = GetParam();
+  CJobManager::GetInstance().SetWorkStealing(param.workStealing);
+
+  double jobsPerSecond = RunJobs(param);
+  EXPECT_GT(jobsPerSecond, 0.0);
+
+  printf("[ BENCHMARK] %s, %u workers: %.0f jobs/sec\n",
+         param.workStealing ? "work stealing" : "shared queue", param.workers, jobsPerSecond);
+  RecordProperty("JobsPerSecond", static_cast<int>(jobsPerSecond));
+}
+
+INSTANTIATE_TEST_CASE_P(JobManager, TestJobManagerBenchmark,
+                        testing::Values(BenchmarkParam{CJob::PRIORITY_LOW_PAUSABLE, 2, false},
+                                        BenchmarkParam{CJob::PRIORITY_LOW, 3, false},
+                                        BenchmarkParam{CJob::PRIORITY_NORMAL, 4, false},
+                                        BenchmarkParam{CJob::PRIORITY_HIGH, 5, false},
+                                        BenchmarkParam{CJob::PRIORITY_LOW_PAUSABLE, 2, true},
+                                        BenchmarkParam{CJob::PRIORITY_LOW, 3, true},
+                                        BenchmarkParam{CJob::PRIORITY_NORMAL, 4, true},
+                                        BenchmarkParam{CJob::PRIORITY_HIGH, 5, true}));
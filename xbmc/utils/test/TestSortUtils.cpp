@@ -6,11 +6,71 @@
  *  See LICENSES/README.md for more information.
  */
 
+#include "utils/SortKeys.h"
 #include "utils/SortUtils.h"
+#include "utils/StringUtils.h"
 #include "utils/Variant.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+
 #include "gtest/gtest.h"
 
+namespace
+{
+std::wstring CreateLabel(std::mt19937& random)
+{
+  static const wchar_t chars[] = L"aAbBcCzZ  019.-()\u00e9\u00c9";
+  std::uniform_int_distribution<size_t> length(0, 12);
+  std::uniform_int_distribution<size_t> index(0, sizeof(chars) / sizeof(wchar_t) - 2);
+
+  std::wstring label;
+  for (size_t i = length(random); i > 0; i--)
+    label += chars[index(random)];
+  return label;
+}
+
+/*!
+ * \brief Library like songs, many tracks of few albums of fewer artists
+ */
+SortItems CreateSongs(size_t count)
+{
+  std::mt19937 random(1);
+  std::uniform_int_distribution<int> artist(0, static_cast<int>(count / 200));
+  std::uniform_int_distribution<int> album(0, 9);
+  std::uniform_int_distribution<int> track(1, 20);
+
+  SortItems items;
+  items.reserve(count);
+  for (size_t i = 0; i < count; i++)
+  {
+    const int artistId = artist(random);
+    SortItemPtr item(new SortItem());
+    (*item)[FieldId] = static_cast<int64_t>(i);
+    (*item)[FieldLabel] = StringUtils::Format("Song %zu", i);
+    (*item)[FieldArtist] = CVariant(CVariant::VariantTypeArray);
+    (*item)[FieldArtist].push_back(StringUtils::Format("Artist %d", artistId));
+    (*item)[FieldAlbum] = StringUtils::Format("Album %d of %d", album(random), artistId);
+    (*item)[FieldTrackNumber] = track(random);
+    items.push_back(item);
+  }
+  return items;
+}
+
+/*!
+ * \brief How SortUtils compared items before CSortKeys, without the checks
+ * for FieldSortSpecial and FieldFolder, which the songs don't have
+ */
+bool LegacyLess(const SortItemPtr& left, const SortItemPtr& right)
+{
+  std::wstring labelLeft = left->at(FieldSort).asWideString();
+  std::wstring labelRight = right->at(FieldSort).asWideString();
+  return StringUtils::AlphaNumericCompare(labelLeft.c_str(), labelRight.c_str()) < 0;
+}
+}
+
 TEST(TestSortUtils, Sort_SortBy)
 {
   SortItems items;
@@ -121,3 +181,137 @@ TEST(TestSortUtils, GetFieldsForSorting)
   EXPECT_EQ(FieldTrackNumber, *it);
   EXPECT_EQ((unsigned int)5, fields.size());
 }
+
+TEST(TestSortUtils, SortKeys_MatchAlphaNumericCompare)
+{
+  std::mt19937 random(2);
+  std::vector<std::wstring> labels;
+  CSortKeys keys;
+  for (int i = 0; i < 2000; i++)
+  {
+    labels.push_back(CreateLabel(random));
+    keys.Add(labels.back());
+  }
+  keys.Prepare();
+  EXPECT_FALSE(keys.IsNumeric());
+
+  std::uniform_int_distribution<size_t> index(0, labels.size() - 1);
+  for (int i = 0; i < 20000; i++)
+  {
+    const size_t left = index(random);
+    const size_t right = index(random);
+    const int64_t expected = StringUtils::AlphaNumericCompare(labels[left].c_str(), labels[right].c_str());
+    const int64_t result = keys.Compare(left, right);
+    EXPECT_EQ(expected < 0, result < 0);
+    EXPECT_EQ(expected > 0, result > 0);
+  }
+}
+
+TEST(TestSortUtils, SortKeys_Numbers)
+{
+  CSortKeys keys;
+  keys.Add(L"100");
+  keys.Add(L"20");
+  keys.Add(L"020");
+  keys.Add(L"3");
+  keys.Prepare();
+  EXPECT_TRUE(keys.IsNumeric());
+
+  const std::vector<size_t> order = keys.Sort(false, true);
+  EXPECT_EQ(std::vector<size_t>({ 3, 1, 2, 0 }), order);
+}
+
+TEST(TestSortUtils, SortKeys_SpecialAndFolders)
+{
+  CSortKeys keys;
+  keys.Add(L"b", SortSpecialNone, 0);
+  keys.Add(L"z", SortSpecialOnTop, 0);
+  keys.Add(L"c", SortSpecialNone, 1);
+  keys.Add(L"a", SortSpecialOnBottom, 1);
+  keys.Add(L"a", SortSpecialNone, 0);
+  keys.Prepare();
+
+  EXPECT_EQ(std::vector<size_t>({ 1, 2, 4, 0, 3 }), keys.Sort(false, true));
+  EXPECT_EQ(std::vector<size_t>({ 1, 4, 0, 2, 3 }), keys.Sort(false, false));
+  EXPECT_EQ(std::vector<size_t>({ 1, 2, 0, 4, 3 }), keys.Sort(true, true));
+}
+
+TEST(TestSortUtils, SortKeys_Parallel)
+{
+  std::mt19937 random(3);
+  std::uniform_int_distribution<int> folder(0, 1);
+  CSortKeys keys;
+  for (size_t i = 0; i < CSortKeys::PARALLEL_THRESHOLD * 3; i++)
+    keys.Add(CreateLabel(random), SortSpecialNone, folder(random));
+  keys.Prepare();
+
+  for (bool descending : { false, true })
+    EXPECT_EQ(keys.Sort(descending, true, 1), keys.Sort(descending, true, 5));
+}
+
+TEST(TestSortUtils, SortKeys_MatchComparingLabels)
+{
+  const size_t count = 3000;
+  SortItems items = CreateSongs(count);
+  SortUtils::Sort(SortByArtist, SortOrderAscending, SortAttributeNone, items);
+
+  // the labels are there now, put the songs back in their original order
+  std::sort(items.begin(), items.end(), [](const SortItemPtr& left, const SortItemPtr& right)
+  {
+    return left->at(FieldId).asInteger() < right->at(FieldId).asInteger();
+  });
+
+  SortItems legacy = items;
+  std::stable_sort(legacy.begin(), legacy.end(), LegacyLess);
+
+  CSortKeys keys;
+  for (const SortItemPtr& item : items)
+    keys.Add(item->at(FieldSort).asWideString());
+  keys.Prepare();
+  const std::vector<size_t> order = keys.Sort(false, true);
+
+  ASSERT_EQ(count, order.size());
+  for (size_t i = 0; i < count; i++)
+    ASSERT_EQ(legacy[i]->at(FieldId).asInteger(), items[order[i]]->at(FieldId).asInteger());
+}
+
+/*
+ * Sorts 60000 songs by artist, album and track like CFileItemList::Sort,
+ * comparing the sort keys with comparing the labels of the items.
+ */
+TEST(TestSortUtils, DISABLED_Benchmark)
+{
+  const size_t count = 60000;
+  SortItems items = CreateSongs(count);
+
+  auto start = std::chrono::steady_clock::now();
+  SortUtils::Sort(SortByArtist, SortOrderAscending, SortAttributeNone, items);
+  const std::chrono::duration<double, std::milli> sorted = std::chrono::steady_clock::now() - start;
+
+  // the labels are there now, put the songs back in their original order
+  std::sort(items.begin(), items.end(), [](const SortItemPtr& left, const SortItemPtr& right)
+  {
+    return left->at(FieldId).asInteger() < right->at(FieldId).asInteger();
+  });
+
+  SortItems legacy = items;
+  start = std::chrono::steady_clock::now();
+  std::stable_sort(legacy.begin(), legacy.end(), LegacyLess);
+  const std::chrono::duration<double, std::milli> compared = std::chrono::steady_clock::now() - start;
+
+  start = std::chrono::steady_clock::now();
+  CSortKeys keys;
+  keys.Reserve(count);
+  for (const SortItemPtr& item : items)
+    keys.Add(item->at(FieldSort).asWideString());
+  keys.Prepare();
+  const std::vector<size_t> order = keys.Sort(false, true);
+  const std::chrono::duration<double, std::milli> keyed = std::chrono::steady_clock::now() - start;
+
+  ASSERT_EQ(count, order.size());
+  for (size_t i = 0; i < count; i++)
+    ASSERT_EQ(legacy[i]->at(FieldId).asInteger(), items[order[i]]->at(FieldId).asInteger());
+
+  printf("[ BENCHMARK] %zu songs by artist: SortUtils::Sort %.1f ms, from the labels %.1f ms with sort keys, %.1f ms comparing labels\n",
+         count, sorted.count(), keyed.count(), compared.count());
+}
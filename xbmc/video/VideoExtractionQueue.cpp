@@ -0,0 +1,141 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "VideoExtractionQueue.h"
+
+#include <algorithm>
+
+#include "cores/VideoPlayer/DVDFileInfo.h"
+#include "FileItem.h"
+#include "ServiceBroker.h"
+#include "settings/Settings.h"
+#include "settings/SettingsComponent.h"
+#include "TextureCache.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "threads/Thread.h"
+#include "utils/CPUInfo.h"
+#include "utils/log.h"
+#include "video/VideoInfoTag.h"
+#include "video/VideoThumbLoader.h"
+
+namespace
+{
+const unsigned int MAX_WORKERS = 4;
+const unsigned int PAUSE_POLL_MS = 500;
+
+/*!
+ \brief Thumb extractor that waits while jobs are paused
+
+ Dedicated workers are not held back by the job manager, so the job waits
+ itself instead of decoding next to the player.
+ */
+class CVideoExtractionJob : public CThumbExtractor
+{
+public:
+  CVideoExtractionJob(const CFileItem& item, bool thumb, const std::string& target = "")
+    : CThumbExtractor(item, item.GetPath(), thumb, target)
+  {
+  }
+
+  bool DoWork() override
+  {
+    while (CJobManager::GetInstance().IsPaused())
+    {
+      if (ShouldCancel(0, 0))
+        return false;
+      XbmcThreads::ThreadSleep(PAUSE_POLL_MS);
+    }
+    return CThumbExtractor::DoWork();
+  }
+};
+}
+
+CVideoExtractionQueue::CVideoExtractionQueue()
+  : CJobQueue(false, GetWorkerCount(), CJob::PRIORITY_DEDICATED)
+{ }
+
+CVideoExtractionQueue::~CVideoExtractionQueue() = default;
+
+CVideoExtractionQueue& CVideoExtractionQueue::GetInstance()
+{
+  static CVideoExtractionQueue s_instance;
+  return s_instance;
+}
+
+unsigned int CVideoExtractionQueue::GetWorkerCount()
+{
+  return std::max(1u, std::min(MAX_WORKERS, static_cast<unsigned int>(g_cpuInfo.getCPUCount()) / 2));
+}
+
+void CVideoExtractionQueue::ExtractItem(const CFileItem& item)
+{
+  if (item.m_bIsFolder || !item.IsVideo() || !item.HasVideoInfoTag() || item.IsPlugin())
+    return;
+
+  const std::shared_ptr<CSettings> settings = CServiceBroker::GetSettingsComponent()->GetSettings();
+  if (!settings->GetBool(CSettings::SETTING_MYVIDEOS_EXTRACTFLAGS))
+    return;
+
+  {
+    CSingleLock lock(m_statsSection);
+    if (!IsProcessing())
+    {
+      m_extracted = 0;
+      m_failed = 0;
+      m_batchStart = XbmcThreads::SystemClockMillis();
+    }
+  }
+
+  // extracting the thumb fills in the stream details as well
+  if (!item.HasArt("thumb") && settings->GetBool(CSettings::SETTING_MYVIDEOS_EXTRACTTHUMB))
+  {
+    std::string thumbURL = CVideoThumbLoader::GetEmbeddedThumbURL(item);
+    if (!CTextureCache::GetInstance().HasCachedImage(thumbURL))
+    {
+      AddJob(new CVideoExtractionJob(item, true, thumbURL));
+      return;
+    }
+  }
+
+  if (!item.GetVideoInfoTag()->HasStreamDetails())
+    AddJob(new CVideoExtractionJob(item, false));
+}
+
+void CVideoExtractionQueue::CancelAllJobs()
+{
+  CJobQueue::CancelJobs();
+  CDVDFileInfo::ClearThumbDecoders();
+}
+
+bool CVideoExtractionQueue::IsRunning() const
+{
+  return CJobQueue::IsProcessing();
+}
+
+void CVideoExtractionQueue::OnJobComplete(unsigned int jobID, bool success, CJob *job)
+{
+  CJobQueue::OnJobComplete(jobID, success, job);
+
+  const bool done = !IsProcessing();
+  {
+    CSingleLock lock(m_statsSection);
+    if (success)
+      m_extracted++;
+    else
+      m_failed++;
+
+    if (done)
+      CLog::Log(LOGDEBUG, "CVideoExtractionQueue: extracted %u files (%u failed) in %u ms",
+                m_extracted, m_failed, XbmcThreads::SystemClockMillis() - m_batchStart);
+  }
+
+  // decoders kept for the next file of the batch aren't needed anymore
+  if (done)
+    CDVDFileInfo::ClearThumbDecoders();
+}
@@ -0,0 +1,72 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "threads/CriticalSection.h"
+#include "utils/JobManager.h"
+
+class CFileItem;
+
+/*!
+ \brief Queue for extracting thumbs and stream details of video files in batches.
+
+ Video files added by a library scan are queued here instead of waiting for
+ the thumb loader of a GUI listing to reach them one at a time. The queue runs
+ several extractions in parallel on dedicated workers, which hold back while
+ video is playing like pausable jobs do.
+ */
+class CVideoExtractionQueue : protected CJobQueue
+{
+public:
+  ~CVideoExtractionQueue() override;
+
+  /*!
+   \brief Gets the singleton instance of the video extraction queue.
+  */
+  static CVideoExtractionQueue& GetInstance();
+
+  /*!
+   \brief Enqueue the extraction of a video file of the library.
+
+   Depending on the settings the thumb is extracted if the item has no thumb
+   and the stream details are extracted if the item has none.
+
+   \param[in] item Video file with the info tag it was stored with in the library
+   */
+  void ExtractItem(const CFileItem& item);
+
+  /*!
+   \brief Cancels all running and queued extractions.
+   */
+  void CancelAllJobs();
+
+  /*!
+   \brief Whether any extractions are running or not.
+   */
+  bool IsRunning() const;
+
+  /*!
+   \brief Number of extractions run at once, half of the CPU cores but at least one and at most four.
+   */
+  static unsigned int GetWorkerCount();
+
+protected:
+  // implementation of IJobCallback
+  void OnJobComplete(unsigned int jobID, bool success, CJob *job) override;
+
+private:
+  CVideoExtractionQueue();
+  CVideoExtractionQueue(const CVideoExtractionQueue&) = delete;
+  CVideoExtractionQueue const& operator=(CVideoExtractionQueue const&) = delete;
+
+  CCriticalSection m_statsSection;
+  unsigned int m_extracted = 0;
+  unsigned int m_failed = 0;
+  unsigned int m_batchStart = 0;
+};
@@ -45,6 +45,7 @@
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
 #include "utils/Variant.h"
+#include "video/VideoExtractionQueue.h"
 #include "video/VideoLibraryQueue.h"
 #include "video/VideoThumbLoader.h"
 #include "VideoInfoDownloader.h"
@@ -213,6 +214,9 @@ namespace VIDEO
     if (m_bCanInterrupt)
       m_database.Interrupt();
 
+    // the extractions queued by the scan are of no use once it is cancelled
+    CVideoExtractionQueue::GetInstance().CancelAllJobs();
+
     m_bStop = true;
   }
 
@@ -1394,6 +1398,9 @@ namespace VIDEO
       if ((CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_bVideoLibraryImportResumePoint || libraryImport) &&
           movieDetails.GetResumePoint().IsSet())
         m_database.AddBookMarkToFile(pItem->GetPath(), movieDetails.GetResumePoint(), CBookmark::RESUME);
+
+      if (lResult > -1)
+        CVideoExtractionQueue::GetInstance().ExtractItem(*pItem);
     }
 
     m_database.Close();
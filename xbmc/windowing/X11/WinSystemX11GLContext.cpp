@@ -28,6 +28,7 @@
 #include "cores/VideoPlayer/VideoRenderers/RenderFactory.h"
 
 #include "OptionalsReg.h"
+#include "cores/AudioEngine/Sinks/AESinkNULL.h"
 #include "platform/linux/OptionalsReg.h"
 
 using namespace KODI;
@@ -59,6 +60,10 @@ CWinSystemX11GLContext::CWinSystemX11GLContext()
   {
     OPTIONALS::SndioRegister();
   }
+  else if (StringUtils::EqualsNoCase(envSink, "NULL"))
+  {
+    CAESinkNULL::Register();
+  }
   else
   {
     if (!OPTIONALS::PulseAudioRegister())
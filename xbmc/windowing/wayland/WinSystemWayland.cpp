@@ -14,6 +14,7 @@
 
 #include "Application.h"
 #include "Connection.h"
+#include "cores/AudioEngine/Sinks/AESinkNULL.h"
 #include "cores/RetroPlayer/process/wayland/RPProcessInfoWayland.h"
 #include "cores/VideoPlayer/Process/wayland/ProcessInfoWayland.h"
 #include "guilib/DispResource.h"
@@ -156,6 +157,10 @@ CWinSystemWayland::CWinSystemWayland()
   {
     OPTIONALS::SndioRegister();
   }
+  else if (StringUtils::EqualsNoCase(envSink, "NULL"))
+  {
+    CAESinkNULL::Register();
+  }
   else
   {
     if (!OPTIONALS::PulseAudioRegister())